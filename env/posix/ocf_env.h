@@ -29,6 +29,7 @@
 #include <sys/time.h>
 #include <sys/param.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <zlib.h>
 
 #include "ocf_env_list.h"
@@ -61,6 +62,8 @@ typedef uint64_t sector_t;
 #define likely(cond)       __builtin_expect(!!(cond), 1)
 #define unlikely(cond)     __builtin_expect(!!(cond), 0)
 
+#define env_prefetch(addr)	__builtin_prefetch(addr)
+
 /* MEMORY MANAGEMENT */
 #define ENV_MEM_NORMAL	0
 #define ENV_MEM_NOIO	0
@@ -192,6 +195,133 @@ static inline void env_secure_free(const void *ptr, size_t size)
 	}
 }
 
+/* LARGE MEMORY ALLOCATIONS */
+/*
+ * Large metadata arrays may be backed by huge pages to reduce TLB misses
+ * on random lookups and placed on given NUMA node or interleaved across all
+ * nodes. Both are hints - if huge pages are not available allocation falls
+ * back to smaller ones and reports backing actually used. Memory returned
+ * is zeroed.
+ */
+
+#define ENV_MEM_PAGE_DEFAULT	0
+#define ENV_MEM_PAGE_THP	1
+#define ENV_MEM_PAGE_2M		2
+#define ENV_MEM_PAGE_1G		3
+
+#define ENV_NUMA_NODE_ANY	(-1)
+#define ENV_NUMA_INTERLEAVE	(-2)
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+/* memory policies as defined by <numaif.h>, which is not always present */
+#define ENV_MPOL_PREFERRED	1
+#define ENV_MPOL_INTERLEAVE	3
+
+static inline size_t env_large_page_size(int page)
+{
+	switch (page) {
+	case ENV_MEM_PAGE_2M:
+		return 2UL << 20;
+	case ENV_MEM_PAGE_1G:
+		return 1UL << 30;
+	default:
+		return PAGE_SIZE;
+	}
+}
+
+static inline void env_large_set_numa(void *ptr, size_t size, int numa_node)
+{
+	unsigned long nodemask;
+	int mode;
+
+	if (numa_node == ENV_NUMA_NODE_ANY)
+		return;
+
+	if (numa_node == ENV_NUMA_INTERLEAVE) {
+		nodemask = ~0UL;
+		mode = ENV_MPOL_INTERLEAVE;
+	} else if (numa_node < (int)(sizeof(nodemask) * 8)) {
+		nodemask = 1UL << numa_node;
+		mode = ENV_MPOL_PREFERRED;
+	} else {
+		return;
+	}
+
+	/* placement is only a hint, memory is usable regardless */
+	syscall(SYS_mbind, ptr, size, mode, &nodemask,
+			sizeof(nodemask) * 8, 0);
+}
+
+static inline void *env_large_mmap(size_t size, int page)
+{
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	void *ptr;
+
+	if (page == ENV_MEM_PAGE_2M)
+		flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+	else if (page == ENV_MEM_PAGE_1G)
+		flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+
+	ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+	return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+/*
+ * @param page requested backing on input, backing actually used on output
+ */
+static inline void *env_large_zalloc(size_t size, int *page, int numa_node)
+{
+	void *ptr = NULL;
+
+	for (; *page >= ENV_MEM_PAGE_2M; (*page)--) {
+		ptr = env_large_mmap(DIV_ROUND_UP(size,
+				env_large_page_size(*page)) *
+				env_large_page_size(*page), *page);
+		if (ptr)
+			break;
+	}
+
+	if (!ptr) {
+		ptr = env_large_mmap(size, ENV_MEM_PAGE_DEFAULT);
+		if (!ptr)
+			return NULL;
+
+		if (*page == ENV_MEM_PAGE_THP && madvise(ptr, size,
+				MADV_HUGEPAGE)) {
+			*page = ENV_MEM_PAGE_DEFAULT;
+		}
+	}
+
+	/* must be set before first touch of the pages */
+	env_large_set_numa(ptr, size, numa_node);
+
+#if SECURE_MEMORY_HANDLING
+	if (mlock(ptr, size)) {
+		munmap(ptr, DIV_ROUND_UP(size, env_large_page_size(*page)) *
+				env_large_page_size(*page));
+		return NULL;
+	}
+#endif
+
+	return ptr;
+}
+
+static inline void env_large_free(void *ptr, size_t size, int page)
+{
+	if (ptr) {
+#if SECURE_MEMORY_HANDLING
+		ENV_BUG_ON(munlock(ptr, size));
+#endif
+		ENV_BUG_ON(munmap(ptr, DIV_ROUND_UP(size,
+				env_large_page_size(page)) *
+				env_large_page_size(page)));
+	}
+}
+
 static inline uint64_t env_get_free_memory(void)
 {
 	return (uint64_t)(-1);
@@ -488,6 +618,12 @@ static inline long env_atomic64_cmpxchg(env_atomic64 *a, long old_v, long new_v)
 	return __sync_val_compare_and_swap(&a->counter, old_v, new_v);
 }
 
+/* Order loads issued before the barrier against loads issued after it */
+static inline void env_smp_rmb(void)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
 /* SPIN LOCKS */
 typedef struct {
 	pthread_spinlock_t lock;
@@ -551,6 +687,11 @@ static inline void env_rwlock_write_lock(env_rwlock *l)
 	ENV_BUG_ON(pthread_rwlock_wrlock(&l->lock));
 }
 
+static inline int env_rwlock_write_trylock(env_rwlock *l)
+{
+	return pthread_rwlock_trywrlock(&l->lock) ? -OCF_ERR_NO_LOCK : 0;
+}
+
 static inline void env_rwlock_write_unlock(env_rwlock *l)
 {
 	ENV_BUG_ON(pthread_rwlock_unlock(&l->lock));
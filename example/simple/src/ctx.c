@@ -126,6 +126,38 @@ static uint64_t ctx_data_copy(ctx_data_t *dst, ctx_data_t *src,
 	return bytes;
 }
 
+/*
+ * Check if data is zero-filled. Buffer is scanned word by word, which
+ * compiler is able to vectorize.
+ */
+static bool ctx_data_is_zero(ctx_data_t *src, uint64_t offset, uint64_t bytes)
+{
+	struct volume_data *data = src;
+	const char *ptr = (const char *)data->ptr + offset;
+	const uint64_t *word;
+	uint64_t acc = 0;
+
+	while (bytes && ((uintptr_t)ptr % sizeof(*word))) {
+		if (*ptr)
+			return false;
+		ptr++;
+		bytes--;
+	}
+
+	for (word = (const uint64_t *)ptr; bytes >= sizeof(*word);
+			bytes -= sizeof(*word)) {
+		acc |= *word++;
+		/* Bail out early on first non-zero page */
+		if (acc && !((uintptr_t)word % PAGE_SIZE))
+			return false;
+	}
+
+	for (ptr = (const char *)word; bytes; bytes--)
+		acc |= *ptr++;
+
+	return !acc;
+}
+
 /*
  * Perform secure erase of data (e.g. fill pages with zeros).
  * Can be left non-implemented if not needed.
@@ -223,6 +255,7 @@ static const struct ocf_ctx_config ctx_cfg = {
 			.seek = ctx_data_seek,
 			.copy = ctx_data_copy,
 			.secure_erase = ctx_data_secure_erase,
+			.is_zero = ctx_data_is_zero,
 		},
 
 		.cleaner = {
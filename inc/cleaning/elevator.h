@@ -0,0 +1,50 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#ifndef __OCF_CLEANING_ELEVATOR_H__
+#define __OCF_CLEANING_ELEVATOR_H__
+
+/**
+ * @file
+ * @brief Elevator cleaning policy API
+ */
+
+enum ocf_cleaning_elevator_parameters {
+	ocf_elevator_wake_up_time,
+	ocf_elevator_flush_max_buffers,
+};
+
+/**
+ * @name Elevator cleaning policy parameters
+ * @{
+ */
+
+/**
+ * Elevator cleaning policy time between flushing cycles (in ms)
+ */
+
+/**< Wake up time minimum value */
+#define OCF_ELEVATOR_MIN_WAKE_UP		0
+/**< Wake up time maximum value */
+#define OCF_ELEVATOR_MAX_WAKE_UP		10000
+/**< Wake up time default value */
+#define OCF_ELEVATOR_DEFAULT_WAKE_UP		10
+
+/**
+ * Elevator cleaning thread number of dirty cache lines to be flushed in one
+ * cycle
+ */
+
+/** Dirty cache lines to be flushed in one cycle minimum value */
+#define OCF_ELEVATOR_MIN_FLUSH_MAX_BUFFERS	1
+/** Dirty cache lines to be flushed in one cycle maximum value */
+#define OCF_ELEVATOR_MAX_FLUSH_MAX_BUFFERS	10000
+/** Dirty cache lines to be flushed in one cycle default value */
+#define OCF_ELEVATOR_DEFAULT_FLUSH_MAX_BUFFERS	1024
+
+/**
+ * @}
+ */
+
+#endif /* __OCF_CLEANING_ELEVATOR_H__ */
@@ -78,6 +78,9 @@ struct ocf_cache_info {
 	ocf_promotion_t promotion_policy;
 		/*!< Promotion policy selected */
 
+	ocf_eviction_t eviction_policy;
+		/*!< Eviction policy selected */
+
 	ocf_cache_line_size_t cache_line_size;
 		/*!< Cache line size in KiB */
 
@@ -92,6 +95,9 @@ struct ocf_cache_info {
 
 	uint32_t metadata_end_offset;
 		/*!< LBA offset where metadata ends (in 4KiB blocks) */
+
+	uint64_t metadata_backing[ocf_metadata_page_max];
+		/*!< Large metadata arrays memory (in bytes) per page backing */
 };
 
 /**
@@ -125,6 +125,20 @@ struct ocf_data_ops {
 	 * @param[in] dst Contex data buffer which shall be erased
 	 */
 	void (*secure_erase)(ctx_data_t *dst);
+
+	/**
+	 * @brief Check whether part of context data buffer is zero-filled
+	 *
+	 * Optional, zero-filled writes are not detected when not implemented.
+	 *
+	 * @param[in] src Context data buffer
+	 * @param[in] offset Starting offset in buffer
+	 * @param[in] bytes Number of bytes to be checked
+	 *
+	 * @retval true All checked bytes are zero
+	 * @retval false At least one checked byte is not zero
+	 */
+	bool (*is_zero)(ctx_data_t *src, uint64_t offset, uint64_t bytes);
 };
 
 /**
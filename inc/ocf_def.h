@@ -49,6 +49,103 @@
  * Maximum value of io error threshold
  */
 #define OCF_CACHE_FALLBACK_PT_MAX_ERROR_THRESHOLD	1000000
+/**
+ * Value to turn off write coalescing
+ */
+#define OCF_CACHE_WRITE_COALESCING_INACTIVE	0
+/**
+ * Maximum size of request produced by write coalescing
+ */
+#define OCF_CACHE_WRITE_COALESCING_MAX_BATCH_SIZE	(1 * MiB)
+/**
+ * Default size of request produced by write coalescing
+ */
+#define OCF_CACHE_WRITE_COALESCING_DEFAULT_BATCH_SIZE	(128 * KiB)
+/**
+ * Value to turn off metadata group commit
+ */
+#define OCF_METADATA_GROUP_COMMIT_INACTIVE	0
+/**
+ * Maximum number of metadata pages written by single group commit
+ */
+#define OCF_METADATA_GROUP_COMMIT_MAX_PAGES	1024
+/**
+ * Maximum time (in microseconds) group commit batch may stay open
+ */
+#define OCF_METADATA_GROUP_COMMIT_MAX_WINDOW_US	10000
+/**
+ * Default time (in microseconds) group commit batch may stay open
+ */
+#define OCF_METADATA_GROUP_COMMIT_DEFAULT_WINDOW_US	100
+/**
+ * Value to turn off request splitting
+ */
+#define OCF_CACHE_SPLIT_IO_INACTIVE	0
+/**
+ * Minimum size of request produced by request splitting
+ */
+#define OCF_CACHE_SPLIT_IO_MIN_SIZE	(64 * KiB)
+/**
+ * Maximum size of request produced by request splitting
+ */
+#define OCF_CACHE_SPLIT_IO_MAX_SIZE	(64 * MiB)
+/**
+ * Value of cleaning governor max_rate turning the governor off
+ */
+#define OCF_CLEANING_GOVERNOR_INACTIVE	0
+/**
+ * Default dirty ratio (in percent) below which cleaning yields to user I/O
+ */
+#define OCF_CLEANING_GOVERNOR_DEFAULT_DIRTY_LOW	10
+/**
+ * Default dirty ratio (in percent) above which cleaning runs at max rate
+ */
+#define OCF_CLEANING_GOVERNOR_DEFAULT_DIRTY_HIGH	50
+/**
+ * Default core read miss latency (in microseconds) considered congested
+ */
+#define OCF_CLEANING_GOVERNOR_DEFAULT_TARGET_LATENCY_US	5000
+/**
+ * Default number of requests in flight considered congested
+ */
+#define OCF_CLEANING_GOVERNOR_DEFAULT_MAX_QUEUE_DEPTH	32
+/**
+ * Minimum number of cache lines in flight per core cleaning stream
+ */
+#define OCF_CLEANING_STREAM_MIN_DEPTH	1
+/**
+ * Maximum number of cache lines in flight per core cleaning stream
+ */
+#define OCF_CLEANING_STREAM_MAX_DEPTH	10000
+/**
+ * Default number of cache lines in flight per core cleaning stream
+ */
+#define OCF_CLEANING_STREAM_DEFAULT_DEPTH	1024
+/**
+ * Value of rewrite counter at which it saturates
+ */
+#define OCF_CLEANING_ABSORB_MAX_REWRITES	15
+/**
+ * Default number of writes after which dirty cache line is not cleaned,
+ * 0 disables write absorption
+ */
+#define OCF_CLEANING_ABSORB_DEFAULT_THRESHOLD	0
+/**
+ * Default dirty ratio (in percent) above which hot cache lines are cleaned
+ */
+#define OCF_CLEANING_ABSORB_DEFAULT_DIRTY_HIGH	70
+/**
+ * Minimum number of flush portions in flight per core
+ */
+#define OCF_MNGT_FLUSH_MIN_QUEUE_DEPTH	1
+/**
+ * Maximum number of flush portions in flight per core
+ */
+#define OCF_MNGT_FLUSH_MAX_QUEUE_DEPTH	64
+/**
+ * Default number of flush portions in flight per core
+ */
+#define OCF_MNGT_FLUSH_DEFAULT_QUEUE_DEPTH	4
 /**
  * @}
  */
@@ -216,6 +313,30 @@ typedef enum {
 		/*!< Default promotion policy */
 } ocf_promotion_t;
 
+/**
+ * OCF supported eviction policy types
+ */
+typedef enum {
+	ocf_eviction_lru = 0,
+		/*!< Least recently used line is evicted. Hit moves line to the
+		 * head of LRU list */
+
+	ocf_eviction_clock,
+		/*!< CLOCK (second chance). Hit only sets line reference bit,
+		 * eviction moves referenced lines back to the list head */
+
+	ocf_eviction_cost,
+		/*!< Cost-aware LRU. Victim is chosen among lines at the LRU
+		 * list tail by their core miss latency, so lines of slow cores
+		 * are retained longer */
+
+	ocf_eviction_max,
+		/*!< Stopper of enumerator */
+
+	ocf_eviction_default = ocf_eviction_lru,
+		/*!< Default eviction policy */
+} ocf_eviction_t;
+
 /**
  * OCF supported Write-Back cleaning policies type
  */
@@ -236,6 +357,12 @@ typedef enum {
 		 * distance. Cleaning thread runs concurrently with I/O.
 		 */
 
+	ocf_cleaning_elevator,
+		/*!< Cleaning thread sweeps dirty data of each core in
+		 * ascending core LBA order, so that core device sees
+		 * sequential writes. Runs concurrently with I/O.
+		 */
+
 	ocf_cleaning_max,
 		/*!< Stopper of enumerator */
 
@@ -288,6 +415,36 @@ typedef enum {
 	ocf_metadata_layout_default = ocf_metadata_layout_striping
 } ocf_metadata_layout_t;
 
+/**
+ * Page backing of large in-memory metadata arrays
+ */
+typedef enum {
+	ocf_metadata_page_default = 0,
+		/*!< Regular pages */
+	ocf_metadata_page_thp,
+		/*!< Transparent huge pages */
+	ocf_metadata_page_2m,
+		/*!< 2 MiB huge pages */
+	ocf_metadata_page_1g,
+		/*!< 1 GiB huge pages */
+	ocf_metadata_page_max,
+} ocf_metadata_page_t;
+
+/**
+ * Place metadata on any NUMA node
+ */
+#define OCF_NUMA_NODE_ANY (-1)
+
+/**
+ * Interleave metadata across all NUMA nodes
+ */
+#define OCF_NUMA_INTERLEAVE (-2)
+
+/**
+ * Number of NUMA nodes metadata can be placed on
+ */
+#define OCF_NUMA_NODE_MAX 64
+
 /**
  * @name OCF IO class definitions
  */
@@ -322,6 +479,9 @@ typedef enum {
 
 /** Default IO class priority */
 #define OCF_IO_CLASS_PRIO_DEFAULT OCF_IO_CLASS_PRIO_LOWEST
+
+/** Maximum IO class cache line time to live in seconds */
+#define OCF_IO_CLASS_TTL_MAX 65535
 /**
  * @}
  */
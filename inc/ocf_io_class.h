@@ -46,6 +46,17 @@ struct ocf_io_class_info {
 
 	ocf_cleaning_t cleaning_policy_type;
 		/*!< The type of cleaning policy for given IO class */
+
+	uint8_t slru_protected_size;
+		/*!< Segmented LRU protected segment size in percent,
+		 * 0 if IO class uses plain LRU
+		 */
+
+	uint8_t headroom_size;
+		/*!< Free space kept for IO class in percent of cache size */
+
+	uint32_t ttl;
+		/*!< Cache line time to live in seconds, 0 if disabled */
 };
 
 /**
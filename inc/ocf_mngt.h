@@ -251,6 +251,11 @@ struct ocf_mngt_cache_config {
 	 */
 	ocf_promotion_t promotion_policy;
 
+	/**
+	 * @brief Eviction policy type
+	 */
+	ocf_eviction_t eviction_policy;
+
 	/**
 	 * @brief Cache line size
 	 */
@@ -263,6 +268,35 @@ struct ocf_mngt_cache_config {
 
 	bool metadata_volatile;
 
+	/**
+	 * @brief Page backing of large metadata arrays
+	 *
+	 * @note Huge pages are a hint - if they can't be allocated, metadata
+	 *       falls back to smaller pages. Backing actually used is reported
+	 *       in struct ocf_cache_info.
+	 */
+	ocf_metadata_page_t metadata_page;
+
+	/**
+	 * @brief NUMA node of large metadata arrays
+	 *
+	 * Node number lower than OCF_NUMA_NODE_MAX, OCF_NUMA_NODE_ANY
+	 * or OCF_NUMA_INTERLEAVE
+	 */
+	int32_t metadata_numa_node;
+
+	/**
+	 * @brief Journal dirty status changes of cache lines
+	 *
+	 * Instead of rewriting collision metadata pages, dirty status
+	 * changes are appended to a sequential journal on cache device,
+	 * which is replayed when cache is loaded after dirty shutdown.
+	 * Collision pages are written lazily by journal checkpoints.
+	 *
+	 * @note Ignored if metadata is volatile or cache device is atomic
+	 */
+	bool metadata_journal;
+
 	/**
 	 * @brief Start cache and keep it locked
 	 *
@@ -303,9 +337,13 @@ static inline void ocf_mngt_cache_config_set_default(
 {
 	cfg->cache_mode = ocf_cache_mode_default;
 	cfg->promotion_policy = ocf_promotion_default;
+	cfg->eviction_policy = ocf_eviction_default;
 	cfg->cache_line_size = ocf_cache_line_size_4;
 	cfg->metadata_layout = ocf_metadata_layout_default;
 	cfg->metadata_volatile = false;
+	cfg->metadata_page = ocf_metadata_page_default;
+	cfg->metadata_numa_node = OCF_NUMA_NODE_ANY;
+	cfg->metadata_journal = false;
 	cfg->backfill.max_queue_size = 65536;
 	cfg->backfill.queue_unblock_size = 60000;
 	cfg->locked = false;
@@ -682,6 +720,33 @@ void ocf_mngt_core_purge(ocf_core_t core,
  */
 void ocf_mngt_cache_flush_interrupt(ocf_cache_t cache);
 
+/**
+ * @brief Set number of flush portions in flight per core
+ *
+ * Cache flush scans cache line metadata in parallel, one segment per
+ * I/O queue, and writes dirty data back in portions as they are
+ * collected. Scanner which would exceed depth portions in flight to
+ * any core waits until one of them completes.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] depth Flush portions in flight per core
+ *
+ * @retval 0 Depth has been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_flush_queue_depth(ocf_cache_t cache, uint32_t depth);
+
+/**
+ * @brief Get number of flush portions in flight per core
+ *
+ * @param[in] cache Cache handle
+ * @param[out] depth Flush portions in flight per core
+ *
+ * @retval 0 Depth has been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_flush_queue_depth(ocf_cache_t cache, uint32_t *depth);
+
 /**
  * @brief Completion callback of save operation
  *
@@ -876,6 +941,39 @@ struct ocf_mngt_io_class_config {
 	 * @brief IO class eviction priority
 	 */
 	int16_t prio;
+
+	/**
+	 * @brief IO class segmented LRU protected segment size in percent
+	 *
+	 * New cache lines are inserted into probationary segment and are
+	 * promoted to protected segment on next hit. Eviction drains
+	 * probationary segment first. 0 selects plain LRU.
+	 */
+	uint8_t slru_protected_size;
+
+	/**
+	 * @brief IO class free space headroom in percent of cache size
+	 *
+	 * Background reclaim keeps this much free cache lines available and
+	 * keeps IO class occupancy this much below its maximum size, so that
+	 * burst of misses does not have to evict synchronously. Space is
+	 * reclaimed from IO classes above their maximum size first, then from
+	 * lowest priority IO classes. Requires background reclaim to run on
+	 * I/O queues. 0 disables headroom.
+	 */
+	uint8_t headroom_size;
+
+	/**
+	 * @brief IO class cache line time to live in seconds
+	 *
+	 * Cache lines mapped longer than TTL ago are not promoted on hit and
+	 * get no second chance on eviction, so they are evicted first.
+	 * 0 disables expiry, maximum is OCF_IO_CLASS_TTL_MAX. Once any IO
+	 * class has TTL set, mapping time of every cache line is tracked
+	 * (5 bytes per line, shared with eviction statistics) until the cache
+	 * is detached.
+	 */
+	uint32_t ttl;
 };
 
 struct ocf_mngt_io_classes_config {
@@ -1061,6 +1159,39 @@ int ocf_mngt_core_set_seq_cutoff_promotion_count_all(ocf_cache_t cache,
 int ocf_mngt_core_get_seq_cutoff_promotion_count(ocf_core_t core,
 		uint32_t *count);
 
+/**
+ * @brief Pin core address range in cache
+ *
+ * Cache lines mapping pinned range are never evicted. Range is merged with
+ * already pinned ranges it overlaps or touches.
+ *
+ * @attention This changes only runtime state, pinned ranges are not
+ *            persistent.
+ *
+ * @param[in] core Core handle
+ * @param[in] addr Start address of the range in bytes
+ * @param[in] bytes Length of the range in bytes
+ *
+ * @retval 0 Range has been pinned successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_core_pin_range(ocf_core_t core, uint64_t addr, uint64_t bytes);
+
+/**
+ * @brief Unpin core address range
+ *
+ * Parts of pinned ranges overlapping given range are unpinned, remaining
+ * parts stay pinned.
+ *
+ * @param[in] core Core handle
+ * @param[in] addr Start address of the range in bytes
+ * @param[in] bytes Length of the range in bytes
+ *
+ * @retval 0 Range has been unpinned successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_core_unpin_range(ocf_core_t core, uint64_t addr, uint64_t bytes);
+
 /**
  * @brief Set cache fallback Pass Through error threshold
  *
@@ -1094,6 +1225,350 @@ int ocf_mngt_cache_get_fallback_pt_error_threshold(ocf_cache_t cache,
  */
 int ocf_mngt_cache_reset_fallback_pt_error_counter(ocf_cache_t cache);
 
+/**
+ * @brief Set write-back write coalescing parameters
+ *
+ * Small write-back writes queued on the same I/O queue which overlap or
+ * are adjacent to each other are merged into a single engine request.
+ * Completion of every merged write is deferred until the merged request
+ * completes, so reads issued after a write completion always observe
+ * its data.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] max_io_size Largest write eligible for coalescing in bytes,
+ *		OCF_CACHE_WRITE_COALESCING_INACTIVE disables coalescing
+ * @param[in] max_batch_size Upper bound of merged request size in bytes
+ *
+ * @retval 0 Parameters have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_write_coalescing(ocf_cache_t cache,
+		uint32_t max_io_size, uint32_t max_batch_size);
+
+/**
+ * @brief Get write-back write coalescing parameters
+ *
+ * @param[in] cache Cache handle
+ * @param[out] max_io_size Largest write eligible for coalescing in bytes
+ * @param[out] max_batch_size Upper bound of merged request size in bytes
+ *
+ * @retval 0 Parameters have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_write_coalescing(ocf_cache_t cache,
+		uint32_t *max_io_size, uint32_t *max_batch_size);
+
+/**
+ * @brief Set metadata group commit parameters
+ *
+ * Metadata pages dirtied by requests which complete while another metadata
+ * write is in progress are gathered and written together once it finishes.
+ * Batch is written earlier when it reaches max_pages or when it has been
+ * open for longer than window_us. Requests complete only after all of
+ * their metadata pages are persistent.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] max_pages Maximum number of pages written by single commit,
+ *		OCF_METADATA_GROUP_COMMIT_INACTIVE disables group commit
+ * @param[in] window_us Maximum time (in microseconds) batch stays open
+ *
+ * @retval 0 Parameters have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_metadata_group_commit(ocf_cache_t cache,
+		uint32_t max_pages, uint32_t window_us);
+
+/**
+ * @brief Get metadata group commit parameters
+ *
+ * @param[in] cache Cache handle
+ * @param[out] max_pages Maximum number of pages written by single commit
+ * @param[out] window_us Maximum time (in microseconds) batch stays open
+ *
+ * @retval 0 Parameters have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_metadata_group_commit(ocf_cache_t cache,
+		uint32_t *max_pages, uint32_t *window_us);
+
+/**
+ * @brief Set size above which requests are split
+ *
+ * Larger requests are split into child requests aligned to multiples of
+ * split size (rounded up to cache line size). Children are spread over
+ * I/O queues of the cache and handled in parallel.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] split_io_size Size in bytes,
+ *		OCF_CACHE_SPLIT_IO_INACTIVE disables splitting
+ *
+ * @retval 0 Split size has been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_split_io_size(ocf_cache_t cache,
+		uint32_t split_io_size);
+
+/**
+ * @brief Get size above which requests are split
+ *
+ * @param[in] cache Cache handle
+ * @param[out] split_io_size Size in bytes
+ *
+ * @retval 0 Split size has been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_split_io_size(ocf_cache_t cache,
+		uint32_t *split_io_size);
+
+/**
+ * @brief Set zero-filled write detection
+ *
+ * When enabled, writes carrying only zeros are not inserted into cache.
+ * They are submitted to the core (as write zeroes if core volume supports
+ * it) and cache lines they touch are invalidated. Detection requires
+ * is_zero context data operation.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] enable Enable or disable detection
+ *
+ * @retval 0 Zero detection has been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_zero_detection(ocf_cache_t cache, bool enable);
+
+/**
+ * @brief Get zero-filled write detection state
+ *
+ * @param[in] cache Cache handle
+ * @param[out] enabled Zero detection state
+ *
+ * @retval 0 Zero detection state has been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_zero_detection(ocf_cache_t cache, bool *enabled);
+
+/**
+ * @brief Set background reclaim watermarks
+ *
+ * When number of free cache lines drops below low watermark, I/O queue
+ * evicts clean cache lines in batches, in its own context, until the number
+ * reaches high watermark. Misses are then mapped from free cache lines
+ * instead of evicting inline.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] low_watermark Free cache lines count starting reclaim,
+ *		0 disables background reclaim
+ * @param[in] high_watermark Free cache lines count stopping reclaim
+ *
+ * @retval 0 Watermarks have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_reclaim_watermarks(ocf_cache_t cache,
+		uint32_t low_watermark, uint32_t high_watermark);
+
+/**
+ * @brief Get background reclaim watermarks
+ *
+ * @param[in] cache Cache handle
+ * @param[out] low_watermark Free cache lines count starting reclaim
+ * @param[out] high_watermark Free cache lines count stopping reclaim
+ *
+ * @retval 0 Watermarks have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_reclaim_watermarks(ocf_cache_t cache,
+		uint32_t *low_watermark, uint32_t *high_watermark);
+
+/**
+ * @brief Set deferred LRU balancing
+ *
+ * When enabled, I/O path does not maintain ratio of hot to cold LRU list
+ * elements. Lists are balanced by the cleaner instead, which then wakes up
+ * at least every 100 ms.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] enable Enable or disable deferred balancing
+ *
+ * @retval 0 Deferred balancing has been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_lru_deferred_balance(ocf_cache_t cache, bool enable);
+
+/**
+ * @brief Get deferred LRU balancing state
+ *
+ * @param[in] cache Cache handle
+ * @param[out] enabled Deferred balancing state
+ *
+ * @retval 0 State has been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_lru_deferred_balance(ocf_cache_t cache, bool *enabled);
+
+/**
+ * @brief Set eviction statistics collection
+ *
+ * When enabled, eviction counters are updated and each cache line hit is
+ * counted for the hits at eviction histogram. Disabled by default.
+ * Enabling allocates mapping time and hit count of every cache line
+ * (5 bytes per line, shared with IO class TTL), which is kept until the
+ * cache is detached.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] enable Enable or disable eviction statistics
+ *
+ * @retval 0 Eviction statistics have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_eviction_stats(ocf_cache_t cache, bool enable);
+
+/**
+ * @brief Get eviction statistics collection state
+ *
+ * @param[in] cache Cache handle
+ * @param[out] enabled Eviction statistics state
+ *
+ * @retval 0 State has been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_eviction_stats(ocf_cache_t cache, bool *enabled);
+
+/**
+ * @brief Cleaning governor parameters
+ */
+struct ocf_mngt_cleaning_governor_config {
+	uint8_t dirty_low;
+		/*!< Dirty to occupied lines ratio (in percent) of the most dirty
+		 * io class, below which cleaning backs off to min_rate whenever
+		 * user I/O is in flight */
+
+	uint8_t dirty_high;
+		/*!< Dirty ratio (in percent) above which cleaning runs at
+		 * max_rate regardless of user I/O */
+
+	uint32_t target_latency_us;
+		/*!< Core read miss latency above which core is congested */
+
+	uint32_t max_queue_depth;
+		/*!< Number of requests in flight above which cache is
+		 * congested */
+
+	uint32_t min_rate;
+		/*!< Lowest cleaning rate in cache lines per second */
+
+	uint32_t max_rate;
+		/*!< Highest cleaning rate in cache lines per second,
+		 * OCF_CLEANING_GOVERNOR_INACTIVE disables the governor */
+};
+
+/**
+ * @brief Set cleaning governor parameters
+ *
+ * Governor replaces idle time heuristics of ALRU and ACP cleaning
+ * policies with a cleaning rate. Rate is adjusted on every cleaner run:
+ * it drops by a quarter when core latency or queue depth exceeds its
+ * target, grows by 1/16 of max_rate otherwise and is pinned at max_rate
+ * once dirty ratio reaches dirty_high. Cleaner flushes at most as many
+ * cache lines as it has accumulated tokens at the current rate, while
+ * policy specific limits of a single cleaning cycle still apply.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] cfg Governor parameters
+ *
+ * @retval 0 Parameters have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_cleaning_governor(ocf_cache_t cache,
+		const struct ocf_mngt_cleaning_governor_config *cfg);
+
+/**
+ * @brief Get cleaning governor parameters
+ *
+ * @param[in] cache Cache handle
+ * @param[out] cfg Governor parameters
+ * @param[out] rate Current cleaning rate in cache lines per second
+ *
+ * @retval 0 Parameters have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_cleaning_governor(ocf_cache_t cache,
+		struct ocf_mngt_cleaning_governor_config *cfg, uint32_t *rate);
+
+/**
+ * @brief Write absorption parameters
+ */
+struct ocf_mngt_write_absorption_config {
+	uint8_t rewrite_threshold;
+		/*!< Number of writes to cache line after which it is considered
+		 * hot and left dirty by ALRU and ACP cleaning policies,
+		 * 0 disables write absorption */
+
+	uint8_t dirty_high;
+		/*!< Dirty ratio (in percent) of the most dirty io class at
+		 * which hot cache lines are cleaned as well */
+};
+
+/**
+ * @brief Set write absorption parameters
+ *
+ * Every cache line counts writes to it in a small saturating counter.
+ * As long as dirty ratio stays below dirty_high, cleaner leaves behind
+ * cache lines which reached rewrite_threshold, so that data about to be
+ * overwritten is not written back to core over and over again. Counter
+ * is halved whenever cache line is left behind and is reset once cache
+ * line gets clean.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] cfg Write absorption parameters
+ *
+ * @retval 0 Parameters have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_write_absorption(ocf_cache_t cache,
+		const struct ocf_mngt_write_absorption_config *cfg);
+
+/**
+ * @brief Get write absorption parameters
+ *
+ * @param[in] cache Cache handle
+ * @param[out] cfg Write absorption parameters
+ *
+ * @retval 0 Parameters have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_write_absorption(ocf_cache_t cache,
+		struct ocf_mngt_write_absorption_config *cfg);
+
+/**
+ * @brief Set number of cache lines in flight per core cleaning stream
+ *
+ * Cleaner writes back dirty data of each core in a separate stream,
+ * submitted on I/O queue assigned to that core. Stream which has depth
+ * cache lines in flight is skipped by the cleaning policy until some of
+ * them complete, so that a slow core does not hold back cleaning of the
+ * others.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] depth Cache lines in flight per stream
+ *
+ * @retval 0 Depth has been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_cleaning_stream_depth(ocf_cache_t cache,
+		uint32_t depth);
+
+/**
+ * @brief Get number of cache lines in flight per core cleaning stream
+ *
+ * @param[in] cache Cache handle
+ * @param[out] depth Cache lines in flight per stream
+ *
+ * @retval 0 Depth has been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_cleaning_stream_depth(ocf_cache_t cache,
+		uint32_t *depth);
+
 /**
  * @brief Get core pool count
  *
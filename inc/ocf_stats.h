@@ -45,6 +45,109 @@ struct ocf_stats_usage {
 	struct ocf_stat dirty;
 };
 
+/**
+ * @brief IO class LRU statistics in 4 KiB unit
+ *
+ * Protected segment holds lines which were hit after insertion (hot lines
+ * for plain LRU), probationary segment holds remaining lines, which are
+ * evicted first. Percentage is relative to IO class occupancy.
+ */
+struct ocf_stats_lru {
+	struct ocf_stat protected;
+	struct ocf_stat probation;
+};
+
+#define OCF_STATS_EVICTION_AGE_BUCKETS 16
+#define OCF_STATS_EVICTION_HITS_BUCKETS 9
+
+/**
+ * @brief IO class eviction statistics
+ *
+ * Counters are accumulated since cache attach. Histogram bucket 0 holds
+ * value 0, bucket n holds values from 2^(n-1) to 2^n - 1 and the last bucket
+ * holds all larger values. Age is counted in seconds since the line was
+ * mapped, hits are counted up to 255 per line. Histogram percentage is
+ * relative to number of victims.
+ */
+struct ocf_stats_eviction {
+	uint64_t victims;
+		/*!< Cache lines evicted from IO class */
+	uint64_t iterations;
+		/*!< LRU nodes visited while looking for victims */
+	uint64_t hash_lock_fails;
+		/*!< Candidates skipped due to hash bucket lock contention */
+	uint64_t line_lock_fails;
+		/*!< Candidates skipped due to cache line lock contention */
+	uint64_t dirty_skipped;
+		/*!< Dirty lines passed over when clean lines were exhausted,
+		 * up to the number of lines eviction was short of */
+	uint64_t lock_contended;
+		/*!< LRU list lock acquisitions which had to wait */
+	uint64_t lock_wait_us;
+		/*!< Total time spent waiting for LRU list locks */
+	struct ocf_stat age[OCF_STATS_EVICTION_AGE_BUCKETS];
+	struct ocf_stat hits[OCF_STATS_EVICTION_HITS_BUCKETS];
+};
+
+/**
+ * @brief Flush progress statistics
+ *
+ * Describes the flush or purge currently in progress. Rate is averaged
+ * over the whole flush, estimated time is 0 until first cache lines are
+ * written back.
+ */
+struct ocf_stats_flush {
+	bool in_progress;
+		/*!< Flush or purge of cache or core is in progress */
+	struct ocf_stat flushed;
+		/*!< Cache lines written back, relative to dirty lines at
+		 * flush start */
+	struct ocf_stat scanned;
+		/*!< Cache line metadata entries scanned, relative to cache
+		 * size */
+	uint64_t elapsed_ms;
+		/*!< Time since flush start */
+	uint64_t rate;
+		/*!< Cache lines written back per second */
+	uint64_t eta_ms;
+		/*!< Estimated time to flush completion */
+};
+
+#define OCF_STATS_CLEANER_LATENCY_BUCKETS 16
+#define OCF_STATS_CLEANER_AGE_BUCKETS 16
+
+/**
+ * @brief Cleaner statistics
+ *
+ * Counters cover cache lines written back both by cleaning policy and by
+ * flush and are accumulated since statistics reset. Histogram buckets are
+ * laid out as in eviction statistics. Latency of cache reads and of core
+ * writes is counted in microseconds per cleaning request, dirty age is
+ * counted in seconds since the last write to the cache line and is known
+ * for ALRU policy only. Histogram percentage is relative to histogram total.
+ */
+struct ocf_stats_cleaner {
+	uint64_t cleaned;
+		/*!< Cache lines written back */
+	uint64_t rate;
+		/*!< Cache lines written back per second since reset */
+	uint64_t core_write_bytes;
+		/*!< Bytes written to core */
+	uint64_t core_writes;
+		/*!< Core write I/Os, adjacent cache lines are merged */
+	uint64_t avg_batch;
+		/*!< Average cache lines per core write I/O, x100 */
+	uint64_t getter_skips;
+		/*!< Cache lines skipped by flush data getter */
+	uint64_t lock_aborts;
+		/*!< Dirty cache lines left behind due to lock contention */
+	uint64_t inflight_skips;
+		/*!< Dirty cache lines left behind as being cleaned already */
+	struct ocf_stat cache_read_latency[OCF_STATS_CLEANER_LATENCY_BUCKETS];
+	struct ocf_stat core_write_latency[OCF_STATS_CLEANER_LATENCY_BUCKETS];
+	struct ocf_stat dirty_age[OCF_STATS_CLEANER_AGE_BUCKETS];
+};
+
 /**
  * @brief Requests statistcs
  *
@@ -57,6 +160,8 @@ struct ocf_stats_usage {
  * ║ Read partial misses  │     1 │   0.5 │ Requests ║
  * ║ Read full misses     │   211 │  95.0 │ Requests ║
  * ║ Read total           │   222 │ 100.0 │ Requests ║
+ * ║ Read lockless hits   │     8 │   3.6 │ Requests ║
+ * ║ Read lockless retries│     0 │   0.0 │ Requests ║
  * ╟──────────────────────┼───────┼───────┼──────────╢
  * ║ Write hits           │     0 │   0.0 │ Requests ║
  * ║ Write partial misses │     0 │   0.0 │ Requests ║
@@ -76,6 +181,8 @@ struct ocf_stats_requests {
 	struct ocf_stat rd_partial_misses;
 	struct ocf_stat rd_full_misses;
 	struct ocf_stat rd_total;
+	struct ocf_stat rd_lockless_hits;
+	struct ocf_stat rd_lockless_retries;
 	struct ocf_stat wr_hits;
 	struct ocf_stat wr_partial_misses;
 	struct ocf_stat wr_full_misses;
@@ -218,6 +325,70 @@ int ocf_stats_collect_part_cache(ocf_cache_t cache, ocf_part_id_t part_id,
 		struct ocf_stats_usage *usage, struct ocf_stats_requests *req,
 		struct ocf_stats_blocks *blocks);
 
+/**
+ * @param Collect LRU statistics for given ioclass
+ *
+ * @param cache Cache instance for which statistics will be collected
+ * @param part_id Ioclass id for which statistics will be collected
+ * @param lru LRU statistics
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_stats_collect_part_lru(ocf_cache_t cache, ocf_part_id_t part_id,
+		struct ocf_stats_lru *lru);
+
+/**
+ * @param Collect eviction statistics for given ioclass
+ *
+ * @param cache Cache instance for which statistics will be collected
+ * @param part_id Ioclass id for which statistics will be collected
+ * @param eviction Eviction statistics
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_stats_collect_part_eviction(ocf_cache_t cache, ocf_part_id_t part_id,
+		struct ocf_stats_eviction *eviction);
+
+/**
+ * @param Collect progress of flush in progress
+ *
+ * @param cache Cache instance for which statistics will be collected
+ * @param flush Flush progress statistics
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_stats_collect_flush(ocf_cache_t cache, struct ocf_stats_flush *flush);
+
+/**
+ * @param Collect cleaner statistics of cache
+ *
+ * @note Getter skips are not attributed to any core and are reported
+ *	for cache only
+ *
+ * @param cache Cache instance for which statistics will be collected
+ * @param cleaner Cleaner statistics
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_stats_collect_cleaner(ocf_cache_t cache,
+		struct ocf_stats_cleaner *cleaner);
+
+/**
+ * @param Collect cleaner statistics of core
+ *
+ * @param core Core for which statistics will be collected
+ * @param cleaner Cleaner statistics
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_stats_collect_core_cleaner(ocf_core_t core,
+		struct ocf_stats_cleaner *cleaner);
+
 /**
  * @brief Initialize or reset core statistics
  *
@@ -15,6 +15,8 @@
 #include "../concurrency/ocf_cache_line_concurrency.h"
 #include "../concurrency/ocf_metadata_concurrency.h"
 #include "cleaning_priv.h"
+#include "cleaning_governor.h"
+#include "cleaning_stream.h"
 
 #define OCF_ACP_DEBUG 0
 
@@ -33,25 +35,17 @@
 #define OCF_DEBUG_PARAM(cache, format, ...) OCF_DEBUG_LOG(cache, "- "format, \
 			##__VA_ARGS__)
 
-#define ACP_DEBUG_INIT(acp) acp->checksum = 0
-#define ACP_DEBUG_BEGIN(acp, cache_line) acp->checksum ^= cache_line
-#define ACP_DEBUG_END(acp, cache_line) acp->checksum ^= cache_line
-#define ACP_DEBUG_CHECK(acp) ENV_BUG_ON(acp->checksum)
 #else
 #define OCF_DEBUG_PREFIX
 #define OCF_DEBUG_LOG(cache, format, ...)
 #define OCF_DEBUG_TRACE(cache)
 #define OCF_DEBUG_MSG(cache, msg)
 #define OCF_DEBUG_PARAM(cache, format, ...)
-#define ACP_DEBUG_INIT(acp)
-#define ACP_DEBUG_BEGIN(acp, cache_line)
-#define ACP_DEBUG_END(acp, cache_line)
-#define ACP_DEBUG_CHECK(acp)
 #endif
 
 #define ACP_CHUNK_SIZE (100 * MiB)
 
-/* minimal time to chunk cleaning after error */
+/* minimal time to chunk cleaning after error in secs */
 #define ACP_CHUNK_CLEANING_BACKOFF_TIME 5
 
 /* time to sleep when nothing to clean in ms */
@@ -68,12 +62,8 @@ static const uint16_t ACP_BUCKET_DEFAULTS[ACP_MAX_BUCKETS] = { 0, 10, 20, 30, 40
 struct acp_flush_context {
 	/* number of cache lines in flush */
 	uint64_t size;
-	/* chunk_for error handling */
-	struct acp_chunk_info *chunk;
 	/* cache lines to flush */
 	struct flush_data data[OCF_ACP_MAX_FLUSH_MAX_BUFFERS];
-	/* flush error code */
-	int error;
 };
 
 struct acp_state {
@@ -86,6 +76,9 @@ struct acp_state {
 	/* true if there are cache lines to process
 	 * current chunk */
 	bool in_progress;
+
+	/* true if hot cache lines of current chunk were left dirty */
+	bool deferred;
 };
 
 struct acp_chunk_info {
@@ -102,37 +95,38 @@ struct acp_bucket {
 	uint16_t threshold; /* threshold in clines */
 };
 
-struct acp_context {
-	env_rwsem chunks_lock;
+/* Chunks of a single core, cleaned through the core cleaning stream */
+struct acp_stream {
+	/* number of chunks */
+	uint64_t num_chunks;
 
-	/* number of chunks per core */
-	uint64_t num_chunks[OCF_CORE_MAX];
-
-	/* per core array of all chunks */
-	struct acp_chunk_info *chunk_info[OCF_CORE_MAX];
+	/* array of all chunks */
+	struct acp_chunk_info *chunk_info;
 
 	struct acp_bucket bucket_info[ACP_MAX_BUCKETS];
 
+	/* cleaning state persistent over subsequent calls to
+	 perform_cleaning */
+	struct acp_state state;
+};
+
+struct acp_context {
+	env_rwsem chunks_lock;
+
+	/* per core streams */
+	struct acp_stream *stream[OCF_CORE_MAX];
+
 	/* total number of chunks in cache */
 	uint64_t chunks_total;
 
-	/* structure to keep track of I/O in progress */
+	/* cache lines collected in current cleaning cycle */
 	struct acp_flush_context flush;
 
-	/* cleaning state persistent over subsequent calls to
-	 perform_cleaning */
-	struct acp_state state;
+	/* stream to start next cleaning cycle from */
+	ocf_core_id_t next_core;
 
 	/* cache handle */
 	ocf_cache_t cache;
-
-	/* cleaner completion callback */
-	ocf_cleaner_end_t cmpl;
-
-#if 1 == OCF_ACP_DEBUG
-	/* debug only */
-	uint64_t checksum;
-#endif
 };
 
 struct acp_core_line_info
@@ -180,7 +174,7 @@ static struct acp_chunk_info *_acp_get_chunk(struct ocf_cache *cache,
 
 	chunk_id = core_line.core_line * ocf_line_size(cache) / ACP_CHUNK_SIZE;
 
-	return &acp->chunk_info[core_line.core_id][chunk_id];
+	return &acp->stream[core_line.core_id]->chunk_info[chunk_id];
 }
 
 static void _acp_remove_cores(struct ocf_cache *cache)
@@ -219,6 +213,7 @@ void cleaning_policy_acp_init_cache_block(struct ocf_cache *cache,
 
 	acp_meta = _acp_meta_get(cache, cache_line);
 	acp_meta->dirty = 0;
+	acp_meta->rewrites = 0;
 }
 
 void cleaning_policy_acp_deinitialize(struct ocf_cache *cache)
@@ -274,15 +269,15 @@ int cleaning_policy_acp_initialize(struct ocf_cache *cache,
 		int init_metadata)
 {
 	struct acp_context *acp;
-	int err, i;
+	int err;
 
 	/* bug if max chunk number would overflow dirty_no array type */
 #if defined (BUILD_BUG_ON)
 	BUILD_BUG_ON(ACP_CHUNK_SIZE / ocf_cache_line_size_min >=
-			1U << (sizeof(acp->chunk_info[0][0].num_dirty) * 8));
+			1U << (sizeof(acp->stream[0]->chunk_info[0].num_dirty) * 8));
 #else
 	ENV_BUG_ON(ACP_CHUNK_SIZE / ocf_cache_line_size_min >=
-			1U << (sizeof(acp->chunk_info[0][0].num_dirty) * 8));
+			1U << (sizeof(acp->stream[0]->chunk_info[0].num_dirty) * 8));
 #endif
 
 	ENV_BUG_ON(cache->cleaner.cleaning_policy_context);
@@ -302,13 +297,6 @@ int cleaning_policy_acp_initialize(struct ocf_cache *cache,
 	cache->cleaner.cleaning_policy_context = acp;
 	acp->cache = cache;
 
-	for (i = 0; i < ACP_MAX_BUCKETS; i++) {
-		INIT_LIST_HEAD(&acp->bucket_info[i].chunk_list);
-		acp->bucket_info[i].threshold =
-			((ACP_CHUNK_SIZE/ocf_line_size(cache)) *
-			 ACP_BUCKET_DEFAULTS[i]) / 100;
-	}
-
 	if (cache->conf_meta->core_count > 0) {
 		err = _acp_load_cores(cache);
 		if (err) {
@@ -395,11 +383,24 @@ static ocf_cache_line_t _acp_trylock_dirty(struct ocf_cache *cache,
 	ocf_engine_lookup_map_entry(cache, &info, core_id,
 			core_line);
 
+	/* Lines held by cleaning stream I/O in flight are skipped, as read
+	 * lock alone would not keep them from being flushed twice */
 	if (info.status == LOOKUP_HIT &&
 			metadata_test_dirty(cache, info.coll_idx)) {
-		locked = ocf_cache_line_try_lock_rd(
+		locked = !ocf_cache_line_is_used(
+				ocf_cache_line_concurrency(cache),
+				info.coll_idx) &&
+			ocf_cache_line_try_lock_rd(
 				ocf_cache_line_concurrency(cache),
 				info.coll_idx);
+		if (!locked && ocf_cleaning_stream_holds(cache, core_id,
+				info.coll_idx)) {
+			ocf_core_stats_cleaner_inflight_skip_update(
+					&cache->core[core_id]);
+		} else if (!locked) {
+			ocf_core_stats_cleaner_lock_abort_update(
+					&cache->core[core_id]);
+		}
 	}
 
 	ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock, lock_idx, core_id,
@@ -408,49 +409,53 @@ static ocf_cache_line_t _acp_trylock_dirty(struct ocf_cache *cache,
 	return locked ? info.coll_idx : cache->device->collision_table_entries;
 }
 
-static void _acp_handle_flush_error(struct ocf_cache *cache,
-		struct acp_context *acp)
+/* called on stream I/O error - batch of a stream always comes from single
+ * chunk, which is left alone for a while */
+static void _acp_flush_error(ocf_cache_t cache, struct flush_data *flush,
+		uint32_t count, int error)
 {
-	struct acp_flush_context *flush = &acp->flush;
+	struct acp_context *acp = _acp_get_ctx_from_cache(cache);
+	struct acp_stream *stream = acp->stream[flush[0].core_id];
+	size_t lines_per_chunk = ACP_CHUNK_SIZE / ocf_line_size(cache);
+	struct acp_chunk_info *chunk;
 
-	flush->chunk->next_cleaning_timestamp = env_get_tick_count() +
+	chunk = &stream->chunk_info[flush[0].core_line / lines_per_chunk];
+
+	chunk->next_cleaning_timestamp = env_get_tick_count() +
 			env_secs_to_ticks(ACP_CHUNK_CLEANING_BACKOFF_TIME);
 
 	if (ocf_cache_log_rl(cache)) {
-		ocf_core_log(&cache->core[flush->chunk->core_id],
+		ocf_core_log(&cache->core[chunk->core_id],
 				log_err, "Cleaning error (%d) in range"
 				" <%llu; %llu) backing off for %u seconds\n",
-				flush->error,
-				flush->chunk->chunk_id * ACP_CHUNK_SIZE,
-				(flush->chunk->chunk_id * ACP_CHUNK_SIZE) +
+				error, chunk->chunk_id * ACP_CHUNK_SIZE,
+				(chunk->chunk_id * ACP_CHUNK_SIZE) +
 						ACP_CHUNK_SIZE,
 				ACP_CHUNK_CLEANING_BACKOFF_TIME);
 	}
 }
 
-static inline bool _acp_can_clean_chunk(struct ocf_cache *cache,
-		struct acp_chunk_info *chunk)
+static inline bool _acp_can_clean_chunk(struct acp_chunk_info *chunk)
 {
-	/* Check if core device is opened and if timeout after cleaning error
-	 * expired or wasn't set in the first place */
-	return (cache->core[chunk->core_id].opened &&
-			(chunk->next_cleaning_timestamp > env_get_tick_count() ||
-					!chunk->next_cleaning_timestamp));
+	/* Check if timeout after cleaning error expired or wasn't set in
+	 * the first place */
+	return chunk->next_cleaning_timestamp <= env_get_tick_count();
 }
 
-static struct acp_chunk_info *_acp_get_cleaning_candidate(ocf_cache_t cache)
+static struct acp_chunk_info *_acp_get_cleaning_candidate(
+		struct acp_context *acp, struct acp_stream *stream)
 {
-	int i;
 	struct acp_chunk_info *cur;
-	struct acp_context *acp = cache->cleaner.cleaning_policy_context;
+	int i;
 
 	ACP_LOCK_CHUNKS_RD();
 
 	/* go through all buckets in descending order, excluding bucket 0 which
 	 * is supposed to contain all clean chunks */
 	for (i = ACP_MAX_BUCKETS - 1; i > 0; i--) {
-		list_for_each_entry(cur, &acp->bucket_info[i].chunk_list, list) {
-			if (_acp_can_clean_chunk(cache, cur)) {
+		list_for_each_entry(cur, &stream->bucket_info[i].chunk_list,
+				list) {
+			if (_acp_can_clean_chunk(cur)) {
 				ACP_UNLOCK_CHUNKS_RD();
 				return cur;
 			}
@@ -461,56 +466,20 @@ static struct acp_chunk_info *_acp_get_cleaning_candidate(ocf_cache_t cache)
 	return NULL;
 }
 
-/* called after flush request completed */
-static void _acp_flush_end(void *priv, int error)
+static void _acp_rotate_chunk(struct acp_context *acp,
+		struct acp_stream *stream, struct acp_chunk_info *chunk)
 {
-	struct acp_cleaning_policy_config *config;
-	struct acp_context *acp = priv;
-	struct acp_flush_context *flush = &acp->flush;
-	ocf_cache_t cache = acp->cache;
-	int i;
-
-	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_acp].data;
-
-	for (i = 0; i < flush->size; i++) {
-		ocf_cache_line_unlock_rd(
-				ocf_cache_line_concurrency(cache),
-				flush->data[i].cache_line);
-		ACP_DEBUG_END(acp, flush->data[i].cache_line);
-	}
-
-	if (error) {
-		flush->error = error;
-		_acp_handle_flush_error(cache, acp);
-	}
-
-	ACP_DEBUG_CHECK(acp);
-
-	acp->cmpl(&cache->cleaner, config->thread_wakeup_time);
-}
-
-/* flush data  */
-static void _acp_flush(struct acp_context *acp)
-{
-	ocf_cache_t cache = acp->cache;
-	struct ocf_cleaner_attribs attribs = {
-		.cmpl_context = acp,
-		.cmpl_fn = _acp_flush_end,
-		.lock_cacheline = false,
-		.lock_metadata = true,
-		.do_sort = false,
-		.io_queue = cache->cleaner.io_queue,
-	};
-
-	ocf_cleaner_do_flush_data_async(cache, acp->flush.data,
-				acp->flush.size, &attribs);
+	ACP_LOCK_CHUNKS_WR();
+	list_move_tail(&chunk->list,
+			&stream->bucket_info[chunk->bucket_id].chunk_list);
+	ACP_UNLOCK_CHUNKS_WR();
 }
 
 static bool _acp_prepare_flush_data(struct acp_context *acp,
-		uint32_t flush_max_buffers)
+		struct acp_stream *stream, uint32_t flush_max_buffers)
 {
 	ocf_cache_t cache = acp->cache;
-	struct acp_state *state = &acp->state;
+	struct acp_state *state = &stream->state;
 	struct acp_chunk_info *chunk = state->chunk;
 	size_t lines_per_chunk = ACP_CHUNK_SIZE / ocf_line_size(cache);
 	uint64_t first_core_line = chunk->chunk_id * lines_per_chunk;
@@ -520,7 +489,6 @@ static bool _acp_prepare_flush_data(struct acp_context *acp,
 			chunk->chunk_id, first_core_line);
 
 	acp->flush.size = 0;
-	acp->flush.chunk = chunk;
 	for (; state->iter < lines_per_chunk &&
 			acp->flush.size < flush_max_buffers; state->iter++) {
 		uint64_t core_line = first_core_line + state->iter;
@@ -530,7 +498,22 @@ static bool _acp_prepare_flush_data(struct acp_context *acp,
 		if (cache_line == cache->device->collision_table_entries)
 			continue;
 
-		ACP_DEBUG_BEGIN(acp, cache_line);
+		if (ocf_cleaning_absorb_defer(cache,
+				&_acp_meta_get(cache, cache_line)->rewrites)) {
+			ocf_cache_line_unlock_rd(
+					ocf_cache_line_concurrency(cache),
+					cache_line);
+			state->deferred = true;
+			continue;
+		}
+
+		/* stream got saturated - resume from this line later */
+		if (!ocf_cleaning_stream_reserve(cache, chunk->core_id)) {
+			ocf_cache_line_unlock_rd(
+					ocf_cache_line_concurrency(cache),
+					cache_line);
+			break;
+		}
 
 		acp->flush.data[acp->flush.size].core_id = chunk->core_id;
 		acp->flush.data[acp->flush.size].core_line = core_line;
@@ -541,51 +524,103 @@ static bool _acp_prepare_flush_data(struct acp_context *acp,
 	if (state->iter == lines_per_chunk) {
 		/* reached end of chunk - reset state */
 		state->in_progress = false;
+
+		/* hot lines keep chunk in its bucket - let other chunks
+		 * of the bucket go first next time */
+		if (state->deferred)
+			_acp_rotate_chunk(acp, stream, chunk);
 	}
 
 	return (acp->flush.size > 0);
 }
 
 /* Clean at most 'flush_max_buffers' cache lines from current or newly
- * selected chunk */
-void cleaning_policy_acp_perform_cleaning(ocf_cache_t cache,
-		ocf_cleaner_end_t cmpl)
+ * selected chunk of the core */
+static uint32_t _acp_clean_stream(struct acp_context *acp,
+		ocf_core_id_t core_id, uint32_t flush_max_buffers)
 {
-	struct acp_cleaning_policy_config *config;
-	struct acp_context *acp = _acp_get_ctx_from_cache(cache);
-	struct acp_state *state = &acp->state;
+	ocf_cache_t cache = acp->cache;
+	struct acp_stream *stream = acp->stream[core_id];
+	struct acp_state *state = &stream->state;
 
-	acp->cmpl = cmpl;
+	if (!ocf_cleaning_stream_ready(cache, core_id))
+		return 0;
+
+	/* cleaning of current chunk failed - pick another one */
+	if (state->in_progress && !_acp_can_clean_chunk(state->chunk))
+		state->in_progress = false;
 
 	if (!state->in_progress) {
 		/* get next chunk to clean */
-		state->chunk = _acp_get_cleaning_candidate(cache);
+		state->chunk = _acp_get_cleaning_candidate(acp, stream);
 
 		if (!state->chunk) {
 			/* nothing co clean */
-			cmpl(&cache->cleaner, ACP_BACKOFF_TIME_MS);
-			return;
+			return 0;
 		}
 
 		/* new cleaning cycle - reset state */
 		state->iter = 0;
 		state->in_progress = true;
+		state->deferred = false;
 	}
 
-	ACP_DEBUG_INIT(acp);
+	if (!_acp_prepare_flush_data(acp, stream, flush_max_buffers))
+		return 0;
+
+	ocf_cleaning_stream_submit(cache, acp->flush.data, acp->flush.size,
+			true, _acp_flush_error);
+
+	return acp->flush.size;
+}
+
+/* Clean chunks of every core in its own stream, each stream gets at most
+ * 'flush_max_buffers' cache lines */
+void cleaning_policy_acp_perform_cleaning(ocf_cache_t cache,
+		ocf_cleaner_end_t cmpl)
+{
+	struct acp_cleaning_policy_config *config;
+	struct acp_context *acp = _acp_get_ctx_from_cache(cache);
+	uint32_t budget, flushed, total = 0;
+	ocf_core_id_t core_id;
+	unsigned i;
 
 	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_acp].data;
 
-	if (_acp_prepare_flush_data(acp, config->flush_max_buffers))
-		_acp_flush(acp);
-	else
-		_acp_flush_end(acp, 0);
+	budget = ocf_cleaning_governor_budget(cache, UINT32_MAX);
+	if (!budget) {
+		/* Cleaning budget used up - governor sets sleep time */
+		cmpl(&cache->cleaner, 0);
+		return;
+	}
+
+	for (i = 0; i < OCF_CORE_MAX; i++) {
+		core_id = (acp->next_core + i) % OCF_CORE_MAX;
+		if (!acp->stream[core_id])
+			continue;
+
+		if (total >= budget) {
+			/* Governor budget used up - start from this stream
+			 * next time, so that budget is shared fairly */
+			acp->next_core = core_id;
+			break;
+		}
+
+		flushed = _acp_clean_stream(acp, core_id, OCF_MIN(budget - total,
+				config->flush_max_buffers));
+		ocf_cleaning_governor_charge(cache, flushed);
+		total += flushed;
+	}
+
+	cmpl(&cache->cleaner, total ? config->thread_wakeup_time :
+			ACP_BACKOFF_TIME_MS);
 }
 
 static void _acp_update_bucket(struct acp_context *acp,
 		struct acp_chunk_info *chunk)
 {
-	struct acp_bucket *bucket = &acp->bucket_info[chunk->bucket_id];
+	struct acp_bucket *bucket =
+			&acp->stream[chunk->core_id]->bucket_info[chunk->bucket_id];
 
 	if (chunk->num_dirty > bucket->threshold) {
 		ENV_BUG_ON(chunk->bucket_id == ACP_MAX_BUCKETS - 1);
@@ -624,6 +659,8 @@ void cleaning_policy_acp_set_hot_cache_line(struct ocf_cache *cache,
 		chunk->num_dirty++;
 	}
 
+	ocf_cleaning_count_rewrite(&acp_meta->rewrites);
+
 	_acp_update_bucket(acp, chunk);
 
 	ACP_UNLOCK_CHUNKS_WR();
@@ -646,6 +683,9 @@ void cleaning_policy_acp_purge_block(struct ocf_cache *cache,
 		chunk->num_dirty--;
 	}
 
+	/* Rewrites of clean cache line start counting anew */
+	acp_meta->rewrites = 0;
+
 	_acp_update_bucket(acp, chunk);
 
 	ACP_UNLOCK_CHUNKS_WR();
@@ -663,29 +703,22 @@ void cleaning_policy_acp_remove_core(ocf_cache_t cache,
 		ocf_core_id_t core_id)
 {
 	struct acp_context *acp  = _acp_get_ctx_from_cache(cache);
-	uint64_t i;
+	struct acp_stream *stream = acp->stream[core_id];
 
-	ENV_BUG_ON(acp->chunks_total < acp->num_chunks[core_id]);
-	ENV_BUG_ON(!acp->chunk_info[core_id]);
-
-	if (acp->state.in_progress && acp->state.chunk->core_id == core_id) {
-		acp->state.in_progress = false;
-		acp->state.iter = 0;
-		acp->state.chunk = NULL;
-	}
+	ENV_BUG_ON(!stream);
+	ENV_BUG_ON(acp->chunks_total < stream->num_chunks);
 
 	ACP_LOCK_CHUNKS_WR();
 
-	for (i = 0; i < acp->num_chunks[core_id]; i++)
-		list_del(&acp->chunk_info[core_id][i].list);
-
-	acp->chunks_total -= acp->num_chunks[core_id];
-	acp->num_chunks[core_id] = 0;
-
-	env_vfree(acp->chunk_info[core_id]);
-	acp->chunk_info[core_id] = NULL;
+	/* chunks are freed along with the stream, so there is no need to
+	 * unlink them from buckets */
+	acp->chunks_total -= stream->num_chunks;
+	acp->stream[core_id] = NULL;
 
 	ACP_UNLOCK_CHUNKS_WR();
+
+	env_vfree(stream->chunk_info);
+	env_vfree(stream);
 }
 
 int cleaning_policy_acp_add_core(ocf_cache_t cache,
@@ -695,38 +728,54 @@ int cleaning_policy_acp_add_core(ocf_cache_t cache,
 	uint64_t core_size = core->conf_meta->length;
 	uint64_t num_chunks = OCF_DIV_ROUND_UP(core_size, ACP_CHUNK_SIZE);
 	struct acp_context *acp = _acp_get_ctx_from_cache(cache);
+	struct acp_stream *stream;
 	int i;
 
 	OCF_DEBUG_PARAM(cache, "%s core_id %llu num_chunks %llu\n",
 			__func__, (uint64_t)core_id, (uint64_t) num_chunks);
 
-	ACP_LOCK_CHUNKS_WR();
+	ENV_BUG_ON(acp->stream[core_id]);
 
-	ENV_BUG_ON(acp->chunk_info[core_id]);
+	stream = env_vzalloc(sizeof(*stream));
+	if (!stream) {
+		OCF_DEBUG_PARAM(cache, "failed to allocate acp stream\n");
+		return -OCF_ERR_NO_MEM;
+	}
 
-	acp->chunk_info[core_id] =
-			env_vzalloc(num_chunks * sizeof(acp->chunk_info[0][0]));
+	stream->chunk_info =
+			env_vzalloc(num_chunks * sizeof(stream->chunk_info[0]));
 
-	if (!acp->chunk_info[core_id]) {
-		ACP_UNLOCK_CHUNKS_WR();
+	if (!stream->chunk_info) {
+		env_vfree(stream);
 		OCF_DEBUG_PARAM(cache, "failed to allocate acp tables\n");
 		return -OCF_ERR_NO_MEM;
 	}
 
 	OCF_DEBUG_PARAM(cache, "successfully allocated acp tables\n");
 
-	/* increment counters */
-	acp->num_chunks[core_id] = num_chunks;
-	acp->chunks_total += num_chunks;
+	stream->num_chunks = num_chunks;
 
-	for (i = 0; i < acp->num_chunks[core_id]; i++) {
+	for (i = 0; i < ACP_MAX_BUCKETS; i++) {
+		INIT_LIST_HEAD(&stream->bucket_info[i].chunk_list);
+		stream->bucket_info[i].threshold =
+			((ACP_CHUNK_SIZE/ocf_line_size(cache)) *
+			 ACP_BUCKET_DEFAULTS[i]) / 100;
+	}
+
+	for (i = 0; i < stream->num_chunks; i++) {
 		/* fill in chunk metadata and add to the clean bucket */
-		acp->chunk_info[core_id][i].core_id = core_id;
-		acp->chunk_info[core_id][i].chunk_id = i;
-		list_add(&acp->chunk_info[core_id][i].list,
-				&acp->bucket_info[0].chunk_list);
+		stream->chunk_info[i].core_id = core_id;
+		stream->chunk_info[i].chunk_id = i;
+		list_add(&stream->chunk_info[i].list,
+				&stream->bucket_info[0].chunk_list);
 	}
 
+	ACP_LOCK_CHUNKS_WR();
+
+	/* increment counters */
+	acp->stream[core_id] = stream;
+	acp->chunks_total += num_chunks;
+
 	ACP_UNLOCK_CHUNKS_WR();
 
 	return 0;
@@ -10,6 +10,8 @@
 /* TODO: remove acp metadata */
 struct acp_cleaning_policy_meta {
 	uint8_t dirty : 1;
+	/* Saturating counter of writes to the cache line */
+	uint8_t rewrites;
 };
 
 /* cleaning policy per partition metadata */
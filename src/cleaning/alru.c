@@ -14,6 +14,8 @@
 #include "../concurrency/ocf_cache_line_concurrency.h"
 #include "../ocf_def_priv.h"
 #include "cleaning_priv.h"
+#include "cleaning_governor.h"
+#include "cleaning_stream.h"
 
 #define is_alru_head(x) (x == collision_table_entries)
 #define is_alru_tail(x) (x == collision_table_entries)
@@ -44,7 +46,6 @@
 #endif
 
 struct alru_flush_ctx {
-	struct ocf_cleaner_attribs attribs;
 	bool flush_perfomed;
 	uint32_t clines_no;
 	ocf_cache_t cache;
@@ -256,6 +257,7 @@ void cleaning_policy_alru_init_cache_block(struct ocf_cache *cache,
 	alru = &ocf_metadata_get_cleaning_policy(cache,
 			cache_line)->meta.alru;
 	alru->timestamp = 0;
+	alru->rewrites = 0;
 	alru->lru_prev = cache->device->collision_table_entries;
 	alru->lru_next = cache->device->collision_table_entries;
 }
@@ -266,9 +268,13 @@ void cleaning_policy_alru_purge_cache_block(struct ocf_cache *cache,
 	struct alru_context *alru = cache->cleaner.cleaning_policy_context;
 	ocf_part_id_t part_id = ocf_metadata_get_partition_id(cache,
 			cache_line);
+	struct alru_cleaning_policy_meta *meta = &ocf_metadata_get_cleaning_policy(
+			cache, cache_line)->meta.alru;
 
 	env_spinlock_lock(&alru->list_lock[part_id]);
 	remove_alru_list(cache, part_id, cache_line);
+	/* Rewrites of clean cache line start counting anew */
+	meta->rewrites = 0;
 	env_spinlock_unlock(&alru->list_lock[part_id]);
 }
 
@@ -276,6 +282,8 @@ static void __cleaning_policy_alru_purge_cache_block_any(
 		struct ocf_cache *cache, uint32_t cache_line)
 {
 	struct alru_context *ctx = cache->cleaner.cleaning_policy_context;
+	struct alru_cleaning_policy_meta *meta = &ocf_metadata_get_cleaning_policy(
+			cache, cache_line)->meta.alru;
 
 	ocf_part_id_t part_id = ocf_metadata_get_partition_id(cache,
 			cache_line);
@@ -284,6 +292,7 @@ static void __cleaning_policy_alru_purge_cache_block_any(
 
 	if (is_on_alru_list(cache, part_id, cache_line))
 		remove_alru_list(cache, part_id, cache_line);
+	meta->rewrites = 0;
 
 	env_spinlock_unlock(&ctx->list_lock[part_id]);
 }
@@ -335,6 +344,7 @@ void cleaning_policy_alru_set_hot_cache_line(struct ocf_cache *cache,
 		remove_alru_list(cache, part_id, cache_line);
 
 	add_alru_head(cache, part_id, cache_line);
+	ocf_cleaning_count_rewrite(&alru->rewrites);
 
 	env_spinlock_unlock(&ctx->list_lock[part_id]);
 }
@@ -587,7 +597,9 @@ static bool is_cleanup_possible(ocf_cache_t cache)
 
 	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_alru].data;
 
-	if (check_for_io_activity(cache, config)) {
+	/* Governor throttles cleaning instead of waiting for idle cache */
+	if (!ocf_cleaning_governor_active(cache) &&
+			check_for_io_activity(cache, config)) {
 		OCF_DEBUG_PARAM(cache, "IO activity detected");
 		return false;
 	}
@@ -649,12 +661,20 @@ static bool block_is_busy(struct ocf_cache *cache,
 	if (!cache->core[core_id].opened)
 		return true;
 
-	if (ocf_cache_line_is_used(ocf_cache_line_concurrency(cache),
+	if (!ocf_cache_line_is_used(ocf_cache_line_concurrency(cache),
 			cache_line)) {
-		return true;
+		return false;
 	}
 
-	return false;
+	if (ocf_cleaning_stream_holds(cache, core_id, cache_line)) {
+		ocf_core_stats_cleaner_inflight_skip_update(
+				&cache->core[core_id]);
+	} else {
+		ocf_core_stats_cleaner_lock_abort_update(
+				&cache->core[core_id]);
+	}
+
+	return true;
 }
 
 static int get_data_to_flush(struct alru_context *ctx)
@@ -666,6 +686,7 @@ static int get_data_to_flush(struct alru_context *ctx)
 	ocf_cache_line_t cache_line;
 	struct ocf_user_part *user_part;
 	uint32_t last_access;
+	uint32_t now = env_ticks_to_secs(env_get_tick_count());
 	int to_flush = 0;
 	int part_id = OCF_IO_CLASS_ID_MAX;
 
@@ -692,14 +713,24 @@ static int get_data_to_flush(struct alru_context *ctx)
 				goto end;
 			}
 
-			if (!block_is_busy(cache, cache_line)) {
+			alru = &ocf_metadata_get_cleaning_policy(cache,
+					cache_line)->meta.alru;
+
+			if (!block_is_busy(cache, cache_line) &&
+					!ocf_cleaning_absorb_defer(cache,
+						&alru->rewrites)) {
 				get_block_to_flush(&fctx->flush_data[to_flush], cache_line,
 						cache);
-				to_flush++;
+				if (ocf_cleaning_stream_reserve(cache,
+						fctx->flush_data[to_flush].core_id)) {
+					ocf_core_stats_cleaner_dirty_age_update(
+						&cache->core[fctx->flush_data[
+							to_flush].core_id],
+						now - alru->timestamp);
+					to_flush++;
+				}
 			}
 
-			alru = &ocf_metadata_get_cleaning_policy(cache,
-					cache_line)->meta.alru;
 			cache_line = alru->lru_prev;
 		}
 
@@ -754,16 +785,18 @@ static void alru_clean(struct alru_context *ctx)
 
 	to_clean = get_data_to_flush(ctx);
 	if (to_clean > 0) {
+		ocf_cleaning_governor_charge(cache, to_clean);
 		fctx->flush_perfomed = true;
-		ocf_cleaner_do_flush_data_async(cache, fctx->flush_data, to_clean,
-				&fctx->attribs);
-		ocf_metadata_end_exclusive_access(&cache->metadata.lock);
-		return;
+		ocf_cleaning_stream_submit(cache, fctx->flush_data, to_clean,
+				false, NULL);
+		goto end;
 	}
 
 	/* Update timestamp only if there are no items to be cleaned */
-	cache->device->runtime_meta->cleaning_thread_access =
-		env_ticks_to_secs(env_get_tick_count());
+	if (!cache->cleaner.streams.deferred) {
+		cache->device->runtime_meta->cleaning_thread_access =
+			env_ticks_to_secs(env_get_tick_count());
+	}
 
 end:
 	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
@@ -778,16 +811,16 @@ void cleaning_alru_perform_cleaning(ocf_cache_t cache, ocf_cleaner_end_t cmpl)
 
 	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_alru].data;
 
-	OCF_REALLOC_INIT(&fctx->flush_data, &fctx->flush_data_limit);
+	fctx->clines_no = ocf_cleaning_governor_budget(cache,
+			config->flush_max_buffers);
+	if (config->flush_max_buffers && !fctx->clines_no) {
+		/* Cleaning budget used up - governor sets sleep time */
+		cmpl(&cache->cleaner, 0);
+		return;
+	}
 
-	fctx->attribs.cmpl_context = fctx;
-	fctx->attribs.cmpl_fn = alru_clean_complete;
-	fctx->attribs.lock_cacheline = true;
-	fctx->attribs.lock_metadata = false;
-	fctx->attribs.do_sort = true;
-	fctx->attribs.io_queue = cache->cleaner.io_queue;
+	OCF_REALLOC_INIT(&fctx->flush_data, &fctx->flush_data_limit);
 
-	fctx->clines_no = config->flush_max_buffers;
 	fctx->cache = cache;
 	fctx->cmpl = cmpl;
 	fctx->flush_perfomed = false;
@@ -11,6 +11,8 @@
 struct alru_cleaning_policy_meta {
 	/* Lru pointers 2*4=8 bytes */
 	uint32_t timestamp;
+	/* Saturating counter of writes to the cache line */
+	uint8_t rewrites;
 	uint32_t lru_prev;
 	uint32_t lru_next;
 } __attribute__((packed));
@@ -13,7 +13,11 @@
 #include "../mngt/ocf_mngt_common.h"
 #include "../metadata/metadata.h"
 #include "../ocf_queue_priv.h"
+#include "../ocf_lru.h"
+#include "../concurrency/ocf_concurrency.h"
 #include "cleaning_ops.h"
+#include "cleaning_governor.h"
+#include "cleaning_stream.h"
 
 int ocf_start_cleaner(ocf_cache_t cache)
 {
@@ -74,11 +78,37 @@ static void ocf_cleaner_run_complete(ocf_cleaner_t cleaner, uint32_t interval)
 {
 	ocf_cache_t cache = ocf_cleaner_get_cache(cleaner);
 
+	interval = ocf_cleaning_governor_interval(cache, interval);
+
+	/* Retry soon lines left behind by saturated streams */
+	if (cache->cleaner.streams.deferred) {
+		interval = OCF_MIN(interval,
+				(uint32_t)CLEANING_STREAM_RETRY_MS);
+	}
+
+	if (cache->lru_deferred_balance) {
+		interval = OCF_MIN(interval,
+				(uint32_t)OCF_LRU_DEFERRED_BALANCE_INTERVAL_MS);
+	}
+
 	ocf_mngt_cache_unlock(cache);
 	ocf_queue_put(cleaner->io_queue);
 	cleaner->end(cleaner, interval);
 }
 
+static void ocf_cleaner_balance_lru(ocf_cache_t cache, ocf_queue_t queue)
+{
+	unsigned lock_idx;
+
+	if (!cache->lru_deferred_balance)
+		return;
+
+	lock_idx = ocf_metadata_concurrency_next_idx(queue);
+	ocf_metadata_start_shared_access(&cache->metadata.lock, lock_idx);
+	ocf_lru_balance_all(cache);
+	ocf_metadata_end_shared_access(&cache->metadata.lock, lock_idx);
+}
+
 void ocf_cleaner_run(ocf_cleaner_t cleaner, ocf_queue_t queue)
 {
 	ocf_cache_t cache;
@@ -112,5 +142,13 @@ void ocf_cleaner_run(ocf_cleaner_t cleaner, ocf_queue_t queue)
 	ocf_queue_get(queue);
 	cleaner->io_queue = queue;
 
+	ocf_cleaner_balance_lru(cache, queue);
+
+	ocf_cleaning_governor_update(cache);
+	ocf_cleaning_absorb_update(cache);
+	ocf_cleaning_streams_update(cache);
+
+	cache->cleaner.streams.deferred = false;
+
 	ocf_cleaning_perform_cleaning(cache, ocf_cleaner_run_complete);
 }
@@ -9,6 +9,7 @@
 #include "alru_structs.h"
 #include "nop_structs.h"
 #include "acp_structs.h"
+#include "elevator_structs.h"
 #include "ocf/ocf_cleaner.h"
 #include "../utils/utils_refcnt.h"
 
@@ -17,6 +18,10 @@
 
 #define SLEEP_TIME_MS (1000)
 
+/* Time to sleep when cache lines were left behind by a saturated cleaning
+ * stream, in ms */
+#define CLEANING_STREAM_RETRY_MS (10)
+
 struct ocf_request;
 
 struct cleaning_policy_config {
@@ -39,11 +44,86 @@ struct cleaning_policy_meta {
 	} meta;
 };
 
+struct ocf_cleaning_governor {
+	struct ocf_mngt_cleaning_governor_config config;
+	/* current cleaning rate in cache lines per second */
+	uint32_t rate;
+	/* accumulated budget in 1/1000 of cache line */
+	uint64_t tokens;
+	/* tick count of last budget refill */
+	uint64_t last_refill;
+};
+
+struct ocf_cleaning_absorb {
+	struct ocf_mngt_write_absorption_config config;
+	/* hot cache lines are left behind in current cleaning cycle */
+	bool active;
+};
+
+struct ocf_cleaning_stream_io;
+
+struct ocf_cleaning_stream {
+	/* cache lines in flight, including ones of completed I/O which were
+	 * not released from the ring yet */
+	env_atomic inflight;
+	/* cache lines collected in current cleaning cycle */
+	uint32_t reserved;
+	/* tick count until which stream backs off after cleaning error */
+	env_atomic64 backoff;
+	/* ring of preallocated I/O descriptors, I/O in slot i owns flush
+	 * data from slot i on */
+	struct ocf_cleaning_stream_io *io;
+	/* ring of flush data, one slot per cache line in flight */
+	struct flush_data *data;
+	/* number of slots in rings */
+	uint32_t capacity;
+	/* oldest slot in flight - slots are released in submission order */
+	uint32_t head;
+	/* first free slot */
+	uint32_t tail;
+	/* protects releasing slots on I/O completion */
+	env_spinlock lock;
+};
+
+struct ocf_cleaning_streams {
+	/* held by every stream I/O in flight */
+	struct ocf_refcnt refcnt __attribute__((aligned(64)));
+	/* max cache lines in flight per stream */
+	uint32_t depth;
+	/* some cache lines were left behind in current cleaning cycle
+	 * because their stream was saturated */
+	bool deferred;
+	/* one stream per core */
+	struct ocf_cleaning_stream stream[OCF_CORE_MAX];
+};
+
+/* Number of most recent discards cleaner checks cache lines against */
+#define CLEANING_DISCARD_HISTORY 32
+
+struct ocf_cleaning_discard {
+	/* epoch of discard stored in this slot, 0 while slot is updated */
+	env_atomic64 epoch;
+	ocf_core_id_t core_id;
+	/* range of core lines fully covered by discard */
+	uint64_t first_line;
+	uint64_t end_line;
+};
+
+struct ocf_cleaning_discards {
+	/* incremented on every discard */
+	env_atomic64 epoch;
+	struct ocf_cleaning_discard history[CLEANING_DISCARD_HISTORY];
+};
+
 struct ocf_cleaner {
 	struct ocf_refcnt refcnt __attribute__((aligned(64)));
 	void *cleaning_policy_context;
 	ocf_queue_t io_queue;
 	ocf_cleaner_end_t end;
+	struct ocf_cleaning_governor governor;
+	struct ocf_cleaning_streams streams;
+	struct ocf_cleaning_absorb absorb;
+	struct ocf_cleaning_discards discards;
 	void *priv;
 };
 
@@ -0,0 +1,90 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../utils/utils_cache_line.h"
+#include "cleaning.h"
+#include "cleaning_discard.h"
+
+/*
+ * Every discard bumps cache wide discard epoch and stores its range of
+ * fully covered core lines in a small ring. Cleaning request remembers the
+ * epoch at allocation time and, before core writes are submitted, checks
+ * its cache lines against discards registered since then. Cache line
+ * covered by such discard is neither written back nor marked clean, as the
+ * discard is going to invalidate it anyway.
+ *
+ * History is lockless. Slot being overwritten concurrently may yield
+ * a wrong answer, which only ever leaves cache line dirty until the next
+ * cleaning cycle or writes back data which is discarded a moment later.
+ */
+
+void ocf_cleaning_discards_init(ocf_cache_t cache)
+{
+	struct ocf_cleaning_discards *discards = &cache->cleaner.discards;
+	uint32_t i;
+
+	env_atomic64_set(&discards->epoch, 0);
+
+	for (i = 0; i < CLEANING_DISCARD_HISTORY; i++)
+		env_atomic64_set(&discards->history[i].epoch, 0);
+}
+
+void ocf_cleaning_discard_register(ocf_cache_t cache, ocf_core_id_t core_id,
+		uint64_t addr, uint64_t bytes)
+{
+	struct ocf_cleaning_discards *discards = &cache->cleaner.discards;
+	struct ocf_cleaning_discard *slot;
+	uint64_t first_line, end_line, epoch;
+
+	/* Partially discarded cache lines still hold valid data */
+	first_line = OCF_DIV_ROUND_UP(addr, ocf_line_size(cache));
+	end_line = (addr + bytes) / ocf_line_size(cache);
+	if (first_line >= end_line)
+		return;
+
+	epoch = env_atomic64_inc_return(&discards->epoch);
+	slot = &discards->history[epoch % CLEANING_DISCARD_HISTORY];
+
+	env_atomic64_set(&slot->epoch, 0);
+	slot->core_id = core_id;
+	slot->first_line = first_line;
+	slot->end_line = end_line;
+	env_atomic64_set(&slot->epoch, epoch);
+}
+
+bool ocf_cleaning_discarded(ocf_cache_t cache, uint64_t epoch,
+		ocf_core_id_t core_id, uint64_t core_line)
+{
+	struct ocf_cleaning_discards *discards = &cache->cleaner.discards;
+	struct ocf_cleaning_discard *slot;
+	uint64_t now = env_atomic64_read(&discards->epoch);
+	uint64_t i;
+	bool hit;
+
+	/* Older discards are no longer in history */
+	if (now - epoch > CLEANING_DISCARD_HISTORY)
+		epoch = now - CLEANING_DISCARD_HISTORY;
+
+	for (i = epoch + 1; i <= now; i++) {
+		slot = &discards->history[i % CLEANING_DISCARD_HISTORY];
+		if (env_atomic64_read(&slot->epoch) != i)
+			continue;
+
+		env_smp_rmb();
+
+		hit = slot->core_id == core_id &&
+				core_line >= slot->first_line &&
+				core_line < slot->end_line;
+
+		env_smp_rmb();
+
+		if (hit && env_atomic64_read(&slot->epoch) == i)
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CLEANING_DISCARD_H__
+#define __CLEANING_DISCARD_H__
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+
+static inline uint64_t ocf_cleaning_discard_epoch(ocf_cache_t cache)
+{
+	return env_atomic64_read(&cache->cleaner.discards.epoch);
+}
+
+/**
+ * @brief Reset discard history
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_discards_init(ocf_cache_t cache);
+
+/**
+ * @brief Record discard of core range, so that cleaning already in progress
+ *	does not write back cache lines fully covered by it
+ *
+ * @param cache Cache instance
+ * @param core_id Core id
+ * @param addr Discard start address (in bytes)
+ * @param bytes Discard length (in bytes)
+ */
+void ocf_cleaning_discard_register(ocf_cache_t cache, ocf_core_id_t core_id,
+		uint64_t addr, uint64_t bytes);
+
+/**
+ * @brief Check whether core line has been discarded since given epoch
+ *
+ * @note False negatives are allowed - the cache line is simply written back
+ *	then, as if no discard happened
+ *
+ * @param cache Cache instance
+ * @param epoch Discard epoch observed before cache line was collected
+ * @param core_id Core id
+ * @param core_line Core line
+ *
+ * @retval true cache line is to be invalidated by discard, writeback may
+ *	be skipped
+ * @retval false cache line is to be written back
+ */
+bool ocf_cleaning_discarded(ocf_cache_t cache, uint64_t epoch,
+		ocf_core_id_t core_id, uint64_t core_line);
+
+#endif /* __CLEANING_DISCARD_H__ */
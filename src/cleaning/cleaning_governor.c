@@ -0,0 +1,227 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_core_priv.h"
+#include "../utils/utils_user_part.h"
+#include "cleaning.h"
+#include "cleaning_governor.h"
+
+/*
+ * Cleaning governor keeps a token bucket filled at the current cleaning
+ * rate. Rate follows AIMD feedback on user I/O pressure - it is cut by
+ * a quarter when core read miss latency or number of requests in flight
+ * exceeds its target and grows by 1/16 of max rate otherwise. Below the
+ * dirty ratio band rate only grows while cache is idle, above the band
+ * it is pinned at max rate, as dirty data must not pile up any further.
+ */
+
+/* Budget units per cache line - cache lines per second times
+ * milliseconds */
+#define GOVERNOR_TOKENS_PER_LINE 1000
+
+/* Budget accumulated during longer sleep is capped, so that cleaner
+ * does not flush in bursts after idle period */
+#define GOVERNOR_BURST_MS 100
+
+static uint64_t _ocf_cleaning_governor_burst(struct ocf_cleaning_governor *gov)
+{
+	uint64_t lines = (uint64_t)gov->rate * GOVERNOR_BURST_MS / 1000;
+
+	return OCF_MAX(lines, 1ULL) * GOVERNOR_TOKENS_PER_LINE;
+}
+
+static void _ocf_cleaning_governor_refill(struct ocf_cleaning_governor *gov)
+{
+	uint64_t now = env_get_tick_count();
+	uint64_t elapsed_ns = env_ticks_to_nsecs(now - gov->last_refill);
+
+	gov->last_refill = now;
+
+	elapsed_ns = OCF_MIN(elapsed_ns, GOVERNOR_BURST_MS * 1000000ULL);
+
+	gov->tokens += gov->rate * elapsed_ns / 1000000;
+	gov->tokens = OCF_MIN(gov->tokens, _ocf_cleaning_governor_burst(gov));
+}
+
+uint32_t ocf_cleaning_dirty_ratio(ocf_cache_t cache)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+	ocf_core_t core;
+	ocf_core_id_t core_id;
+	uint64_t dirty, occupancy;
+	uint32_t ratio = 0;
+
+	for_each_user_part(cache, user_part, part_id) {
+		occupancy = env_atomic_read(&user_part->part.runtime->curr_size);
+		if (!occupancy)
+			continue;
+
+		dirty = 0;
+		for_each_core(cache, core, core_id) {
+			dirty += env_atomic_read(&core->runtime_meta->
+					part_counters[part_id].dirty_clines);
+		}
+
+		ratio = OCF_MAX(ratio, (uint32_t)OCF_MIN(100,
+				dirty * 100 / occupancy));
+	}
+
+	return ratio;
+}
+
+static bool _ocf_cleaning_governor_congested(ocf_cache_t cache,
+		uint32_t inflight)
+{
+	struct ocf_mngt_cleaning_governor_config *cfg =
+			&cache->cleaner.governor.config;
+	ocf_core_t core;
+	ocf_core_id_t core_id;
+
+	if (cfg->max_queue_depth && inflight > cfg->max_queue_depth)
+		return true;
+
+	if (!cfg->target_latency_us)
+		return false;
+
+	for_each_core(cache, core, core_id) {
+		if (!core->opened)
+			continue;
+
+		if (env_atomic_read(&core->miss_latency_us) >
+				cfg->target_latency_us) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ocf_cleaning_governor_init(ocf_cache_t cache)
+{
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+
+	gov->config.dirty_low = OCF_CLEANING_GOVERNOR_DEFAULT_DIRTY_LOW;
+	gov->config.dirty_high = OCF_CLEANING_GOVERNOR_DEFAULT_DIRTY_HIGH;
+	gov->config.target_latency_us =
+			OCF_CLEANING_GOVERNOR_DEFAULT_TARGET_LATENCY_US;
+	gov->config.max_queue_depth =
+			OCF_CLEANING_GOVERNOR_DEFAULT_MAX_QUEUE_DEPTH;
+	gov->config.min_rate = 0;
+	gov->config.max_rate = OCF_CLEANING_GOVERNOR_INACTIVE;
+
+	gov->rate = 0;
+	gov->tokens = 0;
+	gov->last_refill = env_get_tick_count();
+
+	cache->cleaner.absorb.config.rewrite_threshold =
+			OCF_CLEANING_ABSORB_DEFAULT_THRESHOLD;
+	cache->cleaner.absorb.config.dirty_high =
+			OCF_CLEANING_ABSORB_DEFAULT_DIRTY_HIGH;
+	cache->cleaner.absorb.active = false;
+}
+
+void ocf_cleaning_governor_update(ocf_cache_t cache)
+{
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+	struct ocf_mngt_cleaning_governor_config *cfg = &gov->config;
+	uint32_t inflight, dirty_ratio, step;
+	uint64_t rate = gov->rate;
+
+	if (!ocf_cleaning_governor_active(cache))
+		return;
+
+	/* Budget accumulated so far is granted at the previous rate */
+	_ocf_cleaning_governor_refill(gov);
+
+	/* Leave out cleaning streams, so that requests in flight are
+	 * (roughly) user I/O */
+	inflight = env_atomic_read(&cache->refcnt.metadata.counter);
+	inflight -= OCF_MIN(inflight, (uint32_t)env_atomic_read(
+			&cache->cleaner.streams.refcnt.counter));
+	dirty_ratio = ocf_cleaning_dirty_ratio(cache);
+	step = OCF_MAX(cfg->max_rate / 16, 1U);
+
+	if (dirty_ratio >= cfg->dirty_high)
+		rate = cfg->max_rate;
+	else if (_ocf_cleaning_governor_congested(cache, inflight))
+		rate -= rate / 4;
+	else if (dirty_ratio >= cfg->dirty_low || !inflight)
+		rate += step;
+	else
+		rate -= rate / 8;
+
+	gov->rate = OCF_MIN(OCF_MAX(rate, (uint64_t)cfg->min_rate),
+			(uint64_t)cfg->max_rate);
+}
+
+uint32_t ocf_cleaning_governor_budget(ocf_cache_t cache, uint32_t max_lines)
+{
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+
+	if (!ocf_cleaning_governor_active(cache))
+		return max_lines;
+
+	return OCF_MIN(gov->tokens / GOVERNOR_TOKENS_PER_LINE,
+			(uint64_t)max_lines);
+}
+
+void ocf_cleaning_governor_charge(ocf_cache_t cache, uint32_t lines)
+{
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+	uint64_t tokens = (uint64_t)lines * GOVERNOR_TOKENS_PER_LINE;
+
+	if (!ocf_cleaning_governor_active(cache))
+		return;
+
+	gov->tokens -= OCF_MIN(gov->tokens, tokens);
+}
+
+uint32_t ocf_cleaning_governor_interval(ocf_cache_t cache, uint32_t interval)
+{
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+	uint64_t burst, wait;
+
+	if (!ocf_cleaning_governor_active(cache))
+		return interval;
+
+	burst = _ocf_cleaning_governor_burst(gov);
+	if (gov->tokens >= burst)
+		return interval;
+
+	/* Rate is going to be raised on next run at the earliest */
+	if (!gov->rate)
+		return OCF_MAX(interval, (uint32_t)SLEEP_TIME_MS);
+
+	wait = OCF_DIV_ROUND_UP(burst - gov->tokens, gov->rate);
+
+	return OCF_MAX((uint64_t)interval, OCF_MIN(wait,
+			(uint64_t)SLEEP_TIME_MS));
+}
+
+void ocf_cleaning_absorb_update(ocf_cache_t cache)
+{
+	struct ocf_cleaning_absorb *absorb = &cache->cleaner.absorb;
+
+	absorb->active = absorb->config.rewrite_threshold &&
+			ocf_cleaning_dirty_ratio(cache) <
+			absorb->config.dirty_high;
+}
+
+bool ocf_cleaning_absorb_defer(ocf_cache_t cache, uint8_t *rewrites)
+{
+	struct ocf_cleaning_absorb *absorb = &cache->cleaner.absorb;
+
+	if (!absorb->active || *rewrites < absorb->config.rewrite_threshold)
+		return false;
+
+	/* Counter decays on every deferral, so that cache line which is
+	 * no longer rewritten gets cleaned eventually */
+	*rewrites >>= 1;
+
+	return true;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CLEANING_GOVERNOR_H__
+#define __CLEANING_GOVERNOR_H__
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+
+static inline bool ocf_cleaning_governor_active(ocf_cache_t cache)
+{
+	return cache->cleaner.governor.config.max_rate !=
+			OCF_CLEANING_GOVERNOR_INACTIVE;
+}
+
+static inline void ocf_cleaning_count_rewrite(uint8_t *rewrites)
+{
+	if (*rewrites < OCF_CLEANING_ABSORB_MAX_REWRITES)
+		(*rewrites)++;
+}
+
+/**
+ * @brief Set default governor parameters, governor is initially inactive
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_governor_init(ocf_cache_t cache);
+
+/**
+ * @brief Refill cleaning budget and adjust cleaning rate to current dirty
+ *	ratio, core latency and queue depth
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_governor_update(ocf_cache_t cache);
+
+/**
+ * @brief Get number of cache lines cleaner is allowed to flush now
+ *
+ * @param cache Cache instance
+ * @param max_lines Policy limit of single cleaning cycle
+ *
+ * @return max_lines if governor is inactive, cleaning budget limited by
+ *	max_lines otherwise
+ */
+uint32_t ocf_cleaning_governor_budget(ocf_cache_t cache, uint32_t max_lines);
+
+/**
+ * @brief Charge cleaning budget for cache lines submitted for flushing
+ *
+ * @param cache Cache instance
+ * @param lines Number of cache lines
+ */
+void ocf_cleaning_governor_charge(ocf_cache_t cache, uint32_t lines);
+
+/**
+ * @brief Stretch cleaner sleep time until next batch of budget is available
+ *
+ * @param cache Cache instance
+ * @param interval Sleep time (in ms) requested by cleaning policy
+ *
+ * @return Sleep time (in ms) of the cleaner
+ */
+uint32_t ocf_cleaning_governor_interval(ocf_cache_t cache, uint32_t interval);
+
+/**
+ * @brief Get dirty to occupied lines ratio of the most dirty io class
+ *
+ * @param cache Cache instance
+ *
+ * @return Dirty ratio in percent
+ */
+uint32_t ocf_cleaning_dirty_ratio(ocf_cache_t cache);
+
+/**
+ * @brief Decide whether hot cache lines are to be left behind in current
+ *	cleaning cycle, based on dirty ratio
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_absorb_update(ocf_cache_t cache);
+
+/**
+ * @brief Check whether cache line is rewritten often enough to leave it
+ *	dirty, so that further writes are absorbed by the cache
+ *
+ * @note Rewrite counter decays whenever cache line is left behind
+ *
+ * @param cache Cache instance
+ * @param rewrites Rewrite counter of cache line
+ *
+ * @retval true cache line is not to be cleaned now
+ * @retval false cache line is to be cleaned
+ */
+bool ocf_cleaning_absorb_defer(ocf_cache_t cache, uint8_t *rewrites);
+
+#endif /* __CLEANING_GOVERNOR_H__ */
@@ -6,6 +6,7 @@
 #include "alru.h"
 #include "nop.h"
 #include "acp.h"
+#include "elevator.h"
 #include "../metadata/metadata_superblock.h"
 #include "../metadata/metadata_structs.h"
 #include "../ocf_cache_priv.h"
@@ -64,6 +65,15 @@ static struct cleaning_policy_ops cleaning_policy_ops[ocf_cleaning_max] = {
 		.perform_cleaning = cleaning_policy_acp_perform_cleaning,
 		.name = "acp",
 	},
+	[ocf_cleaning_elevator] = {
+		.setup = cleaning_policy_elevator_setup,
+		.initialize = cleaning_policy_elevator_initialize,
+		.deinitialize = cleaning_policy_elevator_deinitialize,
+		.set_cleaning_param = cleaning_policy_elevator_set_cleaning_param,
+		.get_cleaning_param = cleaning_policy_elevator_get_cleaning_param,
+		.perform_cleaning = cleaning_policy_elevator_perform_cleaning,
+		.name = "elevator",
+	},
 };
 
 static inline void ocf_cleaning_setup(ocf_cache_t cache, ocf_cleaning_t policy)
@@ -0,0 +1,397 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_core_priv.h"
+#include "../ocf_queue_priv.h"
+#include "../concurrency/ocf_cache_line_concurrency.h"
+#include "cleaning.h"
+#include "cleaning_stream.h"
+
+/*
+ * Every core has its own cleaning stream. Cleaning policy collects cache
+ * lines within a cleaning cycle as before, reserving a slot in the stream
+ * of each line's core. Batch is then split by core and every part is fired
+ * on the I/O queue assigned to its core, without waiting for completion.
+ * Stream with as many lines in flight as its depth accepts no more lines,
+ * so a slow core only holds back writeback of its own dirty data, while
+ * streams of other cores keep going.
+ */
+
+/* Time to back off stream after cleaning error, in seconds */
+#define CLEANING_STREAM_BACKOFF_TIME 5
+
+struct ocf_cleaning_stream_io {
+	ocf_cache_t cache;
+	ocf_queue_t io_queue;
+	ocf_cleaning_stream_error_t error_fn;
+	ocf_core_id_t core_id;
+	bool locked;
+	/* I/O completed, its slots are to be released */
+	bool done;
+	uint32_t slot;
+	uint32_t count;
+};
+
+void ocf_cleaning_streams_init(ocf_cache_t cache)
+{
+	struct ocf_cleaning_streams *streams = &cache->cleaner.streams;
+
+	ocf_refcnt_init(&streams->refcnt);
+	ocf_refcnt_freeze(&streams->refcnt);
+
+	streams->depth = OCF_CLEANING_STREAM_DEFAULT_DEPTH;
+	streams->deferred = false;
+}
+
+static inline struct ocf_cleaning_stream *_ocf_cleaning_stream(
+		ocf_cache_t cache, ocf_core_id_t core_id)
+{
+	return &cache->cleaner.streams.stream[core_id];
+}
+
+static void _ocf_cleaning_stream_free(struct ocf_cleaning_stream *stream)
+{
+	env_vfree(stream->io);
+	env_vfree(stream->data);
+	stream->io = NULL;
+	stream->data = NULL;
+	stream->capacity = 0;
+}
+
+void ocf_cleaning_streams_deinit(ocf_cache_t cache)
+{
+	struct ocf_cleaning_stream *stream;
+	ocf_core_id_t core_id;
+
+	for (core_id = 0; core_id < OCF_CORE_MAX; core_id++) {
+		stream = _ocf_cleaning_stream(cache, core_id);
+		if (!stream->io)
+			continue;
+
+		_ocf_cleaning_stream_free(stream);
+		env_spinlock_destroy(&stream->lock);
+	}
+}
+
+static int _ocf_cleaning_stream_alloc(struct ocf_cleaning_stream *stream,
+		uint32_t capacity)
+{
+	struct ocf_cleaning_stream_io *io;
+	struct flush_data *data;
+
+	io = env_vzalloc(capacity * sizeof(*io));
+	if (!io)
+		return -OCF_ERR_NO_MEM;
+
+	data = env_vzalloc(capacity * sizeof(*data));
+	if (!data) {
+		env_vfree(io);
+		return -OCF_ERR_NO_MEM;
+	}
+
+	if (!stream->io && env_spinlock_init(&stream->lock)) {
+		env_vfree(data);
+		env_vfree(io);
+		return -OCF_ERR_NO_MEM;
+	}
+
+	_ocf_cleaning_stream_free(stream);
+
+	stream->io = io;
+	stream->data = data;
+	stream->capacity = capacity;
+	stream->head = 0;
+	stream->tail = 0;
+
+	return 0;
+}
+
+void ocf_cleaning_streams_update(ocf_cache_t cache)
+{
+	uint32_t depth = cache->cleaner.streams.depth;
+	struct ocf_cleaning_stream *stream;
+	ocf_core_t core;
+	ocf_core_id_t core_id;
+
+	for_each_core(cache, core, core_id) {
+		stream = _ocf_cleaning_stream(cache, core_id);
+
+		/* Ring can be replaced only when no I/O holds its slots */
+		if (stream->capacity == depth ||
+				env_atomic_read(&stream->inflight)) {
+			continue;
+		}
+
+		if (_ocf_cleaning_stream_alloc(stream, depth) &&
+				ocf_cache_log_rl(cache)) {
+			ocf_core_log(core, log_warn, "Cannot allocate cleaning "
+					"stream of %u cache lines\n", depth);
+		}
+	}
+}
+
+bool ocf_cleaning_stream_ready(ocf_cache_t cache, ocf_core_id_t core_id)
+{
+	struct ocf_cleaning_stream *stream = _ocf_cleaning_stream(cache, core_id);
+	uint32_t inflight = env_atomic_read(&stream->inflight);
+
+	if (!cache->core[core_id].opened)
+		return false;
+
+	if (env_atomic64_read(&stream->backoff) > env_get_tick_count())
+		return false;
+
+	/* Until ring is resized, stream depth is limited by ring capacity */
+	if (inflight + stream->reserved >= OCF_MIN(stream->capacity,
+			cache->cleaner.streams.depth)) {
+		cache->cleaner.streams.deferred = true;
+		return false;
+	}
+
+	return true;
+}
+
+bool ocf_cleaning_stream_reserve(ocf_cache_t cache, ocf_core_id_t core_id)
+{
+	if (!ocf_cleaning_stream_ready(cache, core_id))
+		return false;
+
+	_ocf_cleaning_stream(cache, core_id)->reserved++;
+
+	return true;
+}
+
+bool ocf_cleaning_stream_holds(ocf_cache_t cache, ocf_core_id_t core_id,
+		ocf_cache_line_t cache_line)
+{
+	struct ocf_cleaning_stream *stream = _ocf_cleaning_stream(cache, core_id);
+	bool found = false;
+	uint32_t slot;
+
+	if (!env_atomic_read(&stream->inflight))
+		return false;
+
+	env_spinlock_lock(&stream->lock);
+
+	for (slot = stream->head; slot != stream->tail && !found;
+			slot = (slot + 1) % stream->capacity) {
+		found = stream->data[slot].cache_line == cache_line;
+	}
+
+	env_spinlock_unlock(&stream->lock);
+
+	return found;
+}
+
+/* Cores are spread evenly over I/O queues, so that each stream is
+ * completed in the context of its own queue. Returns queue with reference
+ * taken. */
+static ocf_queue_t _ocf_cleaning_stream_queue_get(ocf_cache_t cache,
+		ocf_core_id_t core_id)
+{
+	ocf_queue_t queue, found = NULL;
+	unsigned long lock_flags = 0;
+	uint32_t count = 0, idx;
+
+	env_spinlock_lock_irqsave(&cache->io_queues_lock, lock_flags);
+
+	list_for_each_entry(queue, &cache->io_queues, list) {
+		if (queue != cache->mngt_queue)
+			count++;
+	}
+
+	idx = count ? core_id % count : 0;
+
+	list_for_each_entry(queue, &cache->io_queues, list) {
+		if (!count)
+			break;
+		if (queue == cache->mngt_queue)
+			continue;
+		if (!idx--) {
+			found = queue;
+			break;
+		}
+	}
+
+	/* Queue being destroyed has no references left */
+	if (found && !env_atomic_add_unless(&found->ref_count, 1, 0))
+		found = NULL;
+
+	env_spinlock_unlock_irqrestore(&cache->io_queues_lock, lock_flags);
+
+	if (!found) {
+		found = cache->cleaner.io_queue;
+		ocf_queue_get(found);
+	}
+
+	return found;
+}
+
+static void _ocf_cleaning_stream_unlock(ocf_cache_t cache,
+		struct flush_data *flush, uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		ocf_cache_line_unlock_rd(ocf_cache_line_concurrency(cache),
+				flush[i].cache_line);
+	}
+}
+
+/* Release slots of completed I/O in submission order, returns number of
+ * released slots */
+static uint32_t _ocf_cleaning_stream_release(
+		struct ocf_cleaning_stream *stream,
+		struct ocf_cleaning_stream_io *io)
+{
+	uint32_t released = 0;
+
+	env_spinlock_lock(&stream->lock);
+
+	io->done = true;
+
+	while (stream->io[stream->head].done) {
+		io = &stream->io[stream->head];
+		io->done = false;
+		released += io->count;
+		stream->head = (stream->head + io->count) % stream->capacity;
+	}
+
+	env_spinlock_unlock(&stream->lock);
+
+	return released;
+}
+
+static void _ocf_cleaning_stream_end(void *priv, int error)
+{
+	struct ocf_cleaning_stream_io *io = priv;
+	ocf_cache_t cache = io->cache;
+	ocf_queue_t io_queue = io->io_queue;
+	struct ocf_cleaning_stream *stream =
+			_ocf_cleaning_stream(cache, io->core_id);
+	struct flush_data *data = &stream->data[io->slot];
+
+	if (io->locked)
+		_ocf_cleaning_stream_unlock(cache, data, io->count);
+
+	/* Lines which failed to flush stay dirty and are retried after
+	 * the policy or the whole stream backs off */
+	if (error && io->error_fn) {
+		io->error_fn(cache, data, io->count, error);
+	} else if (error) {
+		env_atomic64_set(&stream->backoff, env_get_tick_count() +
+				env_secs_to_ticks(CLEANING_STREAM_BACKOFF_TIME));
+
+		if (ocf_cache_log_rl(cache)) {
+			ocf_core_log(&cache->core[io->core_id], log_err,
+					"Cleaning error (%d) of %u cache lines,"
+					" backing off for %u seconds\n", error,
+					io->count, CLEANING_STREAM_BACKOFF_TIME);
+		}
+	}
+
+	/* Descriptor may be reused as soon as its slots are released */
+	env_atomic_sub(_ocf_cleaning_stream_release(stream, io),
+			&stream->inflight);
+
+	ocf_queue_put(io_queue);
+
+	ocf_refcnt_dec(&cache->cleaner.streams.refcnt);
+}
+
+/* Copy flush data to contiguous slots of stream ring and fire I/O */
+static void _ocf_cleaning_stream_fire_slots(ocf_cache_t cache,
+		struct ocf_cleaning_stream *stream, struct flush_data *flush,
+		uint32_t count, bool locked,
+		ocf_cleaning_stream_error_t error_fn)
+{
+	struct ocf_cleaning_stream_io *io = &stream->io[stream->tail];
+	struct ocf_cleaner_attribs attribs = {
+		.lock_cacheline = !locked,
+		.lock_metadata = locked,
+		/* Flush data is sorted already */
+		.do_sort = false,
+		.cmpl_fn = _ocf_cleaning_stream_end,
+	};
+
+	io->cache = cache;
+	io->core_id = flush[0].core_id;
+	io->error_fn = error_fn;
+	io->locked = locked;
+	io->done = false;
+	io->slot = stream->tail;
+	io->count = count;
+	env_memcpy(&stream->data[io->slot], count * sizeof(stream->data[0]),
+			flush, count * sizeof(flush[0]));
+
+	io->io_queue = _ocf_cleaning_stream_queue_get(cache, io->core_id);
+
+	stream->tail = (stream->tail + count) % stream->capacity;
+	env_atomic_add(count, &stream->inflight);
+
+	attribs.cmpl_context = io;
+	attribs.io_queue = io->io_queue;
+
+	ocf_cleaner_do_flush_data_async(cache, &stream->data[io->slot], count,
+			&attribs);
+}
+
+static void _ocf_cleaning_stream_fire(ocf_cache_t cache,
+		struct flush_data *flush, uint32_t count, bool locked,
+		ocf_cleaning_stream_error_t error_fn)
+{
+	ocf_core_id_t core_id = flush[0].core_id;
+	struct ocf_cleaning_stream *stream = _ocf_cleaning_stream(cache, core_id);
+	uint32_t part;
+
+	stream->reserved -= OCF_MIN(stream->reserved, count);
+
+	/* Lines were not reserved in this stream */
+	if (env_atomic_read(&stream->inflight) + count > stream->capacity) {
+		ENV_WARN(true, "Cleaning stream overflow\n");
+		goto release;
+	}
+
+	while (count) {
+		/* Cache device is being detached or core is being removed */
+		if (!ocf_refcnt_inc(&cache->cleaner.streams.refcnt))
+			goto release;
+
+		/* I/O reaching end of the ring is split in two */
+		part = OCF_MIN(count, stream->capacity - stream->tail);
+
+		_ocf_cleaning_stream_fire_slots(cache, stream, flush, part,
+				locked, error_fn);
+
+		flush += part;
+		count -= part;
+	}
+
+	return;
+
+release:
+	if (locked)
+		_ocf_cleaning_stream_unlock(cache, flush, count);
+}
+
+void ocf_cleaning_stream_submit(ocf_cache_t cache, struct flush_data *flush,
+		uint32_t count, bool locked, ocf_cleaning_stream_error_t error_fn)
+{
+	uint32_t i, j;
+
+	ocf_cleaner_sort_sectors(flush, count);
+
+	for (i = 0; i < count; i = j) {
+		for (j = i + 1; j < count; j++) {
+			if (flush[j].core_id != flush[i].core_id)
+				break;
+		}
+
+		_ocf_cleaning_stream_fire(cache, &flush[i], j - i, locked,
+				error_fn);
+	}
+}
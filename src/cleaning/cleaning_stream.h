@@ -0,0 +1,107 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CLEANING_STREAM_H__
+#define __CLEANING_STREAM_H__
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../utils/utils_cleaner.h"
+
+/**
+ * @brief Set default stream depth, streams refcount is initially frozen
+ *	until cache device is attached
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_streams_init(ocf_cache_t cache);
+
+/**
+ * @brief Free I/O rings of all streams
+ *
+ * @note No stream I/O may be in flight
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_streams_deinit(ocf_cache_t cache);
+
+/**
+ * @brief Allocate I/O rings of idle streams whose size does not match
+ *	current stream depth
+ *
+ * @note Cleaner context only, before cleaning cycle starts
+ *
+ * @param cache Cache instance
+ */
+void ocf_cleaning_streams_update(ocf_cache_t cache);
+
+/**
+ * @brief Cleaning error handler of cleaning policy
+ *
+ * @param cache Cache instance
+ * @param flush Flush data of failed stream I/O, all of single core
+ * @param count Number of entries in flush
+ * @param error Error code
+ */
+typedef void (*ocf_cleaning_stream_error_t)(ocf_cache_t cache,
+		struct flush_data *flush, uint32_t count, int error);
+
+/**
+ * @brief Check whether stream of given core accepts cache lines
+ *
+ * @param cache Cache instance
+ * @param core_id Core id
+ *
+ * @retval true stream has free slots and does not back off after error
+ * @retval false stream is saturated, backing off or core is inactive
+ */
+bool ocf_cleaning_stream_ready(ocf_cache_t cache, ocf_core_id_t core_id);
+
+/**
+ * @brief Reserve stream slot for cache line collected by cleaning policy
+ *
+ * @note Cleaner context only, every reserved cache line must be passed
+ *	to ocf_cleaning_stream_submit() within the same cleaning cycle
+ *
+ * @param cache Cache instance
+ * @param core_id Core id of collected cache line
+ *
+ * @retval true slot has been reserved
+ * @retval false stream is not ready, cache line must be left behind
+ */
+bool ocf_cleaning_stream_reserve(ocf_cache_t cache, ocf_core_id_t core_id);
+
+/**
+ * @brief Check whether cache line is held by stream I/O in flight
+ *
+ * @param cache Cache instance
+ * @param core_id Core id of cache line
+ * @param cache_line Cache line
+ *
+ * @retval true cache line occupies slot of the stream of its core
+ * @retval false cache line is not being cleaned by the stream
+ */
+bool ocf_cleaning_stream_holds(ocf_cache_t cache, ocf_core_id_t core_id,
+		ocf_cache_line_t cache_line);
+
+/**
+ * @brief Split flush data by core and submit it to cleaning streams
+ *
+ * Flush data is copied to preallocated ring of the stream, so the caller
+ * may reuse its buffer as soon as this function returns. Every stream
+ * completes on its own I/O queue without waiting for the others.
+ *
+ * @param cache Cache instance
+ * @param flush Flush data, sorted in place
+ * @param count Number of entries in flush
+ * @param locked Cache lines are read locked by the caller and are to be
+ *	unlocked by the stream upon completion
+ * @param error_fn Cleaning error handler, if NULL failing stream backs off
+ *	as a whole
+ */
+void ocf_cleaning_stream_submit(ocf_cache_t cache, struct flush_data *flush,
+		uint32_t count, bool locked, ocf_cleaning_stream_error_t error_fn);
+
+#endif /* __CLEANING_STREAM_H__ */
@@ -0,0 +1,263 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "cleaning.h"
+#include "elevator.h"
+#include "../metadata/metadata.h"
+#include "../utils/utils_cleaner.h"
+#include "../utils/utils_cache_line.h"
+#include "../engine/engine_common.h"
+#include "../concurrency/ocf_cache_line_concurrency.h"
+#include "../concurrency/ocf_metadata_concurrency.h"
+#include "cleaning_priv.h"
+#include "cleaning_governor.h"
+#include "cleaning_stream.h"
+
+/*
+ * Elevator cleaning finds dirty cache lines by walking the metadata dirty
+ * index, which skips clean regions of the cache a word at a time, so no hash
+ * lookup is spent on core lines which are not cached or are clean. Walk
+ * position is kept between cleaning cycles and wraps around at the end of
+ * the cache, so that every dirty cache line is visited within a lap. Lines
+ * of a core whose cleaning stream is saturated are passed over and picked
+ * up on the next lap. Collected batch is sorted by core LBA before it is
+ * submitted, so that each core is written sequentially.
+ */
+
+/* time to sleep when nothing to clean in ms */
+#define ELEVATOR_BACKOFF_TIME_MS 1000
+
+static struct elevator_context *_elevator_get_ctx(ocf_cache_t cache)
+{
+	return cache->cleaner.cleaning_policy_context;
+}
+
+void cleaning_policy_elevator_setup(ocf_cache_t cache)
+{
+	struct elevator_cleaning_policy_config *config;
+
+	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_elevator].data;
+
+	config->thread_wakeup_time = OCF_ELEVATOR_DEFAULT_WAKE_UP;
+	config->flush_max_buffers = OCF_ELEVATOR_DEFAULT_FLUSH_MAX_BUFFERS;
+}
+
+int cleaning_policy_elevator_initialize(ocf_cache_t cache,
+		int init_metadata)
+{
+	struct elevator_context *ctx;
+
+	ENV_BUG_ON(cache->cleaner.cleaning_policy_context);
+
+	ctx = env_vzalloc(sizeof(*ctx));
+	if (!ctx) {
+		ocf_cache_log(cache, log_err, "elevator context allocation "
+				"error\n");
+		return -OCF_ERR_NO_MEM;
+	}
+
+	cache->cleaner.cleaning_policy_context = ctx;
+	ctx->cache = cache;
+
+	ocf_kick_cleaner(cache);
+
+	return 0;
+}
+
+void cleaning_policy_elevator_deinitialize(ocf_cache_t cache)
+{
+	env_vfree(cache->cleaner.cleaning_policy_context);
+	cache->cleaner.cleaning_policy_context = NULL;
+}
+
+int cleaning_policy_elevator_set_cleaning_param(ocf_cache_t cache,
+		uint32_t param_id, uint32_t param_value)
+{
+	struct elevator_cleaning_policy_config *config;
+
+	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_elevator].data;
+
+	switch (param_id) {
+	case ocf_elevator_wake_up_time:
+		OCF_CLEANING_CHECK_PARAM(cache, param_value,
+				OCF_ELEVATOR_MIN_WAKE_UP,
+				OCF_ELEVATOR_MAX_WAKE_UP,
+				"thread_wakeup_time");
+		config->thread_wakeup_time = param_value;
+		ocf_cache_log(cache, log_info, "Write-back flush thread "
+			"wake-up time: %d\n", config->thread_wakeup_time);
+		ocf_kick_cleaner(cache);
+		break;
+	case ocf_elevator_flush_max_buffers:
+		OCF_CLEANING_CHECK_PARAM(cache, param_value,
+				OCF_ELEVATOR_MIN_FLUSH_MAX_BUFFERS,
+				OCF_ELEVATOR_MAX_FLUSH_MAX_BUFFERS,
+				"flush_max_buffers");
+		config->flush_max_buffers = param_value;
+		ocf_cache_log(cache, log_info, "Write-back flush thread max "
+			"buffers flushed per iteration: %d\n",
+			config->flush_max_buffers);
+		break;
+	default:
+		return -OCF_ERR_INVAL;
+	}
+
+	return 0;
+}
+
+int cleaning_policy_elevator_get_cleaning_param(ocf_cache_t cache,
+		uint32_t param_id, uint32_t *param_value)
+{
+	struct elevator_cleaning_policy_config *config;
+
+	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_elevator].data;
+
+	switch (param_id) {
+	case ocf_elevator_wake_up_time:
+		*param_value = config->thread_wakeup_time;
+		break;
+	case ocf_elevator_flush_max_buffers:
+		*param_value = config->flush_max_buffers;
+		break;
+	default:
+		return -OCF_ERR_INVAL;
+	}
+
+	return 0;
+}
+
+/* attempt to lock cache line if it's still mapped to given core line and
+ * dirty */
+static bool _elevator_trylock_dirty(ocf_cache_t cache,
+		ocf_cache_line_t cache_line, ocf_core_id_t core_id,
+		uint64_t core_line)
+{
+	struct ocf_map_info info;
+	bool locked = false;
+	unsigned lock_idx = ocf_metadata_concurrency_next_idx(
+			cache->cleaner.io_queue);
+
+	ocf_hb_cline_prot_lock_rd(&cache->metadata.lock, lock_idx, core_id,
+			core_line);
+
+	/* Core info was read without hash bucket lock, so the cache line
+	 * might have been remapped since */
+	ocf_engine_lookup_map_entry(cache, &info, core_id,
+			core_line);
+
+	/* Lines held by cleaning stream I/O in flight are skipped, as read
+	 * lock alone would not keep them from being flushed twice */
+	if (info.status == LOOKUP_HIT && info.coll_idx == cache_line &&
+			metadata_test_dirty(cache, cache_line) &&
+			!ocf_cache_line_is_used(
+				ocf_cache_line_concurrency(cache),
+				cache_line)) {
+		locked = ocf_cache_line_try_lock_rd(
+				ocf_cache_line_concurrency(cache),
+				cache_line);
+	}
+
+	ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock, lock_idx, core_id,
+			core_line);
+
+	return locked;
+}
+
+/* Collect up to max_lines dirty cache lines, moving walk position forward */
+static uint32_t _elevator_collect(struct elevator_context *ctx,
+		uint32_t max_lines)
+{
+	ocf_cache_t cache = ctx->cache;
+	struct elevator_flush_context *flush = &ctx->flush;
+	ocf_cache_line_t entries = cache->device->collision_table_entries;
+	ocf_cache_line_t start, end, line;
+	ocf_core_id_t core_id;
+	uint64_t core_line;
+	bool wrapped = false;
+
+	flush->size = 0;
+
+	start = ctx->cursor < entries ? ctx->cursor : 0;
+	line = start;
+	end = entries;
+
+	while (flush->size < max_lines) {
+		line = ocf_metadata_dirty_index_next(cache, line, end);
+		if (line >= end) {
+			/* Whole cache walked once - lap is complete */
+			if (wrapped)
+				break;
+
+			wrapped = true;
+			line = 0;
+			end = start;
+			continue;
+		}
+
+		ocf_metadata_get_core_info(cache, line, &core_id, &core_line);
+
+		if (core_id >= OCF_CORE_MAX ||
+				!ocf_cleaning_stream_ready(cache, core_id) ||
+				!_elevator_trylock_dirty(cache, line, core_id,
+						core_line)) {
+			line++;
+			continue;
+		}
+
+		if (!ocf_cleaning_stream_reserve(cache, core_id)) {
+			ocf_cache_line_unlock_rd(
+					ocf_cache_line_concurrency(cache),
+					line);
+			line++;
+			continue;
+		}
+
+		flush->data[flush->size].core_id = core_id;
+		flush->data[flush->size].core_line = core_line;
+		flush->data[flush->size].cache_line = line;
+		flush->size++;
+		line++;
+	}
+
+	ctx->cursor = line;
+
+	return flush->size;
+}
+
+void cleaning_policy_elevator_perform_cleaning(ocf_cache_t cache,
+		ocf_cleaner_end_t cmpl)
+{
+	struct elevator_cleaning_policy_config *config;
+	struct elevator_context *ctx = _elevator_get_ctx(cache);
+	uint32_t flush_max_buffers;
+
+	config = (void *)&cache->conf_meta->cleaning[ocf_cleaning_elevator].data;
+
+	flush_max_buffers = ocf_cleaning_governor_budget(cache,
+			config->flush_max_buffers);
+	if (!flush_max_buffers) {
+		/* Cleaning budget used up - governor sets sleep time */
+		cmpl(&cache->cleaner, 0);
+		return;
+	}
+
+	if (!_elevator_collect(ctx, flush_max_buffers)) {
+		/* nothing to clean */
+		cmpl(&cache->cleaner, ELEVATOR_BACKOFF_TIME_MS);
+		return;
+	}
+
+	ocf_cleaning_governor_charge(cache, ctx->flush.size);
+
+	/* Batch is sorted by core LBA on submission. Lines which fail to
+	 * flush stay dirty and are retried on next lap, once their stream
+	 * is done backing off */
+	ocf_cleaning_stream_submit(cache, ctx->flush.data, ctx->flush.size,
+			true, NULL);
+
+	cmpl(&cache->cleaner, config->thread_wakeup_time);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#ifndef __LAYER_CLEANING_POLICY_ELEVATOR_H__
+#define __LAYER_CLEANING_POLICY_ELEVATOR_H__
+
+#include "cleaning.h"
+#include "../utils/utils_cleaner.h"
+
+struct elevator_flush_context {
+	/* number of cache lines in flush */
+	uint32_t size;
+	/* cache lines to flush */
+	struct flush_data data[OCF_ELEVATOR_MAX_FLUSH_MAX_BUFFERS];
+};
+
+struct elevator_context {
+	/* next cache line to be examined */
+	ocf_cache_line_t cursor;
+
+	/* cache lines collected in current cleaning cycle */
+	struct elevator_flush_context flush;
+
+	/* cache handle */
+	ocf_cache_t cache;
+};
+
+void cleaning_policy_elevator_setup(ocf_cache_t cache);
+
+int cleaning_policy_elevator_initialize(ocf_cache_t cache, int init_metadata);
+
+void cleaning_policy_elevator_deinitialize(ocf_cache_t cache);
+
+void cleaning_policy_elevator_perform_cleaning(ocf_cache_t cache,
+		ocf_cleaner_end_t cmpl);
+
+int cleaning_policy_elevator_set_cleaning_param(ocf_cache_t cache,
+		uint32_t param_id, uint32_t param_value);
+
+int cleaning_policy_elevator_get_cleaning_param(ocf_cache_t cache,
+		uint32_t param_id, uint32_t *param_value);
+
+#endif
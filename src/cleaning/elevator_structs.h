@@ -0,0 +1,15 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#ifndef __CLEANING_ELEVATOR_STRUCTS_H__
+#define __CLEANING_ELEVATOR_STRUCTS_H__
+
+#include "../utils/utils_cleaner.h"
+
+struct elevator_cleaning_policy_config {
+	uint32_t thread_wakeup_time;	/* in milliseconds*/
+	uint32_t flush_max_buffers;	/* in lines */
+};
+
+#endif
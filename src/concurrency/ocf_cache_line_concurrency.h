@@ -148,6 +148,20 @@ void ocf_req_unlock(struct ocf_alock *c,
 bool ocf_cache_line_is_used(struct ocf_alock *c,
 		ocf_cache_line_t line);
 
+/**
+ * @brief Check if cache line is locked for write access
+ *
+ * Only reads lock state, so it does not synchronize with the lock owner.
+ *
+ * @param c - cacheline concurrency private data
+ * @param line - Cache line to be checked
+ *
+ * @retval true - cache line is locked for write access
+ * @retval false - cache line is not locked for write access
+ */
+bool ocf_cache_line_is_locked_wr(struct ocf_alock *c,
+		ocf_cache_line_t line);
+
 /**
  * @brief Check if for specified cache line there are waiters
  * on the waiting list
@@ -68,13 +68,17 @@ int ocf_metadata_concurrency_attached_init(
 
     metadata_lock->hash = env_vzalloc(sizeof(env_rwsem) *
                                       hash_table_entries);
+    metadata_lock->hash_seq = env_vzalloc(sizeof(env_atomic) *
+                                          hash_table_entries);
     metadata_lock->collision_pages = env_vzalloc(sizeof(env_rwsem) *
                                                  colision_table_pages);
-    if (!metadata_lock->hash ||
+    if (!metadata_lock->hash || !metadata_lock->hash_seq ||
         !metadata_lock->collision_pages) {
         env_vfree(metadata_lock->hash);
+        env_vfree(metadata_lock->hash_seq);
         env_vfree(metadata_lock->collision_pages);
         metadata_lock->hash = NULL;
+        metadata_lock->hash_seq = NULL;
         metadata_lock->collision_pages = NULL;
         return -OCF_ERR_NO_MEM;
     }
@@ -93,6 +97,8 @@ int ocf_metadata_concurrency_attached_init(
         return err;
     }
 
+    env_atomic_set(&metadata_lock->exclusive_seq, 0);
+
     for (i = 0; i < colision_table_pages; i++) {
         err = env_rwsem_init(&metadata_lock->collision_pages[i]);
         if (err)
@@ -126,6 +132,9 @@ void ocf_metadata_concurrency_attached_deinit(
         metadata_lock->num_hash_entries = 0;
     }
 
+    env_vfree(metadata_lock->hash_seq);
+    metadata_lock->hash_seq = NULL;
+
     if (metadata_lock->collision_pages) {
         for (i = 0; i < metadata_lock->num_collision_pages; i++)
             env_rwsem_destroy(&metadata_lock->collision_pages[i]);
@@ -142,6 +151,8 @@ void ocf_metadata_start_exclusive_access(
     for (i = 0; i < OCF_NUM_GLOBAL_META_LOCKS; i++) {
         env_rwsem_down_write(&metadata_lock->global[i].sem);
     }
+
+    env_atomic_inc(&metadata_lock->exclusive_seq);
 }
 
 int ocf_metadata_try_start_exclusive_access(
@@ -159,6 +170,8 @@ int ocf_metadata_try_start_exclusive_access(
         while (i--) {
             env_rwsem_up_write(&metadata_lock->global[i].sem);
         }
+    } else {
+        env_atomic_inc(&metadata_lock->exclusive_seq);
     }
 
     return error;
@@ -168,6 +181,8 @@ void ocf_metadata_end_exclusive_access(
     struct ocf_metadata_lock* metadata_lock) {
     unsigned i;
 
+    env_atomic_inc(&metadata_lock->exclusive_seq);
+
     for (i = OCF_NUM_GLOBAL_META_LOCKS; i > 0; i--)
         env_rwsem_up_write(&metadata_lock->global[i - 1].sem);
 }
@@ -209,9 +224,10 @@ static inline void ocf_hb_id_naked_lock(
     int rw) {
     ENV_BUG_ON(hash >= metadata_lock->num_hash_entries);
 
-    if (rw == OCF_METADATA_WR)
+    if (rw == OCF_METADATA_WR) {
         env_rwsem_down_write(&metadata_lock->hash[hash]);
-    else if (rw == OCF_METADATA_RD)
+        env_atomic_inc(&metadata_lock->hash_seq[hash]);
+    } else if (rw == OCF_METADATA_RD)
         env_rwsem_down_read(&metadata_lock->hash[hash]);
     else
         ENV_BUG();
@@ -223,9 +239,10 @@ static inline void ocf_hb_id_naked_unlock(
     int rw) {
     ENV_BUG_ON(hash >= metadata_lock->num_hash_entries);
 
-    if (rw == OCF_METADATA_WR)
+    if (rw == OCF_METADATA_WR) {
+        env_atomic_inc(&metadata_lock->hash_seq[hash]);
         env_rwsem_up_write(&metadata_lock->hash[hash]);
-    else if (rw == OCF_METADATA_RD)
+    } else if (rw == OCF_METADATA_RD)
         env_rwsem_up_read(&metadata_lock->hash[hash]);
     else
         ENV_BUG();
@@ -241,6 +258,8 @@ static int ocf_hb_id_naked_trylock(struct ocf_metadata_lock* metadata_lock,
     if (rw == OCF_METADATA_WR) {
         result = env_rwsem_down_write_trylock(
             &metadata_lock->hash[hash]);
+        if (!result)
+            env_atomic_inc(&metadata_lock->hash_seq[hash]);
     } else if (rw == OCF_METADATA_RD) {
         result = env_rwsem_down_read_trylock(
             &metadata_lock->hash[hash]);
@@ -439,6 +458,51 @@ bool ocf_req_hash_in_range(struct ocf_request* req,
             hash <= _MAX_HASH(req));
 }
 
+/* Sequence value is a sum of hash bucket sequence counters for all hash
+ * buckets of the request and of the exclusive access sequence counter. Each
+ * counter only grows, so the sum changes whenever any of them changes. */
+static bool ocf_hb_req_seq_read(struct ocf_request* req, uint32_t* seq) {
+    struct ocf_metadata_lock* metadata_lock = &req->cache->metadata.lock;
+    ocf_cache_line_t hash;
+    uint32_t sum, val;
+
+    sum = env_atomic_read(&metadata_lock->exclusive_seq);
+    if (sum & 1)
+        return false;
+
+    for_each_req_hash_asc(req, hash) {
+        val = env_atomic_read(&metadata_lock->hash_seq[hash]);
+        if (val & 1)
+            return false;
+        sum += val;
+    }
+
+    *seq = sum;
+    return true;
+}
+
+bool ocf_hb_req_seq_read_begin(struct ocf_request* req, uint32_t* seq) {
+    if (!ocf_hb_req_seq_read(req, seq))
+        return false;
+
+    /* Metadata must not be read before sequence counters */
+    env_smp_rmb();
+
+    return true;
+}
+
+bool ocf_hb_req_seq_read_retry(struct ocf_request* req, uint32_t seq) {
+    uint32_t curr;
+
+    /* Metadata must be read before sequence counters */
+    env_smp_rmb();
+
+    if (!ocf_hb_req_seq_read(req, &curr))
+        return true;
+
+    return curr != seq;
+}
+
 void ocf_hb_req_prot_lock_rd(struct ocf_request* req) {
     ocf_cache_line_t hash;
 
@@ -35,6 +35,12 @@ static inline void ocf_metadata_lru_wr_lock(
     env_rwlock_write_lock(&metadata_lock->lru[ev_list]);
 }
 
+static inline bool ocf_metadata_lru_wr_trylock(
+    struct ocf_metadata_lock* metadata_lock,
+    unsigned ev_list) {
+    return !env_rwlock_write_trylock(&metadata_lock->lru[ev_list]);
+}
+
 static inline void ocf_metadata_lru_wr_unlock(
     struct ocf_metadata_lock* metadata_lock,
     unsigned ev_list) {
@@ -70,19 +76,19 @@ static inline void ocf_metadata_lru_wr_unlock_all(
 
 #define OCF_METADATA_LRU_WR_LOCK(cline)             \
     ocf_metadata_lru_wr_lock(&cache->metadata.lock, \
-                             cline % OCF_NUM_LRU_LISTS)
+                             ocf_lru_list_idx(cache, cline))
 
 #define OCF_METADATA_LRU_WR_UNLOCK(cline)             \
     ocf_metadata_lru_wr_unlock(&cache->metadata.lock, \
-                               cline % OCF_NUM_LRU_LISTS)
+                               ocf_lru_list_idx(cache, cline))
 
 #define OCF_METADATA_LRU_RD_LOCK(cline)             \
     ocf_metadata_lru_rd_lock(&cache->metadata.lock, \
-                             cline % OCF_NUM_LRU_LISTS)
+                             ocf_lru_list_idx(cache, cline))
 
 #define OCF_METADATA_LRU_RD_UNLOCK(cline)             \
     ocf_metadata_lru_rd_unlock(&cache->metadata.lock, \
-                               cline % OCF_NUM_LRU_LISTS)
+                               ocf_lru_list_idx(cache, cline))
 
 #define OCF_METADATA_LRU_WR_LOCK_ALL() \
     ocf_metadata_lru_wr_lock_all(&cache->metadata.lock)
@@ -179,6 +185,12 @@ void ocf_hb_req_prot_lock_wr(struct ocf_request* req);
 void ocf_hb_req_prot_unlock_wr(struct ocf_request* req);
 void ocf_hb_req_prot_lock_upgrade(struct ocf_request* req);
 
+/* optimistic lockless read of request hash buckets - begin returns false if
+ * any of the buckets is being modified, retry returns true if any of them was
+ * modified after begin */
+bool ocf_hb_req_seq_read_begin(struct ocf_request* req, uint32_t* seq);
+bool ocf_hb_req_seq_read_retry(struct ocf_request* req, uint32_t seq);
+
 /* collision table page lock interface */
 void ocf_collision_start_shared_access(struct ocf_metadata_lock* metadata_lock,
                                        uint32_t page);
@@ -13,6 +13,7 @@
 #include "../ocf_space.h"
 #include "../utils/utils_refcnt.h"
 #include "../utils/utils_user_part.h"
+#include "engine_coalesce.h"
 #include "engine_common.h"
 #include "engine_d2c.h"
 #include "engine_discard.h"
@@ -25,6 +26,7 @@
 #include "engine_wi.h"
 #include "engine_wo.h"
 #include "engine_wt.h"
+#include "engine_zero.h"
 #include "ocf/ocf.h"
 
 enum ocf_io_if_type {
@@ -123,6 +125,7 @@ struct ocf_request* ocf_engine_pop_req(ocf_queue_t q) {
 
     env_atomic_dec(&q->io_no);
     list_del(&req->list);
+    ocf_engine_coalesce_seal(q, req);
 
     /* UNLOCK */
     env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
@@ -194,6 +197,13 @@ int ocf_engine_hndl_req(struct ocf_request* req) {
 
     ocf_req_get(req);
 
+    /* Zero-filled writes are not inserted into cache */
+    ocf_engine_zero_write_detect(req);
+
+    /* Small write-back writes wait in the queue for neighbours */
+    if (ocf_engine_coalesce_submit(req))
+        return 0;
+
     /* Till OCF engine is not synchronous fully need to push OCF request
      * to into OCF workers
      */
@@ -207,6 +217,11 @@ int ocf_engine_hndl_fast_req(struct ocf_request* req) {
     const struct ocf_io_if* io_if;
     int ret;
 
+    /* Zero-filled writes are not inserted into cache, leave them to
+     * write-invalidate engine */
+    if (ocf_engine_zero_write_detect(req))
+        return OCF_FAST_PATH_NO;
+
     io_if = ocf_get_io_if(req->cache_mode);
     if (!io_if)
         return -OCF_ERR_INVAL;
@@ -83,6 +83,7 @@ static int _ocf_backfill_do(struct ocf_request *req)
 	env_atomic_set(&req->req_remaining, reqs_to_issue);
 
 	req->data = req->cp_data;
+	req->offset = 0;
 
 	ocf_submit_cache_reqs(req->cache, req, OCF_WRITE, 0, req->byte_length,
 				reqs_to_issue, _ocf_backfill_complete);
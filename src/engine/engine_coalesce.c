@@ -0,0 +1,284 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_ctx_priv.h"
+#include "../ocf_queue_priv.h"
+#include "../ocf_request.h"
+#include "cache_engine.h"
+#include "engine_common.h"
+#include "engine_coalesce.h"
+
+#define OCF_ENGINE_DEBUG_IO_NAME "coalesce"
+#include "engine_debug.h"
+
+/*
+ * Write coalescing works on top of the I/O queue. The first eligible write
+ * is pushed to the queue as a batch head. Following writes submitted to the
+ * same queue, which overlap or are adjacent to the range covered by the
+ * batch, are attached to the head instead of being queued separately. Once
+ * the queue worker picks the head up, the batch is sealed and all attached
+ * writes are copied (in submission order) into a single request handled by
+ * the write-back engine.
+ *
+ * Completion of every write in the batch is deferred until the merged
+ * request completes, so any read submitted after a write completion
+ * observes the written data.
+ */
+
+bool ocf_engine_coalesce_eligible(struct ocf_request *req)
+{
+	uint32_t max_io_size = req->cache->write_coalescing.max_io_size;
+
+	if (max_io_size == OCF_CACHE_WRITE_COALESCING_INACTIVE)
+		return false;
+
+	if (req->rw != OCF_WRITE || req->cache_mode != ocf_req_cache_mode_wb)
+		return false;
+
+	if (req->d2c || req->force_pt || req->info.internal)
+		return false;
+
+	/* Flags must be propagated to bottom volumes as they are */
+	if (req->ioi.io.flags)
+		return false;
+
+	return req->byte_length && req->byte_length <= max_io_size;
+}
+
+static bool _ocf_coalesce_can_attach(struct ocf_request *head,
+		struct ocf_request *req)
+{
+	uint64_t head_end = head->coalesce.addr + head->coalesce.bytes;
+	uint64_t req_end = req->byte_position + req->byte_length;
+
+	if (head->core != req->core || head->part_id != req->part_id)
+		return false;
+
+	if (head->cache_mode != req->cache_mode)
+		return false;
+
+	/* Merged request is accounted and evicted as single IO class */
+	if (head->ioi.io.io_class != req->ioi.io.io_class)
+		return false;
+
+	/* Only overlapping or adjacent writes are merged */
+	if (req->byte_position > head_end || req_end < head->coalesce.addr)
+		return false;
+
+	return OCF_MAX(head_end, req_end) -
+			OCF_MIN(head->coalesce.addr, req->byte_position) <=
+			head->cache->write_coalescing.max_batch_size;
+}
+
+static void _ocf_coalesce_attach(struct ocf_request *head,
+		struct ocf_request *req)
+{
+	uint64_t head_end = head->coalesce.addr + head->coalesce.bytes;
+	uint64_t req_end = req->byte_position + req->byte_length;
+
+	head->coalesce.addr = OCF_MIN(head->coalesce.addr, req->byte_position);
+	head->coalesce.bytes = OCF_MAX(head_end, req_end) - head->coalesce.addr;
+	head->coalesce.count++;
+
+	list_add_tail(&req->list, &head->coalesce.batch);
+}
+
+static void _ocf_coalesce_complete(struct ocf_request *merged, int error)
+{
+	struct ocf_request *req, *tmp;
+
+	OCF_DEBUG_RQ(merged, "Completion");
+
+	list_for_each_entry_safe(req, tmp, &merged->coalesce.batch, list) {
+		list_del(&req->list);
+
+		req->complete(req, error);
+
+		/* Release reference taken when request entered the engine */
+		ocf_req_put(req);
+	}
+
+	ctx_data_free(merged->cache->owner, merged->data);
+	merged->data = NULL;
+
+	ocf_req_put(merged);
+}
+
+bool ocf_engine_coalesced(struct ocf_request *req)
+{
+	return req->complete == _ocf_coalesce_complete;
+}
+
+void ocf_engine_coalesce_update_stats(struct ocf_request *merged)
+{
+	struct ocf_request *req;
+	uint32_t first, i, hit_no;
+
+	list_for_each_entry(req, &merged->coalesce.batch, list) {
+		first = req->core_line_first - merged->core_line_first;
+		hit_no = 0;
+
+		for (i = 0; i < req->core_line_count; i++) {
+			if (merged->map[first + i].status == LOOKUP_HIT)
+				hit_no++;
+		}
+
+		ocf_core_stats_request_update(req->core, req->part_id, req->rw,
+				hit_no, req->core_line_count);
+		ocf_core_stats_vol_block_update(req->core, req->part_id,
+				req->rw, req->byte_length);
+	}
+}
+
+static void _ocf_coalesce_copy(struct ocf_request *merged,
+		struct ocf_request *req)
+{
+	ctx_data_cpy(merged->cache->owner, merged->data, req->data,
+			req->byte_position - merged->byte_position, req->offset,
+			req->byte_length);
+}
+
+static struct ocf_request *_ocf_coalesce_merge(struct ocf_request *head)
+{
+	ocf_cache_t cache = head->cache;
+	struct ocf_request *merged, *req, *tmp;
+
+	merged = ocf_req_new(head->io_queue, head->core, head->coalesce.addr,
+			head->coalesce.bytes, OCF_WRITE);
+	if (!merged)
+		return NULL;
+
+	/* Cache is being detached, let the writes go on their own */
+	if (merged->d2c)
+		goto err;
+
+	if (ocf_req_alloc_map(merged))
+		goto err;
+
+	merged->data = ctx_data_alloc(cache->owner,
+			OCF_DIV_ROUND_UP(head->coalesce.bytes, PAGE_SIZE));
+	if (!merged->data)
+		goto err;
+
+	/* Copy in submission order - where writes overlap, data of the
+	 * later one wins */
+	_ocf_coalesce_copy(merged, head);
+	list_for_each_entry(req, &head->coalesce.batch, list)
+		_ocf_coalesce_copy(merged, req);
+
+	merged->ioi.io.io_class = head->ioi.io.io_class;
+	merged->part_id = head->part_id;
+	merged->cache_mode = head->cache_mode;
+	merged->io_if = head->io_if;
+	merged->complete = _ocf_coalesce_complete;
+
+	/* Merged request takes over the whole batch */
+	INIT_LIST_HEAD(&merged->coalesce.batch);
+	list_add_tail(&head->list, &merged->coalesce.batch);
+	ocf_io_start(&head->ioi.io);
+	list_for_each_entry_safe(req, tmp, &head->coalesce.batch, list) {
+		list_move_tail(&req->list, &merged->coalesce.batch);
+		ocf_io_start(&req->ioi.io);
+	}
+
+	merged->coalesce.addr = head->coalesce.addr;
+	merged->coalesce.bytes = head->coalesce.bytes;
+	merged->coalesce.count = head->coalesce.count;
+
+	return merged;
+
+err:
+	ocf_req_put(merged);
+	return NULL;
+}
+
+static int _ocf_write_coalesce(struct ocf_request *head)
+{
+	struct ocf_request *merged, *req, *tmp;
+
+	head->io_if = ocf_get_io_if(head->cache_mode);
+
+	if (list_empty(&head->coalesce.batch))
+		return head->io_if->write(head);
+
+	merged = _ocf_coalesce_merge(head);
+	if (merged) {
+		OCF_DEBUG_RQ(merged, "Merged %u writes",
+				merged->coalesce.count);
+
+		/* Reference released by the engine on completion */
+		ocf_req_get(merged);
+		return merged->io_if->write(merged);
+	}
+
+	/* Could not merge the batch - handle writes one by one, preserving
+	 * their submission order */
+	OCF_DEBUG_RQ(head, "Merge failed, handling %u writes separately",
+			head->coalesce.count);
+
+	head->io_if->write(head);
+
+	list_for_each_entry_safe(req, tmp, &head->coalesce.batch, list) {
+		list_del(&req->list);
+		req->io_if = head->io_if;
+		req->io_if->write(req);
+	}
+
+	return 0;
+}
+
+static const struct ocf_io_if _io_if_coalesce = {
+	.read = _ocf_write_coalesce,
+	.write = _ocf_write_coalesce,
+	.name = "Write Coalescing",
+};
+
+bool ocf_engine_coalesce_submit(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_queue_t q = req->io_queue;
+	struct ocf_request *head;
+	unsigned long lock_flags = 0;
+
+	if (!ocf_engine_coalesce_eligible(req))
+		return false;
+
+	env_atomic_set(&cache->last_access_ms,
+			env_ticks_to_msecs(env_get_tick_count()));
+
+	env_spinlock_lock_irqsave(&q->io_list_lock, lock_flags);
+
+	head = q->coalesce_head;
+	if (head && _ocf_coalesce_can_attach(head, req)) {
+		_ocf_coalesce_attach(head, req);
+		env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
+
+		OCF_DEBUG_RQ(req, "Attached to batch");
+		return true;
+	}
+
+	/* Start new batch. Previous one is not extended anymore, so writes
+	 * are never reordered against each other. */
+	INIT_LIST_HEAD(&req->coalesce.batch);
+	req->coalesce.addr = req->byte_position;
+	req->coalesce.bytes = req->byte_length;
+	req->coalesce.count = 1;
+	req->io_if = &_io_if_coalesce;
+
+	INIT_LIST_HEAD(&req->list);
+	list_add_tail(&req->list, &q->io_list);
+	env_atomic_inc(&q->io_no);
+	q->coalesce_head = req;
+
+	env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
+
+	/* Time spent by batch head in the queue is the coalescing window,
+	 * so never process it synchronously in the submitter context */
+	ocf_queue_kick(q, false);
+
+	return true;
+}
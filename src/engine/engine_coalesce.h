@@ -0,0 +1,68 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __ENGINE_COALESCE_H__
+#define __ENGINE_COALESCE_H__
+
+#include "ocf/ocf.h"
+#include "../ocf_queue_priv.h"
+
+/**
+ * @brief Check whether request may be merged with other small writes
+ *
+ * @param req OCF request
+ *
+ * @retval true request is eligible for write coalescing
+ * @retval false request must be handled on its own
+ */
+bool ocf_engine_coalesce_eligible(struct ocf_request *req);
+
+/**
+ * @brief Queue write request through write coalescing stage
+ *
+ * Request is either attached to the batch which is still waiting in the
+ * queue or it is pushed to the queue as head of a new batch.
+ *
+ * @param req OCF request
+ *
+ * @retval true request has been queued
+ * @retval false request is not eligible for coalescing
+ */
+bool ocf_engine_coalesce_submit(struct ocf_request *req);
+
+/**
+ * @brief Check whether request has been merged from batch of writes
+ *
+ * @param req OCF request
+ *
+ * @retval true request is result of write coalescing
+ * @retval false request has been submitted on its own
+ */
+bool ocf_engine_coalesced(struct ocf_request *req);
+
+/**
+ * @brief Update request and block statistics of each write merged into
+ *	request, as if it was handled on its own
+ *
+ * @param merged Request merged from batch of writes
+ */
+void ocf_engine_coalesce_update_stats(struct ocf_request *merged);
+
+/**
+ * @brief Stop attaching new writes to the batch headed by request
+ *
+ * @note Caller must hold queue io_list_lock
+ *
+ * @param q I/O queue
+ * @param req OCF request removed from the queue
+ */
+static inline void ocf_engine_coalesce_seal(ocf_queue_t q,
+		struct ocf_request *req)
+{
+	if (q->coalesce_head == req)
+		q->coalesce_head = NULL;
+}
+
+#endif /* __ENGINE_COALESCE_H__ */
@@ -204,7 +204,7 @@ static void ocf_engine_set_hot(struct ocf_request* req) {
 
         if (status == LOOKUP_HIT) {
             /* Update eviction (LRU) */
-            ocf_lru_hot_cline(cache, entry->coll_idx);
+            ocf_lru_hot_cline(cache, entry->coll_idx, req->io_queue);
         }
     }
 }
@@ -215,7 +215,7 @@ static void ocf_engine_set_hot(struct ocf_request* req) {
  *
  * 该函数遍历请求中的所有core line，检查它们在cache中的状态（命中/未命中）
  */
-static void ocf_engine_lookup(struct ocf_request* req) {
+void ocf_engine_lookup(struct ocf_request* req) {
     uint32_t i;
     uint64_t core_line;
 
@@ -564,6 +564,9 @@ int ocf_engine_prepare_clines(struct ocf_request* req) {
                       128);
     }
 
+    /* Refill free cachelines before next misses have to evict inline */
+    ocf_space_reclaim_kick(req);
+
     return lock;
 }
 
@@ -643,6 +646,10 @@ void ocf_engine_push_req_back(struct ocf_request* req, bool allow_sync) {
     list_add_tail(&req->list, &q->io_list);
     env_atomic_inc(&q->io_no);
 
+    /* Writes coalesced later must not overtake this one */
+    if (req->rw == OCF_WRITE)
+        q->coalesce_head = NULL;
+
     env_spinlock_unlock_irqrestore(&q->io_list_lock, lock_flags);
 
     /* NOTE: do not dereference @req past this line, it might
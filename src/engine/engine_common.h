@@ -227,6 +227,16 @@ int ocf_engine_prepare_clines(struct ocf_request* req);
  */
 void ocf_engine_traverse(struct ocf_request* req);
 
+/**
+ * @brief Lookup OCF request in metadata without updating eviction
+ *
+ * @note Caller either holds hash bucket locks or validates the result
+ * with hash bucket sequence counters.
+ *
+ * @param req OCF request
+ */
+void ocf_engine_lookup(struct ocf_request* req);
+
 /**
  * @brief Check if OCF request mapping is still valid
  *
@@ -12,6 +12,7 @@
 #include "../utils/utils_io.h"
 #include "../utils/utils_cache_line.h"
 #include "../concurrency/ocf_concurrency.h"
+#include "../cleaning/cleaning_discard.h"
 
 #define OCF_ENGINE_DEBUG 0
 
@@ -128,7 +129,7 @@ static void _ocf_discard_finish_step(struct ocf_request *req)
 
 	if (req->discard.handled < req->discard.nr_sects)
 		req->io_if = &_io_if_discard_step;
-	else if (!req->cache->metadata.is_volatile)
+	else if (!req->cache->metadata.is_volatile && req->discard.purged)
 		req->io_if = &_io_if_discard_flush_cache;
 	else
 		req->io_if = &_io_if_discard_core;
@@ -174,6 +175,7 @@ int _ocf_discard_step_do(struct ocf_request *req)
 
 		/* Remove mapped cache lines from metadata */
 		ocf_purge_map_info(req);
+		req->discard.purged += ocf_engine_mapped_count(req);
 
 		if (req->info.flush_metadata) {
 			/* Request was dirty and need to flush metadata */
@@ -207,6 +209,59 @@ static void _ocf_discard_on_resume(struct ocf_request *req)
 	ocf_engine_push_req_front(req, true);
 }
 
+/*
+ * Skips leading part of remaining range which has no lines in cache, probing
+ * hash bucket of each core line. Returns true if whole remaining range may
+ * be skipped.
+ *
+ * Only the prefix is skipped - once a mapped line is found, the rest of the
+ * range is handled by regular steps, which look up every line again under
+ * hash bucket locks of the step.
+ */
+static bool _ocf_discard_skip_unmapped(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_core_id_t core_id = ocf_core_get_id(req->core);
+	uint64_t start = SECTORS_TO_BYTES(req->discard.sector +
+			req->discard.handled);
+	uint64_t end = SECTORS_TO_BYTES(req->discard.sector +
+			req->discard.nr_sects);
+	uint64_t core_line = ocf_bytes_2_lines(cache, start);
+	uint64_t last = ocf_bytes_2_lines(cache, end - 1);
+	struct ocf_map_info entry;
+	uint64_t skip;
+
+	/* Promotion policy may still track discarded addresses */
+	if (cache->conf_meta->promotion_policy_type != ocf_promotion_always)
+		return false;
+
+	if (!env_atomic_read(&req->core->runtime_meta->cached_clines))
+		return true;
+
+	for (; core_line <= last; core_line++) {
+		ocf_hb_cline_prot_lock_rd(&cache->metadata.lock,
+				req->lock_idx, core_id, core_line);
+		ocf_engine_lookup_map_entry(cache, &entry, core_id, core_line);
+		ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock,
+				req->lock_idx, core_id, core_line);
+
+		if (entry.status == LOOKUP_HIT)
+			break;
+	}
+
+	if (core_line > last)
+		return true;
+
+	skip = ocf_lines_2_bytes(cache, core_line);
+	if (skip > start) {
+		OCF_DEBUG_RQ(req, "Skipping %llu unmapped bytes",
+				(unsigned long long)(skip - start));
+		req->discard.handled += BYTES_TO_SECTORS(skip - start);
+	}
+
+	return false;
+}
+
 static int _ocf_discard_step(struct ocf_request *req)
 {
 	int lock;
@@ -214,6 +269,14 @@ static int _ocf_discard_step(struct ocf_request *req)
 
 	OCF_DEBUG_TRACE(req->cache);
 
+	if (_ocf_discard_skip_unmapped(req)) {
+		OCF_DEBUG_RQ(req, "Range not mapped");
+		req->byte_length = 0;
+		req->discard.handled = req->discard.nr_sects;
+		_ocf_discard_finish_step(req);
+		return 0;
+	}
+
 	req->byte_position = SECTORS_TO_BYTES(req->discard.sector +
 			req->discard.handled);
 	req->byte_length = OCF_MIN(SECTORS_TO_BYTES(req->discard.nr_sects -
@@ -274,6 +337,10 @@ int ocf_discard(struct ocf_request *req)
 		return 0;
 	}
 
+	/* Cleaning in progress skips writeback of discarded cache lines */
+	ocf_cleaning_discard_register(req->cache, ocf_core_get_id(req->core),
+			req->byte_position, req->byte_length);
+
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
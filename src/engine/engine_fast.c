@@ -100,6 +100,142 @@ static const struct ocf_io_if _io_if_read_fast_resume = {
     .write = _ocf_read_fast_do,
 };
 
+/*
+ * Lockless read hit
+ *
+ * Mapping and status of cache lines are read without taking hash bucket or
+ * cache line locks. Instead hash bucket sequence counters are sampled before
+ * lookup and checked again once data is read from cache. Every change of
+ * mapping is done under hash bucket write lock (or exclusive metadata access),
+ * which moves the counters, so unchanged counters prove the data read belongs
+ * to the request. On conflict request is retried with locks taken.
+ */
+
+static int _ocf_read_fast_retry(struct ocf_request* req) {
+    bool hit;
+    int lock = OCF_LOCK_NOT_ACQUIRED;
+
+    OCF_DEBUG_RQ(req, "Lockless read conflict, retry");
+
+    req->io_if = &_io_if_read_fast_resume;
+
+    ocf_hb_req_prot_lock_rd(req);
+
+    ocf_engine_traverse(req);
+
+    hit = ocf_engine_is_hit(req);
+    if (hit) {
+        lock = ocf_req_async_lock_rd(
+            ocf_cache_line_concurrency(req->cache),
+            req, ocf_engine_on_resume);
+    }
+
+    ocf_hb_req_prot_unlock_rd(req);
+
+    if (!hit) {
+        /* Not a hit anymore, read from core (clean dirty lines first) */
+        ocf_read_pt_do(req);
+    } else if (lock < 0) {
+        req->complete(req, lock);
+        ocf_req_put(req);
+    } else if (lock == OCF_LOCK_ACQUIRED) {
+        _ocf_read_fast_do(req);
+    }
+
+    return 0;
+}
+
+static const struct ocf_io_if _io_if_read_fast_retry = {
+    .read = _ocf_read_fast_retry,
+    .write = _ocf_read_fast_retry,
+};
+
+static void _ocf_read_fast_lockless_complete(struct ocf_request* req,
+                                             int error) {
+    if (error)
+        req->error |= error;
+
+    if (env_atomic_dec_return(&req->req_remaining)) {
+        /* Not all requests finished */
+        return;
+    }
+
+    if (req->error) {
+        OCF_DEBUG_RQ(req, "ERROR");
+
+        ocf_core_stats_cache_error_update(req->core, OCF_READ);
+        ocf_engine_push_req_front_pt(req);
+        return;
+    }
+
+    if (ocf_hb_req_seq_read_retry(req, req->hb_seq)) {
+        /* Mapping changed while data was read, it may be stale */
+        ocf_core_stats_request_lockless_update(req->core, req->part_id, true);
+        ocf_engine_push_req_front_if(req, &_io_if_read_fast_retry, false);
+        return;
+    }
+
+    OCF_DEBUG_RQ(req, "Lockless HIT completion");
+
+    ocf_engine_update_request_stats(req);
+    ocf_engine_update_block_stats(req);
+    ocf_core_stats_request_lockless_update(req->core, req->part_id, false);
+
+    req->complete(req, 0);
+
+    /* Free the request at the last point of the completion path */
+    ocf_req_put(req);
+}
+
+static bool _ocf_read_fast_lockless(struct ocf_request* req) {
+    struct ocf_cache* cache = req->cache;
+    struct ocf_alock* c = ocf_cache_line_concurrency(cache);
+    ocf_cache_line_t line;
+    uint32_t i;
+
+    if (!ocf_hb_req_seq_read_begin(req, &req->hb_seq))
+        return false;
+
+    ocf_engine_lookup(req);
+
+    if (!ocf_engine_is_hit(req) || ocf_engine_needs_repart(req))
+        return false;
+
+    if (!ocf_user_part_has_space(req))
+        return false;
+
+    for (i = 0; i < req->core_line_count; i++) {
+        line = req->map[i].coll_idx;
+
+        /* Data of write locked line may not be in cache yet */
+        if (ocf_cache_line_is_locked_wr(c, line))
+            return false;
+
+        /* Leave LRU update to locked path, only hot lines go lockless */
+        if (!ocf_metadata_get_lru(cache, line)->hot)
+            return false;
+    }
+
+    if (ocf_hb_req_seq_read_retry(req, req->hb_seq))
+        return false;
+
+    ocf_io_start(&req->ioi.io);
+
+    /* Get OCF request - increase reference counter */
+    ocf_req_get(req);
+
+    OCF_DEBUG_RQ(req, "Lockless submit");
+    env_atomic_set(&req->req_remaining, ocf_engine_io_count(req));
+    ocf_submit_cache_reqs(cache, req, OCF_READ, 0, req->byte_length,
+                          ocf_engine_io_count(req),
+                          _ocf_read_fast_lockless_complete);
+
+    /* Put OCF request - decrease reference counter */
+    ocf_req_put(req);
+
+    return true;
+}
+
 int ocf_read_fast(struct ocf_request* req) {
     bool hit;
     int lock = OCF_LOCK_NOT_ACQUIRED;
@@ -111,9 +247,16 @@ int ocf_read_fast(struct ocf_request* req) {
     /* Set resume io_if */
     req->io_if = &_io_if_read_fast_resume;
 
-    /*- Metadata RD access -----------------------------------------------*/
     /* Calculate hashes for hash-based mappings */
     ocf_req_hash(req);
+
+    if (_ocf_read_fast_lockless(req)) {
+        /* Put OCF request - decrease reference counter */
+        ocf_req_put(req);
+        return OCF_FAST_PATH_YES;
+    }
+
+    /*- Metadata RD access -----------------------------------------------*/
     // get metadata lock
     ocf_hb_req_prot_lock_rd(req);
 
@@ -103,11 +103,14 @@ static void _ocf_read_generic_miss_complete(struct ocf_request* req, int error)
             return;
         }
 
+        ocf_core_update_miss_latency(req->core, env_ticks_to_nsecs(
+                env_get_tick_count() - req->core_submit_tick) / 1000);
+
         /* Copy pages to copy vec, since this is the one needed
          * by the above layer
          */
-        ctx_data_cpy(cache->owner, req->cp_data, req->data, 0, 0,
-                     req->byte_length);
+        ctx_data_cpy(cache->owner, req->cp_data, req->data, 0,
+                     req->offset, req->byte_length);
 
         /* Complete request */
         req->complete(req, req->error);
@@ -139,6 +142,7 @@ static inline void _ocf_read_generic_submit_miss(struct ocf_request* req) {
         goto err_alloc;
 
     /* Submit read request to core device. */
+    req->core_submit_tick = env_get_tick_count();
     ocf_submit_volume_req(&req->core->volume, req,
                           _ocf_read_generic_miss_complete);
 
@@ -226,6 +230,19 @@ static const struct ocf_engine_callbacks _rd_engine_callbacks =
         .resume = ocf_engine_on_resume,
 };
 
+/* Checks whether all lines of request are mapped */
+static bool _ocf_read_generic_is_hit(struct ocf_request* req) {
+    bool hit;
+
+    ocf_req_hash(req);
+    ocf_hb_req_prot_lock_rd(req);
+    ocf_engine_lookup(req);
+    hit = ocf_engine_is_hit(req);
+    ocf_hb_req_prot_unlock_rd(req);
+
+    return hit;
+}
+
 int ocf_read_generic(struct ocf_request* req) {
     print_test();
 
@@ -254,8 +271,10 @@ int ocf_read_generic(struct ocf_request* req) {
         // ocf_history_hash_print_stats();
     }
 
-    /* 如果请求不允许二次准入，则直接使用PT模式 */
-    if (!req->allow_second_admission) {
+    /* 如果请求不允许二次准入，则直接使用PT模式。拆分请求的子请求不经过
+     * fast path，全部命中的子请求照常从缓存读取 */
+    if (!req->allow_second_admission &&
+        !(req->split.parent && _ocf_read_generic_is_hit(req))) {
         OCF_DEBUG_IO("PT, Second admission denied", req);
 
         ocf_req_clear(req);
@@ -0,0 +1,247 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_queue_priv.h"
+#include "../ocf_request.h"
+#include "../utils/utils_cache_line.h"
+#include "cache_engine.h"
+#include "engine_common.h"
+#include "engine_split.h"
+
+#define OCF_ENGINE_DEBUG_IO_NAME "split"
+#include "engine_debug.h"
+
+/*
+ * Requests larger than configured split size are divided into child
+ * requests aligned to multiples of split size (rounded up to cache line
+ * size). Children share data buffer of the parent, each at its own offset.
+ * At most OCF_ENGINE_SPLIT_MAX_IN_FLIGHT children are allocated at a time -
+ * the first ones are pushed to consecutive I/O queues of the cache, so one
+ * large request is handled by several queue threads, and each completing
+ * child submits the next part of the request on its own queue. Parent
+ * completes when the last part completes.
+ */
+
+#define OCF_ENGINE_SPLIT_MAX_IN_FLIGHT 8
+
+bool ocf_engine_split_needed(struct ocf_request *req)
+{
+	uint32_t split_io_size = req->cache->split_io_size;
+
+	if (split_io_size == OCF_CACHE_SPLIT_IO_INACTIVE)
+		return false;
+
+	if (req->d2c)
+		return false;
+
+	return req->byte_length > split_io_size;
+}
+
+/*
+ * Returns next I/O queue after q with reference taken
+ */
+static ocf_queue_t _ocf_split_next_queue(ocf_cache_t cache, ocf_queue_t q)
+{
+	struct list_head *iter = &q->list;
+	unsigned long lock_flags = 0;
+
+	env_spinlock_lock_irqsave(&cache->io_queues_lock, lock_flags);
+
+	/* Queue being destroyed has no references left - skip it. Loop ends
+	 * at the latest on q, which is referenced by the caller. */
+	do {
+		iter = iter->next;
+		if (iter == &cache->io_queues)
+			continue;
+
+		q = list_entry(iter, struct ocf_queue, list);
+	} while (iter == &cache->io_queues || q == cache->mngt_queue ||
+			!env_atomic_add_unless(&q->ref_count, 1, 0));
+
+	env_spinlock_unlock_irqrestore(&cache->io_queues_lock, lock_flags);
+
+	return q;
+}
+
+static void _ocf_split_child_complete(struct ocf_request *child, int error);
+
+static struct ocf_request *_ocf_split_child_new(struct ocf_request *req,
+		ocf_queue_t q, uint32_t idx)
+{
+	uint64_t split_size = req->split.size;
+	uint64_t addr = (req->byte_position / split_size + idx) * split_size;
+	uint64_t end = OCF_MIN(req->byte_position + req->byte_length,
+			addr + split_size);
+	struct ocf_request *child;
+
+	addr = OCF_MAX(addr, req->byte_position);
+
+	child = ocf_req_new(q, req->core, addr, end - addr, req->rw);
+	if (!child)
+		return NULL;
+
+	/* Cache is being detached */
+	if (child->d2c || ocf_req_alloc_map(child)) {
+		ocf_req_put(child);
+		return NULL;
+	}
+
+	child->split.parent = req;
+	child->data = req->data;
+	child->offset = req->offset + (addr - req->byte_position);
+	child->part_id = req->part_id;
+	child->cache_mode = req->cache_mode;
+	child->seq_cutoff = req->seq_cutoff;
+	child->force_pt = req->force_pt;
+	child->allow_second_admission = req->allow_second_admission;
+	child->ioi.io.io_class = req->ioi.io.io_class;
+	child->ioi.io.flags = req->ioi.io.flags;
+	child->io_if = ocf_get_io_if(child->cache_mode);
+	child->complete = _ocf_split_child_complete;
+
+	return child;
+}
+
+static void _ocf_split_child_submit(struct ocf_request *child)
+{
+	/* Reference released by the engine on completion */
+	ocf_req_get(child);
+
+	/* Do not process children synchronously, so they can run on
+	 * their queues in parallel */
+	ocf_engine_push_req_back(child, false);
+}
+
+static void _ocf_split_part_complete(struct ocf_request *req, int error)
+{
+	/* Keep the first error */
+	if (error)
+		env_atomic_cmpxchg(&req->split.error, 0, error);
+
+	if (env_atomic_dec_return(&req->split.remaining))
+		return;
+
+	OCF_DEBUG_RQ(req, "Completion");
+
+	req->complete(req, env_atomic_read(&req->split.error));
+}
+
+/*
+ * Submits next part of the request on queue q. Caller has to hold part
+ * of the request which is not completed yet, so request can't complete
+ * in here.
+ */
+static void _ocf_split_continue(struct ocf_request *req, ocf_queue_t q)
+{
+	struct ocf_request *child;
+	uint32_t idx;
+
+	while (true) {
+		idx = env_atomic_inc_return(&req->split.next) - 1;
+		if (idx >= req->split.count)
+			return;
+
+		/* Don't bother submitting the rest of failed request */
+		if (env_atomic_read(&req->split.error)) {
+			_ocf_split_part_complete(req, 0);
+			continue;
+		}
+
+		child = _ocf_split_child_new(req, q, idx);
+		if (child) {
+			_ocf_split_child_submit(child);
+			return;
+		}
+
+		_ocf_split_part_complete(req, -OCF_ERR_NO_MEM);
+	}
+}
+
+static void _ocf_split_child_complete(struct ocf_request *child, int error)
+{
+	struct ocf_request *parent = child->split.parent;
+
+	OCF_DEBUG_RQ(child, "Completion");
+
+	if (error)
+		env_atomic_cmpxchg(&parent->split.error, 0, error);
+
+	/* Child queue is referenced by the child until it is put */
+	_ocf_split_continue(parent, child->io_queue);
+
+	/* Release reference taken at child allocation */
+	ocf_req_put(child);
+
+	_ocf_split_part_complete(parent, 0);
+}
+
+int ocf_engine_prepare_split_req(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	uint64_t line_size = ocf_line_size(cache);
+	uint64_t split_size = OCF_DIV_ROUND_UP(cache->split_io_size,
+			line_size) * line_size;
+	uint64_t end = req->byte_position + req->byte_length;
+	struct ocf_request *child, *tmp;
+	ocf_queue_t q = req->io_queue, next;
+	uint32_t idx, window;
+
+	req->split.size = split_size;
+	req->split.count = (end - 1) / split_size -
+			req->byte_position / split_size + 1;
+	window = OCF_MIN(req->split.count, OCF_ENGINE_SPLIT_MAX_IN_FLIGHT);
+
+	INIT_LIST_HEAD(&req->split.children);
+
+	ocf_queue_get(q);
+
+	/* Allocate first children in advance, so request is either split
+	 * or handled as a whole */
+	for (idx = 0; idx < window; idx++) {
+		child = _ocf_split_child_new(req, q, idx);
+		if (!child)
+			goto err;
+
+		list_add_tail(&child->list, &req->split.children);
+
+		next = _ocf_split_next_queue(cache, q);
+		ocf_queue_put(q);
+		q = next;
+	}
+
+	ocf_queue_put(q);
+
+	OCF_DEBUG_RQ(req, "Split into %u requests", req->split.count);
+
+	env_atomic_set(&req->split.error, 0);
+	env_atomic_set(&req->split.remaining, req->split.count);
+	env_atomic_set(&req->split.next, window);
+
+	return 0;
+
+err:
+	ocf_queue_put(q);
+
+	list_for_each_entry_safe(child, tmp, &req->split.children, list) {
+		list_del(&child->list);
+		ocf_req_put(child);
+	}
+
+	return -OCF_ERR_NO_MEM;
+}
+
+void ocf_engine_submit_split_req(struct ocf_request *req)
+{
+	struct ocf_request *child, *tmp;
+
+	list_for_each_entry_safe(child, tmp, &req->split.children, list) {
+		list_del(&child->list);
+		/* Admission is decided after first children are allocated */
+		child->allow_second_admission = req->allow_second_admission;
+		_ocf_split_child_submit(child);
+	}
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __ENGINE_SPLIT_H__
+#define __ENGINE_SPLIT_H__
+
+/**
+ * @brief Check whether request is large enough to be split
+ *
+ * @param req OCF request
+ *
+ * @retval true request should be handled by ocf_engine_prepare_split_req()
+ * @retval false request is handled as a whole
+ */
+bool ocf_engine_split_needed(struct ocf_request *req);
+
+/**
+ * @brief Split request into line aligned child requests
+ *
+ * First child requests are allocated and assigned to consecutive I/O queues
+ * of the cache. The rest is allocated as the first ones complete.
+ *
+ * @note Effective cache mode of request must be already resolved. Second
+ *	admission of request may be decided after request has been split.
+ *
+ * @param req OCF request
+ *
+ * @retval 0 request has been split, ocf_engine_submit_split_req() has
+ *	to be called to start it
+ * @retval Non-zero request could not be split, it has to be handled
+ *	as a whole
+ */
+int ocf_engine_prepare_split_req(struct ocf_request *req);
+
+/**
+ * @brief Submit child requests of split request
+ *
+ * Child requests are handled in parallel. Request is completed once all
+ * of its parts complete. Children take second admission decision of
+ * the request.
+ *
+ * @param req OCF request prepared by ocf_engine_prepare_split_req()
+ */
+void ocf_engine_submit_split_req(struct ocf_request *req);
+
+#endif /* __ENGINE_SPLIT_H__ */
@@ -9,6 +9,7 @@
 #include "engine_common.h"
 #include "engine_wb.h"
 #include "engine_inv.h"
+#include "engine_coalesce.h"
 #include "../metadata/metadata.h"
 #include "../ocf_request.h"
 #include "../utils/utils_io.h"
@@ -158,8 +159,12 @@ int ocf_write_wb_do(struct ocf_request *req)
 	_ocf_write_wb_submit(req);
 
 	/* Update statistics */
-	ocf_engine_update_request_stats(req);
-	ocf_engine_update_block_stats(req);
+	if (ocf_engine_coalesced(req)) {
+		ocf_engine_coalesce_update_stats(req);
+	} else {
+		ocf_engine_update_request_stats(req);
+		ocf_engine_update_block_stats(req);
+	}
 
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
@@ -139,6 +139,11 @@ static void _ocf_write_wi_core_complete(struct ocf_request *req, int error)
 	}
 }
 
+static void _ocf_write_wi_core_zeroes_complete(void *priv, int error)
+{
+	_ocf_write_wi_core_complete(priv, error);
+}
+
 static int _ocf_write_wi_core_write(struct ocf_request *req)
 {
 	/* Get OCF request - increase reference counter */
@@ -148,9 +153,17 @@ static int _ocf_write_wi_core_write(struct ocf_request *req)
 
 	OCF_DEBUG_RQ(req, "Submit");
 
-	/* Submit write IO to the core */
-	ocf_submit_volume_req(&req->core->volume, req,
-			   _ocf_write_wi_core_complete);
+	if (req->write_zeroes &&
+			ocf_volume_has_write_zeroes(&req->core->volume)) {
+		/* Data is zero-filled, there is no need to transfer it */
+		ocf_submit_write_zeros(&req->core->volume, req->byte_position,
+				req->byte_length,
+				_ocf_write_wi_core_zeroes_complete, req);
+	} else {
+		/* Submit write IO to the core */
+		ocf_submit_volume_req(&req->core->volume, req,
+				   _ocf_write_wi_core_complete);
+	}
 
 	/* Update statistics */
 	ocf_engine_update_block_stats(req);
@@ -5,6 +5,7 @@
 
 #include "ocf/ocf.h"
 #include "../ocf_cache_priv.h"
+#include "../ocf_ctx_priv.h"
 #include "engine_zero.h"
 #include "engine_common.h"
 #include "../concurrency/ocf_concurrency.h"
@@ -166,3 +167,48 @@ void ocf_engine_zero_line(struct ocf_request *req)
 	}
 }
 
+
+static bool _ocf_engine_is_zero_write(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+
+	if (!cache->zero_detection || !ctx_data_has_is_zero(cache->owner))
+		return false;
+
+	if (req->rw != OCF_WRITE || !req->data || !req->byte_length)
+		return false;
+
+	if (req->cache_mode == ocf_req_cache_mode_d2c)
+		return false;
+
+	/* Flags must be propagated to core volume as they are */
+	if (req->ioi.io.flags)
+		return false;
+
+	return ctx_data_is_zero(cache->owner, req->data, req->offset,
+			req->byte_length);
+}
+
+/**
+ * @brief Redirect zero-filled write to write-invalidate engine
+ *
+ * Zero-filled data is not worth cache space. Such write goes directly
+ * to the core (as write zeroes when core volume supports it) and cache
+ * lines it touches are invalidated. Result of the data check is kept in
+ * request, so write detected in fast path is not checked again.
+ *
+ * @retval true request has been redirected
+ */
+bool ocf_engine_zero_write_detect(struct ocf_request *req)
+{
+	if (!req->write_zeroes && !_ocf_engine_is_zero_write(req))
+		return false;
+
+	OCF_DEBUG_RQ(req, "Zero-filled write");
+
+	req->write_zeroes = true;
+	req->cache_mode = ocf_req_cache_mode_wi;
+	req->io_if = ocf_get_io_if(req->cache_mode);
+
+	return true;
+}
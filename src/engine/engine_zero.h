@@ -8,4 +8,6 @@
 
 void ocf_engine_zero_line(struct ocf_request *req);
 
+bool ocf_engine_zero_write_detect(struct ocf_request *req);
+
 #endif /* ENGINE_ZERO_H_ */
@@ -10,6 +10,7 @@
 #include "metadata_segment_id.h"
 #include "metadata_internal.h"
 #include "metadata_io.h"
+#include "metadata_journal.h"
 #include "metadata_raw.h"
 #include "metadata_segment.h"
 #include "../concurrency/ocf_concurrency.h"
@@ -104,6 +105,9 @@ static ocf_cache_line_t ocf_metadata_get_entries(
 	case metadata_segment_core_uuid:
 		return OCF_CORE_MAX;
 
+	case metadata_segment_journal:
+		return OCF_METADATA_JOURNAL_PAGES;
+
 	default:
 		break;
 	}
@@ -177,6 +181,10 @@ static int64_t ocf_metadata_get_element_size(
 		size = sizeof(struct ocf_metadata_uuid);
 		break;
 
+	case metadata_segment_journal:
+		size = PAGE_SIZE;
+		break;
+
 	default:
 		break;
 
@@ -204,6 +212,7 @@ static bool ocf_metadata_is_flapped(
 	case metadata_segment_reserved:
 	case metadata_segment_part_runtime:
 	case metadata_segment_core_runtime:
+	case metadata_segment_journal:
 	case metadata_segment_cleaning:
 	case metadata_segment_lru:
 	case metadata_segment_collision:
@@ -363,6 +372,7 @@ const char * const ocf_metadata_segment_names[] = {
 		[metadata_segment_core_config]		= "Core config",
 		[metadata_segment_core_runtime]		= "Core runtime",
 		[metadata_segment_core_uuid]		= "Core UUID",
+		[metadata_segment_journal]		= "Journal",
 };
 #if 1 == OCF_METADATA_DEBUG
 /*
@@ -435,6 +445,10 @@ void ocf_metadata_deinit_variable_size(struct ocf_cache *cache)
 
 	ocf_metadata_concurrency_attached_deinit(&cache->metadata.lock);
 
+	ocf_metadata_dirty_index_deinit(cache);
+
+	ocf_metadata_journal_deinit(cache);
+
 	/*
 	 * De initialize RAW types
 	 */
@@ -803,6 +817,22 @@ finalize:
 	cache->conf_meta->cachelines = ctrl->cachelines;
 	cache->conf_meta->line_size = cache_line_size;
 
+	result = ocf_metadata_dirty_index_init(cache);
+	if (result) {
+		ocf_cache_log(cache, log_err, "Failed to allocate dirty "
+				"cache lines index\n");
+		ocf_metadata_deinit_variable_size(cache);
+		return result;
+	}
+
+	result = ocf_metadata_journal_init(cache);
+	if (result) {
+		ocf_cache_log(cache, log_err, "Failed to initialize metadata "
+				"journal\n");
+		ocf_metadata_deinit_variable_size(cache);
+		return result;
+	}
+
 	ocf_metadata_raw_info(cache, ctrl);
 
 	ocf_cache_log(cache, log_info, "Cache line size: %llu kiB\n",
@@ -1002,8 +1032,10 @@ struct ocf_pipeline_properties ocf_metadata_flush_all_pipeline_props = {
 	.steps = {
 		OCF_PL_STEP_ARG_INT(ocf_metadata_flush_all_set_status,
 				ocf_metadata_dirty_shutdown),
+		OCF_PL_STEP(ocf_metadata_journal_flush_begin),
 		OCF_PL_STEP_FOREACH(ocf_metadata_flush_segment,
 				ocf_metadata_flush_all_args),
+		OCF_PL_STEP(ocf_metadata_journal_flush_end),
 		OCF_PL_STEP_FOREACH(ocf_metadata_calculate_crc,
 				ocf_metadata_flush_all_args),
 		OCF_PL_STEP_ARG_INT(ocf_metadata_flush_all_set_status,
@@ -1040,21 +1072,57 @@ void ocf_metadata_flush_all(ocf_cache_t cache,
 	ocf_pipeline_next(pipeline);
 }
 
+static void ocf_metadata_flush_collision_finish(ocf_pipeline_t pipeline,
+		void *priv, int error)
+{
+	struct ocf_metadata_context *context = priv;
+
+	context->cmpl(context->priv, error);
+	ocf_pipeline_destroy(pipeline);
+}
+
+/*
+ * Journal records appended before the flush would bring back old state
+ * of cache lines on recovery, so they are marked obsolete as well
+ */
+struct ocf_pipeline_properties ocf_metadata_flush_collision_pipeline_props = {
+	.priv_size = sizeof(struct ocf_metadata_context),
+	.finish = ocf_metadata_flush_collision_finish,
+	.steps = {
+		OCF_PL_STEP(ocf_metadata_journal_flush_begin),
+		OCF_PL_STEP_ARG_INT(ocf_metadata_flush_segment,
+				metadata_segment_collision),
+		OCF_PL_STEP(ocf_metadata_journal_flush_end),
+		OCF_PL_STEP_TERMINATOR(),
+	},
+};
+
 /*
  * Flush collision metadata
  */
 void ocf_metadata_flush_collision(ocf_cache_t cache,
 		ocf_metadata_end_t cmpl, void *priv)
 {
-	struct ocf_metadata_ctrl *ctrl;
-	struct ocf_metadata_raw *raw;
+	struct ocf_metadata_context *context;
+	ocf_pipeline_t pipeline;
+	int result;
 
 	OCF_DEBUG_TRACE(cache);
 
-	ctrl = cache->metadata.priv;
-	raw = &ctrl->raw_desc[metadata_segment_collision];
+	result = ocf_pipeline_create(&pipeline, cache,
+			&ocf_metadata_flush_collision_pipeline_props);
+	if (result)
+		OCF_CMPL_RET(priv, result);
+
+	context = ocf_pipeline_get_priv(pipeline);
+
+	context->cmpl = cmpl;
+	context->priv = priv;
+	context->pipeline = pipeline;
+	context->cache = cache;
+	context->ctrl = cache->metadata.priv;
 
-	ocf_metadata_raw_flush_all(cache, raw, cmpl, priv, 0);
+	ocf_pipeline_next(pipeline);
 }
 
 /*
@@ -1101,9 +1169,13 @@ void ocf_metadata_flush_do_asynch(struct ocf_cache *cache,
 
 	env_atomic_inc(&req->req_remaining); /* Core device IO */
 
-	result |= ocf_metadata_raw_flush_do_asynch(cache, req,
-			&(ctrl->raw_desc[metadata_segment_collision]),
-			complete);
+	if (ocf_metadata_journal_active(cache)) {
+		result |= ocf_metadata_journal_append(cache, req, complete);
+	} else {
+		result |= ocf_metadata_raw_flush_do_asynch(cache, req,
+				&(ctrl->raw_desc[metadata_segment_collision]),
+				complete);
+	}
 
 	if (result) {
 		ocf_metadata_error(cache);
@@ -1123,6 +1195,10 @@ static void ocf_metadata_load_all_finish(ocf_pipeline_t pipeline,
 		goto out;
 	}
 
+	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
+	ocf_metadata_dirty_index_rebuild(cache);
+	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
+
 	ocf_cache_log(cache, log_info, "Done loading cache state\n");
 
 out:
@@ -1281,6 +1357,8 @@ static void _recovery_rebuild_metadata(ocf_pipeline_t pipeline,
 		OCF_COND_RESCHED(step, 128);
 	}
 
+	ocf_metadata_dirty_index_rebuild(cache);
+
 	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
 
 	ocf_pipeline_next(pipeline);
@@ -1313,6 +1391,9 @@ ocf_metadata_load_recovery_legacy_pl_props = {
 	.steps = {
 		OCF_PL_STEP_ARG_INT(ocf_metadata_load_segment,
 				metadata_segment_collision),
+		OCF_PL_STEP_ARG_INT(ocf_metadata_load_segment,
+				metadata_segment_journal),
+		OCF_PL_STEP(ocf_metadata_journal_replay),
 		OCF_PL_STEP_ARG_INT(_recovery_rebuild_metadata, true),
 		OCF_PL_STEP_TERMINATOR(),
 	},
@@ -1562,6 +1643,10 @@ void ocf_metadata_set_hash(struct ocf_cache *cache, ocf_cache_line_t index,
  *  Bitmap status
  ******************************************************************************/
 
+/* Only dirty status is indexed */
+#define _ocf_metadata_index_dirty ocf_metadata_dirty_index_update
+#define _ocf_metadata_index_valid(cache, line, set)
+
 #include "metadata_bit.h"
 
 #define _ocf_metadata_funcs_5arg(what) \
@@ -1668,6 +1753,39 @@ void ocf_metadata_deinit(struct ocf_cache *cache)
 	ocf_metadata_concurrency_deinit(&cache->metadata.lock);
 }
 
+void *ocf_metadata_large_alloc(struct ocf_cache *cache, size_t size,
+		ocf_metadata_page_t *backing)
+{
+	int page = cache->metadata.page;
+	void *ptr;
+
+	ENV_BUILD_BUG_ON(ocf_metadata_page_thp != ENV_MEM_PAGE_THP);
+	ENV_BUILD_BUG_ON(ocf_metadata_page_2m != ENV_MEM_PAGE_2M);
+	ENV_BUILD_BUG_ON(ocf_metadata_page_1g != ENV_MEM_PAGE_1G);
+	ENV_BUILD_BUG_ON(OCF_NUMA_NODE_ANY != ENV_NUMA_NODE_ANY);
+	ENV_BUILD_BUG_ON(OCF_NUMA_INTERLEAVE != ENV_NUMA_INTERLEAVE);
+
+	ptr = env_large_zalloc(size, &page, cache->metadata.numa_node);
+	if (!ptr)
+		return NULL;
+
+	/* fallback to smaller pages is reported in cache info */
+	*backing = page;
+	env_atomic64_add(size, &cache->metadata.backing[page]);
+
+	return ptr;
+}
+
+void ocf_metadata_large_free(struct ocf_cache *cache, void *ptr, size_t size,
+		ocf_metadata_page_t backing)
+{
+	if (!ptr)
+		return;
+
+	env_large_free(ptr, size, backing);
+	env_atomic64_sub(size, &cache->metadata.backing[backing]);
+}
+
 void ocf_metadata_error(struct ocf_cache *cache)
 {
 	if (cache->device->metadata_error == 0)
@@ -18,6 +18,7 @@
 #include "metadata_collision.h"
 #include "metadata_core.h"
 #include "metadata_misc.h"
+#include "metadata_dirty_index.h"
 
 #define INVALID 0
 #define VALID 1
@@ -89,6 +90,30 @@ void ocf_metadata_deinit_variable_size(struct ocf_cache *cache);
  */
 size_t ocf_metadata_size_of(struct ocf_cache *cache);
 
+/**
+ * @brief Allocate zeroed memory for large metadata array
+ *
+ * Memory is backed and placed according to cache metadata configuration.
+ *
+ * @param cache - Cache instance
+ * @param size - Size in bytes
+ * @param[out] backing - Page backing actually used
+ * @return Allocated memory, NULL on failure
+ */
+void *ocf_metadata_large_alloc(struct ocf_cache *cache, size_t size,
+		ocf_metadata_page_t *backing);
+
+/**
+ * @brief Free memory allocated with ocf_metadata_large_alloc()
+ *
+ * @param cache - Cache instance
+ * @param ptr - Memory to be freed
+ * @param size - Size in bytes
+ * @param backing - Page backing returned on allocation
+ */
+void ocf_metadata_large_free(struct ocf_cache *cache, void *ptr, size_t size,
+		ocf_metadata_page_t backing);
+
 /**
  * @brief Handle metadata error
  *
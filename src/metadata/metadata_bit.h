@@ -120,6 +120,7 @@ static bool _ocf_metadata_clear_##what##_##type(struct ocf_cache *cache, \
 	_raw_bug_on(raw, line); \
 \
 	map[line].what &= ~mask; \
+	_ocf_metadata_index_##what(cache, line, !!map[line].what); \
 \
 	if (map[line].what) { \
 		return true; \
@@ -147,6 +148,7 @@ static bool _ocf_metadata_set_##what##_##type(struct ocf_cache *cache, \
 	result = map[line].what ? true : false; \
 \
 	map[line].what |= mask; \
+	_ocf_metadata_index_##what(cache, line, true); \
 \
 	return result; \
 } \
@@ -183,6 +185,7 @@ static bool _ocf_metadata_test_and_set_##what##_##type( \
 	} \
 \
 	map[line].what |= mask; \
+	_ocf_metadata_index_##what(cache, line, true); \
 	return test; \
 } \
 \
@@ -218,6 +221,7 @@ static bool _ocf_metadata_test_and_clear_##what##_##type( \
 	} \
 \
 	map[line].what &= ~mask; \
+	_ocf_metadata_index_##what(cache, line, !!map[line].what); \
 	return test; \
 } \
 
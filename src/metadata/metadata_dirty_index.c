@@ -0,0 +1,109 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "metadata.h"
+#include "../ocf_def_priv.h"
+
+/*
+ * Dirty index keeps one bit per cache line, set whenever any sector of the
+ * cache line is dirty, and one summary bit per word of cache line bits.
+ * Summary bit is set along with any cache line bit of its word, but it is
+ * cleared only by lookup which finds the word empty. This way lookup skips
+ * clean parts of the cache a word of words at a time, so that finding all
+ * dirty cache lines costs time proportional to the amount of dirty data
+ * rather than to the cache size.
+ */
+
+int ocf_metadata_dirty_index_init(struct ocf_cache *cache)
+{
+	struct ocf_metadata_dirty_index *index = &cache->metadata.dirty_index;
+	uint64_t entries = cache->device->collision_table_entries;
+
+	index->words = OCF_DIV_ROUND_UP(entries, OCF_METADATA_DIRTY_INDEX_BITS);
+	index->groups = OCF_DIV_ROUND_UP(index->words,
+			OCF_METADATA_DIRTY_INDEX_BITS);
+
+	index->lines = env_vzalloc(index->words * sizeof(*index->lines));
+	if (!index->lines)
+		return -OCF_ERR_NO_MEM;
+
+	index->summary = env_vzalloc(index->groups * sizeof(*index->summary));
+	if (!index->summary) {
+		env_vfree(index->lines);
+		index->lines = NULL;
+		return -OCF_ERR_NO_MEM;
+	}
+
+	return 0;
+}
+
+void ocf_metadata_dirty_index_deinit(struct ocf_cache *cache)
+{
+	struct ocf_metadata_dirty_index *index = &cache->metadata.dirty_index;
+
+	env_vfree(index->summary);
+	index->summary = NULL;
+	env_vfree(index->lines);
+	index->lines = NULL;
+}
+
+void ocf_metadata_dirty_index_rebuild(struct ocf_cache *cache)
+{
+	struct ocf_metadata_dirty_index *index = &cache->metadata.dirty_index;
+	ocf_cache_line_t line, entries = cache->device->collision_table_entries;
+	unsigned char step = 0;
+
+	env_memset(index->lines, index->words * sizeof(*index->lines), 0);
+	env_memset(index->summary, index->groups * sizeof(*index->summary), 0);
+
+	for (line = 0; line < entries; line++) {
+		if (metadata_test_dirty(cache, line))
+			ocf_metadata_dirty_index_update(cache, line, true);
+
+		OCF_COND_RESCHED_DEFAULT(step);
+	}
+}
+
+ocf_cache_line_t ocf_metadata_dirty_index_next(struct ocf_cache *cache,
+		ocf_cache_line_t line, ocf_cache_line_t end)
+{
+	struct ocf_metadata_dirty_index *index = &cache->metadata.dirty_index;
+	const uint64_t bits = OCF_METADATA_DIRTY_INDEX_BITS;
+	uint64_t pos = line, word;
+
+	while (pos < end) {
+		word = pos / bits;
+
+		if (!index->summary[word / bits]) {
+			/* No dirty cache lines in the whole group of words */
+			pos = (word / bits + 1) * bits * bits;
+			continue;
+		}
+
+		if (!env_bit_test(word, index->summary)) {
+			pos = (word + 1) * bits;
+			continue;
+		}
+
+		if (!index->lines[word]) {
+			/* Cache line of this word may have got dirty right
+			 * before summary was cleared - check again */
+			env_bit_clear(word, index->summary);
+			if (index->lines[word])
+				env_bit_set(word, index->summary);
+
+			pos = (word + 1) * bits;
+			continue;
+		}
+
+		if (env_bit_test(pos, index->lines))
+			return pos;
+
+		pos++;
+	}
+
+	return end;
+}
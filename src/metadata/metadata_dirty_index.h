@@ -0,0 +1,78 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __METADATA_DIRTY_INDEX_H__
+#define __METADATA_DIRTY_INDEX_H__
+
+#define OCF_METADATA_DIRTY_INDEX_BITS (sizeof(unsigned long) * 8)
+
+/**
+ * @brief Account change of cache line dirty status in dirty index
+ *
+ * @note Caller must hold cache line write lock or exclusive metadata access
+ *
+ * @param cache Cache instance
+ * @param line Cache line
+ * @param dirty true if any sector of the cache line is dirty
+ */
+static inline void ocf_metadata_dirty_index_update(struct ocf_cache *cache,
+		ocf_cache_line_t line, bool dirty)
+{
+	struct ocf_metadata_dirty_index *index = &cache->metadata.dirty_index;
+
+	if (dirty == env_bit_test(line, index->lines))
+		return;
+
+	if (dirty) {
+		env_bit_set(line, index->lines);
+		/* Summary bit goes after cache line bit, so that lazy clearing
+		 * of summary in ocf_metadata_dirty_index_next() can't lose it */
+		env_bit_set(line / OCF_METADATA_DIRTY_INDEX_BITS,
+				index->summary);
+	} else {
+		env_bit_clear(line, index->lines);
+	}
+}
+
+/**
+ * @brief Allocate dirty index for all cache lines of the cache
+ *
+ * @param cache Cache instance
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_metadata_dirty_index_init(struct ocf_cache *cache);
+
+/**
+ * @brief Free dirty index
+ *
+ * @param cache Cache instance
+ */
+void ocf_metadata_dirty_index_deinit(struct ocf_cache *cache);
+
+/**
+ * @brief Rebuild dirty index from cache line status bits, after they were
+ *	loaded from cache device
+ *
+ * @note Caller must hold exclusive metadata access
+ *
+ * @param cache Cache instance
+ */
+void ocf_metadata_dirty_index_rebuild(struct ocf_cache *cache);
+
+/**
+ * @brief Find next cache line having any dirty sector
+ *
+ * @param cache Cache instance
+ * @param line First cache line to check
+ * @param end Cache line past the last one to check
+ *
+ * @return First dirty cache line within <line, end), end if there is none
+ */
+ocf_cache_line_t ocf_metadata_dirty_index_next(struct ocf_cache *cache,
+		ocf_cache_line_t line, ocf_cache_line_t end);
+
+#endif /* __METADATA_DIRTY_INDEX_H__ */
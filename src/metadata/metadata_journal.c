@@ -0,0 +1,999 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "metadata.h"
+#include "metadata_internal.h"
+#include "metadata_io.h"
+#include "metadata_journal.h"
+#include "../ocf_def_priv.h"
+#include "../utils/utils_pipeline.h"
+
+/*
+ * Journal keeps dirty status changes of cache lines in a ring of pages
+ * following a header page. Instead of writing collision pages, request
+ * appends copies of collision entries of its cache lines to the open
+ * journal page. Open page is written as soon as no other page is being
+ * written or it is full, and request is completed once all pages up to
+ * the one holding its last record are written. This way concurrent
+ * requests share sequential journal writes rather than rewrite scattered
+ * collision pages one by one.
+ *
+ * Collision pages touched by records are written lazily by checkpoint,
+ * started once half of the journal is in use. Header write which follows
+ * marks records appended before the checkpoint as obsolete and lets their
+ * pages be reused. Metadata flush writes whole collision table, so it does
+ * the same for all records appended before it started. So does collision
+ * flush on core removal, which invalidates cache lines of the core without
+ * appending records.
+ *
+ * Recovery applies records newer than the checkpoint to collision table
+ * in order of their pages. All dirty status changes go through the
+ * journal, so the last record of cache line is never older than dirty
+ * status of its collision entry on cache device.
+ */
+
+#define OCF_METADATA_JOURNAL_MAGIC 0x314c4e524a46434fULL /* "OCFJRNL1" */
+
+/* Preallocated journal requests, allocated on demand once exhausted */
+#define OCF_METADATA_JOURNAL_REQS 1024
+
+struct ocf_metadata_journal_header {
+	uint64_t magic;
+	uint64_t checkpoint;
+	uint32_t record_size;
+	uint32_t crc;
+};
+
+struct ocf_metadata_journal_page {
+	uint64_t seq;
+	uint32_t count;
+	uint32_t crc;
+	uint8_t records[];
+};
+
+struct ocf_metadata_journal_record {
+	uint32_t line;
+	uint8_t entry[];
+};
+
+struct _journal_req {
+	struct ocf_request *req;
+	ocf_req_end_t complete;
+	uint64_t first_seq;
+	uint64_t last_seq;
+	uint32_t next;
+	int error;
+	struct list_head list;
+};
+
+/* Work gathered under journal lock, to be done after it is released */
+struct _journal_actions {
+	uint64_t submit_first;
+	uint64_t submit_end;
+	bool checkpoint;
+	struct list_head completed;
+};
+
+static inline struct ocf_metadata_raw *_journal_raw(ocf_cache_t cache,
+		enum ocf_metadata_segment_id segment)
+{
+	struct ocf_metadata_ctrl *ctrl = cache->metadata.priv;
+
+	return &ctrl->raw_desc[segment];
+}
+
+static inline struct ocf_metadata_journal_header *_journal_header(
+		ocf_cache_t cache)
+{
+	return _journal_raw(cache, metadata_segment_journal)->mem_pool;
+}
+
+static inline uint32_t _journal_slot(struct ocf_metadata_journal *journal,
+		uint64_t seq)
+{
+	return seq % journal->pages;
+}
+
+static inline struct ocf_metadata_journal_page *_journal_page(
+		ocf_cache_t cache, uint32_t slot)
+{
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_journal);
+
+	/* Header goes first */
+	return (void *)((uint8_t *)raw->mem_pool + (slot + 1) * PAGE_SIZE);
+}
+
+static inline struct ocf_metadata_journal_record *_journal_record(
+		struct ocf_metadata_journal *journal,
+		struct ocf_metadata_journal_page *page, uint32_t idx)
+{
+	return (void *)(page->records + idx * journal->record_size);
+}
+
+static uint32_t _journal_header_crc(struct ocf_metadata_journal_header *header)
+{
+	return env_crc32(0, (void *)header,
+			offsetof(struct ocf_metadata_journal_header, crc));
+}
+
+static void _journal_header_set(ocf_cache_t cache, uint64_t checkpoint)
+{
+	struct ocf_metadata_journal_header *header = _journal_header(cache);
+
+	header->magic = OCF_METADATA_JOURNAL_MAGIC;
+	header->checkpoint = checkpoint;
+	header->record_size = cache->metadata.journal.record_size;
+	header->crc = _journal_header_crc(header);
+}
+
+static void _journal_free(struct ocf_metadata_journal *journal)
+{
+	env_vfree(journal->reqs);
+	journal->reqs = NULL;
+	env_vfree(journal->dirty_pages);
+	journal->dirty_pages = NULL;
+	env_vfree(journal->checkpoint_pages);
+	journal->checkpoint_pages = NULL;
+	env_free(journal->done);
+	journal->done = NULL;
+	env_free(journal->queues);
+	journal->queues = NULL;
+}
+
+int ocf_metadata_journal_init(struct ocf_cache *cache)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_journal);
+	struct ocf_metadata_raw *collision =
+			_journal_raw(cache, metadata_segment_collision);
+	const uint64_t bits = sizeof(unsigned long) * 8;
+	struct _journal_req *jreq;
+	uint32_t i;
+
+	journal->record_size = OCF_DIV_ROUND_UP(
+			sizeof(struct ocf_metadata_journal_record) +
+			collision->entry_size, sizeof(uint64_t)) *
+			sizeof(uint64_t);
+	journal->records_per_page = (PAGE_SIZE -
+			sizeof(struct ocf_metadata_journal_page)) /
+			journal->record_size;
+	journal->pages = raw->entries - 1;
+
+	journal->active = journal->enabled &&
+			raw->raw_type == metadata_raw_type_ram &&
+			collision->raw_type == metadata_raw_type_ram;
+
+	INIT_LIST_HEAD(&journal->pending);
+	INIT_LIST_HEAD(&journal->waiting);
+	INIT_LIST_HEAD(&journal->free_reqs);
+	journal->flush = NULL;
+	journal->flush_writing = false;
+
+	if (journal->active) {
+		journal->page_words = OCF_DIV_ROUND_UP(collision->ssd_pages,
+				bits);
+		journal->dirty_pages = env_vzalloc(journal->page_words *
+				sizeof(unsigned long));
+		journal->checkpoint_pages = env_vzalloc(journal->page_words *
+				sizeof(unsigned long));
+		journal->done = env_zalloc(OCF_DIV_ROUND_UP(journal->pages,
+				bits) * sizeof(unsigned long), ENV_MEM_NORMAL);
+		journal->queues = env_zalloc(journal->pages *
+				sizeof(ocf_queue_t), ENV_MEM_NORMAL);
+		journal->reqs = env_vzalloc(OCF_METADATA_JOURNAL_REQS *
+				sizeof(struct _journal_req));
+
+		if (!journal->dirty_pages || !journal->checkpoint_pages ||
+				!journal->done || !journal->queues ||
+				!journal->reqs) {
+			_journal_free(journal);
+			journal->pages = 0;
+			return -OCF_ERR_NO_MEM;
+		}
+
+		for (i = 0; i < OCF_METADATA_JOURNAL_REQS; i++) {
+			jreq = &((struct _journal_req *)journal->reqs)[i];
+			list_add_tail(&jreq->list, &journal->free_reqs);
+		}
+	}
+
+	env_spinlock_init(&journal->lock);
+
+	ocf_metadata_journal_reset(cache);
+
+	if (journal->active) {
+		ocf_cache_log(cache, log_info, "Metadata journal: %u pages, "
+				"%u records per page\n", journal->pages,
+				journal->records_per_page);
+	}
+
+	return 0;
+}
+
+void ocf_metadata_journal_deinit(struct ocf_cache *cache)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+
+	/* Not initialized */
+	if (!journal->pages)
+		return;
+
+	ENV_BUG_ON(journal->in_flight);
+	ENV_BUG_ON(!list_empty(&journal->pending));
+	ENV_BUG_ON(!list_empty(&journal->waiting));
+
+	_journal_free(journal);
+	env_spinlock_destroy(&journal->lock);
+
+	journal->active = false;
+	journal->pages = 0;
+}
+
+void ocf_metadata_journal_reset(struct ocf_cache *cache)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_journal);
+
+	ENV_BUG_ON(journal->in_flight);
+
+	env_memset(raw->mem_pool, raw->mem_pool_limit, 0);
+
+	journal->head = 1;
+	journal->written = 1;
+	journal->checkpoint = 1;
+	journal->open = false;
+	journal->checkpoint_running = false;
+	journal->reset_pending = true;
+
+	_journal_header_set(cache, journal->checkpoint);
+
+	if (journal->active) {
+		env_memset(journal->dirty_pages, journal->page_words *
+				sizeof(unsigned long), 0);
+		env_memset(journal->checkpoint_pages, journal->page_words *
+				sizeof(unsigned long), 0);
+	}
+}
+
+/*******************************************************************************
+ * Appending records
+ ******************************************************************************/
+
+static inline bool _journal_can_open(struct ocf_metadata_journal *journal)
+{
+	/* Page is reused once it is written and its records are covered
+	 * by checkpoint on cache device */
+	return journal->head < OCF_MIN(journal->written,
+			journal->checkpoint) + journal->pages;
+}
+
+static void _journal_open(ocf_cache_t cache, ocf_queue_t queue)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	uint32_t slot = _journal_slot(journal, journal->head);
+	struct ocf_metadata_journal_page *page = _journal_page(cache, slot);
+
+	page->seq = journal->head;
+	page->count = 0;
+
+	env_bit_clear(slot, journal->done);
+	journal->queues[slot] = queue;
+
+	journal->head++;
+	journal->open = true;
+}
+
+static void _journal_close(struct ocf_metadata_journal *journal,
+		struct _journal_actions *actions)
+{
+	journal->open = false;
+	journal->in_flight++;
+
+	/* Pages are closed in order, so they make up a single range */
+	if (actions->submit_first == actions->submit_end)
+		actions->submit_first = journal->head - 1;
+	actions->submit_end = journal->head;
+}
+
+/*
+ * Returns false if request has to wait for free journal pages
+ */
+static bool _journal_append_locked(ocf_cache_t cache,
+		struct _journal_req *jreq, struct _journal_actions *actions)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *collision =
+			_journal_raw(cache, metadata_segment_collision);
+	struct ocf_request *req = jreq->req;
+	struct ocf_metadata_journal_page *page;
+	struct ocf_metadata_journal_record *record;
+	ocf_cache_line_t line;
+
+	for (; jreq->next < req->core_line_count; jreq->next++) {
+		if (!req->map[jreq->next].flush)
+			continue;
+
+		if (!journal->open) {
+			if (!_journal_can_open(journal))
+				return false;
+
+			_journal_open(cache, req->io_queue);
+		}
+
+		page = _journal_page(cache,
+				_journal_slot(journal, journal->head - 1));
+		line = req->map[jreq->next].coll_idx;
+
+		/* Cache line is locked by the request, so its entry can't
+		 * change until request is completed */
+		record = _journal_record(journal, page, page->count);
+		record->line = line;
+		env_memcpy(record->entry, collision->entry_size,
+				ocf_metadata_raw_rd_access(cache, collision,
+						line), collision->entry_size);
+
+		env_bit_set(ocf_metadata_raw_page(collision, line),
+				journal->dirty_pages);
+
+		if (!jreq->first_seq)
+			jreq->first_seq = journal->head - 1;
+		jreq->last_seq = journal->head - 1;
+
+		if (++page->count == journal->records_per_page)
+			_journal_close(journal, actions);
+	}
+
+	return true;
+}
+
+static void _journal_checkpoint_start_locked(
+		struct ocf_metadata_journal *journal,
+		struct _journal_actions *actions)
+{
+	unsigned long *pages;
+
+	if (journal->checkpoint_running)
+		return;
+
+	if (journal->head - journal->checkpoint < journal->pages / 2)
+		return;
+
+	/* Records of open page may still be followed by ones which are not
+	 * covered by this checkpoint */
+	journal->checkpoint_seq = journal->open ?
+			journal->head - 1 : journal->head;
+	journal->checkpoint_running = true;
+
+	pages = journal->checkpoint_pages;
+	journal->checkpoint_pages = journal->dirty_pages;
+	journal->dirty_pages = pages;
+
+	actions->checkpoint = true;
+}
+
+static void _journal_progress_locked(ocf_cache_t cache,
+		struct _journal_actions *actions)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct _journal_req *jreq, *tmp;
+
+	while (journal->written < journal->head &&
+			env_bit_test(_journal_slot(journal, journal->written),
+					journal->done)) {
+		journal->written++;
+	}
+
+	/* Requests are pending in order of their last records */
+	list_for_each_entry_safe(jreq, tmp, &journal->pending, list) {
+		if (jreq->last_seq >= journal->written)
+			break;
+		list_move_tail(&jreq->list, &actions->completed);
+	}
+
+	list_for_each_entry_safe(jreq, tmp, &journal->waiting, list) {
+		if (!_journal_append_locked(cache, jreq, actions))
+			break;
+		list_move_tail(&jreq->list, &journal->pending);
+	}
+
+	if (journal->open && !journal->in_flight)
+		_journal_close(journal, actions);
+
+	_journal_checkpoint_start_locked(journal, actions);
+}
+
+static void _journal_checkpoint(ocf_cache_t cache, ocf_queue_t queue);
+
+static int _journal_page_fill(ocf_cache_t cache, ctx_data_t *data,
+		uint32_t page, void *context)
+{
+	ctx_data_wr_check(cache->owner, data, context, PAGE_SIZE);
+
+	return 0;
+}
+
+static void _journal_page_complete(ocf_cache_t cache, void *context,
+		int error);
+
+static inline bool _journal_req_pooled(struct ocf_metadata_journal *journal,
+		struct _journal_req *jreq)
+{
+	struct _journal_req *reqs = journal->reqs;
+
+	return jreq >= reqs && jreq < reqs + OCF_METADATA_JOURNAL_REQS;
+}
+
+static struct _journal_req *_journal_req_get_locked(
+		struct ocf_metadata_journal *journal)
+{
+	struct _journal_req *jreq;
+
+	if (list_empty(&journal->free_reqs))
+		return NULL;
+
+	jreq = list_first_entry(&journal->free_reqs, struct _journal_req,
+			list);
+	list_del(&jreq->list);
+	env_memset(jreq, sizeof(*jreq), 0);
+
+	return jreq;
+}
+
+static void _journal_act(ocf_cache_t cache, struct _journal_actions *actions,
+		ocf_queue_t queue)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_journal);
+	struct ocf_metadata_journal_page *page;
+	struct _journal_req *jreq, *tmp;
+	unsigned long lock_flags = 0;
+	uint32_t slot;
+	uint64_t seq;
+	int result;
+
+	for (seq = actions->submit_first; seq < actions->submit_end; seq++) {
+		slot = _journal_slot(journal, seq);
+		page = _journal_page(cache, slot);
+
+		page->crc = env_crc32(0, page->records,
+				page->count * journal->record_size);
+
+		result = metadata_io_write_i_asynch(cache,
+				journal->queues[slot], page,
+				raw->ssd_pages_offset + 1 + slot, 1, 0,
+				_journal_page_fill, _journal_page_complete,
+				NULL);
+		if (result)
+			_journal_page_complete(cache, page, result);
+	}
+
+	if (actions->checkpoint)
+		_journal_checkpoint(cache, queue);
+
+	list_for_each_entry_safe(jreq, tmp, &actions->completed, list) {
+		jreq->req->error |= jreq->error;
+		jreq->complete(jreq->req, jreq->error);
+
+		if (!_journal_req_pooled(journal, jreq)) {
+			list_del(&jreq->list);
+			env_free(jreq);
+		}
+	}
+
+	if (list_empty(&actions->completed))
+		return;
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+	list_for_each_entry_safe(jreq, tmp, &actions->completed, list)
+		list_move_tail(&jreq->list, &journal->free_reqs);
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+}
+
+static inline void _journal_actions_init(struct _journal_actions *actions)
+{
+	actions->submit_first = actions->submit_end = 0;
+	actions->checkpoint = false;
+	INIT_LIST_HEAD(&actions->completed);
+}
+
+static void _journal_page_error_locked(struct ocf_metadata_journal *journal,
+		struct list_head *list, uint64_t seq, int error)
+{
+	struct _journal_req *jreq;
+
+	list_for_each_entry(jreq, list, list) {
+		if (jreq->first_seq && jreq->first_seq <= seq &&
+				seq <= jreq->last_seq) {
+			jreq->error = error;
+		}
+	}
+}
+
+static void _journal_page_complete(ocf_cache_t cache, void *context,
+		int error)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_journal_page *page = context;
+	uint32_t slot = _journal_slot(journal, page->seq);
+	struct _journal_actions actions;
+	unsigned long lock_flags = 0;
+
+	_journal_actions_init(&actions);
+
+	if (error)
+		ocf_metadata_error(cache);
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+
+	if (error) {
+		_journal_page_error_locked(journal, &journal->pending,
+				page->seq, error);
+		_journal_page_error_locked(journal, &journal->waiting,
+				page->seq, error);
+	}
+
+	env_bit_set(slot, journal->done);
+	journal->in_flight--;
+
+	_journal_progress_locked(cache, &actions);
+
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+	_journal_act(cache, &actions, journal->queues[slot]);
+}
+
+int ocf_metadata_journal_append(struct ocf_cache *cache,
+		struct ocf_request *req, ocf_req_end_t complete)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct _journal_actions actions;
+	struct _journal_req *jreq;
+	unsigned long lock_flags = 0;
+
+	ENV_BUG_ON(!complete);
+
+	if (!req->info.flush_metadata) {
+		/* Nothing to flush call flush callback */
+		complete(req, 0);
+		return 0;
+	}
+
+	_journal_actions_init(&actions);
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+
+	jreq = _journal_req_get_locked(journal);
+	if (!jreq) {
+		env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+		jreq = env_zalloc(sizeof(*jreq), ENV_MEM_NOIO);
+		if (!jreq) {
+			complete(req, -OCF_ERR_NO_MEM);
+			return -OCF_ERR_NO_MEM;
+		}
+
+		env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+	}
+
+	jreq->req = req;
+	jreq->complete = complete;
+
+	/* Requests waiting for free pages go first */
+	if (list_empty(&journal->waiting) &&
+			_journal_append_locked(cache, jreq, &actions)) {
+		list_add_tail(&jreq->list, &journal->pending);
+	} else {
+		list_add_tail(&jreq->list, &journal->waiting);
+	}
+
+	_journal_progress_locked(cache, &actions);
+
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+	_journal_act(cache, &actions, req->io_queue);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Checkpoint
+ ******************************************************************************/
+
+static void _journal_header_complete(ocf_cache_t cache, void *context,
+		int error);
+
+static int _journal_header_fill(ocf_cache_t cache, ctx_data_t *data,
+		uint32_t page, void *context)
+{
+	struct ocf_metadata_journal_header *header = context;
+
+	ctx_data_wr_check(cache->owner, data, header, sizeof(*header));
+	ctx_data_zero_check(cache->owner, data, PAGE_SIZE - sizeof(*header));
+
+	return 0;
+}
+
+static void _journal_header_write(ocf_cache_t cache, ocf_queue_t queue,
+		uint64_t checkpoint)
+{
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_journal);
+	struct ocf_metadata_journal_header *header = _journal_header(cache);
+	int result;
+
+	/* Header writes are serialized, so memory copy of header is not
+	 * modified until the write is completed */
+	_journal_header_set(cache, checkpoint);
+
+	result = metadata_io_write_i_asynch(cache, queue, header,
+			raw->ssd_pages_offset, 1, 0, _journal_header_fill,
+			_journal_header_complete, NULL);
+	if (result)
+		_journal_header_complete(cache, header, result);
+}
+
+static void _journal_header_complete(ocf_cache_t cache, void *context,
+		int error)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_journal_header *header = context;
+	struct ocf_metadata_context *flush = NULL;
+	struct _journal_actions actions;
+	unsigned long lock_flags = 0;
+	uint64_t checkpoint = 0;
+
+	_journal_actions_init(&actions);
+
+	if (error)
+		ocf_metadata_error(cache);
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+
+	if (!error)
+		journal->checkpoint = header->checkpoint;
+	journal->checkpoint_running = false;
+
+	if (journal->flush && journal->flush_writing) {
+		flush = journal->flush;
+		journal->flush = NULL;
+		journal->flush_writing = false;
+	} else if (journal->flush) {
+		/* Metadata flush has been waiting for checkpoint to finish */
+		checkpoint = OCF_MAX(journal->flush_seq, journal->checkpoint);
+		journal->flush_writing = true;
+		journal->checkpoint_running = true;
+	}
+
+	_journal_progress_locked(cache, &actions);
+
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+	if (checkpoint)
+		_journal_header_write(cache, cache->mngt_queue, checkpoint);
+
+	_journal_act(cache, &actions, journal->checkpoint_queue);
+
+	if (flush)
+		OCF_PL_NEXT_ON_SUCCESS_RET(flush->pipeline, error);
+}
+
+static void _journal_checkpoint_finish(ocf_cache_t cache)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	unsigned long lock_flags = 0;
+	uint64_t checkpoint = 0;
+	uint64_t i;
+
+	if (!journal->checkpoint_error) {
+		env_memset(journal->checkpoint_pages, journal->page_words *
+				sizeof(unsigned long), 0);
+		_journal_header_write(cache, journal->checkpoint_queue,
+				journal->checkpoint_seq);
+		return;
+	}
+
+	ocf_metadata_error(cache);
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+
+	/* Collision pages have to be written by next checkpoint */
+	for (i = 0; i < journal->page_words; i++) {
+		journal->dirty_pages[i] |= journal->checkpoint_pages[i];
+		journal->checkpoint_pages[i] = 0;
+	}
+
+	journal->checkpoint_running = false;
+
+	if (journal->flush) {
+		checkpoint = OCF_MAX(journal->flush_seq, journal->checkpoint);
+		journal->flush_writing = true;
+		journal->checkpoint_running = true;
+	}
+
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+	if (checkpoint)
+		_journal_header_write(cache, cache->mngt_queue, checkpoint);
+}
+
+static int _journal_collision_fill(ocf_cache_t cache, ctx_data_t *data,
+		uint32_t page, void *context)
+{
+	struct ocf_metadata_raw *raw = context;
+	uint32_t raw_page = page - raw->ssd_pages_offset;
+	uint32_t size = raw->entry_size * raw->entries_in_page;
+
+	raw->lock_page(cache, raw, raw_page);
+	ctx_data_wr_check(cache->owner, data, ocf_metadata_raw_rd_access(
+			cache, raw, raw_page * raw->entries_in_page), size);
+	raw->unlock_page(cache, raw, raw_page);
+
+	ctx_data_zero_check(cache->owner, data, PAGE_SIZE - size);
+
+	return 0;
+}
+
+static void _journal_checkpoint_io_complete(ocf_cache_t cache,
+		void *context, int error)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+
+	if (error)
+		journal->checkpoint_error = error;
+
+	if (env_atomic_dec_return(&journal->checkpoint_remaining))
+		return;
+
+	_journal_checkpoint_finish(cache);
+}
+
+static void _journal_checkpoint(ocf_cache_t cache, ocf_queue_t queue)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_collision);
+	const uint64_t bits = sizeof(unsigned long) * 8;
+	uint64_t page = 0, start;
+	int result;
+
+	journal->checkpoint_queue = queue;
+	journal->checkpoint_error = 0;
+	env_atomic_set(&journal->checkpoint_remaining, 1);
+
+	while (page < raw->ssd_pages) {
+		if (!journal->checkpoint_pages[page / bits]) {
+			page = (page / bits + 1) * bits;
+			continue;
+		}
+
+		if (!env_bit_test(page, journal->checkpoint_pages)) {
+			page++;
+			continue;
+		}
+
+		/* Write runs of adjacent pages at once */
+		start = page;
+		while (page < raw->ssd_pages &&
+				env_bit_test(page, journal->checkpoint_pages)) {
+			page++;
+		}
+
+		env_atomic_inc(&journal->checkpoint_remaining);
+
+		result = metadata_io_write_i_asynch(cache, queue, raw,
+				raw->ssd_pages_offset + start, page - start, 0,
+				_journal_collision_fill,
+				_journal_checkpoint_io_complete, raw->mio_conc);
+		if (result) {
+			env_atomic_dec(&journal->checkpoint_remaining);
+			journal->checkpoint_error = result;
+			break;
+		}
+	}
+
+	_journal_checkpoint_io_complete(cache, raw, 0);
+}
+
+/*******************************************************************************
+ * Metadata flush
+ ******************************************************************************/
+
+void ocf_metadata_journal_flush_begin(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_metadata_context *context = priv;
+	struct ocf_metadata_journal *journal = &context->cache->metadata.journal;
+	unsigned long lock_flags = 0;
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+	journal->flush_seq = journal->open ? journal->head - 1 : journal->head;
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+	ocf_pipeline_next(pipeline);
+}
+
+static void _journal_reset_complete(void *priv, int error)
+{
+	struct ocf_metadata_context *context = priv;
+
+	if (!error)
+		context->cache->metadata.journal.reset_pending = false;
+
+	OCF_PL_NEXT_ON_SUCCESS_RET(context->pipeline, error);
+}
+
+void ocf_metadata_journal_flush_end(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_metadata_context *context = priv;
+	ocf_cache_t cache = context->cache;
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *raw =
+			_journal_raw(cache, metadata_segment_journal);
+	unsigned long lock_flags = 0;
+	uint64_t checkpoint;
+
+	if (raw->raw_type != metadata_raw_type_ram)
+		OCF_PL_NEXT_RET(pipeline);
+
+	/* Records left on cache device by previous cache instance have to
+	 * be wiped out */
+	if (journal->reset_pending) {
+		ocf_metadata_raw_flush_all(cache, raw,
+				_journal_reset_complete, context, 0);
+		return;
+	}
+
+	env_spinlock_lock_irqsave(&journal->lock, lock_flags);
+
+	journal->flush = context;
+
+	if (journal->checkpoint_running) {
+		/* Header is written once checkpoint is finished */
+		env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+		return;
+	}
+
+	journal->flush_writing = true;
+	journal->checkpoint_running = true;
+	checkpoint = OCF_MAX(journal->flush_seq, journal->checkpoint);
+
+	env_spinlock_unlock_irqrestore(&journal->lock, lock_flags);
+
+	_journal_header_write(cache, cache->mngt_queue, checkpoint);
+}
+
+/*******************************************************************************
+ * Recovery
+ ******************************************************************************/
+
+struct _journal_replay_page {
+	uint64_t seq;
+	uint32_t slot;
+};
+
+static int _journal_replay_cmp(const void *item1, const void *item2)
+{
+	const struct _journal_replay_page *page1 = item1;
+	const struct _journal_replay_page *page2 = item2;
+
+	if (page1->seq > page2->seq)
+		return 1;
+
+	if (page1->seq < page2->seq)
+		return -1;
+
+	return 0;
+}
+
+static int _journal_replay(ocf_cache_t cache,
+		struct ocf_metadata_journal_header *header)
+{
+	struct ocf_metadata_journal *journal = &cache->metadata.journal;
+	struct ocf_metadata_raw *collision =
+			_journal_raw(cache, metadata_segment_collision);
+	struct _journal_replay_page *pages;
+	struct ocf_metadata_journal_page *page;
+	struct ocf_metadata_journal_record *record;
+	uint32_t slot, count = 0, i, j;
+	uint32_t records = 0;
+	int result = 0;
+
+	pages = env_vzalloc(journal->pages * sizeof(*pages));
+	if (!pages)
+		return -OCF_ERR_NO_MEM;
+
+	/* Page which was not written completely is skipped, as none of its
+	 * requests has been completed */
+	for (slot = 0; slot < journal->pages; slot++) {
+		page = _journal_page(cache, slot);
+
+		if (page->seq < header->checkpoint)
+			continue;
+
+		if (page->count > journal->records_per_page)
+			continue;
+
+		if (page->crc != env_crc32(0, page->records,
+				page->count * journal->record_size)) {
+			continue;
+		}
+
+		pages[count].seq = page->seq;
+		pages[count].slot = slot;
+		count++;
+	}
+
+	env_sort(pages, count, sizeof(*pages), _journal_replay_cmp, NULL);
+
+	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
+
+	for (i = 0; i < count && !result; i++) {
+		page = _journal_page(cache, pages[i].slot);
+
+		for (j = 0; j < page->count; j++) {
+			record = _journal_record(journal, page, j);
+			if (record->line >= collision->entries) {
+				result = -OCF_ERR_INVAL;
+				break;
+			}
+
+			env_memcpy(ocf_metadata_raw_wr_access(cache, collision,
+					record->line), collision->entry_size,
+					record->entry, collision->entry_size);
+			records++;
+		}
+	}
+
+	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
+
+	env_vfree(pages);
+
+	if (!result) {
+		ocf_cache_log(cache, log_info, "Replayed %u metadata "
+				"journal records from %u pages\n",
+				records, count);
+	}
+
+	return result;
+}
+
+void ocf_metadata_journal_replay(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_metadata_context *context = priv;
+	ocf_cache_t cache = context->cache;
+	struct ocf_metadata_journal_header *header = _journal_header(cache);
+	int result = 0;
+
+	/* Journal has never been written */
+	if (header->magic != OCF_METADATA_JOURNAL_MAGIC)
+		goto reset;
+
+	if (header->crc != _journal_header_crc(header) ||
+			header->record_size !=
+					cache->metadata.journal.record_size) {
+		ocf_cache_log(cache, log_err, "Invalid metadata journal "
+				"header\n");
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL);
+	}
+
+	result = _journal_replay(cache, header);
+	if (result) {
+		ocf_cache_log(cache, log_err, "Metadata journal replay "
+				"FAILURE\n");
+		OCF_PL_FINISH_RET(pipeline, result);
+	}
+
+reset:
+	ocf_metadata_journal_reset(cache);
+
+	ocf_pipeline_next(pipeline);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __METADATA_JOURNAL_H__
+#define __METADATA_JOURNAL_H__
+
+#include "../utils/utils_pipeline.h"
+
+/* Journal pages on cache device, including header page */
+#define OCF_METADATA_JOURNAL_PAGES 256
+
+static inline bool ocf_metadata_journal_active(struct ocf_cache *cache)
+{
+	return cache->metadata.journal.active;
+}
+
+/**
+ * @brief Initialize journal for attached cache device and reset it
+ *
+ * @note Journal is active only if it is enabled in cache configuration,
+ *	metadata is not volatile and collision is not kept in atomic metadata
+ *
+ * @param cache Cache instance
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error
+ */
+int ocf_metadata_journal_init(struct ocf_cache *cache);
+
+/**
+ * @brief Deinitialize journal
+ *
+ * @param cache Cache instance
+ */
+void ocf_metadata_journal_deinit(struct ocf_cache *cache);
+
+/**
+ * @brief Discard journal content in memory, so that whole journal is zeroed
+ *	by next metadata flush
+ *
+ * @note Caller must guarantee that no I/O is running
+ *
+ * @param cache Cache instance
+ */
+void ocf_metadata_journal_reset(struct ocf_cache *cache);
+
+/**
+ * @brief Append collision entries of cache lines marked for flush to
+ *	the journal
+ *
+ * @param cache Cache instance
+ * @param req Request
+ * @param complete Callback called once all records of the request are
+ *	written to cache device
+ *
+ * @retval 0 Success
+ * @retval Non-zero Error, complete has been called with error
+ */
+int ocf_metadata_journal_append(struct ocf_cache *cache,
+		struct ocf_request *req, ocf_req_end_t complete);
+
+/**
+ * @brief Metadata flush step - remember sequence number of records which
+ *	are going to be covered by the flush
+ */
+void ocf_metadata_journal_flush_begin(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg);
+
+/**
+ * @brief Metadata flush step - write journal header marking records
+ *	covered by the flush as obsolete, or zero whole journal after reset
+ */
+void ocf_metadata_journal_flush_end(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg);
+
+/**
+ * @brief Recovery step - apply records of loaded journal to collision
+ *	table and reset the journal
+ */
+void ocf_metadata_journal_replay(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg);
+
+#endif /* __METADATA_JOURNAL_H__ */
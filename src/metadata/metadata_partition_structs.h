@@ -26,6 +26,13 @@ struct ocf_user_part_config {
 	} flags;
 	int16_t priority;
 	ocf_cache_mode_t cache_mode;
+	uint8_t slru_protected_size;
+		/*!< Segmented LRU protected segment size in percent,
+		 * 0 if partition uses plain LRU */
+	uint8_t headroom_size;
+		/*!< Free space kept for partition in percent of cache size */
+	uint16_t ttl;
+		/*!< Cache line time to live in seconds, 0 if disabled */
 };
 
 struct ocf_part_runtime {
@@ -55,13 +62,19 @@ struct ocf_lru_iter
 	uint32_t num_avail_lrus;
 	/* current lru list index */
 	uint32_t lru_idx;
+	/* number of lru lists in use */
+	uint32_t num_lrus;
 	/* callback to determine whether given hash bucket is already
 	 * locked by the caller */
 	_lru_hash_locked_pfn hash_locked;
 	/* optional caller request */
 	struct ocf_request *req;
+	/* eviction telemetry of iterated partition, NULL for freelist */
+	struct ocf_lru_part_stats *stats;
 	/* 1 if iterating over clean lists, 0 if over dirty */
 	bool clean : 1;
+	/* 1 if starting list is drained before moving to other lists */
+	bool local : 1;
 };
 
 #define OCF_EVICTION_CLEAN_SIZE 32U
@@ -80,11 +93,25 @@ struct ocf_part {
 	ocf_part_id_t id;
 };
 
+/* Eviction telemetry, see struct ocf_stats_eviction */
+struct ocf_lru_part_stats {
+	env_atomic64 victims;
+	env_atomic64 iterations;
+	env_atomic64 hash_lock_fails;
+	env_atomic64 line_lock_fails;
+	env_atomic64 dirty_skipped;
+	env_atomic64 lock_contended;
+	env_atomic64 lock_wait_ticks;
+	env_atomic64 age[OCF_STATS_EVICTION_AGE_BUCKETS];
+	env_atomic64 hits[OCF_STATS_EVICTION_HITS_BUCKETS];
+};
+
 struct ocf_user_part {
 	struct ocf_user_part_config *config;
 	struct cleaning_policy *clean_pol;
 	struct ocf_part part;
 	struct ocf_part_cleaning_ctx cleaning;
+	struct ocf_lru_part_stats lru_stats;
 	struct ocf_lst_entry lst_valid;
 };
 
@@ -90,7 +90,14 @@ static int _raw_ram_deinit(ocf_cache_t cache,
 	OCF_DEBUG_TRACE(cache);
 
 	if (raw->mem_pool) {
-		env_secure_free(raw->mem_pool, raw->mem_pool_limit);
+		ENV_BUG_ON(raw->group_commit.open);
+		ENV_BUG_ON(raw->group_commit.in_flight);
+		env_free(raw->group_commit.spare);
+		raw->group_commit.spare = NULL;
+		env_spinlock_destroy(&raw->group_commit.lock);
+
+		ocf_metadata_large_free(cache, raw->mem_pool,
+				raw->mem_pool_limit, raw->mem_pool_backing);
 		raw->mem_pool = NULL;
 	}
 
@@ -124,16 +131,21 @@ static int _raw_ram_init(ocf_cache_t cache,
 	mem_pool_size = raw->ssd_pages;
 	mem_pool_size *= PAGE_SIZE;
 	raw->mem_pool_limit = mem_pool_size;
-	raw->mem_pool = env_secure_alloc(mem_pool_size);
+	raw->mem_pool = ocf_metadata_large_alloc(cache, mem_pool_size,
+			&raw->mem_pool_backing);
 	if (!raw->mem_pool) {
 		ocf_mio_concurrency_deinit(&raw->mio_conc);
 		return -OCF_ERR_NO_MEM;
 	}
-	ENV_BUG_ON(env_memset(raw->mem_pool, mem_pool_size, 0));
 
 	raw->lock_page = lock_page_pfn;
 	raw->unlock_page = unlock_page_pfn;
 
+	env_spinlock_init(&raw->group_commit.lock);
+	raw->group_commit.open = NULL;
+	raw->group_commit.in_flight = 0;
+	raw->group_commit.spare = NULL;
+
 	return 0;
 }
 
@@ -396,18 +408,13 @@ static void _raw_ram_flush_do_asynch_io_complete(ocf_cache_t cache,
 /*
  * RAM Implementation - Flush IO callback - Fill page
  */
-static int _raw_ram_flush_do_asynch_fill(ocf_cache_t cache,
-		ctx_data_t *data, uint32_t page, void *context)
+static int __raw_ram_flush_do_asynch_fill(ocf_cache_t cache,
+		ctx_data_t *data, uint32_t page, struct ocf_metadata_raw *raw)
 {
 	ocf_cache_line_t line;
 	uint32_t raw_page;
-	struct _raw_ram_flush_ctx *ctx = context;
-	struct ocf_metadata_raw *raw = NULL;
 	uint32_t size;
 
-	ENV_BUG_ON(!ctx);
-
-	raw = ctx->raw;
 	ENV_BUG_ON(!raw);
 
 	size = raw->entry_size * raw->entries_in_page;
@@ -429,6 +436,16 @@ static int _raw_ram_flush_do_asynch_fill(ocf_cache_t cache,
 	return 0;
 }
 
+static int _raw_ram_flush_do_asynch_fill(ocf_cache_t cache,
+		ctx_data_t *data, uint32_t page, void *context)
+{
+	struct _raw_ram_flush_ctx *ctx = context;
+
+	ENV_BUG_ON(!ctx);
+
+	return __raw_ram_flush_do_asynch_fill(cache, data, page, ctx->raw);
+}
+
 /*
  * RAM RAM Implementation - Do Flush
  */
@@ -465,17 +482,322 @@ static void __raw_ram_flush_do_asynch_add_pages(struct ocf_request *req,
 	*pages_to_flush = j;
 }
 
+/*
+ * Sort pages and write them, merging consecutive pages into single IO.
+ * Caller holds one reference on flush_req_cnt while IOs are submitted.
+ */
+static int __raw_ram_flush_do_asynch_write(ocf_cache_t cache,
+		ocf_queue_t queue, int flags, struct ocf_metadata_raw *raw,
+		uint32_t *pages_tab, int pages_to_flush, void *context,
+		env_atomic *flush_req_cnt, ocf_metadata_io_event_t fill_hndl,
+		ocf_metadata_io_end_t compl_hndl)
+{
+	int result = 0, i;
+	uint32_t start_page = 0;
+	uint32_t count = 0;
+
+	env_sort(pages_tab, pages_to_flush, sizeof(*pages_tab),
+			_raw_ram_flush_do_page_cmp, NULL);
+
+	i = 0;
+	while (i < pages_to_flush) {
+		start_page = pages_tab[i];
+		count = 1;
+
+		while (true) {
+			if ((i + 1) >= pages_to_flush)
+				break;
+
+			if (pages_tab[i] == pages_tab[i + 1]) {
+				i++;
+				continue;
+			}
+
+			if ((pages_tab[i] + 1) != pages_tab[i + 1])
+				break;
+
+			i++;
+			count++;
+		}
+
+		env_atomic_inc(flush_req_cnt);
+
+		result = metadata_io_write_i_asynch(cache, queue, context,
+				raw->ssd_pages_offset + start_page, count,
+				flags, fill_hndl, compl_hndl, raw->mio_conc);
+
+		if (result)
+			break;
+
+		i++;
+	}
+
+	return result;
+}
+
+/*
+ * RAM Implementation - Group commit
+ *
+ * Pages marked by requests are gathered in an open batch which is written
+ * as soon as no other batch is being written, it reaches its page limit or
+ * it has been open for longer than configured window. All requests of the
+ * batch are completed once all of its pages are written. One completed batch
+ * is kept as spare, so that opening a batch normally does not allocate.
+ */
+struct _raw_ram_commit_waiter {
+	struct ocf_request *req;
+	ocf_req_end_t complete;
+};
+
+struct _raw_ram_commit_batch {
+	struct ocf_metadata_raw *raw;
+	ocf_queue_t queue;
+	env_atomic flush_req_cnt;
+	int error;
+	uint64_t open_ts;
+	uint32_t pages_max;
+	uint32_t pages_count;
+	uint32_t waiters_count;
+	uint32_t *pages;
+	struct _raw_ram_commit_waiter waiters[];
+};
+
+static struct _raw_ram_commit_batch *_raw_ram_commit_alloc(
+		struct ocf_metadata_raw *raw, uint32_t pages_max)
+{
+	struct _raw_ram_commit_batch *batch;
+
+	/* Each request adds at least one page, so there are never more
+	 * waiters than pages */
+	batch = env_zalloc(sizeof(*batch) + pages_max * (sizeof(uint32_t) +
+			sizeof(struct _raw_ram_commit_waiter)), ENV_MEM_NOIO);
+	if (!batch)
+		return NULL;
+
+	batch->raw = raw;
+	batch->pages_max = pages_max;
+	batch->pages = (void *)&batch->waiters[pages_max];
+
+	return batch;
+}
+
+/*
+ * Returns batch to be freed by caller, NULL if it was kept as spare
+ */
+static struct _raw_ram_commit_batch *_raw_ram_commit_recycle(
+		ocf_cache_t cache, struct ocf_metadata_raw *raw,
+		struct _raw_ram_commit_batch *batch)
+{
+	unsigned long lock_flags = 0;
+
+	if (batch->pages_max != cache->metadata_group_commit.max_pages)
+		return batch;
+
+	batch->error = 0;
+	batch->pages_count = 0;
+	batch->waiters_count = 0;
+
+	env_spinlock_lock_irqsave(&raw->group_commit.lock, lock_flags);
+	if (!raw->group_commit.spare) {
+		raw->group_commit.spare = batch;
+		batch = NULL;
+	}
+	env_spinlock_unlock_irqrestore(&raw->group_commit.lock, lock_flags);
+
+	return batch;
+}
+
+static int _raw_ram_commit_fill(ocf_cache_t cache,
+		ctx_data_t *data, uint32_t page, void *context)
+{
+	struct _raw_ram_commit_batch *batch = context;
+
+	return __raw_ram_flush_do_asynch_fill(cache, data, page, batch->raw);
+}
+
+static void _raw_ram_commit_submit(ocf_cache_t cache,
+		struct _raw_ram_commit_batch *batch);
+
+static void _raw_ram_commit_complete(ocf_cache_t cache,
+		void *context, int error)
+{
+	struct _raw_ram_commit_batch *batch = context;
+	struct ocf_metadata_raw *raw = batch->raw;
+	struct _raw_ram_commit_batch *next = NULL;
+	struct _raw_ram_commit_waiter *waiter;
+	unsigned long lock_flags = 0;
+	uint32_t i;
+
+	if (error) {
+		batch->error = error;
+		ocf_metadata_error(cache);
+	}
+
+	if (env_atomic_dec_return(&batch->flush_req_cnt))
+		return;
+
+	OCF_DEBUG_PARAM(cache, "Group commit of %u requests complete",
+			batch->waiters_count);
+
+	env_spinlock_lock_irqsave(&raw->group_commit.lock, lock_flags);
+	raw->group_commit.in_flight--;
+	if (!raw->group_commit.in_flight && raw->group_commit.open) {
+		next = raw->group_commit.open;
+		raw->group_commit.open = NULL;
+		raw->group_commit.in_flight++;
+	}
+	env_spinlock_unlock_irqrestore(&raw->group_commit.lock, lock_flags);
+
+	for (i = 0; i < batch->waiters_count; i++) {
+		waiter = &batch->waiters[i];
+		waiter->req->error |= batch->error;
+		waiter->complete(waiter->req, batch->error);
+	}
+
+	env_free(_raw_ram_commit_recycle(cache, raw, batch));
+
+	if (next)
+		_raw_ram_commit_submit(cache, next);
+}
+
+static void _raw_ram_commit_submit(ocf_cache_t cache,
+		struct _raw_ram_commit_batch *batch)
+{
+	int result;
+
+	env_atomic_set(&batch->flush_req_cnt, 1);
+
+	result = __raw_ram_flush_do_asynch_write(cache, batch->queue, 0,
+			batch->raw, batch->pages, batch->pages_count, batch,
+			&batch->flush_req_cnt, _raw_ram_commit_fill,
+			_raw_ram_commit_complete);
+
+	_raw_ram_commit_complete(cache, batch, result);
+}
+
+/*
+ * Returns false if request has to be flushed on its own
+ */
+static bool _raw_ram_commit_join(ocf_cache_t cache,
+		struct ocf_request *req, struct ocf_metadata_raw *raw,
+		ocf_req_end_t complete)
+{
+	uint32_t max_pages = cache->metadata_group_commit.max_pages;
+	uint64_t window_ns = cache->metadata_group_commit.window_us * 1000ULL;
+	struct _raw_ram_commit_batch *batch, *spare;
+	struct _raw_ram_commit_batch *alloc = NULL, *stale = NULL;
+	struct _raw_ram_commit_batch *full = NULL, *submit = NULL;
+	struct _raw_ram_commit_waiter *waiter;
+	unsigned long lock_flags = 0;
+	uint64_t now;
+	uint32_t i, pages = 0;
+
+	if (max_pages == OCF_METADATA_GROUP_COMMIT_INACTIVE)
+		return false;
+
+	/* Flags have to be preserved for every metadata write */
+	if (req->ioi.io.flags)
+		return false;
+
+	for (i = 0; i < req->core_line_count; i++)
+		pages += req->map[i].flush;
+
+	if (pages > max_pages)
+		return false;
+
+	now = env_get_tick_count();
+
+retry:
+	env_spinlock_lock_irqsave(&raw->group_commit.lock, lock_flags);
+
+	batch = raw->group_commit.open;
+	if (!batch || batch->pages_count + pages > batch->pages_max) {
+		spare = raw->group_commit.spare;
+		if (spare && spare->pages_max != max_pages) {
+			/* Left from before max_pages change */
+			raw->group_commit.spare = NULL;
+			stale = spare;
+			spare = NULL;
+		}
+
+		if (!spare && !alloc) {
+			/* Never allocate under the lock */
+			env_spinlock_unlock_irqrestore(&raw->group_commit.lock,
+					lock_flags);
+			env_free(stale);
+			stale = NULL;
+			alloc = _raw_ram_commit_alloc(raw, max_pages);
+			if (!alloc)
+				return false;
+			goto retry;
+		}
+
+		if (batch) {
+			full = batch;
+			raw->group_commit.in_flight++;
+		}
+
+		if (spare) {
+			raw->group_commit.spare = NULL;
+			batch = spare;
+		} else {
+			batch = alloc;
+			alloc = NULL;
+		}
+
+		batch->queue = req->io_queue;
+		batch->open_ts = now;
+		raw->group_commit.open = batch;
+	}
+
+	/* Allocated batch turned out not needed - keep it for next time */
+	if (alloc && !raw->group_commit.spare) {
+		raw->group_commit.spare = alloc;
+		alloc = NULL;
+	}
+
+	for (i = 0; i < req->core_line_count; i++) {
+		if (req->map[i].flush) {
+			batch->pages[batch->pages_count++] =
+				_RAW_RAM_PAGE(raw, req->map[i].coll_idx);
+		}
+	}
+
+	waiter = &batch->waiters[batch->waiters_count++];
+	waiter->req = req;
+	waiter->complete = complete;
+
+	if (!raw->group_commit.in_flight ||
+			batch->pages_count >= batch->pages_max ||
+			env_ticks_to_nsecs(now - batch->open_ts) >= window_ns) {
+		submit = batch;
+		raw->group_commit.open = NULL;
+		raw->group_commit.in_flight++;
+	}
+
+	env_spinlock_unlock_irqrestore(&raw->group_commit.lock, lock_flags);
+
+	env_free(alloc);
+	env_free(stale);
+
+	if (full)
+		_raw_ram_commit_submit(cache, full);
+
+	if (submit)
+		_raw_ram_commit_submit(cache, submit);
+
+	return true;
+}
+
 static int _raw_ram_flush_do_asynch(ocf_cache_t cache,
 		struct ocf_request *req, struct ocf_metadata_raw *raw,
 		ocf_req_end_t complete)
 {
-	int result = 0, i;
+	int result = 0;
 	uint32_t __pages_tab[MAX_STACK_TAB_SIZE];
 	uint32_t *pages_tab;
 	int line_no = req->core_line_count;
 	int pages_to_flush;
-	uint32_t start_page = 0;
-	uint32_t count = 0;
 	struct _raw_ram_flush_ctx *ctx;
 
 	ENV_BUG_ON(!complete);
@@ -488,6 +810,9 @@ static int _raw_ram_flush_do_asynch(ocf_cache_t cache,
 		return 0;
 	}
 
+	if (_raw_ram_commit_join(cache, req, raw, complete))
+		return 0;
+
 	ctx = env_zalloc(sizeof(*ctx), ENV_MEM_NOIO);
 	if (!ctx) {
 		complete(req, -OCF_ERR_NO_MEM);
@@ -517,45 +842,10 @@ static int _raw_ram_flush_do_asynch(ocf_cache_t cache,
 	__raw_ram_flush_do_asynch_add_pages(req, pages_tab, raw,
 			&pages_to_flush);
 
-	env_sort(pages_tab, pages_to_flush, sizeof(*pages_tab),
-			_raw_ram_flush_do_page_cmp, NULL);
-
-	i = 0;
-	while (i < pages_to_flush) {
-		start_page = pages_tab[i];
-		count = 1;
-
-		while (true) {
-			if ((i + 1) >= pages_to_flush)
-				break;
-
-			if (pages_tab[i] == pages_tab[i + 1]) {
-				i++;
-				continue;
-			}
-
-			if ((pages_tab[i] + 1) != pages_tab[i + 1])
-				break;
-
-			i++;
-			count++;
-		}
-
-
-		env_atomic_inc(&ctx->flush_req_cnt);
-
-		result  |= metadata_io_write_i_asynch(cache, req->io_queue, ctx,
-				raw->ssd_pages_offset + start_page, count,
-				req->ioi.io.flags,
-				_raw_ram_flush_do_asynch_fill,
-				_raw_ram_flush_do_asynch_io_complete,
-				raw->mio_conc);
-
-		if (result)
-			break;
-
-		i++;
-	}
+	result = __raw_ram_flush_do_asynch_write(cache, req->io_queue,
+			req->ioi.io.flags, raw, pages_tab, pages_to_flush, ctx,
+			&ctx->flush_req_cnt, _raw_ram_flush_do_asynch_fill,
+			_raw_ram_flush_do_asynch_io_complete);
 
 	_raw_ram_flush_do_asynch_io_complete(cache, ctx, result);
 
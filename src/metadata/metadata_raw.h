@@ -86,12 +86,25 @@ struct ocf_metadata_raw {
 
 	size_t mem_pool_limit; /*! Current memory pool size (limit) */
 
+	ocf_metadata_page_t mem_pool_backing; /*!< Memory pool page backing */
+
 	void *priv; /*!< Private data - context */
 
 	ocf_flush_page_synch_t lock_page; /*!< Page lock callback */
 	ocf_flush_page_synch_t unlock_page; /*!< Page unlock callback */
 
 	struct ocf_alock *mio_conc;
+
+	/**
+	 * @name Group commit of asynchronous flushes
+	 */
+	struct {
+		env_spinlock lock;
+		struct _raw_ram_commit_batch *open; /*!< Batch accepting pages */
+		uint32_t in_flight; /*!< Batches being written */
+		struct _raw_ram_commit_batch *spare;
+			/*!< Completed batch kept for reuse */
+	} group_commit;
 };
 
 /**
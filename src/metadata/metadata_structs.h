@@ -58,12 +58,88 @@ struct ocf_metadata_lock
 	env_rwlock lru[OCF_NUM_LRU_LISTS]; /*!< Fast locks for lru list */
 	env_spinlock partition[OCF_USER_IO_CLASS_MAX]; /* partition lock */
 	env_rwsem *hash; /*!< Hash bucket locks */
+	env_atomic *hash_seq;
+		/*!< Hash bucket sequence counters, odd while bucket
+		 * is locked for write */
+	env_atomic exclusive_seq;
+		/*!< Sequence counter of exclusive metadata access */
 	env_rwsem *collision_pages; /*!< Collision table page locks */
 	ocf_cache_t cache;  /*!< Parent cache object */
 	uint32_t num_hash_entries;  /*!< Hash bucket count */
 	uint32_t num_collision_pages; /*!< Collision table page count */
 };
 
+/**
+ * @brief Index of cache lines having any dirty sector
+ */
+struct ocf_metadata_dirty_index {
+	unsigned long *lines;
+		/*!< One bit per cache line, set if cache line is dirty */
+
+	unsigned long *summary;
+		/*!< One bit per word of lines, set if word may be non-zero */
+
+	uint64_t words; /*!< Number of words in lines */
+	uint64_t groups; /*!< Number of words in summary */
+};
+
+struct ocf_metadata_context;
+
+/**
+ * @brief Journal of cache line dirty status changes
+ */
+struct ocf_metadata_journal {
+	bool enabled;
+		/*!< Journaling requested in cache configuration */
+
+	bool active;
+		/*!< Collision updates are appended to the journal */
+
+	bool reset_pending;
+		/*!< Whole journal is to be zeroed by next metadata flush */
+
+	bool checkpoint_running;
+		/*!< Checkpoint or header write in progress */
+
+	env_spinlock lock;
+
+	uint32_t record_size; /*!< Size of single record */
+	uint32_t records_per_page; /*!< Number of records in journal page */
+	uint32_t pages; /*!< Number of journal pages, header excluded */
+
+	uint64_t head; /*!< Sequence number of next page to be opened */
+	uint64_t written;
+		/*!< Lowest sequence number of page not written yet */
+	uint64_t checkpoint;
+		/*!< Lowest sequence number not covered by checkpoint on disk */
+	uint64_t checkpoint_seq; /*!< Checkpoint being written */
+	bool open; /*!< Page head - 1 accepts records */
+	uint32_t in_flight; /*!< Pages being written */
+
+	unsigned long *done; /*!< One bit per page, set once written */
+	ocf_queue_t *queues; /*!< Queue to write each page on */
+
+	struct list_head pending; /*!< Requests waiting for their pages */
+	struct list_head waiting; /*!< Requests waiting for free pages */
+
+	void *reqs; /*!< Preallocated requests */
+	struct list_head free_reqs; /*!< Preallocated requests not in use */
+
+	unsigned long *dirty_pages;
+		/*!< Collision pages updated since last checkpoint */
+	unsigned long *checkpoint_pages;
+		/*!< Collision pages written by running checkpoint */
+	uint64_t page_words; /*!< Number of words in page bitmaps */
+	ocf_queue_t checkpoint_queue; /*!< Queue to write checkpoint on */
+	env_atomic checkpoint_remaining;
+	int checkpoint_error;
+
+	struct ocf_metadata_context *flush;
+		/*!< Metadata flush waiting for its checkpoint header write */
+	uint64_t flush_seq; /*!< Checkpoint of metadata flush */
+	bool flush_writing; /*!< Header write of metadata flush in progress */
+};
+
 /**
  * @brief Metadata control structure
  */
@@ -80,6 +156,21 @@ struct ocf_metadata {
 	bool is_volatile;
 		/*!< true if metadata used in volatile mode (RAM only) */
 
+	ocf_metadata_page_t page;
+		/*!< Requested page backing of large metadata arrays */
+
+	int numa_node;
+		/*!< NUMA placement of large metadata arrays */
+
+	env_atomic64 backing[ocf_metadata_page_max];
+		/*!< Large metadata arrays memory per page backing */
+
+	struct ocf_metadata_dirty_index dirty_index;
+		/*!< Dirty cache lines lookup for flush */
+
+	struct ocf_metadata_journal journal;
+		/*!< Journal of dirty status changes */
+
 	struct ocf_metadata_lock lock;
 };
 
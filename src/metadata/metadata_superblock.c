@@ -191,6 +191,17 @@ int ocf_metadata_validate_superblock(ocf_cache_t cache,
 		return -OCF_ERR_INVAL;
 	}
 
+	if ((unsigned)superblock->eviction_policy_type >= ocf_eviction_max) {
+		ocf_log_invalid_superblock("eviction policy");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (superblock->lru_lists == 0 ||
+			superblock->lru_lists > OCF_NUM_LRU_LISTS) {
+		ocf_log_invalid_superblock("number of LRU lists");
+		return -OCF_ERR_INVAL;
+	}
+
 	return 0;
 }
 
@@ -213,6 +224,76 @@ static void _ocf_metadata_validate_superblock(ocf_pipeline_t pipeline,
 	ocf_pipeline_next(pipeline);
 }
 
+#define ocf_log_invalid_part(part_id, param) \
+	ocf_cache_log(cache, log_err, \
+			"Loading %s: invalid %s of IO class %u\n", \
+			ocf_metadata_segment_names[ \
+					metadata_segment_part_config], \
+			param, part_id)
+
+static int ocf_metadata_validate_part_config(ocf_cache_t cache)
+{
+	struct ocf_user_part_config *config;
+	struct ocf_lru_part_meta *lru;
+	uint32_t headroom = 0;
+	ocf_part_id_t part_id;
+	uint32_t i;
+
+	for (part_id = 0; part_id < OCF_USER_IO_CLASS_MAX; part_id++) {
+		config = cache->user_parts[part_id].config;
+		lru = cache->user_parts[part_id].part.runtime->lru;
+
+		if (config->slru_protected_size > PARTITION_SIZE_MAX) {
+			ocf_log_invalid_part(part_id,
+					"segmented LRU protected size");
+			return -OCF_ERR_INVAL;
+		}
+
+		for (i = 0; i < OCF_NUM_LRU_LISTS; i++) {
+			if (lru[i].clean.protected_pct > PARTITION_SIZE_MAX ||
+					lru[i].dirty.protected_pct >
+					PARTITION_SIZE_MAX) {
+				ocf_log_invalid_part(part_id,
+						"LRU list protected size");
+				return -OCF_ERR_INVAL;
+			}
+		}
+
+		if (!config->flags.valid)
+			continue;
+
+		if (config->headroom_size > config->max_size) {
+			ocf_log_invalid_part(part_id, "headroom size");
+			return -OCF_ERR_INVAL;
+		}
+
+		headroom += config->headroom_size;
+	}
+
+	if (headroom > PARTITION_SIZE_MAX) {
+		ocf_cache_log(cache, log_err, "Loading %s: total headroom size "
+				"of IO classes exceeds cache size\n",
+				ocf_metadata_segment_names[
+						metadata_segment_part_config]);
+		return -OCF_ERR_INVAL;
+	}
+
+	return 0;
+}
+
+static void _ocf_metadata_validate_part_config(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_metadata_context *context = priv;
+	int ret;
+
+	ret = ocf_metadata_validate_part_config(context->cache);
+	if (ret)
+		OCF_PL_FINISH_RET(pipeline, ret);
+
+	ocf_pipeline_next(pipeline);
+}
+
 static void ocf_metadata_load_superblock_post(ocf_pipeline_t pipeline,
 		void *priv, ocf_pipeline_arg_t arg)
 {
@@ -331,6 +412,7 @@ struct ocf_pipeline_properties ocf_metadata_load_sb_pipeline_props = {
 				ocf_metadata_load_sb_check_crc_args),
 		OCF_PL_STEP_FOREACH(ocf_metadata_check_crc_if_clean,
 				ocf_metadata_load_sb_check_crc_args_clean),
+		OCF_PL_STEP(_ocf_metadata_validate_part_config),
 		OCF_PL_STEP(ocf_metadata_load_superblock_post),
 		OCF_PL_STEP_TERMINATOR(),
 	},
@@ -22,8 +22,12 @@
 #include "../utils/utils_async_lock.h"
 #include "../concurrency/ocf_concurrency.h"
 #include "../ocf_lru.h"
+#include "../ocf_pin.h"
 #include "../ocf_ctx_priv.h"
 #include "../cleaning/cleaning.h"
+#include "../cleaning/cleaning_governor.h"
+#include "../cleaning/cleaning_stream.h"
+#include "../cleaning/cleaning_discard.h"
 #include "../promotion/ops.h"
 
 #define OCF_ASSERT_PLUGGED(cache) ENV_BUG_ON(!(cache)->device)
@@ -80,6 +84,8 @@ struct ocf_cache_mngt_init_params {
 		/*!< cache mode */
 
 		ocf_promotion_t promotion_policy;
+
+		ocf_eviction_t eviction_policy;
 	} metadata;
 };
 
@@ -251,6 +257,16 @@ static void __init_cores(ocf_cache_t cache)
 			sizeof(cache->conf_meta->valid_core_bitmap), 0));
 }
 
+/* One LRU list per execution context, so that each I/O queue may have its
+ * own list (see ocf_lru_home_list()) */
+static void __init_lru_lists(ocf_cache_t cache)
+{
+	unsigned contexts = env_get_execution_context_count();
+
+	cache->conf_meta->lru_lists = OCF_MIN(OCF_MAX(contexts, 1U),
+			(unsigned)OCF_NUM_LRU_LISTS);
+}
+
 static void __init_metadata_version(ocf_cache_t cache)
 {
 	cache->conf_meta->metadata_version = METADATA_VERSION();
@@ -331,6 +347,8 @@ static void _ocf_mngt_close_all_uninitialized_cores(
 		if (cache->core[i].seq_cutoff)
 			ocf_core_seq_cutoff_deinit(&cache->core[i]);
 
+		ocf_core_pin_deinit(&cache->core[i]);
+
 		env_free(cache->core[i].counters);
 		cache->core[i].counters = NULL;
 
@@ -411,6 +429,10 @@ static int _ocf_mngt_load_add_cores(
 		if (ret < 0)
 			goto err;
 
+		ret = ocf_core_pin_init(core);
+		if (ret < 0)
+			goto err;
+
 		if (!core->opened) {
 			env_bit_set(ocf_cache_state_incomplete,
 					&cache->cache_state);
@@ -553,6 +575,11 @@ static int _ocf_mngt_init_new_cache(struct ocf_cache_mngt_init_params *params)
 		goto lock_err;
 	}
 
+	if (env_spinlock_init(&cache->io_queues_lock)) {
+		result = -OCF_ERR_NO_MEM;
+		goto lock_err;
+	}
+
 	ENV_BUG_ON(!ocf_refcnt_inc(&cache->refcnt.cache));
 
 	/* start with freezed metadata ref counter to indicate detached device*/
@@ -665,7 +692,40 @@ static int _ocf_mngt_init_prepare_cache(struct ocf_cache_mngt_init_params *param
 	cache->pt_unaligned_io = cfg->pt_unaligned_io;
 	cache->use_submit_io_fast = cfg->use_submit_io_fast;
 
+	cache->write_coalescing.max_io_size =
+			OCF_CACHE_WRITE_COALESCING_INACTIVE;
+	cache->write_coalescing.max_batch_size =
+			OCF_CACHE_WRITE_COALESCING_DEFAULT_BATCH_SIZE;
+
+	cache->metadata_group_commit.max_pages =
+			OCF_METADATA_GROUP_COMMIT_INACTIVE;
+	cache->metadata_group_commit.window_us =
+			OCF_METADATA_GROUP_COMMIT_DEFAULT_WINDOW_US;
+
+	cache->split_io_size = OCF_CACHE_SPLIT_IO_INACTIVE;
+
+	cache->flush_queue_depth = OCF_MNGT_FLUSH_DEFAULT_QUEUE_DEPTH;
+	ocf_cache_stats_cleaner_initialize(cache);
+
+	cache->zero_detection = false;
+
+	cache->lru_deferred_balance = false;
+	cache->lru_ttl_active = false;
+	cache->eviction_stats = false;
+	env_atomic_set(&cache->pinned_ranges, 0);
+
+	cache->lru_reclaim.low_watermark = 0;
+	cache->lru_reclaim.high_watermark = 0;
+	cache->lru_reclaim.headroom = 0;
+
+	ocf_cleaning_governor_init(cache);
+	ocf_cleaning_streams_init(cache);
+	ocf_cleaning_discards_init(cache);
+
 	cache->metadata.is_volatile = cfg->metadata_volatile;
+	cache->metadata.page = cfg->metadata_page;
+	cache->metadata.numa_node = cfg->metadata_numa_node;
+	cache->metadata.journal.enabled = cfg->metadata_journal;
 
 out:
 	return ret;
@@ -1111,8 +1171,10 @@ static void _ocf_mngt_attach_handle_error(
 	if (context->flags.cores_opened)
 		_ocf_mngt_close_all_uninitialized_cores(cache);
 
-	if (context->flags.attached_metadata_inited)
+	if (context->flags.attached_metadata_inited) {
+		ocf_lru_age_deinit(cache);
 		ocf_metadata_deinit_variable_size(cache);
+	}
 
 	if (context->flags.device_opened)
 		ocf_volume_close(&cache->device->volume);
@@ -1138,6 +1200,7 @@ static void _ocf_mngt_cache_init(ocf_cache_t cache,
 	cache->conf_meta->cache_mode = params->metadata.cache_mode;
 	cache->conf_meta->metadata_layout = params->metadata.layout;
 	cache->conf_meta->promotion_policy_type = params->metadata.promotion_policy;
+	cache->conf_meta->eviction_policy_type = params->metadata.eviction_policy;
 
 	INIT_LIST_HEAD(&cache->io_queues);
 
@@ -1148,6 +1211,7 @@ static void _ocf_mngt_cache_init(ocf_cache_t cache,
 	__init_cores(cache);
 	__init_metadata_version(cache);
 	__init_partitions(cache);
+	__init_lru_lists(cache);
 }
 
 static int _ocf_mngt_cache_start(ocf_ctx_t ctx, ocf_cache_t *cache,
@@ -1165,6 +1229,7 @@ static int _ocf_mngt_cache_start(ocf_ctx_t ctx, ocf_cache_t *cache,
 	params.metadata.line_size = cfg->cache_line_size;
 	params.metadata_volatile = cfg->metadata_volatile;
 	params.metadata.promotion_policy = cfg->promotion_policy;
+	params.metadata.eviction_policy = cfg->eviction_policy;
 	params.locked = cfg->locked;
 
 	result = env_rmutex_lock_interruptible(&ctx->lock);
@@ -1492,10 +1557,19 @@ static void _ocf_mngt_attach_post_init(ocf_pipeline_t pipeline,
 {
 	struct ocf_cache_attach_context *context = priv;
 	ocf_cache_t cache = context->cache;
+	int result;
+
+	result = cache->eviction_stats ? ocf_lru_age_init(cache) : 0;
+	if (!result)
+		result = ocf_lru_update_ttl(cache);
+	if (result)
+		OCF_PL_FINISH_RET(pipeline, result);
 
 	ocf_cleaner_refcnt_unfreeze(cache);
 	ocf_refcnt_unfreeze(&cache->refcnt.metadata);
 
+	ocf_space_update_headroom(cache);
+
 	ocf_cache_log(cache, log_debug, "Cache attached\n");
 
 	ocf_pipeline_next(pipeline);
@@ -1862,6 +1936,11 @@ static int _ocf_mngt_cache_validate_cfg(struct ocf_mngt_cache_config *cfg)
 		return -OCF_ERR_INVAL;
 	}
 
+	if (cfg->eviction_policy >= ocf_eviction_max ||
+			cfg->eviction_policy < 0) {
+		return -OCF_ERR_INVAL;
+	}
+
 	if (!ocf_cache_line_size_is_valid(cfg->cache_line_size))
 		return -OCF_ERR_INVALID_CACHE_LINE_SIZE;
 
@@ -1870,6 +1949,16 @@ static int _ocf_mngt_cache_validate_cfg(struct ocf_mngt_cache_config *cfg)
 		return -OCF_ERR_INVAL;
 	}
 
+	if (cfg->metadata_page >= ocf_metadata_page_max ||
+			cfg->metadata_page < 0) {
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->metadata_numa_node < OCF_NUMA_INTERLEAVE ||
+			cfg->metadata_numa_node >= OCF_NUMA_NODE_MAX) {
+		return -OCF_ERR_INVAL;
+	}
+
 	if (cfg->backfill.queue_unblock_size > cfg->backfill.max_queue_size )
 		return -OCF_ERR_INVAL;
 
@@ -1989,6 +2078,7 @@ static void _ocf_mngt_cache_unplug_complete(void *priv, int error)
 
 	ocf_volume_close(&cache->device->volume);
 
+	ocf_lru_age_deinit(cache);
 	ocf_metadata_deinit_variable_size(cache);
 	ocf_concurrency_deinit(cache);
 
@@ -2403,6 +2493,371 @@ int ocf_mngt_cache_get_fallback_pt_error_threshold(ocf_cache_t cache,
 	return 0;
 }
 
+int ocf_mngt_cache_set_write_coalescing(ocf_cache_t cache,
+		uint32_t max_io_size, uint32_t max_batch_size)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (max_batch_size > OCF_CACHE_WRITE_COALESCING_MAX_BATCH_SIZE)
+		return -OCF_ERR_INVAL;
+
+	if (max_io_size > max_batch_size)
+		return -OCF_ERR_INVAL;
+
+	cache->write_coalescing.max_io_size = max_io_size;
+	cache->write_coalescing.max_batch_size = max_batch_size;
+
+	if (max_io_size == OCF_CACHE_WRITE_COALESCING_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Write coalescing inactive\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Write coalescing active, "
+				"max io size %u, max batch size %u\n",
+				max_io_size, max_batch_size);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_write_coalescing(ocf_cache_t cache,
+		uint32_t *max_io_size, uint32_t *max_batch_size)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(max_io_size);
+	OCF_CHECK_NULL(max_batch_size);
+
+	*max_io_size = cache->write_coalescing.max_io_size;
+	*max_batch_size = cache->write_coalescing.max_batch_size;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_metadata_group_commit(ocf_cache_t cache,
+		uint32_t max_pages, uint32_t window_us)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (max_pages > OCF_METADATA_GROUP_COMMIT_MAX_PAGES)
+		return -OCF_ERR_INVAL;
+
+	if (window_us > OCF_METADATA_GROUP_COMMIT_MAX_WINDOW_US)
+		return -OCF_ERR_INVAL;
+
+	cache->metadata_group_commit.max_pages = max_pages;
+	cache->metadata_group_commit.window_us = window_us;
+
+	if (max_pages == OCF_METADATA_GROUP_COMMIT_INACTIVE) {
+		ocf_cache_log(cache, log_info,
+				"Metadata group commit inactive\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Metadata group commit active, "
+				"max pages %u, window %u us\n",
+				max_pages, window_us);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_metadata_group_commit(ocf_cache_t cache,
+		uint32_t *max_pages, uint32_t *window_us)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(max_pages);
+	OCF_CHECK_NULL(window_us);
+
+	*max_pages = cache->metadata_group_commit.max_pages;
+	*window_us = cache->metadata_group_commit.window_us;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_split_io_size(ocf_cache_t cache,
+		uint32_t split_io_size)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (split_io_size != OCF_CACHE_SPLIT_IO_INACTIVE &&
+			(split_io_size < OCF_CACHE_SPLIT_IO_MIN_SIZE ||
+			split_io_size > OCF_CACHE_SPLIT_IO_MAX_SIZE)) {
+		return -OCF_ERR_INVAL;
+	}
+
+	cache->split_io_size = split_io_size;
+
+	if (split_io_size == OCF_CACHE_SPLIT_IO_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Request splitting inactive\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Request splitting active, "
+				"split size %u\n", split_io_size);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_split_io_size(ocf_cache_t cache,
+		uint32_t *split_io_size)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(split_io_size);
+
+	*split_io_size = cache->split_io_size;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_zero_detection(ocf_cache_t cache, bool enable)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (enable && !ctx_data_has_is_zero(cache->owner)) {
+		ocf_cache_log(cache, log_err, "Zero detection is not "
+				"supported by context\n");
+		return -OCF_ERR_NOT_SUPP;
+	}
+
+	cache->zero_detection = enable;
+
+	ocf_cache_log(cache, log_info, "Zero detection %s\n",
+			enable ? "enabled" : "disabled");
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_zero_detection(ocf_cache_t cache, bool *enabled)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(enabled);
+
+	*enabled = cache->zero_detection;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_reclaim_watermarks(ocf_cache_t cache,
+		uint32_t low_watermark, uint32_t high_watermark)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (low_watermark > high_watermark) {
+		ocf_cache_log(cache, log_err, "Reclaim low watermark can't "
+				"exceed high watermark\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	cache->lru_reclaim.high_watermark = high_watermark;
+	cache->lru_reclaim.low_watermark = low_watermark;
+
+	if (low_watermark) {
+		ocf_cache_log(cache, log_info, "Background reclaim watermarks: "
+				"%u-%u cache lines\n", low_watermark,
+				high_watermark);
+	} else {
+		ocf_cache_log(cache, log_info, "Background reclaim "
+				"disabled\n");
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_reclaim_watermarks(ocf_cache_t cache,
+		uint32_t *low_watermark, uint32_t *high_watermark)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(low_watermark);
+	OCF_CHECK_NULL(high_watermark);
+
+	*low_watermark = cache->lru_reclaim.low_watermark;
+	*high_watermark = cache->lru_reclaim.high_watermark;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_lru_deferred_balance(ocf_cache_t cache, bool enable)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (ocf_cache_is_device_attached(cache))
+		ocf_lru_set_deferred_balance(cache, enable);
+	else
+		cache->lru_deferred_balance = enable;
+
+	ocf_cache_log(cache, log_info, "Deferred LRU balancing %s\n",
+			enable ? "enabled" : "disabled");
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_lru_deferred_balance(ocf_cache_t cache, bool *enabled)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(enabled);
+
+	*enabled = cache->lru_deferred_balance;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_eviction_stats(ocf_cache_t cache, bool enable)
+{
+	int result;
+
+	OCF_CHECK_NULL(cache);
+
+	if (enable) {
+		result = ocf_lru_age_init(cache);
+		if (result)
+			return result;
+	}
+
+	cache->eviction_stats = enable;
+
+	ocf_cache_log(cache, log_info, "Eviction statistics %s\n",
+			enable ? "enabled" : "disabled");
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_eviction_stats(ocf_cache_t cache, bool *enabled)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(enabled);
+
+	*enabled = cache->eviction_stats;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_cleaning_governor(ocf_cache_t cache,
+		const struct ocf_mngt_cleaning_governor_config *cfg)
+{
+	struct ocf_cleaning_governor *gov;
+
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(cfg);
+
+	gov = &cache->cleaner.governor;
+
+	if (cfg->dirty_low > cfg->dirty_high || cfg->dirty_high > 100) {
+		ocf_cache_log(cache, log_err, "Invalid cleaning governor "
+				"dirty ratio band: %u-%u%%\n", cfg->dirty_low,
+				cfg->dirty_high);
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->min_rate > cfg->max_rate) {
+		ocf_cache_log(cache, log_err, "Cleaning governor min rate "
+				"can't exceed max rate\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	gov->config = *cfg;
+	gov->rate = cfg->min_rate;
+	gov->tokens = 0;
+	gov->last_refill = env_get_tick_count();
+
+	if (cfg->max_rate == OCF_CLEANING_GOVERNOR_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Cleaning governor "
+				"disabled\n");
+		return 0;
+	}
+
+	ocf_cache_log(cache, log_info, "Cleaning governor: dirty ratio "
+			"%u-%u%%, rate %u-%u lines/s, target latency %u us, "
+			"max queue depth %u\n", cfg->dirty_low, cfg->dirty_high,
+			cfg->min_rate, cfg->max_rate, cfg->target_latency_us,
+			cfg->max_queue_depth);
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_cleaning_governor(ocf_cache_t cache,
+		struct ocf_mngt_cleaning_governor_config *cfg, uint32_t *rate)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(cfg);
+	OCF_CHECK_NULL(rate);
+
+	*cfg = cache->cleaner.governor.config;
+	*rate = cache->cleaner.governor.rate;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_write_absorption(ocf_cache_t cache,
+		const struct ocf_mngt_write_absorption_config *cfg)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(cfg);
+
+	if (cfg->rewrite_threshold > OCF_CLEANING_ABSORB_MAX_REWRITES) {
+		ocf_cache_log(cache, log_err, "Rewrite threshold can't "
+				"exceed %u\n", OCF_CLEANING_ABSORB_MAX_REWRITES);
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->dirty_high > 100) {
+		ocf_cache_log(cache, log_err, "Invalid write absorption "
+				"dirty ratio: %u%%\n", cfg->dirty_high);
+		return -OCF_ERR_INVAL;
+	}
+
+	cache->cleaner.absorb.config = *cfg;
+
+	if (!cfg->rewrite_threshold) {
+		ocf_cache_log(cache, log_info, "Write absorption disabled\n");
+		return 0;
+	}
+
+	ocf_cache_log(cache, log_info, "Write absorption: rewrite "
+			"threshold %u, dirty ratio %u%%\n",
+			cfg->rewrite_threshold, cfg->dirty_high);
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_write_absorption(ocf_cache_t cache,
+		struct ocf_mngt_write_absorption_config *cfg)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(cfg);
+
+	*cfg = cache->cleaner.absorb.config;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_cleaning_stream_depth(ocf_cache_t cache,
+		uint32_t depth)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (depth < OCF_CLEANING_STREAM_MIN_DEPTH ||
+			depth > OCF_CLEANING_STREAM_MAX_DEPTH) {
+		ocf_cache_log(cache, log_err, "Cleaning stream depth must be "
+				"within range <%u-%u>\n",
+				OCF_CLEANING_STREAM_MIN_DEPTH,
+				OCF_CLEANING_STREAM_MAX_DEPTH);
+		return -OCF_ERR_INVAL;
+	}
+
+	cache->cleaner.streams.depth = depth;
+
+	ocf_cache_log(cache, log_info, "Cleaning stream depth: %u cache "
+			"lines\n", depth);
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_cleaning_stream_depth(ocf_cache_t cache,
+		uint32_t *depth)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(depth);
+
+	*depth = cache->cleaner.streams.depth;
+
+	return 0;
+}
+
 struct ocf_mngt_cache_detach_context {
 	/* unplug context - this is private structure of _ocf_mngt_cache_unplug,
 	 * it is member of detach context only to reserve memory in advance for
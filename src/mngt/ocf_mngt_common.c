@@ -12,9 +12,11 @@
 #include "../engine/cache_engine.h"
 #include "../ocf_request.h"
 #include "../ocf_lru.h"
+#include "../ocf_pin.h"
 #include "../ocf_logger_priv.h"
 #include "../ocf_queue_priv.h"
 #include "../engine/engine_common.h"
+#include "../cleaning/cleaning_stream.h"
 
 /* Close if opened */
 void cache_mngt_core_deinit(ocf_core_t core)
@@ -126,6 +128,7 @@ void cache_mngt_core_remove_from_cache(ocf_core_t core)
 	ocf_core_id_t core_id = ocf_core_get_id(core);
 
 	ocf_core_seq_cutoff_deinit(core);
+	ocf_core_pin_deinit(core);
 	env_free(core->counters);
 	core->counters = NULL;
 	core->added = false;
@@ -146,6 +149,8 @@ void ocf_mngt_cache_put(ocf_cache_t cache)
 	if (ocf_refcnt_dec(&cache->refcnt.cache) == 0) {
 		ctx = cache->owner;
 		ocf_metadata_deinit(cache);
+		ocf_cleaning_streams_deinit(cache);
+		env_spinlock_destroy(&cache->io_queues_lock);
 		env_vfree(cache);
 		ocf_ctx_put(ctx);
 	}
@@ -8,6 +8,7 @@
 #include "../metadata/metadata.h"
 #include "../ocf_def_priv.h"
 #include "../ocf_priv.h"
+#include "../ocf_pin.h"
 #include "../ocf_stats_priv.h"
 #include "../utils/utils_pipeline.h"
 #include "ocf/ocf.h"
@@ -109,6 +110,7 @@ struct ocf_cache_add_core_context {
         bool clean_pol_added : 1;
         bool counters_allocated : 1;
         bool cutoff_initialized : 1;
+        bool pin_initialized : 1;
     } flags;
 };
 
@@ -139,6 +141,9 @@ static void _ocf_mngt_cache_add_core_handle_error(
     if (context->flags.clean_pol_added)
         ocf_cleaning_remove_core(cache, core_id);
 
+    if (context->flags.pin_initialized)
+        ocf_core_pin_deinit(core);
+
     if (context->flags.cutoff_initialized)
         ocf_core_seq_cutoff_deinit(core);
 
@@ -426,6 +431,11 @@ static void ocf_mngt_cache_add_core_insert(ocf_pipeline_t pipeline,
         OCF_PL_FINISH_RET(pipeline, result);
     context->flags.cutoff_initialized = true;
 
+    result = ocf_core_pin_init(core);
+    if (result)
+        OCF_PL_FINISH_RET(pipeline, result);
+    context->flags.pin_initialized = true;
+
     /* When adding new core to cache, allocate stat counters */
     core->counters =
         env_zalloc(sizeof(*core->counters), ENV_MEM_NORMAL);
@@ -1062,3 +1072,59 @@ int ocf_mngt_core_get_seq_cutoff_promotion_count(ocf_core_t core,
 
     return 0;
 }
+
+static int _cache_mngt_core_pin_lines(ocf_core_t core, uint64_t addr,
+                                      uint64_t bytes, uint64_t* first,
+                                      uint64_t* last) {
+    uint64_t line_size = ocf_cache_get_line_size(ocf_core_get_cache(core));
+
+    if (bytes == 0 || addr + bytes < addr)
+        return -OCF_ERR_INVAL;
+
+    *first = addr / line_size;
+    *last = (addr + bytes - 1) / line_size;
+
+    return 0;
+}
+
+int ocf_mngt_core_pin_range(ocf_core_t core, uint64_t addr, uint64_t bytes) {
+    uint64_t first, last;
+    int result;
+
+    OCF_CHECK_NULL(core);
+
+    result = _cache_mngt_core_pin_lines(core, addr, bytes, &first, &last);
+    if (result)
+        return result;
+
+    result = ocf_core_pin_add(core, first, last);
+    if (result)
+        return result;
+
+    ocf_core_log(core, log_info,
+                 "Pinned range %" ENV_PRIu64 "-%" ENV_PRIu64 "\n",
+                 addr, addr + bytes - 1);
+
+    return 0;
+}
+
+int ocf_mngt_core_unpin_range(ocf_core_t core, uint64_t addr, uint64_t bytes) {
+    uint64_t first, last;
+    int result;
+
+    OCF_CHECK_NULL(core);
+
+    result = _cache_mngt_core_pin_lines(core, addr, bytes, &first, &last);
+    if (result)
+        return result;
+
+    result = ocf_core_pin_remove(core, first, last);
+    if (result)
+        return result;
+
+    ocf_core_log(core, log_info,
+                 "Unpinned range %" ENV_PRIu64 "-%" ENV_PRIu64 "\n",
+                 addr, addr + bytes - 1);
+
+    return 0;
+}
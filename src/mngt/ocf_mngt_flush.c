@@ -7,6 +7,7 @@
 #include "ocf_mngt_common.h"
 #include "../ocf_priv.h"
 #include "../metadata/metadata.h"
+#include "../concurrency/ocf_metadata_concurrency.h"
 #include "../cleaning/cleaning.h"
 #include "../engine/cache_engine.h"
 #include "../engine/engine_common.h"
@@ -16,24 +17,66 @@
 #include "../utils/utils_pipeline.h"
 #include "../utils/utils_refcnt.h"
 #include "../ocf_request.h"
+#include "../ocf_queue_priv.h"
 #include "../ocf_def_priv.h"
 
 struct ocf_mngt_cache_flush_context;
 typedef void (*ocf_flush_complete_t)(struct ocf_mngt_cache_flush_context *, int);
 
-struct flush_containers_context
+/* Cache lines collected by scanner before they are fired */
+#define OCF_MNGT_FLUSH_PORTION_LINES 1024
+
+/* Collision table entries examined by scanner in single step */
+#define OCF_MNGT_FLUSH_SCAN_STEP 131072
+
+/* Upper limit of metadata scanners running in parallel */
+#define OCF_MNGT_FLUSH_MAX_SCANNERS 64
+
+struct flush_scanner
+{
+	struct ocf_mngt_cache_flush_context *context;
+	/* request running the scanner on its I/O queue */
+	struct ocf_request *req;
+	/* next cache line to examine and end of metadata segment */
+	ocf_cache_line_t line;
+	ocf_cache_line_t end;
+	/* core the scanner waits for, OCF_CORE_MAX if not waiting */
+	ocf_core_id_t waiting;
+	/* number of collected cache lines */
+	uint32_t count;
+	/* number of collected cache lines fired so far */
+	uint32_t iter;
+	struct flush_data data[OCF_MNGT_FLUSH_PORTION_LINES];
+};
+
+struct flush_portion
+{
+	struct ocf_mngt_cache_flush_context *context;
+	ocf_core_id_t core_id;
+	uint32_t count;
+};
+
+struct flush_engine_context
 {
-	/* array of container descriptors */
-	struct flush_container *fctbl;
-	/* fctbl array size */
-	uint32_t fcnum;
-	/* shared error for all concurrent container flushes */
+	/* array of metadata scanners */
+	struct flush_scanner *scanners;
+	/* scanners array size */
+	uint32_t scanners_num;
+	/* core to be flushed, OCF_CORE_ID_INVALID for all cores */
+	ocf_core_id_t core_id;
+	/* dirty cache lines not found by scanners yet */
+	env_atomic64 to_find;
+	/* protects inflight and waiting state of scanners */
+	env_spinlock lock;
+	/* number of portions in flight per core */
+	uint32_t *inflight;
+	/* shared error for all scanners and portions */
 	env_atomic error;
-	/* number of outstanding container flushes */
+	/* number of outstanding scanners and portions */
 	env_atomic count;
-	/* first container flush to notice interrupt sets this to 1 */
+	/* first scanner to notice interrupt sets this to 1 */
 	env_atomic interrupt_seen;
-	/* completion to be called after all containers are flushed */
+	/* completion to be called after all portions are flushed */
 	ocf_flush_complete_t complete;
 };
 
@@ -77,8 +120,8 @@ struct ocf_mngt_cache_flush_context
 		uint64_t core_id;
 	} purge;
 
-	/* context for flush containers logic */
-	struct flush_containers_context fcs;
+	/* context for flush engine */
+	struct flush_engine_context fe;
 };
 
 static void _ocf_mngt_begin_flush_complete(void *priv)
@@ -128,410 +171,434 @@ bool ocf_mngt_cache_is_dirty(ocf_cache_t cache)
 	return false;
 }
 
-/************************FLUSH CORE CODE**************************************/
-/* Returns:
- * 0 if OK and tbl & num is filled:
- * * tbl - table with sectors&cacheline
- * * num - number of items in this table.
- * other value means error.
- * NOTE:
- * Table is not sorted.
+/************************FLUSH ENGINE CODE************************************/
+/*
+ * Collision table is split into segments, one per I/O queue, each walked
+ * by its own scanner request. Scanner collects dirty cache lines of
+ * a segment into a portion, sorts it and fires it to the cleaner core
+ * by core right away, so that writing back dirty data overlaps with
+ * scanning. Each core has at most flush_queue_depth portions in flight,
+ * scanner waiting for a slot is woken up by completion of any portion
+ * of that core.
  */
-static int _ocf_mngt_get_sectors(ocf_cache_t cache, ocf_core_id_t core_id,
-		struct flush_data **tbl, uint32_t *num)
+
+static void _ocf_mngt_flush_engine_put(
+		struct ocf_mngt_cache_flush_context *context)
 {
-	ocf_core_t core = ocf_cache_get_core(cache, core_id);
-	uint64_t core_line;
-	ocf_core_id_t i_core_id;
-	struct flush_data *elem;
-	uint32_t line, dirty_found = 0, dirty_total = 0;
-	unsigned ret = 0;
+	struct flush_engine_context *fe = &context->fe;
+	ocf_cache_t cache = context->cache;
 
-	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
+	if (env_atomic_dec_return(&fe->count))
+		return;
 
-	dirty_total = env_atomic_read(&core->runtime_meta->dirty_clines);
-	if (!dirty_total) {
-		*num = 0;
-		*tbl = NULL;
-		goto unlock;
-	}
+	env_atomic_set(&cache->flush_progress.active, 0);
 
-	*tbl = env_vmalloc(dirty_total * sizeof(**tbl));
-	if (*tbl == NULL) {
-		ret = -OCF_ERR_NO_MEM;
-		goto unlock;
-	}
+	env_spinlock_destroy(&fe->lock);
+	env_vfree(fe->inflight);
+	env_vfree(fe->scanners);
 
-	for (line = 0, elem = *tbl;
-			line < cache->device->collision_table_entries;
-			line++) {
-		ocf_metadata_get_core_info(cache, line, &i_core_id,
-				&core_line);
+	fe->complete(context, env_atomic_read(&fe->error));
+}
 
-		if (i_core_id == core_id &&
-				metadata_test_valid_any(cache, line) &&
-				metadata_test_dirty(cache, line)) {
-			/* It's valid and dirty target core cacheline */
-			elem->cache_line = line;
-			elem->core_line = core_line;
-			elem->core_id = i_core_id;
-			elem++;
-			dirty_found++;
-
-			/* stop if all cachelines were found */
-			if (dirty_found == dirty_total)
-				break;
-		}
+static bool _ocf_mngt_flush_stopped(
+		struct ocf_mngt_cache_flush_context *context)
+{
+	struct flush_engine_context *fe = &context->fe;
+	ocf_cache_t cache = context->cache;
+	bool first_interrupt;
 
-		if ((line + 1) % 131072 == 0) {
-			ocf_metadata_end_exclusive_access(
-					&cache->metadata.lock);
-			env_cond_resched();
-			ocf_metadata_start_exclusive_access(
-					&cache->metadata.lock);
+	if (cache->flushing_interrupted) {
+		first_interrupt = !env_atomic_cmpxchg(
+				&fe->interrupt_seen, 0, 1);
+		if (first_interrupt) {
+			ocf_cache_log(cache, log_info,
+					"Flushing interrupted by user\n");
+			env_atomic_cmpxchg(&fe->error, 0,
+					-OCF_ERR_FLUSHING_INTERRUPTED);
 		}
 	}
 
-	ocf_core_log(core, log_debug,
-			"%u dirty cache lines to clean\n", dirty_found);
-
-
-	*num = dirty_found;
-
-unlock:
-	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
-
-	return ret;
+	return !!env_atomic_read(&fe->error);
 }
 
-static int _ocf_mngt_get_flush_containers(ocf_cache_t cache,
-		struct flush_container **fctbl, uint32_t *fcnum)
+/* Take portion slot of the core or register scanner as waiting for it */
+static bool _ocf_mngt_flush_slot_get(struct flush_scanner *sc,
+		ocf_core_id_t core_id)
 {
-	struct flush_container *fc;
-	struct flush_container *curr;
-	uint32_t *core_revmap;
-	uint32_t num;
-	uint64_t core_line;
-	ocf_core_id_t core_id;
-	ocf_core_t core;
-	uint32_t i, j = 0, line;
-	uint32_t dirty_found = 0, dirty_total = 0;
-	int ret = 0;
+	struct flush_engine_context *fe = &sc->context->fe;
+	ocf_cache_t cache = sc->context->cache;
+	unsigned long flags;
+	bool acquired;
+
+	env_spinlock_lock_irqsave(&fe->lock, flags);
+	acquired = fe->inflight[core_id] < cache->flush_queue_depth;
+	if (acquired)
+		fe->inflight[core_id]++;
+	else
+		sc->waiting = core_id;
+	env_spinlock_unlock_irqrestore(&fe->lock, flags);
+
+	return acquired;
+}
 
-	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
+static void _ocf_mngt_flush_slot_put(
+		struct ocf_mngt_cache_flush_context *context,
+		ocf_core_id_t core_id)
+{
+	struct flush_engine_context *fe = &context->fe;
+	uint64_t woken = 0;
+	unsigned long flags;
+	uint32_t i;
+
+	env_spinlock_lock_irqsave(&fe->lock, flags);
+	fe->inflight[core_id]--;
+	for (i = 0; i < fe->scanners_num; i++) {
+		if (fe->scanners[i].waiting != core_id)
+			continue;
 
-	/*
-	 * TODO: Create containers for each physical device, not for
-	 *       each core. Cores can be partitions of single device.
-	 */
-	num = cache->conf_meta->core_count;
-	if (num == 0) {
-		*fcnum = 0;
-		goto unlock;
+		fe->scanners[i].waiting = OCF_CORE_MAX;
+		woken |= 1ULL << i;
 	}
+	env_spinlock_unlock_irqrestore(&fe->lock, flags);
 
-	core_revmap = env_vzalloc(sizeof(*core_revmap) * OCF_CORE_MAX);
-	if (!core_revmap)
-		return -OCF_ERR_NO_MEM;
-
-	/* TODO: Alloc fcs and data tables in single allocation */
-	fc = env_vzalloc(sizeof(**fctbl) * num);
-	if (!fc) {
-		env_vfree(core_revmap);
-		ret = -OCF_ERR_NO_MEM;
-		goto unlock;
+	for (i = 0; i < fe->scanners_num; i++) {
+		if (woken & (1ULL << i))
+			ocf_engine_push_req_back(fe->scanners[i].req, false);
 	}
+}
 
-	for_each_core(cache, core, core_id) {
-		fc[j].core_id = core_id;
-		core_revmap[core_id] = j;
-
-		/* Check for dirty blocks */
-		fc[j].count = env_atomic_read(
-				&core->runtime_meta->dirty_clines);
-		dirty_total += fc[j].count;
-
-		if (fc[j].count) {
-			fc[j].flush_data = env_vmalloc(fc[j].count *
-					sizeof(*fc[j].flush_data));
-		}
-
-		if (++j == cache->conf_meta->core_count)
-			break;
-	}
+static void _ocf_mngt_flush_portion_end(void *private_data, int error)
+{
+	struct flush_portion *portion = private_data;
+	struct ocf_mngt_cache_flush_context *context = portion->context;
+	ocf_cache_t cache = context->cache;
+	ocf_core_t core = &cache->core[portion->core_id];
 
-	if (!dirty_total) {
-		env_vfree(core_revmap);
-		env_vfree(fc);
-		*fcnum = 0;
-		goto unlock;
-	}
+	env_atomic_add(portion->count, &core->flushed);
+	env_atomic64_add(portion->count, &cache->flush_progress.flushed);
 
-	for (line = 0; line < cache->device->collision_table_entries; line++) {
-		ocf_metadata_get_core_info(cache, line, &core_id, &core_line);
+	env_atomic_cmpxchg(&context->fe.error, 0, error);
 
-		if (metadata_test_valid_any(cache, line) &&
-				metadata_test_dirty(cache, line)) {
-			curr = &fc[core_revmap[core_id]];
+	_ocf_mngt_flush_slot_put(context, portion->core_id);
+	env_free(portion);
 
-			ENV_BUG_ON(curr->iter >= curr->count);
+	_ocf_mngt_flush_engine_put(context);
+}
 
-			/* It's core_id cacheline and it's valid and it's dirty! */
-			curr->flush_data[curr->iter].cache_line = line;
-			curr->flush_data[curr->iter].core_line = core_line;
-			curr->flush_data[curr->iter].core_id = core_id;
-			curr->iter++;
-			dirty_found++;
+/* Fire collected cache lines core by core. Returns false if scanner has
+ * to wait for portion slot. */
+static bool _ocf_mngt_flush_fire(struct flush_scanner *sc)
+{
+	struct ocf_mngt_cache_flush_context *context = sc->context;
+	struct flush_engine_context *fe = &context->fe;
+	ocf_cache_t cache = context->cache;
+	struct flush_portion *portion;
+	struct ocf_cleaner_attribs attribs = {
+		.lock_cacheline = true,
+		.lock_metadata = true,
+		/* Portion is sorted already */
+		.do_sort = false,
+		.cmpl_fn = _ocf_mngt_flush_portion_end,
+		.io_queue = sc->req->io_queue,
+	};
+	ocf_core_id_t core_id;
+	uint32_t end;
 
-			/* stop if all cachelines were found */
-			if (dirty_found == dirty_total)
+	while (sc->iter < sc->count) {
+		core_id = sc->data[sc->iter].core_id;
+		for (end = sc->iter + 1; end < sc->count; end++) {
+			if (sc->data[end].core_id != core_id)
 				break;
 		}
 
-		if ((line + 1) % 131072 == 0) {
-			ocf_metadata_end_exclusive_access(
-					&cache->metadata.lock);
-			env_cond_resched();
-			ocf_metadata_start_exclusive_access(
-					&cache->metadata.lock);
+		if (!_ocf_mngt_flush_slot_get(sc, core_id))
+			return false;
+
+		portion = env_malloc(sizeof(*portion), ENV_MEM_NOIO);
+		if (!portion) {
+			_ocf_mngt_flush_slot_put(context, core_id);
+			env_atomic_cmpxchg(&fe->error, 0, -OCF_ERR_NO_MEM);
+			return true;
 		}
-	}
 
-	if (dirty_total != dirty_found) {
-		for (i = 0; i < num; i++)
-			fc[i].count = fc[i].iter;
-	}
+		portion->context = context;
+		portion->core_id = core_id;
+		portion->count = end - sc->iter;
 
-	for (i = 0; i < num; i++)
-		fc[i].iter = 0;
+		env_atomic_inc(&fe->count);
 
-	env_vfree(core_revmap);
-	*fctbl = fc;
-	*fcnum = num;
+		/* Cleaner copies flush data before it returns, so scanner
+		 * buffer can be refilled right away */
+		attribs.cmpl_context = portion;
+		ocf_cleaner_do_flush_data_async(cache, &sc->data[sc->iter],
+				portion->count, &attribs);
 
-unlock:
-	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
-	return ret;
+		sc->iter = end;
+	}
+
+	return true;
 }
 
-static void _ocf_mngt_free_flush_containers(struct flush_container *fctbl,
-	uint32_t num)
+static void _ocf_mngt_flush_scan(struct flush_scanner *sc)
 {
-	int i;
+	struct ocf_mngt_cache_flush_context *context = sc->context;
+	struct flush_engine_context *fe = &context->fe;
+	ocf_cache_t cache = context->cache;
+	unsigned lock_idx = ocf_metadata_concurrency_next_idx(
+			sc->req->io_queue);
+	ocf_cache_line_t start = sc->line;
+	ocf_cache_line_t end;
+	ocf_core_id_t core_id;
+	uint64_t core_line;
 
-	for (i = 0; i < num; i++)
-		env_vfree(fctbl[i].flush_data);
-	env_vfree(fctbl);
-}
+	end = OCF_MIN((uint64_t)sc->end,
+			(uint64_t)start + OCF_MNGT_FLUSH_SCAN_STEP);
 
-/*
- * OCF will try to guess disk speed etc. and adjust flushing block
- * size accordingly, however these bounds shall be respected regardless
- * of disk speed, cache line size configured etc.
- */
-#define OCF_MNG_FLUSH_MIN (4*MiB / ocf_line_size(cache))
-#define OCF_MNG_FLUSH_MAX (100*MiB / ocf_line_size(cache))
+	sc->count = 0;
+	sc->iter = 0;
 
-static void _ocf_mngt_flush_portion(struct flush_container *fc)
-{
-	ocf_cache_t cache = fc->cache;
-	uint64_t flush_portion_div;
-	uint32_t curr_count;
+	ocf_metadata_start_shared_access(&cache->metadata.lock, lock_idx);
+
+	for (; sc->line < end; sc->line++) {
+		if (sc->count == OCF_MNGT_FLUSH_PORTION_LINES)
+			break;
+
+		/* Skip clean cache lines without touching their metadata */
+		sc->line = ocf_metadata_dirty_index_next(cache, sc->line, end);
+		if (sc->line == end)
+			break;
+
+		if (!metadata_test_dirty(cache, sc->line) ||
+				!metadata_test_valid_any(cache, sc->line)) {
+			continue;
+		}
 
-	flush_portion_div = env_ticks_to_msecs(fc->ticks2 - fc->ticks1);
-	if (unlikely(!flush_portion_div))
-		flush_portion_div = 1;
+		ocf_metadata_get_core_info(cache, sc->line, &core_id,
+				&core_line);
 
-	fc->flush_portion = fc->flush_portion * 1000 / flush_portion_div;
-	fc->flush_portion &= ~0x3ffULL;
+		if (fe->core_id != OCF_CORE_ID_INVALID &&
+				core_id != fe->core_id) {
+			continue;
+		}
 
-	/* regardless those calculations, limit flush portion to be
-	 * between OCF_MNG_FLUSH_MIN and OCF_MNG_FLUSH_MAX
-	 */
-	fc->flush_portion = OCF_MIN(fc->flush_portion, OCF_MNG_FLUSH_MAX);
-	fc->flush_portion = OCF_MAX(fc->flush_portion, OCF_MNG_FLUSH_MIN);
+		sc->data[sc->count].cache_line = sc->line;
+		sc->data[sc->count].core_line = core_line;
+		sc->data[sc->count].core_id = core_id;
+		sc->count++;
+	}
 
-	curr_count = OCF_MIN(fc->count - fc->iter, fc->flush_portion);
+	ocf_metadata_end_shared_access(&cache->metadata.lock, lock_idx);
 
-	ocf_cleaner_do_flush_data_async(fc->cache,
-			&fc->flush_data[fc->iter],
-			curr_count, &fc->attribs);
+	env_atomic64_add(sc->line - start, &cache->flush_progress.scanned);
+	env_atomic64_sub(sc->count, &fe->to_find);
 
-	fc->iter += curr_count;
+	ocf_cleaner_sort_sectors(sc->data, sc->count);
 }
 
-static void _ocf_mngt_flush_portion_end(void *private_data, int error)
+static int _ocf_mngt_flush_scanner_step(struct ocf_request *req)
 {
-	struct flush_container *fc = private_data;
-	struct ocf_mngt_cache_flush_context *context = fc->context;
-	struct flush_containers_context *fsc = &context->fcs;
-	ocf_cache_t cache = context->cache;
-	ocf_core_t core = &cache->core[fc->core_id];
-	bool first_interrupt;
+	struct flush_scanner *sc = req->priv;
+	struct ocf_mngt_cache_flush_context *context = sc->context;
 
-	env_atomic_set(&core->flushed, fc->iter);
+	while (!_ocf_mngt_flush_stopped(context)) {
+		if (sc->iter < sc->count) {
+			if (!_ocf_mngt_flush_fire(sc))
+				return 0;
+			continue;
+		}
 
-	fc->ticks2 = env_get_tick_count();
+		/* Segment is done or all dirty lines were found already */
+		if (sc->line == sc->end ||
+				env_atomic64_read(&context->fe.to_find) <= 0) {
+			break;
+		}
 
-	env_atomic_cmpxchg(&fsc->error, 0, error);
+		_ocf_mngt_flush_scan(sc);
 
-	if (cache->flushing_interrupted) {
-		first_interrupt = !env_atomic_cmpxchg(
-				&fsc->interrupt_seen, 0, 1);
-		if (first_interrupt) {
-			ocf_cache_log(cache, log_info,
-					"Flushing interrupted by user\n");
-			env_atomic_cmpxchg(&fsc->error, 0,
-					-OCF_ERR_FLUSHING_INTERRUPTED);
-		}
+		/* Let I/O requests go between scan steps */
+		ocf_engine_push_req_back(req, false);
+		return 0;
 	}
 
-	if (env_atomic_read(&fsc->error) || fc->iter == fc->count) {
-		ocf_req_put(fc->req);
-		fc->end(context);
-		return;
-	}
+	ocf_req_put(req);
+	_ocf_mngt_flush_engine_put(context);
 
-	ocf_engine_push_req_back(fc->req, false);
+	return 0;
 }
 
+static const struct ocf_io_if _io_if_flush_scanner = {
+	.read = _ocf_mngt_flush_scanner_step,
+	.write = _ocf_mngt_flush_scanner_step,
+};
 
-static int _ofc_flush_container_step(struct ocf_request *req)
+static uint32_t _ocf_mngt_flush_io_queues_count(ocf_cache_t cache)
 {
-	struct flush_container *fc = req->priv;
-	ocf_cache_t cache = fc->cache;
+	unsigned long lock_flags = 0;
+	ocf_queue_t queue;
+	uint32_t count = 0;
 
-	ocf_metadata_start_exclusive_access(&cache->metadata.lock);
-	_ocf_mngt_flush_portion(fc);
-	ocf_metadata_end_exclusive_access(&cache->metadata.lock);
+	env_spinlock_lock_irqsave(&cache->io_queues_lock, lock_flags);
 
-	return 0;
-}
+	list_for_each_entry(queue, &cache->io_queues, list) {
+		if (queue != cache->mngt_queue)
+			count++;
+	}
 
-static const struct ocf_io_if _io_if_flush_portion = {
-	.read = _ofc_flush_container_step,
-	.write = _ofc_flush_container_step,
-};
+	env_spinlock_unlock_irqrestore(&cache->io_queues_lock, lock_flags);
 
-static void _ocf_mngt_flush_container(
-		struct ocf_mngt_cache_flush_context *context,
-		struct flush_container *fc, ocf_flush_containter_coplete_t end)
-{
-	ocf_cache_t cache = context->cache;
-	struct ocf_request *req;
-	int error = 0;
+	return count;
+}
 
-	if (!fc->count)
-		goto finish;
+/* Scanners are spread over I/O queues, falling back to management queue
+ * when there are none. Caller must put the returned queue. */
+static ocf_queue_t _ocf_mngt_flush_scanner_queue_get(ocf_cache_t cache,
+		uint32_t idx)
+{
+	ocf_queue_t queue, found = NULL;
+	unsigned long lock_flags = 0;
 
-	fc->end = end;
-	fc->context = context;
+	env_spinlock_lock_irqsave(&cache->io_queues_lock, lock_flags);
 
-	req = ocf_req_new(cache->mngt_queue, NULL, 0, 0, 0);
-	if (!req) {
-		error = OCF_ERR_NO_MEM;
-		goto finish;
+	list_for_each_entry(queue, &cache->io_queues, list) {
+		if (queue == cache->mngt_queue)
+			continue;
+		if (!idx--) {
+			found = queue;
+			break;
+		}
 	}
 
-	req->info.internal = true;
-	req->io_if = &_io_if_flush_portion;
-	req->priv = fc;
-
-	fc->req = req;
-	fc->attribs.lock_cacheline = true;
-	fc->attribs.lock_metadata = false;
-	fc->attribs.cmpl_context = fc;
-	fc->attribs.cmpl_fn = _ocf_mngt_flush_portion_end;
-	fc->attribs.io_queue = cache->mngt_queue;
-	fc->cache = cache;
-	fc->flush_portion = OCF_MNG_FLUSH_MIN;
-	fc->ticks1 = 0;
-	fc->ticks2 = UINT_MAX;
-
-	ocf_engine_push_req_back(fc->req, true);
-	return;
+	/* Queue being destroyed has no references left */
+	if (found && !env_atomic_add_unless(&found->ref_count, 1, 0))
+		found = NULL;
+
+	env_spinlock_unlock_irqrestore(&cache->io_queues_lock, lock_flags);
+
+	if (!found) {
+		found = cache->mngt_queue;
+		ocf_queue_get(found);
+	}
 
-finish:
-	env_atomic_cmpxchg(&context->fcs.error, 0, error);
-	end(context);
+	return found;
 }
 
-void _ocf_flush_container_complete(void *ctx)
+static struct ocf_request *_ocf_mngt_flush_scanner_req(ocf_cache_t cache,
+		struct flush_scanner *sc, uint32_t idx)
 {
-	struct ocf_mngt_cache_flush_context *context = ctx;
+	struct ocf_request *req;
+	ocf_queue_t queue;
 
-	if (env_atomic_dec_return(&context->fcs.count)) {
-		return;
+	queue = _ocf_mngt_flush_scanner_queue_get(cache, idx);
+	req = ocf_req_new(queue, NULL, 0, 0, 0);
+	ocf_queue_put(queue);
+
+	if (req && req->d2c) {
+		/* Metadata refcount is frozen, I/O queues cannot be used */
+		ocf_req_put(req);
+		req = ocf_req_new(cache->mngt_queue, NULL, 0, 0, 0);
 	}
 
-	_ocf_mngt_free_flush_containers(context->fcs.fctbl,
-			context->fcs.fcnum);
+	if (!req)
+		return NULL;
 
-	context->fcs.complete(context,
-			env_atomic_read(&context->fcs.error));
+	req->info.internal = true;
+	req->io_if = &_io_if_flush_scanner;
+	req->priv = sc;
+
+	return req;
 }
 
-static void _ocf_mngt_flush_containers(
+static void _ocf_mngt_flush_engine_start(
 		struct ocf_mngt_cache_flush_context *context,
-		struct flush_container *fctbl,
-		uint32_t fcnum, ocf_flush_complete_t complete)
+		ocf_core_id_t core_id, uint64_t dirty,
+		ocf_flush_complete_t complete)
 {
-	int i;
+	struct flush_engine_context *fe = &context->fe;
+	ocf_cache_t cache = context->cache;
+	uint64_t entries = cache->device->collision_table_entries;
+	struct flush_scanner *sc;
+	uint64_t segment;
+	uint32_t i, num;
 
-	if (fcnum == 0) {
+	if (!dirty) {
 		complete(context, 0);
 		return;
 	}
 
-	/* Sort data. Smallest sectors first (0...n). */
-	ocf_cleaner_sort_flush_containers(fctbl, fcnum);
+	num = _ocf_mngt_flush_io_queues_count(cache);
+	num = OCF_MIN(OCF_MAX(num, 1U), (uint32_t)OCF_MNGT_FLUSH_MAX_SCANNERS);
+
+	fe->scanners = env_vzalloc(num * sizeof(*fe->scanners));
+	if (!fe->scanners)
+		goto err_scanners;
+
+	fe->inflight = env_vzalloc(OCF_CORE_MAX * sizeof(*fe->inflight));
+	if (!fe->inflight)
+		goto err_inflight;
+
+	if (env_spinlock_init(&fe->lock))
+		goto err_lock;
+
+	fe->scanners_num = num;
+	fe->core_id = core_id;
+	fe->complete = complete;
+	env_atomic64_set(&fe->to_find, dirty);
+	env_atomic_set(&fe->error, 0);
+	env_atomic_set(&fe->interrupt_seen, 0);
+	env_atomic_set(&fe->count, 1);
+
+	cache->flush_progress.start = env_get_tick_count();
+	cache->flush_progress.dirty_initial = dirty;
+	cache->flush_progress.total = entries;
+	env_atomic64_set(&cache->flush_progress.flushed, 0);
+	env_atomic64_set(&cache->flush_progress.scanned, 0);
+	env_atomic_set(&cache->flush_progress.active, 1);
+
+	segment = OCF_DIV_ROUND_UP(entries, num);
+
+	for (i = 0; i < num; i++) {
+		sc = &fe->scanners[i];
+		sc->context = context;
+		sc->line = OCF_MIN(i * segment, entries);
+		sc->end = OCF_MIN((i + 1) * segment, entries);
+		sc->waiting = OCF_CORE_MAX;
+
+		sc->req = _ocf_mngt_flush_scanner_req(cache, sc, i);
+		if (!sc->req) {
+			env_atomic_cmpxchg(&fe->error, 0, -OCF_ERR_NO_MEM);
+			continue;
+		}
 
-	env_atomic_set(&context->fcs.error, 0);
-	env_atomic_set(&context->fcs.count, 1);
-	context->fcs.complete = complete;
-	context->fcs.fctbl = fctbl;
-	context->fcs.fcnum = fcnum;
+		env_atomic_inc(&fe->count);
+	}
 
-	for (i = 0; i < fcnum; i++) {
-		env_atomic_inc(&context->fcs.count);
-		_ocf_mngt_flush_container(context, &fctbl[i],
-			_ocf_flush_container_complete);
+	for (i = 0; i < num; i++) {
+		if (fe->scanners[i].req)
+			ocf_engine_push_req_back(fe->scanners[i].req, false);
 	}
 
-	_ocf_flush_container_complete(context);
-}
+	_ocf_mngt_flush_engine_put(context);
+	return;
 
+err_lock:
+	env_vfree(fe->inflight);
+err_inflight:
+	env_vfree(fe->scanners);
+err_scanners:
+	ocf_cache_log(cache, log_err, "Flushing operation aborted, "
+			"no memory\n");
+	complete(context, -OCF_ERR_NO_MEM);
+}
 
 static void _ocf_mngt_flush_core(
 	struct ocf_mngt_cache_flush_context *context,
 	ocf_flush_complete_t complete)
 {
-	ocf_cache_t cache = context->cache;
 	ocf_core_t core = context->core;
-	ocf_core_id_t core_id = ocf_core_get_id(core);
-	struct flush_container *fc;
-	int ret;
-
-	fc = env_vzalloc(sizeof(*fc));
-	if (!fc) {
-		complete(context, -OCF_ERR_NO_MEM);
-		return;
-	}
 
-	ret = _ocf_mngt_get_sectors(cache, core_id,
-			&fc->flush_data, &fc->count);
-	if (ret) {
-		ocf_core_log(core, log_err, "Flushing operation aborted, "
-				"no memory\n");
-		env_vfree(fc);
-		complete(context, -OCF_ERR_NO_MEM);
-		return;
-	}
-
-	fc->core_id = core_id;
-	fc->iter = 0;
-
-	_ocf_mngt_flush_containers(context, fc, 1, complete);
+	_ocf_mngt_flush_engine_start(context, ocf_core_get_id(core),
+			env_atomic_read(&core->runtime_meta->dirty_clines),
+			complete);
 }
 
 static void _ocf_mngt_flush_all_cores(
@@ -539,9 +606,9 @@ static void _ocf_mngt_flush_all_cores(
 	ocf_flush_complete_t complete)
 {
 	ocf_cache_t cache = context->cache;
-	struct flush_container *fctbl = NULL;
-	uint32_t fcnum = 0;
-	int ret;
+	ocf_core_t core;
+	ocf_core_id_t core_id;
+	uint64_t dirty = 0;
 
 	if (context->op == flush_cache)
 		ocf_cache_log(cache, log_info, "Flushing cache\n");
@@ -550,17 +617,11 @@ static void _ocf_mngt_flush_all_cores(
 
 	env_atomic_set(&cache->flush_in_progress, 1);
 
-	/* Get all 'dirty' sectors for all cores */
-	ret = _ocf_mngt_get_flush_containers(cache, &fctbl, &fcnum);
-	if (ret) {
-		ocf_cache_log(cache, log_err, "Flushing operation aborted, "
-				"no memory\n");
-		ocf_metadata_end_exclusive_access(&cache->metadata.lock);
-		complete(context, ret);
-		return;
-	}
+	for_each_core(cache, core, core_id)
+		dirty += env_atomic_read(&core->runtime_meta->dirty_clines);
 
-	_ocf_mngt_flush_containers(context, fctbl, fcnum, complete);
+	_ocf_mngt_flush_engine_start(context, OCF_CORE_ID_INVALID, dirty,
+			complete);
 }
 
 static void _ocf_mngt_flush_all_cores_complete(
@@ -901,6 +962,35 @@ void ocf_mngt_cache_flush_interrupt(ocf_cache_t cache)
 	cache->flushing_interrupted = 1;
 }
 
+int ocf_mngt_cache_set_flush_queue_depth(ocf_cache_t cache, uint32_t depth)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (depth < OCF_MNGT_FLUSH_MIN_QUEUE_DEPTH ||
+			depth > OCF_MNGT_FLUSH_MAX_QUEUE_DEPTH) {
+		ocf_cache_log(cache, log_err, "Invalid flush queue depth %u\n",
+				depth);
+		return -OCF_ERR_INVAL;
+	}
+
+	cache->flush_queue_depth = depth;
+
+	ocf_cache_log(cache, log_info, "Flush queue depth set to %u\n",
+			depth);
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_flush_queue_depth(ocf_cache_t cache, uint32_t *depth)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(depth);
+
+	*depth = cache->flush_queue_depth;
+
+	return 0;
+}
+
 struct ocf_mngt_cache_set_cleaning_context
 {
 	/* pipeline for switching cleaning policy */
@@ -72,6 +72,9 @@ int ocf_mngt_add_partition_to_cache(struct ocf_cache *cache,
 	cache->user_parts[part_id].config->max_size = max_size;
 	cache->user_parts[part_id].config->priority = priority;
 	cache->user_parts[part_id].config->cache_mode = ocf_cache_mode_max;
+	cache->user_parts[part_id].config->slru_protected_size = 0;
+	cache->user_parts[part_id].config->headroom_size = 0;
+	cache->user_parts[part_id].config->ttl = 0;
 
 	ocf_user_part_set_valid(cache, part_id, valid);
 	ocf_lst_add(&cache->user_part_list, part_id);
@@ -107,6 +110,43 @@ static int _ocf_mngt_set_partition_size(struct ocf_cache *cache,
 	return 0;
 }
 
+static void _ocf_mngt_set_partition_protected_size(ocf_cache_t cache,
+		struct ocf_user_part *user_part, uint8_t protected_size)
+{
+	if (user_part->config->slru_protected_size == protected_size)
+		return;
+
+	user_part->config->slru_protected_size = protected_size;
+	ocf_lru_set_protected_size(cache, &user_part->part, protected_size);
+
+	ocf_cache_log(cache, log_info, "IO class %u segmented LRU protected "
+			"size: %u%%\n", user_part->part.id, protected_size);
+}
+
+static void _ocf_mngt_set_partition_headroom(ocf_cache_t cache,
+		struct ocf_user_part *user_part, uint8_t headroom_size)
+{
+	if (user_part->config->headroom_size == headroom_size)
+		return;
+
+	user_part->config->headroom_size = headroom_size;
+
+	ocf_cache_log(cache, log_info, "IO class %u headroom size: %u%%\n",
+			user_part->part.id, headroom_size);
+}
+
+static void _ocf_mngt_set_partition_ttl(ocf_cache_t cache,
+		struct ocf_user_part *user_part, uint32_t ttl)
+{
+	if (user_part->config->ttl == ttl)
+		return;
+
+	user_part->config->ttl = ttl;
+
+	ocf_cache_log(cache, log_info, "IO class %u time to live: %us\n",
+			user_part->part.id, ttl);
+}
+
 static int _ocf_mngt_io_class_configure(ocf_cache_t cache,
 		const struct ocf_mngt_io_class_config *cfg)
 {
@@ -153,6 +193,11 @@ static int _ocf_mngt_io_class_configure(ocf_cache_t cache,
 		}
 		ocf_user_part_set_prio(cache, dest_part, prio);
 		dest_part->config->cache_mode = cache_mode;
+		_ocf_mngt_set_partition_protected_size(cache, dest_part,
+				cfg->slru_protected_size);
+		_ocf_mngt_set_partition_headroom(cache, dest_part,
+				cfg->headroom_size);
+		_ocf_mngt_set_partition_ttl(cache, dest_part, cfg->ttl);
 
 		ocf_cache_log(cache, log_info,
 				"Updating unclassified IO class, id: %u, name :'%s',"
@@ -192,6 +237,10 @@ static int _ocf_mngt_io_class_configure(ocf_cache_t cache,
 
 	ocf_user_part_set_prio(cache, dest_part, prio);
 	dest_part->config->cache_mode = cache_mode;
+	_ocf_mngt_set_partition_protected_size(cache, dest_part,
+			cfg->slru_protected_size);
+	_ocf_mngt_set_partition_headroom(cache, dest_part, cfg->headroom_size);
+	_ocf_mngt_set_partition_ttl(cache, dest_part, cfg->ttl);
 
 	return result;
 }
@@ -272,6 +321,53 @@ static int _ocf_mngt_io_class_validate_cfg(ocf_cache_t cache,
 		return -OCF_ERR_INVAL;
 	}
 
+	if (cfg->slru_protected_size > PARTITION_SIZE_MAX) {
+		ocf_cache_log(cache, log_info, "Invalid value of the "
+				"partition segmented LRU protected size\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->slru_protected_size && cache->conf_meta->eviction_policy_type
+			== ocf_eviction_clock) {
+		ocf_cache_log(cache, log_info, "Segmented LRU is not "
+				"supported with CLOCK eviction policy\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->headroom_size > cfg->max_size) {
+		ocf_cache_log(cache, log_info, "Invalid value of the "
+				"partition headroom size\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->ttl > OCF_IO_CLASS_TTL_MAX) {
+		ocf_cache_log(cache, log_info, "Invalid value of the "
+				"partition time to live\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	return 0;
+}
+
+/* Headroom of all IO classes is reserved from the same free space, so it
+ * can't exceed the cache size */
+static int _ocf_mngt_io_classes_validate_headroom(ocf_cache_t cache,
+		const struct ocf_mngt_io_classes_config *cfg)
+{
+	uint32_t headroom = 0;
+	int i;
+
+	for (i = 0; i < OCF_USER_IO_CLASS_MAX; i++) {
+		if (cfg->config[i].name)
+			headroom += cfg->config[i].headroom_size;
+	}
+
+	if (headroom > PARTITION_SIZE_MAX) {
+		ocf_cache_log(cache, log_info, "Total headroom size of IO "
+				"classes exceeds cache size\n");
+		return -OCF_ERR_INVAL;
+	}
+
 	return 0;
 }
 
@@ -291,6 +387,21 @@ int ocf_mngt_cache_io_classes_configure(ocf_cache_t cache,
 			return result;
 	}
 
+	result = _ocf_mngt_io_classes_validate_headroom(cache, cfg);
+	if (result)
+		return result;
+
+	/* Mapping time of cache lines is needed to expire them, allocate it
+	 * upfront so that new config is applied without failure */
+	for (i = 0; i < OCF_USER_IO_CLASS_MAX; i++) {
+		if (cfg->config[i].name && cfg->config[i].ttl) {
+			result = ocf_lru_age_init(cache);
+			if (result)
+				return result;
+			break;
+		}
+	}
+
 	old_config = env_malloc(sizeof(cache->user_parts), ENV_MEM_NORMAL);
 	if (!old_config)
 		return -OCF_ERR_NO_MEM;
@@ -312,6 +423,8 @@ int ocf_mngt_cache_io_classes_configure(ocf_cache_t cache,
 	}
 
 	ocf_user_part_sort(cache);
+	ocf_space_update_headroom(cache);
+	ENV_BUG_ON(ocf_lru_update_ttl(cache));
 
 out_edit:
 	if (result) {
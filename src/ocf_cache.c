@@ -83,6 +83,7 @@ int ocf_cache_get_info(ocf_cache_t cache, struct ocf_cache_info *info)
 	uint32_t cache_occupancy_inactive = 0;
 	ocf_core_t core;
 	ocf_core_id_t core_id;
+	int i;
 
 	OCF_CHECK_NULL(cache);
 
@@ -177,10 +178,16 @@ int ocf_cache_get_info(ocf_cache_t cache, struct ocf_cache_info *info)
 
 	info->cleaning_policy = cache->conf_meta->cleaning_policy_type;
 	info->promotion_policy = cache->conf_meta->promotion_policy_type;
+	info->eviction_policy = cache->conf_meta->eviction_policy_type;
 	info->metadata_footprint = ocf_cache_is_device_attached(cache) ?
 			ocf_metadata_size_of(cache) : 0;
 	info->cache_line_size = ocf_line_size(cache);
 
+	for (i = 0; i < ocf_metadata_page_max; i++) {
+		info->metadata_backing[i] = env_atomic64_read(
+				&cache->metadata.backing[i]);
+	}
+
 	return 0;
 }
 
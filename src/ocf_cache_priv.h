@@ -108,9 +108,34 @@ struct ocf_cache {
     env_atomic flush_in_progress;
     env_mutex flush_mutex;
 
+    /* container portions in flight per core during flush */
+    uint32_t flush_queue_depth;
+
+    struct {
+        /* flush or purge is in progress */
+        env_atomic active;
+        /* tick count at flush start */
+        uint64_t start;
+        /* dirty cache lines to be flushed */
+        uint64_t dirty_initial;
+        /* cache lines written back so far */
+        env_atomic64 flushed;
+        /* cache line metadata entries scanned so far */
+        env_atomic64 scanned;
+        /* cache line metadata entries to be scanned */
+        uint64_t total;
+    } flush_progress;
+
     struct ocf_cleaner cleaner;
 
+    /* cleaner counters which are not attributed to any core */
+    struct ocf_counters_cleaner cleaner_counters;
+
     struct list_head io_queues;
+    /* protects io_queues list */
+    env_spinlock io_queues_lock;
+    /* lru home list assigned to the next created queue */
+    env_atomic next_lru_home;
     ocf_promotion_policy_t promotion_policy;
 
     struct {
@@ -118,6 +143,51 @@ struct ocf_cache {
         uint32_t queue_unblock_size;
     } backfill;
 
+    struct {
+        /* largest write eligible for coalescing, 0 if disabled */
+        uint32_t max_io_size;
+        /* upper bound of merged request size */
+        uint32_t max_batch_size;
+    } write_coalescing;
+
+    struct {
+        /* pages written by single metadata commit, 0 if disabled */
+        uint32_t max_pages;
+        /* how long batch may wait behind commit in progress */
+        uint32_t window_us;
+    } metadata_group_commit;
+
+    /* requests larger than this are split, 0 if disabled */
+    uint32_t split_io_size;
+
+    /* zero-filled writes bypass cache data path */
+    bool zero_detection;
+
+    /* lru hot elements are balanced by cleaner, not on I/O path */
+    bool lru_deferred_balance;
+
+    /* any io class has time to live set */
+    bool lru_ttl_active;
+
+    /* eviction telemetry is collected */
+    bool eviction_stats;
+
+    /* per line mapping time and hits, NULL unless stats or ttl need them */
+    struct ocf_lru_age *lru_age;
+
+    /* pinned core line ranges of all cores */
+    env_atomic pinned_ranges;
+
+    struct {
+        /* free cachelines count starting background reclaim,
+         * 0 if disabled */
+        uint32_t low_watermark;
+        /* free cachelines count at which reclaim stops */
+        uint32_t high_watermark;
+        /* free cachelines kept for io classes headroom */
+        uint32_t headroom;
+    } lru_reclaim;
+
     void* priv;
 
     /*
@@ -4,6 +4,8 @@
  */
 
 #include "engine/cache_engine.h"
+#include "engine/engine_coalesce.h"
+#include "engine/engine_split.h"
 #include "metadata/metadata.h"
 #include "ocf/ocf.h"
 #include "ocf_core_priv.h"
@@ -218,6 +220,10 @@ static int ocf_core_submit_io_fast(struct ocf_io* io, struct ocf_request* req, o
         case ocf_req_cache_mode_pt:
             return -OCF_ERR_IO;
         case ocf_req_cache_mode_wb:
+            /* Leave small writes to the coalescing stage */
+            if (ocf_engine_coalesce_eligible(req))
+                return -OCF_ERR_IO;
+            /* fall through */
         case ocf_req_cache_mode_wo:
             req->cache_mode = ocf_req_cache_mode_fast;
             break;
@@ -249,6 +255,76 @@ static int ocf_core_submit_io_fast(struct ocf_io* io, struct ocf_request* req, o
     return -OCF_ERR_IO;
 }
 
+static void ocf_core_update_second_admission(struct ocf_request* req) {
+    // 考虑将二次准入的代码移植到此处
+    // 给 req 增加一个字段，用于后续进行判断是否能够二次准入
+    // 默认允许二次准入
+    req->allow_second_admission = true;
+    
+    // 只对读请求进行二次准入检查
+    if (req->rw == OCF_READ) {
+        // 使用宏定义计算页面对齐的地址和总页数
+        uint64_t start_addr = PAGE_ALIGN_DOWN(req->ioi.io.addr);
+        uint64_t end_addr = PAGE_ALIGN_DOWN(req->ioi.io.addr + req->ioi.io.bytes - 1);
+        uint64_t total_pages = PAGES_IN_REQ(start_addr, end_addr);
+        uint64_t hit_pages = 0;
+
+        // 检查历史记录中的命中情况
+        for (uint64_t curr_addr = start_addr; curr_addr <= end_addr; curr_addr += PAGE_SIZE) {
+            if (ocf_history_hash_find(curr_addr, ocf_core_get_id(req->core))) {
+                hit_pages++;
+            }
+        }
+
+        // 判断缓存使用情况，缓存占满了才启用二次准入，否则不启用
+        bool cache_full = ocf_is_cache_full(req->cache);
+
+        // 如果历史命中率低于阈值且缓存已满，则不允许二次准入
+        if ((float)hit_pages / total_pages < HISTORY_HIT_RATIO_THRESHOLD && cache_full) {
+            req->allow_second_admission = false;
+            
+            // 将当前请求涉及到的所有 4K 块都尝试添加到历史记录中
+            for (uint64_t curr_addr = start_addr; curr_addr <= end_addr; curr_addr += PAGE_SIZE) {
+                ocf_history_hash_add_addr(curr_addr, ocf_core_get_id(req->core));
+            }
+        }
+    }
+}
+
+static int ocf_core_submit_io_split(struct ocf_io* io, struct ocf_request* req, ocf_core_t core, ocf_cache_t cache) {
+    int ret;
+
+    /* Children inherit effective cache mode of the request */
+    ocf_resolve_effective_cache_mode(cache, core, req);
+
+    ret = ocf_engine_prepare_split_req(req);
+    if (ret) {
+        /* Request is handled as a whole, with cache mode resolved here */
+        return ret;
+    }
+
+    /* Children are not handled in fast path, so admission is decided
+     * once for the whole request, as for request missed in fast path */
+    ocf_core_update_second_admission(req);
+
+    OCF_DEBUG_IO("Split", req);
+
+    ocf_io_get(io);
+
+    /* Account request before any of its children can complete it */
+    ocf_core_update_stats(core, io);
+    ocf_core_seq_cutoff_update(core, req);
+
+    if (io->dir == OCF_WRITE)
+        ocf_trace_io(req, ocf_event_operation_wr);
+    else if (io->dir == OCF_READ)
+        ocf_trace_io(req, ocf_event_operation_rd);
+
+    ocf_engine_submit_split_req(req);
+
+    return 0;
+}
+
 void ocf_core_volume_submit_io(struct ocf_io* io) {
     env_atomic_inc(&cnt);
     OCF_DEBUG_SEPARATOR(cnt);
@@ -256,6 +332,7 @@ void ocf_core_volume_submit_io(struct ocf_io* io) {
     struct ocf_request* req;
     ocf_core_t core;
     ocf_cache_t cache;
+    bool resolved = false;
     int ret;
 
     OCF_CHECK_NULL(io);
@@ -278,17 +355,28 @@ void ocf_core_volume_submit_io(struct ocf_io* io) {
         return;
     }
 
+    req->part_id = ocf_user_part_class2id(cache, io->io_class);
+    req->core = core;
+    req->complete = ocf_req_complete;
+
+    /* Split large request before its map is allocated */
+    if (ocf_engine_split_needed(req)) {
+        if (!ocf_core_submit_io_split(io, req, core, cache))
+            return;
+
+        /* Reuse cache mode resolved when split was declined */
+        resolved = true;
+    }
+
     ret = ocf_req_alloc_map(req);
     if (ret) {
+        dec_counter_if_req_was_dirty(req);
         ocf_io_end(io, ret);
         return;
     }
 
-    req->part_id = ocf_user_part_class2id(cache, io->io_class);
-    req->core = core;
-    req->complete = ocf_req_complete;
-
-    ocf_resolve_effective_cache_mode(cache, core, req);
+    if (!resolved)
+        ocf_resolve_effective_cache_mode(cache, core, req);
 
     ocf_core_update_stats(core, io);
 
@@ -303,39 +391,7 @@ void ocf_core_volume_submit_io(struct ocf_io* io) {
         return;
     }
 
-    // 考虑将二次准入的代码移植到此处
-    // 给 req 增加一个字段，用于后续进行判断是否能够二次准入
-    // 默认允许二次准入
-    req->allow_second_admission = true;
-    
-    // 只对读请求进行二次准入检查
-    if (io->dir == OCF_READ) {
-        // 使用宏定义计算页面对齐的地址和总页数
-        uint64_t start_addr = PAGE_ALIGN_DOWN(req->ioi.io.addr);
-        uint64_t end_addr = PAGE_ALIGN_DOWN(req->ioi.io.addr + req->ioi.io.bytes - 1);
-        uint64_t total_pages = PAGES_IN_REQ(start_addr, end_addr);
-        uint64_t hit_pages = 0;
-
-        // 检查历史记录中的命中情况
-        for (uint64_t curr_addr = start_addr; curr_addr <= end_addr; curr_addr += PAGE_SIZE) {
-            if (ocf_history_hash_find(curr_addr, ocf_core_get_id(req->core))) {
-                hit_pages++;
-            }
-        }
-
-        // 判断缓存使用情况，缓存占满了才启用二次准入，否则不启用
-        bool cache_full = ocf_is_cache_full(req->cache);
-
-        // 如果历史命中率低于阈值且缓存已满，则不允许二次准入
-        if ((float)hit_pages / total_pages < HISTORY_HIT_RATIO_THRESHOLD && cache_full) {
-            req->allow_second_admission = false;
-            
-            // 将当前请求涉及到的所有 4K 块都尝试添加到历史记录中
-            for (uint64_t curr_addr = start_addr; curr_addr <= end_addr; curr_addr += PAGE_SIZE) {
-                ocf_history_hash_add_addr(curr_addr, ocf_core_get_id(req->core));
-            }
-        }
-    }
+    ocf_core_update_second_admission(req);
 
     OCF_DEBUG_IO("Miss", req);
 
@@ -11,6 +11,7 @@
 #include "ocf_ctx_priv.h"
 #include "ocf_volume_priv.h"
 #include "ocf_seq_cutoff.h"
+#include "ocf_def_priv.h"
 
 #define ocf_core_log_prefix(core, lvl, prefix, fmt, ...) \
 	ocf_cache_log_prefix(ocf_core_get_cache(core), lvl, ".%s" prefix, \
@@ -82,8 +83,14 @@ struct ocf_core {
 
 	struct ocf_seq_cutoff *seq_cutoff;
 
+	/* pinned core line ranges */
+	struct ocf_core_pin *pin;
+
 	env_atomic flushed;
 
+	/* average latency of read misses served by core volume */
+	env_atomic miss_latency_us;
+
 	/* This bit means that core volume is initialized */
 	uint32_t has_volume : 1;
 	/* This bit means that core volume is open */
@@ -96,6 +103,17 @@ struct ocf_core {
 	void *priv;
 };
 
+/* Moving average of core read miss latency, each sample weighs 1/8 */
+static inline void ocf_core_update_miss_latency(ocf_core_t core,
+		uint64_t latency_us)
+{
+	int avg = env_atomic_read(&core->miss_latency_us);
+	int sample = OCF_MIN(latency_us, (uint64_t)INT_MAX);
+
+	env_atomic_set(&core->miss_latency_us,
+			avg ? avg + (sample - avg) / 8 : sample);
+}
+
 bool ocf_core_is_valid(ocf_cache_t cache, ocf_core_id_t id);
 
 ocf_core_id_t ocf_core_get_id(ocf_core_t core);
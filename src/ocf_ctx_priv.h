@@ -145,6 +145,20 @@ static inline void ctx_data_secure_erase(ocf_ctx_t ctx, ctx_data_t *dst)
 	return ctx->ops->data.secure_erase(dst);
 }
 
+static inline bool ctx_data_has_is_zero(ocf_ctx_t ctx)
+{
+	return !!ctx->ops->data.is_zero;
+}
+
+static inline bool ctx_data_is_zero(ocf_ctx_t ctx, ctx_data_t *src,
+		uint64_t offset, uint64_t bytes)
+{
+	if (!ctx->ops->data.is_zero)
+		return false;
+
+	return ctx->ops->data.is_zero(src, offset, bytes);
+}
+
 static inline int ctx_cleaner_init(ocf_ctx_t ctx, ocf_cleaner_t cleaner)
 {
 	return ctx->ops->cleaner.init(cleaner);
@@ -40,7 +40,12 @@
         __x < __y ? __x : __y;   \
     })
 
-#define METADATA_VERSION() ((OCF_VERSION_MAIN << 16) + \
+/* Revision of on-disk metadata layout, bumped on every change of persistent
+ * structures which is made without OCF version change */
+#define METADATA_LAYOUT_REVISION 7
+
+#define METADATA_VERSION() ((METADATA_LAYOUT_REVISION << 24) + \
+                            (OCF_VERSION_MAIN << 16) + \
                             (OCF_VERSION_MAJOR << 8) + OCF_VERSION_MINOR)
 
 /* call conditional reschedule every 'iterations' calls */
@@ -45,6 +45,10 @@ int ocf_cache_io_class_get_info(ocf_cache_t cache, uint32_t io_class,
 	info->cleaning_policy_type = cache->conf_meta->cleaning_policy_type;
 
 	info->cache_mode = cache->user_parts[part_id].config->cache_mode;
+	info->slru_protected_size =
+			cache->user_parts[part_id].config->slru_protected_size;
+	info->headroom_size = cache->user_parts[part_id].config->headroom_size;
+	info->ttl = cache->user_parts[part_id].config->ttl;
 
 	return 0;
 }
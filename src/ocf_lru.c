@@ -7,15 +7,91 @@
 #include "ocf_lru.h"
 #include "utils/utils_cleaner.h"
 #include "utils/utils_cache_line.h"
+#include "utils/utils_user_part.h"
 #include "concurrency/ocf_concurrency.h"
 #include "mngt/ocf_mngt_common.h"
 #include "engine/engine_zero.h"
 #include "ocf_cache_priv.h"
 #include "ocf_request.h"
 #include "engine/engine_common.h"
+#include "ocf_pin.h"
 
 static const ocf_cache_line_t end_marker = (ocf_cache_line_t)-1;
 
+uint32_t ocf_lru_num_lists(ocf_cache_t cache)
+{
+	return cache->conf_meta->lru_lists;
+}
+
+/* LRU list owned by the queue. Lines mapped through the queue are taken from
+ * this list of the freelist, so they land on the same list of the user
+ * partition, which keeps list locks mostly local to the queue. */
+static inline uint32_t ocf_lru_home_list(ocf_cache_t cache,
+		ocf_queue_t io_queue)
+{
+	return io_queue->lru_home % ocf_lru_num_lists(cache);
+}
+
+/* With CLOCK eviction hot bit of LRU node is used as reference bit. Lists
+ * do not track hot elements then, so the bit is never balanced. */
+static inline bool ocf_lru_is_clock(ocf_cache_t cache)
+{
+	return cache->conf_meta->eviction_policy_type == ocf_eviction_clock;
+}
+
+static inline bool ocf_lru_is_cost_aware(ocf_cache_t cache)
+{
+	return cache->conf_meta->eviction_policy_type == ocf_eviction_cost;
+}
+
+/* Time to live of partition lines in seconds, 0 if lines do not expire */
+static inline uint16_t ocf_lru_part_ttl(ocf_cache_t cache,
+		struct ocf_part *part)
+{
+	if (!cache->lru_ttl_active || part->id == PARTITION_FREELIST)
+		return 0;
+
+	return cache->user_parts[part->id].config->ttl;
+}
+
+static inline uint32_t ocf_lru_now_secs(void)
+{
+	return env_ticks_to_secs(env_get_tick_count());
+}
+
+static inline struct ocf_lru_age *ocf_lru_get_age(ocf_cache_t cache,
+		ocf_cache_line_t cline)
+{
+	return cache->lru_age ? &cache->lru_age[cline] : NULL;
+}
+
+/* Pinned ranges are looked up only for lines considered for eviction */
+static inline bool ocf_lru_pinned(ocf_cache_t cache, ocf_cache_line_t cline)
+{
+	ocf_core_id_t core_id;
+	uint64_t core_line;
+
+	if (!env_atomic_read(&cache->pinned_ranges))
+		return false;
+
+	ocf_metadata_get_core_info(cache, cline, &core_id, &core_line);
+	if (core_id >= OCF_CORE_MAX || !cache->core[core_id].pin)
+		return false;
+
+	return ocf_core_pin_check(&cache->core[core_id], core_line);
+}
+
+static inline bool ocf_lru_expired(ocf_cache_t cache, ocf_cache_line_t cline,
+		uint16_t ttl, uint32_t now)
+{
+	struct ocf_lru_age *age = ocf_lru_get_age(cache, cline);
+
+	return ttl && age && now - age->mapped_secs >= ttl;
+}
+
+/* Number of lines at the lru list tail compared by cost-aware eviction */
+#define OCF_LRU_COST_WINDOW 8
+
 /* update list last_hot index. returns pivot element (the one for which hot
  * status effectively changes during balancing). */
 static inline ocf_cache_line_t balance_update_last_hot(ocf_cache_t cache,
@@ -52,19 +128,53 @@ static inline ocf_cache_line_t balance_update_last_hot(ocf_cache_t cache,
 	return (change > 0) ? list->last_hot : last_hot_old;
 }
 
+static inline unsigned lru_list_target_hot(struct ocf_lru_list *list)
+{
+	if (list->protected_pct) {
+		return (uint64_t)list->num_nodes * list->protected_pct /
+				PARTITION_SIZE_MAX;
+	}
+
+	return list->num_nodes / OCF_LRU_HOT_RATIO;
+}
+
+/* Segmented LRU - lines become protected only when hit, so protected
+ * segment is never filled up to its target size, only trimmed down to it.
+ * Demoted lines become head of the probation segment. */
+static void balance_slru_list(ocf_cache_t cache, struct ocf_lru_list *list)
+{
+	unsigned target_hot_count = lru_list_target_hot(list);
+	ocf_cache_line_t pivot;
+
+	while (list->num_hot > target_hot_count) {
+		pivot = balance_update_last_hot(cache, list, -1);
+		--list->num_hot;
+		ocf_metadata_get_lru(cache, pivot)->hot = false;
+	}
+}
+
 /* Increase / decrease number of hot elements to achieve target count.
  * Asssumes that the list has hot element clustered together at the
  * head of the list.
  */
 static void balance_lru_list(ocf_cache_t cache, struct ocf_lru_list *list)
 {
-	unsigned target_hot_count = list->num_nodes / OCF_LRU_HOT_RATIO;
+	unsigned target_hot_count = lru_list_target_hot(list);
 	int change = target_hot_count - list->num_hot;
 	ocf_cache_line_t pivot;
 
 	if (!list->track_hot)
 		return;
 
+	/* done periodically by ocf_lru_balance_all() */
+	if (cache->lru_deferred_balance)
+		return;
+
+	if (list->protected_pct) {
+		balance_slru_list(cache, list);
+		return;
+	}
+
 	/* 1 - update hot counter */
 	list->num_hot = target_hot_count;
 
@@ -124,10 +234,51 @@ static void add_lru_head_nobalance(ocf_cache_t cache,
 	}
 }
 
+/* Adds the given collision_index right after the last hot element, that is
+ * to the head of segmented LRU probation segment */
+static void add_lru_probation_nobalance(ocf_cache_t cache,
+		struct ocf_lru_list *list, ocf_cache_line_t collision_index)
+{
+	struct ocf_lru_meta *node, *prev_node;
+	ocf_cache_line_t next;
+
+	ENV_BUG_ON(collision_index == end_marker);
+
+	node = ocf_metadata_get_lru(cache, collision_index);
+	node->hot = false;
+
+	if (list->last_hot == end_marker) {
+		next = list->head;
+		list->head = collision_index;
+	} else {
+		prev_node = ocf_metadata_get_lru(cache, list->last_hot);
+		next = prev_node->next;
+		prev_node->next = collision_index;
+	}
+
+	node->prev = list->last_hot;
+	node->next = next;
+
+	if (next == end_marker)
+		list->tail = collision_index;
+	else
+		ocf_metadata_get_lru(cache, next)->prev = collision_index;
+
+	++list->num_nodes;
+}
+
 static void add_lru_head(ocf_cache_t cache, struct ocf_lru_list *list,
 		ocf_cache_line_t collision_index)
 {
-	add_lru_head_nobalance(cache, list, collision_index);
+	/* with deferred balancing hot count is not adjusted on insertion,
+	 * so new line goes cold, right after the last hot element */
+	if (list->track_hot && (list->protected_pct ||
+			cache->lru_deferred_balance)) {
+		add_lru_probation_nobalance(cache, list, collision_index);
+	} else {
+		add_lru_head_nobalance(cache, list, collision_index);
+	}
+
 	balance_lru_list(cache, list);
 }
 
@@ -186,12 +337,13 @@ static void remove_lru_list_nobalance(ocf_cache_t cache,
 	remove_update_ptrs(cache, list, collision_index, node);
 
 	--list->num_nodes;
-	if (node->hot)
+	if (list->track_hot && node->hot)
 		--list->num_hot;
 
 	node->next = end_marker;
 	node->prev = end_marker;
 	node->hot = false;
+	node->touched = false;
 }
 
 static void remove_lru_list(ocf_cache_t cache, struct ocf_lru_list *list,
@@ -205,6 +357,7 @@ static void ocf_lru_set_hot(ocf_cache_t cache, struct ocf_lru_list *list,
 		ocf_cache_line_t cline)
 
 {
+	/* clears deferred touch as well */
 	remove_lru_list_nobalance(cache, list, cline);
 	add_lru_head_nobalance(cache, list, cline);
 	balance_lru_list(cache, list);
@@ -212,13 +365,20 @@ static void ocf_lru_set_hot(ocf_cache_t cache, struct ocf_lru_list *list,
 
 void ocf_lru_init_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 {
+	struct ocf_lru_age *age = ocf_lru_get_age(cache, cline);
 	struct ocf_lru_meta *node;
 
 	node = ocf_metadata_get_lru(cache, cline);
 
 	node->hot = false;
+	node->touched = false;
 	node->prev = end_marker;
 	node->next = end_marker;
+
+	if (age) {
+		age->hits = 0;
+		age->mapped_secs = 0;
+	}
 }
 
 static struct ocf_lru_list *ocf_lru_get_list(struct ocf_part *part,
@@ -234,7 +394,7 @@ static struct ocf_lru_list *ocf_lru_get_list(struct ocf_part *part,
 static inline struct ocf_lru_list *lru_get_cline_list(ocf_cache_t cache,
 		ocf_cache_line_t cline)
 {
-	uint32_t lru_list = (cline % OCF_NUM_LRU_LISTS);
+	uint32_t lru_list = ocf_lru_list_idx(cache, cline);
 	ocf_part_id_t part_id;
 	struct ocf_part *part;
 
@@ -261,10 +421,29 @@ static inline void ocf_lru_move(ocf_cache_t cache, ocf_cache_line_t cline,
 	add_lru_head(cache, dst_list, cline);
 }
 
+/* Move line between clean and dirty list of a partition. Protected line
+ * stays protected, so dirtying or cleaning it does not expose it to
+ * eviction. */
+static inline void ocf_lru_move_keep_hot(ocf_cache_t cache,
+		ocf_cache_line_t cline, struct ocf_lru_list *src_list,
+		struct ocf_lru_list *dst_list)
+{
+	bool hot = ocf_metadata_get_lru(cache, cline)->hot;
+
+	remove_lru_list(cache, src_list, cline);
+
+	if (hot && dst_list->track_hot) {
+		add_lru_head_nobalance(cache, dst_list, cline);
+		balance_lru_list(cache, dst_list);
+	} else {
+		add_lru_head(cache, dst_list, cline);
+	}
+}
+
 static void ocf_lru_repart_locked(ocf_cache_t cache, ocf_cache_line_t cline,
 		struct ocf_part *src_part, struct ocf_part *dst_part)
 {
-	uint32_t lru_list = (cline % OCF_NUM_LRU_LISTS);
+	uint32_t lru_list = ocf_lru_list_idx(cache, cline);
 	struct ocf_lru_list *src_list, *dst_list;
 	bool clean;
 
@@ -309,16 +488,18 @@ static inline void lru_iter_init(struct ocf_lru_iter *iter, ocf_cache_t cache,
 	iter->cache = cache;
 	iter->c = ocf_cache_line_concurrency(cache);
 	iter->part = part;
-	/* set iterator value to start_lru - 1 modulo OCF_NUM_LRU_LISTS */
-	iter->lru_idx = (start_lru + OCF_NUM_LRU_LISTS - 1) %
-			OCF_NUM_LRU_LISTS;
-	iter->num_avail_lrus = OCF_NUM_LRU_LISTS;
-	iter->next_avail_lru = ((1ULL << OCF_NUM_LRU_LISTS) - 1);
+	iter->num_lrus = ocf_lru_num_lists(cache);
+	/* set iterator value to start_lru - 1 modulo number of lists */
+	iter->lru_idx = (start_lru + iter->num_lrus - 1) % iter->num_lrus;
+	iter->num_avail_lrus = iter->num_lrus;
+	iter->next_avail_lru = ((1ULL << iter->num_lrus) - 1);
 	iter->clean = clean;
+	iter->local = false;
 	iter->hash_locked = hash_locked;
 	iter->req = req;
+	iter->stats = NULL;
 
-	for (i = 0; i < OCF_NUM_LRU_LISTS; i++)
+	for (i = 0; i < iter->num_lrus; i++)
 		iter->curr_cline[i] = ocf_lru_get_list(part, i, clean)->tail;
 }
 
@@ -340,37 +521,130 @@ static inline void lru_iter_eviction_init(struct ocf_lru_iter *iter,
 	 * to acquire the same hash bucket lock twice) */
 	lru_iter_init(iter, cache, part, start_lru, true, ocf_req_hash_in_range,
 			req);
+
+	/* Drain home list of the request queue first, so that queues do not
+	 * contend on each other lists unless theirs are exhausted. All lists
+	 * are available, so bitmap stays valid with start list as current. */
+	iter->lru_idx = start_lru;
+	iter->local = true;
+
+	if (part->id != PARTITION_FREELIST && cache->eviction_stats)
+		iter->stats = &cache->user_parts[part->id].lru_stats;
 }
 
 
+static inline bool _lru_lru_is_empty(struct ocf_lru_iter *iter)
+{
+	return !(iter->next_avail_lru & (1ULL << (iter->num_lrus - 1)));
+}
+
+static inline void _lru_lru_set_empty(struct ocf_lru_iter *iter)
+{
+	iter->next_avail_lru &= ~(1ULL << (iter->num_lrus - 1));
+	iter->num_avail_lrus--;
+	iter->local = false;
+}
+
 static inline uint32_t _lru_next_lru(struct ocf_lru_iter *iter)
 {
 	unsigned increment;
 
+	/* local iterator stays on the list it has been started at until
+	 * that list is marked empty */
+	if (iter->local)
+		return iter->lru_idx;
+
 	increment = __builtin_ffsll(iter->next_avail_lru);
 	iter->next_avail_lru = ocf_rotate_right(iter->next_avail_lru,
-			increment, OCF_NUM_LRU_LISTS);
-	iter->lru_idx = (iter->lru_idx + increment) % OCF_NUM_LRU_LISTS;
+			increment, iter->num_lrus);
+	iter->lru_idx = (iter->lru_idx + increment) % iter->num_lrus;
 
 	return iter->lru_idx;
 }
 
+static inline bool _lru_lru_all_empty(struct ocf_lru_iter *iter)
+{
+	return iter->num_avail_lrus == 0;
+}
 
+static inline unsigned lru_stats_bucket(uint32_t value, unsigned buckets)
+{
+	unsigned bucket = 0;
 
-static inline bool _lru_lru_is_empty(struct ocf_lru_iter *iter)
+	while (value && bucket < buckets - 1) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/* Take lru list lock, accounting time spent waiting for it. Clock is not
+ * read unless the lock is contended. */
+static inline void lru_iter_lock_list(struct ocf_lru_iter *iter,
+		uint32_t lru_idx)
 {
-	return !(iter->next_avail_lru & (1ULL << (OCF_NUM_LRU_LISTS - 1)));
+	struct ocf_metadata_lock *lock = &iter->cache->metadata.lock;
+	uint64_t start;
+
+	if (!iter->stats) {
+		ocf_metadata_lru_wr_lock(lock, lru_idx);
+		return;
+	}
+
+	if (ocf_metadata_lru_wr_trylock(lock, lru_idx))
+		return;
+
+	start = env_get_tick_count();
+	ocf_metadata_lru_wr_lock(lock, lru_idx);
+
+	env_atomic64_inc(&iter->stats->lock_contended);
+	env_atomic64_add(env_get_tick_count() - start,
+			&iter->stats->lock_wait_ticks);
 }
 
-static inline void _lru_lru_set_empty(struct ocf_lru_iter *iter)
+/* Account victim and restart its age and hit count for the new mapping.
+ * Caller must hold lru list lock. */
+static inline void lru_iter_account_victim(struct ocf_lru_iter *iter,
+		ocf_cache_line_t cline)
 {
-	iter->next_avail_lru &= ~(1ULL << (OCF_NUM_LRU_LISTS - 1));
-	iter->num_avail_lrus--;
+	struct ocf_lru_age *age = ocf_lru_get_age(iter->cache, cline);
+	struct ocf_lru_part_stats *stats = iter->stats;
+	uint32_t now;
+
+	if (!age)
+		return;
+
+	now = ocf_lru_now_secs();
+
+	if (stats) {
+		env_atomic64_inc(&stats->victims);
+		env_atomic64_inc(&stats->age[lru_stats_bucket(
+				now - age->mapped_secs,
+				OCF_STATS_EVICTION_AGE_BUCKETS)]);
+		env_atomic64_inc(&stats->hits[lru_stats_bucket(age->hits,
+				OCF_STATS_EVICTION_HITS_BUCKETS)]);
+	}
+
+	age->hits = 0;
+	age->mapped_secs = now;
 }
 
-static inline bool _lru_lru_all_empty(struct ocf_lru_iter *iter)
+/* Account dirty lines which eviction had to pass over, as many as clean lines
+ * were missing. Dirty list sizes are read without the lock. */
+static inline void lru_iter_account_dirty(struct ocf_lru_iter *iter,
+		uint32_t missing)
 {
-	return iter->num_avail_lrus == 0;
+	uint64_t dirty = 0;
+	uint32_t i;
+
+	if (!iter->stats)
+		return;
+
+	for (i = 0; i < iter->num_lrus && dirty < missing; i++)
+		dirty += ocf_lru_get_list(iter->part, i, false)->num_nodes;
+
+	env_atomic64_add(OCF_MIN(dirty, missing), &iter->stats->dirty_skipped);
 }
 
 static bool inline _lru_trylock_hash(struct ocf_lru_iter *iter,
@@ -406,14 +680,17 @@ static bool inline _lru_iter_evition_lock(struct ocf_lru_iter *iter,
 {
 	struct ocf_request *req = iter->req;
 
-	if (!ocf_cache_line_try_lock_wr(iter->c, cache_line))
+	if (!ocf_cache_line_try_lock_wr(iter->c, cache_line)) {
+		if (iter->stats)
+			env_atomic64_inc(&iter->stats->line_lock_fails);
 		return false;
+	}
 
 	ocf_metadata_get_core_info(iter->cache, cache_line,
 		core_id, core_line);
 
 	/* avoid evicting current request target cachelines */
-	if (*core_id == ocf_core_get_id(req->core) &&
+	if (req && *core_id == ocf_core_get_id(req->core) &&
 			*core_line >= req->core_line_first &&
 			*core_line <= req->core_line_last) {
 		ocf_cache_line_unlock_wr(iter->c, cache_line);
@@ -421,6 +698,8 @@ static bool inline _lru_iter_evition_lock(struct ocf_lru_iter *iter,
 	}
 
 	if (!_lru_trylock_hash(iter, *core_id, *core_line)) {
+		if (iter->stats)
+			env_atomic64_inc(&iter->stats->hash_lock_fails);
 		ocf_cache_line_unlock_wr(iter->c, cache_line);
 		return false;
 	}
@@ -434,6 +713,140 @@ static bool inline _lru_iter_evition_lock(struct ocf_lru_iter *iter,
 	return true;
 }
 
+/* Expected penalty of evicting the line - core miss latency scaled by
+ * likelihood of re-reference. Lines further from the list tail and lines hit
+ * since insertion are more likely to be accessed again. */
+static inline uint64_t lru_cline_eviction_cost(ocf_cache_t cache,
+		ocf_cache_line_t cline, struct ocf_lru_meta *node,
+		unsigned distance)
+{
+	ocf_core_id_t core_id;
+	uint64_t core_line;
+	uint64_t cost;
+	ocf_core_t core;
+
+	ocf_metadata_get_core_info(cache, cline, &core_id, &core_line);
+	core = ocf_cache_get_core(cache, core_id);
+	if (!core)
+		return 0;
+
+	cost = (env_atomic_read(&core->miss_latency_us) + 1ULL) *
+			(distance + 1);
+
+	return (node->hot || node->touched) ? 2 * cost : cost;
+}
+
+/* Pick the cheapest line out of OCF_LRU_COST_WINDOW lines at the list tail.
+ * With equal core latencies this is always the tail line, same as LRU.
+ * Caller must hold lru list lock. */
+static inline ocf_cache_line_t lru_list_cost_candidate(
+		struct ocf_lru_iter *iter, struct ocf_lru_list *list,
+		ocf_core_id_t *core_id, uint64_t *core_line)
+{
+	ocf_cache_t cache = iter->cache;
+	ocf_cache_line_t cline = list->tail, victim = end_marker;
+	uint64_t cost, min_cost = ~0ULL;
+	struct ocf_lru_meta *node;
+	unsigned i;
+
+	for (i = 0; i < OCF_LRU_COST_WINDOW && cline != end_marker; i++) {
+		node = ocf_metadata_get_lru(cache, cline);
+		cost = ocf_lru_pinned(cache, cline) ? ~0ULL :
+				lru_cline_eviction_cost(cache, cline, node, i);
+		if (cost < min_cost) {
+			min_cost = cost;
+			victim = cline;
+		}
+		cline = node->prev;
+	}
+
+	if (iter->stats)
+		env_atomic64_add(i, &iter->stats->iterations);
+
+	if (victim != end_marker && _lru_iter_evition_lock(iter, victim,
+			core_id, core_line)) {
+		return victim;
+	}
+
+	return end_marker;
+}
+
+/* Find eviction candidate starting from the tail of lru list. With CLOCK
+ * eviction lines referenced since the previous sweep get a second chance -
+ * reference bit is cleared and line is moved to the list head, where the
+ * sweep reaches it again after visiting all other lines. With LRU deferred
+ * touch from foreign queue is applied the same way, as if the line was
+ * promoted at hit time. Lines past partition TTL get no second chance.
+ * Pinned lines are never evicted - they are moved to the list head, so that
+ * they do not pile up at the tail. Caller must hold lru list lock. */
+static inline ocf_cache_line_t lru_list_eviction_candidate(
+		struct ocf_lru_iter *iter, struct ocf_lru_list *list,
+		ocf_core_id_t *core_id, uint64_t *core_line)
+{
+	ocf_cache_t cache = iter->cache;
+	uint32_t chances = list->num_nodes;
+	bool clock = ocf_lru_is_clock(cache);
+	uint16_t ttl = ocf_lru_part_ttl(cache, iter->part);
+	uint32_t now = ttl ? ocf_lru_now_secs() : 0;
+	struct ocf_lru_meta *node;
+	ocf_cache_line_t cline, prev;
+	uint32_t visited = 0;
+	bool expired;
+
+	if (ocf_lru_is_cost_aware(cache)) {
+		cline = lru_list_cost_candidate(iter, list, core_id, core_line);
+		/* otherwise fall back to regular scan */
+		if (cline != end_marker)
+			return cline;
+	}
+
+	cline = list->tail;
+	while (cline != end_marker) {
+		node = ocf_metadata_get_lru(cache, cline);
+		prev = node->prev;
+		visited++;
+
+		/* next candidate is likely to be visited as well */
+		if (prev != end_marker)
+			env_prefetch(ocf_metadata_get_lru(cache, prev));
+
+		expired = ocf_lru_expired(cache, cline, ttl, now);
+
+		if (ocf_lru_pinned(cache, cline)) {
+			if (chances) {
+				chances--;
+				ocf_lru_set_hot(cache, list, cline);
+				if (prev == end_marker)
+					prev = cline;
+			}
+		} else if (chances && clock && node->hot && !expired) {
+			chances--;
+			remove_lru_list_nobalance(cache, list, cline);
+			add_lru_head_nobalance(cache, list, cline);
+
+			/* line was the head already, visit it once again */
+			if (prev == end_marker)
+				prev = cline;
+		} else if (chances && !clock && node->touched && !expired) {
+			chances--;
+			ocf_lru_set_hot(cache, list, cline);
+
+			if (prev == end_marker)
+				prev = cline;
+		} else if (_lru_iter_evition_lock(iter, cline, core_id,
+				core_line)) {
+			break;
+		}
+
+		cline = prev;
+	}
+
+	if (iter->stats)
+		env_atomic64_add(visited, &iter->stats->iterations);
+
+	return cline;
+}
+
 /* Get next clean cacheline from tail of lru lists. Caller must not hold any
  * lru list lock.
  * - returned cacheline is write locked
@@ -456,17 +869,15 @@ static inline ocf_cache_line_t lru_iter_eviction_next(struct ocf_lru_iter *iter,
 	do {
 		curr_lru = _lru_next_lru(iter);
 
-		ocf_metadata_lru_wr_lock(&cache->metadata.lock, curr_lru);
+		lru_iter_lock_list(iter, curr_lru);
 
 		list = ocf_lru_get_list(part, curr_lru, iter->clean);
 
-		cline = list->tail;
-		while (cline != end_marker && !_lru_iter_evition_lock(iter,
-				cline, core_id, core_line)) {
-			cline = ocf_metadata_get_lru(iter->cache, cline)->prev;
-		}
+		cline = lru_list_eviction_candidate(iter, list, core_id,
+				core_line);
 
 		if (cline != end_marker) {
+			lru_iter_account_victim(iter, cline);
 			if (dst_part != part) {
 				ocf_lru_repart_locked(cache, cline, part,
 						dst_part);
@@ -520,6 +931,7 @@ static inline ocf_cache_line_t lru_iter_free_next(struct ocf_lru_iter *iter,
 		}
 
 		if (cline != end_marker) {
+			lru_iter_account_victim(iter, cline);
 			ocf_lru_repart_locked(cache, cline, free, dst_part);
 		}
 
@@ -633,7 +1045,7 @@ void ocf_lru_clean(ocf_cache_t cache, struct ocf_user_part *user_part,
 	}
 
 	ctx->cache = cache;
-	lru_idx = io_queue->lru_idx++ % OCF_NUM_LRU_LISTS;
+	lru_idx = ocf_lru_home_list(cache, io_queue);
 
 	lock_idx = ocf_metadata_concurrency_next_idx(io_queue);
 	ocf_metadata_start_shared_access(&cache->metadata.lock, lock_idx);
@@ -715,7 +1127,7 @@ uint32_t ocf_lru_req_clines(struct ocf_request *req,
 	ENV_BUG_ON(req->part_id == PARTITION_FREELIST);
 	dst_part = &cache->user_parts[req->part_id].part;
 
-	lru_idx = req->io_queue->lru_idx++ % OCF_NUM_LRU_LISTS;
+	lru_idx = ocf_lru_home_list(cache, req->io_queue);
 
 	lru_iter_eviction_init(&iter, cache, src_part, lru_idx, req);
 
@@ -765,13 +1177,55 @@ uint32_t ocf_lru_req_clines(struct ocf_request *req,
 		ENV_BUG_ON(req_idx == req->core_line_count && i != cline_no );
 	}
 
+	if (i < cline_no)
+		lru_iter_account_dirty(&iter, cline_no - i);
+
+	return i;
+}
+
+/* Evict up to count clean cachelines of the partition to the freelist,
+ * starting from the home lru list of the queue, so that reclaimed lines land
+ * on freelist list the queue allocates from.
+ * NOTE: the caller must hold the metadata read lock.
+ */
+uint32_t ocf_lru_reclaim(ocf_cache_t cache, struct ocf_part *part,
+		ocf_queue_t io_queue, uint32_t count)
+{
+	struct ocf_lru_iter iter;
+	ocf_cache_line_t cline;
+	uint64_t core_line;
+	ocf_core_id_t core_id;
+	uint32_t i;
+
+	ENV_BUG_ON(part->id == PARTITION_FREELIST);
+
+	lru_iter_eviction_init(&iter, cache, part,
+			ocf_lru_home_list(cache, io_queue), NULL);
+	/* no request, so no hash buckets are locked by the caller */
+	iter.hash_locked = NULL;
+
+	for (i = 0; i < count; i++) {
+		cline = lru_iter_eviction_next(&iter, &cache->free, &core_id,
+				&core_line);
+		if (cline == end_marker)
+			break;
+
+		ENV_BUG_ON(metadata_test_dirty(cache, cline));
+
+		ocf_lru_invalidate(cache, cline, core_id, part->id);
+		_lru_unlock_hash(&iter, core_id, core_line);
+		ocf_cache_line_unlock_wr(iter.c, cline);
+	}
+
 	return i;
 }
 
 /* the caller must hold the metadata lock */
-void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline)
+void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline,
+		ocf_queue_t io_queue)
 {
-	const uint32_t lru_list = (cline % OCF_NUM_LRU_LISTS);
+	const uint32_t lru_list = ocf_lru_list_idx(cache, cline);
+	struct ocf_lru_age *age = ocf_lru_get_age(cache, cline);
 	struct ocf_lru_meta *node;
 	struct ocf_lru_list *list;
 	ocf_part_id_t part_id;
@@ -781,6 +1235,29 @@ void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 
 	node = ocf_metadata_get_lru(cache, cline);
 
+	/* racy, hit count is only telemetry */
+	if (cache->eviction_stats && age && age->hits < 255)
+		age->hits++;
+
+	/* expired line is not promoted, so it drifts to the list tail */
+	if (cache->lru_ttl_active) {
+		part_id = ocf_metadata_get_partition_id(cache, cline);
+		if (ocf_lru_expired(cache, cline, ocf_lru_part_ttl(cache,
+				&cache->user_parts[part_id].part),
+				ocf_lru_now_secs())) {
+			return;
+		}
+	}
+
+	if (ocf_lru_is_clock(cache)) {
+		/* Only reference bit is set, list is not touched. Racing
+		 * with eviction sweep may lose the reference, which merely
+		 * makes line a candidate a bit earlier. */
+		if (!node->hot)
+			node->hot = true;
+		return;
+	}
+
 	OCF_METADATA_LRU_RD_LOCK(cline);
 	hot = node->hot;
 	OCF_METADATA_LRU_RD_UNLOCK(cline);
@@ -788,6 +1265,14 @@ void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 	if (hot)
 		return;
 
+	if (lru_list != ocf_lru_home_list(cache, io_queue)) {
+		/* List belongs to other queue - leave the promotion to the
+		 * owner or to eviction, instead of taking its lock */
+		if (!node->touched)
+			node->touched = true;
+		return;
+	}
+
 	part_id = ocf_metadata_get_partition_id(cache, cline);
 	part = &cache->user_parts[part_id].part;
 	clean = !metadata_test_dirty(cache, cline);
@@ -804,7 +1289,63 @@ void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 	OCF_METADATA_LRU_WR_UNLOCK(cline);
 }
 
-static inline void _lru_init(struct ocf_lru_list *list, bool track_hot)
+/* Allocate mapping time and hit count of cache lines, if not done yet.
+ * Lines already mapped are accounted as mapped now. Array is kept until
+ * cache is detached, as I/O may access it without any lock. */
+int ocf_lru_age_init(ocf_cache_t cache)
+{
+	ocf_cache_line_t entries, cline;
+	struct ocf_lru_age *age;
+	uint32_t now;
+
+	if (cache->lru_age || !cache->device)
+		return 0;
+
+	entries = cache->device->collision_table_entries;
+
+	age = env_vzalloc(sizeof(*age) * entries);
+	if (!age)
+		return -OCF_ERR_NO_MEM;
+
+	now = ocf_lru_now_secs();
+	for (cline = 0; cline < entries; cline++)
+		age[cline].mapped_secs = now;
+
+	cache->lru_age = age;
+
+	return 0;
+}
+
+void ocf_lru_age_deinit(ocf_cache_t cache)
+{
+	env_vfree(cache->lru_age);
+	cache->lru_age = NULL;
+}
+
+/* Enable expiry checks only if any partition has time to live set */
+int ocf_lru_update_ttl(ocf_cache_t cache)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+	bool active = false;
+	int result;
+
+	for_each_user_part(cache, user_part, part_id)
+		active |= !!user_part->config->ttl;
+
+	if (active) {
+		result = ocf_lru_age_init(cache);
+		if (result)
+			return result;
+	}
+
+	cache->lru_ttl_active = active && cache->lru_age;
+
+	return 0;
+}
+
+static inline void _lru_init(struct ocf_lru_list *list, bool track_hot,
+		uint8_t protected_pct)
 {
 	list->num_nodes = 0;
 	list->head = end_marker;
@@ -812,12 +1353,14 @@ static inline void _lru_init(struct ocf_lru_list *list, bool track_hot)
 	list->num_hot = 0;
 	list->last_hot = end_marker;
 	list->track_hot = track_hot;
+	list->protected_pct = protected_pct;
 }
 
 void ocf_lru_init(ocf_cache_t cache, struct ocf_part *part)
 {
 	struct ocf_lru_list *clean_list;
 	struct ocf_lru_list *dirty_list;
+	uint8_t protected_pct;
 	uint32_t i;
 
 	for (i = 0; i < OCF_NUM_LRU_LISTS; i++) {
@@ -825,20 +1368,144 @@ void ocf_lru_init(ocf_cache_t cache, struct ocf_part *part)
 		dirty_list = ocf_lru_get_list(part, i, false);
 
 		if (part->id == PARTITION_FREELIST) {
-			_lru_init(clean_list, false);
+			_lru_init(clean_list, false, 0);
 		} else {
-			_lru_init(clean_list, true);
-			_lru_init(dirty_list, true);
+			protected_pct = cache->user_parts[part->id].config->
+					slru_protected_size;
+			_lru_init(clean_list, !ocf_lru_is_clock(cache),
+					protected_pct);
+			_lru_init(dirty_list, !ocf_lru_is_clock(cache),
+					protected_pct);
 		}
 	}
 
 	env_atomic_set(&part->runtime->curr_size, 0);
+
+	if (part->id != PARTITION_FREELIST) {
+		ENV_BUG_ON(env_memset(&cache->user_parts[part->id].lru_stats,
+				sizeof(struct ocf_lru_part_stats), 0));
+	}
+}
+
+/* Rebalance list after its protected segment size has changed */
+static void ocf_lru_rebalance(ocf_cache_t cache, struct ocf_lru_list *list)
+{
+	unsigned target_hot_count = lru_list_target_hot(list);
+	ocf_cache_line_t pivot;
+	int change;
+
+	if (!list->track_hot)
+		return;
+
+	while (list->num_hot != target_hot_count) {
+		change = (list->num_hot < target_hot_count) ? 1 : -1;
+
+		/* segmented LRU protects only lines which were hit */
+		if (change > 0 && list->protected_pct)
+			break;
+
+		pivot = balance_update_last_hot(cache, list, change);
+		list->num_hot += change;
+		ocf_metadata_get_lru(cache, pivot)->hot = (change > 0);
+	}
+}
+
+void ocf_lru_set_protected_size(ocf_cache_t cache, struct ocf_part *part,
+		uint8_t protected_pct)
+{
+	struct ocf_lru_list *list;
+	uint32_t i;
+
+	ENV_BUG_ON(part->id == PARTITION_FREELIST);
+
+	OCF_METADATA_LRU_WR_LOCK_ALL();
+
+	for (i = 0; i < ocf_lru_num_lists(cache); i++) {
+		list = ocf_lru_get_list(part, i, true);
+		list->protected_pct = protected_pct;
+		ocf_lru_rebalance(cache, list);
+
+		list = ocf_lru_get_list(part, i, false);
+		list->protected_pct = protected_pct;
+		ocf_lru_rebalance(cache, list);
+	}
+
+	OCF_METADATA_LRU_WR_UNLOCK_ALL();
+}
+
+static void ocf_lru_rebalance_part(ocf_cache_t cache, struct ocf_part *part)
+{
+	uint32_t i;
+
+	for (i = 0; i < ocf_lru_num_lists(cache); i++) {
+		ocf_lru_rebalance(cache, ocf_lru_get_list(part, i, true));
+		ocf_lru_rebalance(cache, ocf_lru_get_list(part, i, false));
+	}
+}
+
+void ocf_lru_set_deferred_balance(ocf_cache_t cache, bool deferred)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+
+	OCF_METADATA_LRU_WR_LOCK_ALL();
+
+	/* inline balancing moves hot boundary by single element only,
+	 * so lists need to be balanced before it takes over */
+	if (!deferred && cache->lru_deferred_balance) {
+		for_each_user_part(cache, user_part, part_id)
+			ocf_lru_rebalance_part(cache, &user_part->part);
+	}
+
+	cache->lru_deferred_balance = deferred;
+
+	OCF_METADATA_LRU_WR_UNLOCK_ALL();
+}
+
+/* Balance hot elements of all lists, one list lock at a time.
+ * NOTE: the caller must hold the metadata read lock. */
+void ocf_lru_balance_all(ocf_cache_t cache)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+	uint32_t i;
+
+	for_each_user_part(cache, user_part, part_id) {
+		for (i = 0; i < ocf_lru_num_lists(cache); i++) {
+			ocf_metadata_lru_wr_lock(&cache->metadata.lock, i);
+			ocf_lru_rebalance(cache, ocf_lru_get_list(
+					&user_part->part, i, true));
+			ocf_lru_rebalance(cache, ocf_lru_get_list(
+					&user_part->part, i, false));
+			ocf_metadata_lru_wr_unlock(&cache->metadata.lock, i);
+		}
+	}
+}
+
+void ocf_lru_get_segments(ocf_cache_t cache, struct ocf_part *part,
+		uint32_t *protected, uint32_t *probation)
+{
+	struct ocf_lru_list *list;
+	uint32_t i;
+
+	*protected = 0;
+	*probation = 0;
+
+	for (i = 0; i < ocf_lru_num_lists(cache); i++) {
+		list = ocf_lru_get_list(part, i, true);
+		*protected += list->num_hot;
+		*probation += list->num_nodes - list->num_hot;
+
+		list = ocf_lru_get_list(part, i, false);
+		*protected += list->num_hot;
+		*probation += list->num_nodes - list->num_hot;
+	}
 }
 
 void ocf_lru_clean_cline(ocf_cache_t cache, struct ocf_part *part,
 		ocf_cache_line_t cline)
 {
-	uint32_t lru_list = (cline % OCF_NUM_LRU_LISTS);
+	uint32_t lru_list = ocf_lru_list_idx(cache, cline);
 	struct ocf_lru_list *clean_list;
 	struct ocf_lru_list *dirty_list;
 
@@ -846,15 +1513,14 @@ void ocf_lru_clean_cline(ocf_cache_t cache, struct ocf_part *part,
 	dirty_list = ocf_lru_get_list(part, lru_list, false);
 
 	OCF_METADATA_LRU_WR_LOCK(cline);
-	remove_lru_list(cache, dirty_list, cline);
-	add_lru_head(cache, clean_list, cline);
+	ocf_lru_move_keep_hot(cache, cline, dirty_list, clean_list);
 	OCF_METADATA_LRU_WR_UNLOCK(cline);
 }
 
 void ocf_lru_dirty_cline(ocf_cache_t cache, struct ocf_part *part,
 		ocf_cache_line_t cline)
 {
-	uint32_t lru_list = (cline % OCF_NUM_LRU_LISTS);
+	uint32_t lru_list = ocf_lru_list_idx(cache, cline);
 	struct ocf_lru_list *clean_list;
 	struct ocf_lru_list *dirty_list;
 
@@ -862,8 +1528,7 @@ void ocf_lru_dirty_cline(ocf_cache_t cache, struct ocf_part *part,
 	dirty_list = ocf_lru_get_list(part, lru_list, false);
 
 	OCF_METADATA_LRU_WR_LOCK(cline);
-	remove_lru_list(cache, clean_list, cline);
-	add_lru_head(cache, dirty_list, cline);
+	ocf_lru_move_keep_hot(cache, cline, clean_list, dirty_list);
 	OCF_METADATA_LRU_WR_UNLOCK(cline);
 }
 
@@ -911,7 +1576,7 @@ void ocf_lru_populate(ocf_cache_t cache, ocf_cache_line_t num_free_clines)
 
 		ocf_metadata_set_partition_id(cache, cline, PARTITION_FREELIST);
 
-		lru_list = (cline % OCF_NUM_LRU_LISTS);
+		lru_list = ocf_lru_list_idx(cache, cline);
 		list = ocf_lru_get_list(&cache->free, lru_list, true);
 
 		add_lru_head(cache, list, cline);
@@ -997,7 +1662,7 @@ int ocf_metadata_actor(struct ocf_cache *cache,
 	ENV_BUG_ON(part_id == PARTITION_FREELIST);
 	part = &cache->user_parts[part_id].part;
 
-	for (i = 0; i < OCF_NUM_LRU_LISTS; i++) {
+	for (i = 0; i < ocf_lru_num_lists(cache); i++) {
 		for (clean = 0; clean <= 1; clean++) {
 			list = ocf_lru_get_list(part, i, clean);
 
@@ -14,12 +14,27 @@ struct ocf_part_runtime;
 struct ocf_part_cleaning_ctx;
 struct ocf_request;
 
+/* Cleaner wake up interval upper bound when lru balancing is deferred */
+#define OCF_LRU_DEFERRED_BALANCE_INTERVAL_MS 100
+
+uint32_t ocf_lru_num_lists(ocf_cache_t cache);
+
+/* LRU list (and LRU list lock) index of given cache line */
+static inline uint32_t ocf_lru_list_idx(ocf_cache_t cache,
+		ocf_cache_line_t cline)
+{
+	return cline % ocf_lru_num_lists(cache);
+}
+
 void ocf_lru_init_cline(ocf_cache_t cache, ocf_cache_line_t cline);
 void ocf_lru_rm_cline(struct ocf_cache *cache, ocf_cache_line_t cline);
 bool ocf_lru_can_evict(struct ocf_cache *cache);
 uint32_t ocf_lru_req_clines(struct ocf_request *req,
 		struct ocf_part *src_part, uint32_t cline_no);
-void ocf_lru_hot_cline(struct ocf_cache *cache, ocf_cache_line_t cline);
+uint32_t ocf_lru_reclaim(ocf_cache_t cache, struct ocf_part *part,
+		ocf_queue_t io_queue, uint32_t count);
+void ocf_lru_hot_cline(struct ocf_cache *cache, ocf_cache_line_t cline,
+		ocf_queue_t io_queue);
 void ocf_lru_add(ocf_cache_t cache, ocf_cache_line_t cline);
 void ocf_lru_init(struct ocf_cache *cache, struct ocf_part *part);
 void ocf_lru_dirty_cline(struct ocf_cache *cache, struct ocf_part *part,
@@ -30,6 +45,15 @@ void ocf_lru_clean(ocf_cache_t cache, struct ocf_user_part *user_part,
 		ocf_queue_t io_queue, uint32_t count);
 void ocf_lru_repart(ocf_cache_t cache, ocf_cache_line_t cline,
 		struct ocf_part *src_upart, struct ocf_part *dst_upart);
+void ocf_lru_set_protected_size(ocf_cache_t cache, struct ocf_part *part,
+		uint8_t protected_pct);
+void ocf_lru_set_deferred_balance(ocf_cache_t cache, bool deferred);
+void ocf_lru_balance_all(ocf_cache_t cache);
+int ocf_lru_age_init(ocf_cache_t cache);
+void ocf_lru_age_deinit(ocf_cache_t cache);
+int ocf_lru_update_ttl(ocf_cache_t cache);
+void ocf_lru_get_segments(ocf_cache_t cache, struct ocf_part *part,
+		uint32_t *protected, uint32_t *probation);
 uint32_t ocf_lru_num_free(ocf_cache_t cache);
 void ocf_lru_populate(ocf_cache_t cache, ocf_cache_line_t num_free_clines);
 
@@ -10,6 +10,18 @@ struct ocf_lru_meta {
 	uint32_t prev;
 	uint32_t next;
 	uint8_t hot;
+	uint8_t touched;
+		/*!< Hit from queue other than list owner, promotion is
+		 * deferred until the line is considered for eviction */
+} __attribute__((packed));
+
+/* Allocated per cache line only while eviction statistics or time to live
+ * are enabled, so that LRU node does not grow for caches using neither */
+struct ocf_lru_age {
+	uint32_t mapped_secs;
+		/*!< Mapping time in seconds */
+	uint8_t hits;
+		/*!< Hits since the line was mapped, saturated */
 } __attribute__((packed));
 
 struct ocf_lru_list {
@@ -19,6 +31,9 @@ struct ocf_lru_list {
 	uint32_t num_hot;
 	uint32_t last_hot;
 	bool track_hot;
+	uint8_t protected_pct;
+		/*!< Protected (hot) segment size in percent of list, when
+		 * non-zero list works as segmented LRU */
 };
 
 struct ocf_lru_part_meta {
@@ -0,0 +1,177 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf_pin.h"
+#include "ocf_core_priv.h"
+#include "ocf_cache_priv.h"
+#include "ocf_priv.h"
+
+/*
+ * Pinned core line ranges are kept in interval tree. Ranges are merged on
+ * insertion, so tree holds disjoint intervals and interval overlapping with
+ * given one can be found with regular tree lookup. Tree is consulted only
+ * for eviction candidates, and not at all while no core of the cache has
+ * any range pinned - cache keeps the total count of pinned ranges.
+ */
+
+static int ocf_pin_range_cmp(struct ocf_rb_node *n1, struct ocf_rb_node *n2)
+{
+	struct ocf_pin_range *r1 = container_of(n1, struct ocf_pin_range, node);
+	struct ocf_pin_range *r2 = container_of(n2, struct ocf_pin_range, node);
+
+	if (r1->last < r2->first)
+		return -1;
+
+	if (r1->first > r2->last)
+		return 1;
+
+	return 0;
+}
+
+static inline void ocf_pin_count_add(ocf_core_t core, int i)
+{
+	env_atomic_add(i, &core->pin->count);
+	env_atomic_add(i, &ocf_core_get_cache(core)->pinned_ranges);
+}
+
+static struct ocf_pin_range *ocf_pin_find(struct ocf_core_pin *pin,
+		uint64_t first, uint64_t last)
+{
+	struct ocf_pin_range probe = { .first = first, .last = last };
+	struct ocf_rb_node *node;
+
+	node = ocf_rb_tree_find(&pin->tree, &probe.node);
+	if (!node)
+		return NULL;
+
+	return container_of(node, struct ocf_pin_range, node);
+}
+
+int ocf_core_pin_init(ocf_core_t core)
+{
+	struct ocf_core_pin *pin;
+
+	pin = env_vzalloc(sizeof(*pin));
+	if (!pin)
+		return -OCF_ERR_NO_MEM;
+
+	env_rwlock_init(&pin->lock);
+	ocf_rb_tree_init(&pin->tree, ocf_pin_range_cmp, NULL);
+	env_atomic_set(&pin->count, 0);
+
+	core->pin = pin;
+
+	return 0;
+}
+
+int ocf_core_pin_add(ocf_core_t core, uint64_t first, uint64_t last)
+{
+	struct ocf_core_pin *pin = core->pin;
+	struct ocf_pin_range *range, *merged;
+
+	range = env_vzalloc(sizeof(*range));
+	if (!range)
+		return -OCF_ERR_NO_MEM;
+
+	env_rwlock_write_lock(&pin->lock);
+
+	/* absorb all ranges overlapping or adjacent to the new one */
+	while ((merged = ocf_pin_find(pin, first ? first - 1 : 0,
+			last < ~0ULL ? last + 1 : last))) {
+		first = OCF_MIN(first, merged->first);
+		last = OCF_MAX(last, merged->last);
+
+		ocf_rb_tree_remove(&pin->tree, &merged->node);
+		ocf_pin_count_add(core, -1);
+		env_vfree(merged);
+	}
+
+	range->first = first;
+	range->last = last;
+	ocf_rb_tree_insert(&pin->tree, &range->node);
+	ocf_pin_count_add(core, 1);
+
+	env_rwlock_write_unlock(&pin->lock);
+
+	return 0;
+}
+
+int ocf_core_pin_remove(ocf_core_t core, uint64_t first, uint64_t last)
+{
+	struct ocf_core_pin *pin = core->pin;
+	struct ocf_pin_range *range, *tail;
+
+	/* at most one range gets split in two */
+	tail = env_vzalloc(sizeof(*tail));
+	if (!tail)
+		return -OCF_ERR_NO_MEM;
+
+	env_rwlock_write_lock(&pin->lock);
+
+	while ((range = ocf_pin_find(pin, first, last))) {
+		ocf_rb_tree_remove(&pin->tree, &range->node);
+		ocf_pin_count_add(core, -1);
+
+		if (range->last > last) {
+			tail->first = last + 1;
+			tail->last = range->last;
+			ocf_rb_tree_insert(&pin->tree, &tail->node);
+			ocf_pin_count_add(core, 1);
+			tail = NULL;
+		}
+
+		if (range->first < first) {
+			range->last = first - 1;
+			ocf_rb_tree_insert(&pin->tree, &range->node);
+			ocf_pin_count_add(core, 1);
+		} else {
+			env_vfree(range);
+		}
+	}
+
+	env_rwlock_write_unlock(&pin->lock);
+
+	if (tail)
+		env_vfree(tail);
+
+	return 0;
+}
+
+bool ocf_core_pin_check(ocf_core_t core, uint64_t core_line)
+{
+	struct ocf_core_pin *pin = core->pin;
+	bool pinned;
+
+	if (!env_atomic_read(&pin->count))
+		return false;
+
+	env_rwlock_read_lock(&pin->lock);
+	pinned = !!ocf_pin_find(pin, core_line, core_line);
+	env_rwlock_read_unlock(&pin->lock);
+
+	return pinned;
+}
+
+void ocf_core_pin_deinit(ocf_core_t core)
+{
+	struct ocf_core_pin *pin = core->pin;
+	struct ocf_pin_range *range;
+
+	if (!pin)
+		return;
+
+	ocf_pin_count_add(core, -env_atomic_read(&pin->count));
+
+	while (pin->tree.root) {
+		range = container_of(pin->tree.root, struct ocf_pin_range,
+				node);
+		ocf_rb_tree_remove(&pin->tree, &range->node);
+		env_vfree(range);
+	}
+
+	env_rwlock_destroy(&pin->lock);
+	env_vfree(pin);
+	core->pin = NULL;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __OCF_PIN_H__
+#define __OCF_PIN_H__
+
+#include "ocf/ocf.h"
+#include "utils/utils_rbtree.h"
+
+/* Pinned range of core lines, ranges in tree never overlap nor touch */
+struct ocf_pin_range {
+	uint64_t first;
+	uint64_t last;
+	struct ocf_rb_node node;
+};
+
+struct ocf_core_pin {
+	env_rwlock lock;
+	struct ocf_rb_tree tree;
+	env_atomic count;
+};
+
+int ocf_core_pin_init(ocf_core_t core);
+
+int ocf_core_pin_add(ocf_core_t core, uint64_t first, uint64_t last);
+
+int ocf_core_pin_remove(ocf_core_t core, uint64_t first, uint64_t last);
+
+bool ocf_core_pin_check(ocf_core_t core, uint64_t core_line);
+
+void ocf_core_pin_deinit(ocf_core_t core);
+
+#endif /* __OCF_PIN_H__ */
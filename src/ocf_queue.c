@@ -17,6 +17,7 @@ int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 		const struct ocf_queue_ops *ops)
 {
 	ocf_queue_t tmp_queue;
+	unsigned long lock_flags = 0;
 	int result;
 
 	OCF_CHECK_NULL(cache);
@@ -43,6 +44,7 @@ int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 	env_atomic_set(&tmp_queue->ref_count, 1);
 	tmp_queue->cache = cache;
 	tmp_queue->ops = ops;
+	tmp_queue->lru_home = env_atomic_inc_return(&cache->next_lru_home) - 1;
 
 	result = ocf_queue_seq_cutoff_init(tmp_queue);
 	if (result) {
@@ -51,7 +53,9 @@ int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 		return result;
 	}
 
+	env_spinlock_lock_irqsave(&cache->io_queues_lock, lock_flags);
 	list_add(&tmp_queue->list, &cache->io_queues);
+	env_spinlock_unlock_irqrestore(&cache->io_queues_lock, lock_flags);
 
 	*queue = tmp_queue;
 
@@ -67,10 +71,18 @@ void ocf_queue_get(ocf_queue_t queue)
 
 void ocf_queue_put(ocf_queue_t queue)
 {
+	ocf_cache_t cache;
+	unsigned long lock_flags = 0;
+
 	OCF_CHECK_NULL(queue);
 
+	cache = queue->cache;
+
 	if (env_atomic_dec_return(&queue->ref_count) == 0) {
+		env_spinlock_lock_irqsave(&cache->io_queues_lock, lock_flags);
 		list_del(&queue->list);
+		env_spinlock_unlock_irqrestore(&cache->io_queues_lock,
+				lock_flags);
 		queue->ops->stop(queue);
 		ocf_queue_seq_cutoff_deinit(queue);
 		ocf_mngt_cache_put(queue->cache);
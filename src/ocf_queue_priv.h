@@ -15,11 +15,18 @@ struct ocf_queue {
 
 	struct list_head io_list;
 
+	/* write coalescing batch still accepting new writes, protected
+	 * by io_list_lock */
+	struct ocf_request *coalesce_head;
+
 	/* per-queue free running global metadata lock index */
 	unsigned lock_idx;
 
-	/* per-queue free running lru list index */
-	unsigned lru_idx;
+	/* lru list preferred by this queue, modulo number of lru lists */
+	unsigned lru_home;
+
+	/* background reclaim request is queued */
+	env_atomic reclaim_pending;
 
 	struct ocf_seq_cutoff *seq_cutoff;
 
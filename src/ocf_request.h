@@ -91,6 +91,52 @@ struct ocf_req_discard_info {
 
     sector_t handled;
     /*!< Number of processed sector during discard operation */
+
+    uint32_t purged;
+    /*!< Number of cache lines invalidated during discard operation */
+};
+
+/**
+ * @brief OCF write coalescing batch info
+ */
+struct ocf_req_coalesce_info {
+    struct list_head batch;
+    /*!< Writes attached to this request (valid for batch head only) */
+
+    uint64_t addr;
+    /*!< First byte covered by the batch */
+
+    uint32_t bytes;
+    /*!< Number of bytes covered by the batch */
+
+    uint32_t count;
+    /*!< Number of writes in the batch, including the head */
+};
+
+/**
+ * @brief OCF request split info
+ */
+struct ocf_req_split_info {
+    struct ocf_request* parent;
+    /*!< Request which has been split (valid for child requests only) */
+
+    struct list_head children;
+    /*!< Child requests allocated, but not submitted yet */
+
+    env_atomic remaining;
+    /*!< Number of parts not completed yet */
+
+    env_atomic next;
+    /*!< Index of next part to be submitted */
+
+    env_atomic error;
+    /*!< First error of any of the child requests */
+
+    uint32_t count;
+    /*!< Number of parts */
+
+    uint32_t size;
+    /*!< Size of single part in bytes */
 };
 
 /**
@@ -140,6 +186,9 @@ struct ocf_request {
     ctx_data_t* data;
     /*!< Request data*/
 
+    uint32_t offset;
+    /*!< Offset of request in data buffer */
+
     ctx_data_t* cp_data;
     /*!< Copy of request data */
 
@@ -191,6 +240,9 @@ struct ocf_request {
     uint8_t wi_second_pass : 1;
     /*!< Set after first pass of WI write is completed */
 
+    uint8_t write_zeroes : 1;
+    /*!< Write data is zero-filled */
+
     // @hb 新增字段，用于判断是否允许进行二次准入
     uint8_t allow_second_admission : 1;
     /*!< Indicates if request is allowed for second admission based on history hit ratio */
@@ -201,6 +253,9 @@ struct ocf_request {
     uint8_t lock_idx : OCF_METADATA_GLOBAL_LOCK_IDX_BITS;
     /* !< Selected global metadata read lock */
 
+    uint32_t hb_seq;
+    /*!< Hash buckets sequence observed by lockless read */
+
     ocf_req_cache_mode_t cache_mode;
 
     log_sid_t sid;
@@ -209,6 +264,15 @@ struct ocf_request {
     uint64_t timestamp;
     /*!< Tracing timestamp */
 
+    uint64_t core_submit_tick;
+    /*!< Time of read miss submission to core volume */
+
+    uint64_t discard_epoch;
+    /*!< Discard epoch observed when cleaning request was allocated */
+
+    uint64_t cleaner_tick;
+    /*!< Start of current cleaning request phase */
+
     ocf_queue_t io_queue;
     /*!< I/O queue handle for which request should be submitted */
 
@@ -223,6 +287,12 @@ struct ocf_request {
 
     struct ocf_req_discard_info discard;
 
+    struct ocf_req_coalesce_info coalesce;
+    /*!< Write coalescing batch info */
+
+    struct ocf_req_split_info split;
+    /*!< Request split info */
+
     uint32_t alock_rw;
     /*!< Read/Write mode for alock*/
 
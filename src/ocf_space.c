@@ -4,8 +4,14 @@
  */
 
 #include "ocf_space.h"
+#include "ocf_queue_priv.h"
 #include "utils/utils_user_part.h"
 #include "engine/engine_common.h"
+#include "mngt/ocf_mngt_common.h"
+#include "concurrency/ocf_concurrency.h"
+
+/* Maximum number of cachelines reclaimed in single queue run */
+#define OCF_SPACE_RECLAIM_BATCH 128
 
 static uint32_t ocf_evict_calculate(ocf_cache_t cache,
 		struct ocf_user_part *user_part, uint32_t to_evict)
@@ -155,3 +161,192 @@ int ocf_space_managment_remap_do(struct ocf_request *req)
 
 	return LOOKUP_MISS;
 }
+
+static inline uint32_t ocf_space_part_headroom(ocf_cache_t cache,
+		struct ocf_user_part *user_part)
+{
+	uint64_t headroom = user_part->config->headroom_size;
+
+	headroom *= cache->conf_meta->cachelines;
+
+	return OCF_DIV_ROUND_UP(headroom, 100);
+}
+
+/* Number of cachelines by which partition exceeds its maximum size reduced
+ * by its headroom. For partition without headroom it is its overflow size. */
+static uint32_t ocf_space_part_excess(ocf_cache_t cache,
+		struct ocf_user_part *user_part)
+{
+	uint32_t occupancy = ocf_part_get_occupancy(&user_part->part);
+	uint32_t limit = ocf_user_part_get_max_size(cache, user_part);
+	uint32_t headroom = ocf_space_part_headroom(cache, user_part);
+
+	limit = limit > headroom ? limit - headroom : 0;
+
+	return occupancy > limit ? occupancy - limit : 0;
+}
+
+void ocf_space_update_headroom(ocf_cache_t cache)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+	uint64_t headroom = 0;
+
+	for_each_user_part(cache, user_part, part_id)
+		headroom += ocf_space_part_headroom(cache, user_part);
+
+	cache->lru_reclaim.headroom = OCF_MIN(headroom,
+			(uint64_t)cache->conf_meta->cachelines);
+}
+
+/* Free cachelines reclaim aims at - headroom is refilled with some slack,
+ * so that reclaim is not kicked on each miss */
+static inline uint32_t ocf_space_reclaim_target(ocf_cache_t cache)
+{
+	uint32_t headroom = cache->lru_reclaim.headroom;
+
+	if (headroom)
+		headroom += OCF_SPACE_RECLAIM_BATCH;
+
+	return OCF_MAX(cache->lru_reclaim.high_watermark, headroom);
+}
+
+/* Trim partitions down to their maximum size reduced by headroom */
+static uint32_t ocf_reclaim_excess(ocf_cache_t cache, ocf_queue_t queue,
+		uint32_t count)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+	uint32_t to_evict, evicted = 0;
+
+	for_each_user_part(cache, user_part, part_id) {
+		to_evict = OCF_MIN(ocf_space_part_excess(cache, user_part),
+				count - evicted);
+		to_evict = ocf_evict_calculate(cache, user_part, to_evict);
+		if (to_evict == 0)
+			continue;
+
+		evicted += ocf_lru_reclaim(cache, &user_part->part, queue,
+				to_evict);
+		if (evicted >= count)
+			break;
+	}
+
+	return evicted;
+}
+
+static uint32_t ocf_reclaim_user_partitions(ocf_cache_t cache,
+		ocf_queue_t queue, uint32_t count)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+	uint32_t to_evict, evicted = 0;
+
+	/* For each partition from the lowest priority to highest one */
+	for_each_user_part(cache, user_part, part_id) {
+		/* Pinned partitions are evicted only on demand */
+		if (!user_part->config->flags.eviction)
+			break;
+
+		to_evict = ocf_evict_calculate(cache, user_part,
+				count - evicted);
+		if (to_evict == 0)
+			continue;
+
+		evicted += ocf_lru_reclaim(cache, &user_part->part, queue,
+				to_evict);
+		if (evicted >= count)
+			break;
+	}
+
+	return evicted;
+}
+
+static int ocf_space_reclaim_handle(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_queue_t queue = req->io_queue;
+	uint32_t target = ocf_space_reclaim_target(cache);
+	uint32_t count = OCF_SPACE_RECLAIM_BATCH, reclaimed = 0;
+	uint32_t free;
+	unsigned lock_idx;
+
+	/* d2c request does not hold metadata reference - cache is being
+	 * detached */
+	if (!req->d2c && !ocf_mngt_cache_is_locked(cache)) {
+		lock_idx = ocf_metadata_concurrency_next_idx(queue);
+		ocf_metadata_start_shared_access(&cache->metadata.lock,
+				lock_idx);
+
+		if (cache->lru_reclaim.headroom)
+			reclaimed = ocf_reclaim_excess(cache, queue, count);
+
+		free = ocf_lru_num_free(cache);
+		if (free < target && reclaimed < count) {
+			reclaimed += ocf_reclaim_user_partitions(cache, queue,
+					OCF_MIN(target - free, count - reclaimed));
+		}
+
+		ocf_metadata_end_shared_access(&cache->metadata.lock,
+				lock_idx);
+	}
+
+	/* Let user I/O in between subsequent batches */
+	if (reclaimed == count) {
+		ocf_engine_push_req_back(req, false);
+		return 0;
+	}
+
+	env_atomic_set(&queue->reclaim_pending, 0);
+	ocf_req_put(req);
+
+	return 0;
+}
+
+static const struct ocf_io_if _io_if_space_reclaim = {
+	.read = ocf_space_reclaim_handle,
+	.write = ocf_space_reclaim_handle,
+	.name = "Space reclaim",
+};
+
+static bool ocf_space_reclaim_needed(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	uint32_t low = cache->lru_reclaim.low_watermark;
+	uint32_t headroom = cache->lru_reclaim.headroom;
+	uint32_t free = ocf_lru_num_free(cache);
+
+	if (free < low || free < headroom)
+		return true;
+
+	return headroom && ocf_space_part_excess(cache,
+			&cache->user_parts[req->part_id]);
+}
+
+void ocf_space_reclaim_kick(struct ocf_request *orig_req)
+{
+	ocf_cache_t cache = orig_req->cache;
+	ocf_queue_t queue = orig_req->io_queue;
+	struct ocf_request *req;
+
+	if (queue == cache->mngt_queue)
+		return;
+
+	if (!ocf_space_reclaim_needed(orig_req))
+		return;
+
+	/* Single reclaim request per queue at a time */
+	if (env_atomic_cmpxchg(&queue->reclaim_pending, 0, 1))
+		return;
+
+	req = ocf_req_new(queue, NULL, 0, 0, 0);
+	if (!req) {
+		env_atomic_set(&queue->reclaim_pending, 0);
+		return;
+	}
+
+	req->info.internal = true;
+	req->io_if = &_io_if_space_reclaim;
+
+	ocf_engine_push_req_back(req, false);
+}
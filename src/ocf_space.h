@@ -10,6 +10,8 @@
 #include "ocf_lru.h"
 #include "ocf_lru_structs.h"
 
+/* Maximum number of LRU lists per partition. Number of lists actually used
+ * by the cache is chosen at start time, see ocf_lru_num_lists() */
 #define OCF_NUM_LRU_LISTS 32
 
 struct ocf_part;
@@ -27,6 +29,19 @@ struct ocf_request;
  */
 int ocf_space_managment_remap_do(struct ocf_request *req);
 
+/*
+ * Schedules background reclaim of clean cachelines on the request queue, if
+ * number of free cachelines dropped below low watermark or io classes
+ * headroom, or if request io class does not fit its headroom.
+ */
+void ocf_space_reclaim_kick(struct ocf_request *req);
+
+/*
+ * Recalculates free cachelines needed for io classes headroom. Called when
+ * io classes configuration or cache size changes.
+ */
+void ocf_space_update_headroom(ocf_cache_t cache);
+
 typedef void (*ocf_metadata_actor_t)(struct ocf_cache *cache,
 		ocf_cache_line_t cache_line);
 
@@ -33,6 +33,8 @@ static void ocf_stats_req_init(struct ocf_counters_req *stats)
 	env_atomic64_set(&stats->partial_miss, 0);
 	env_atomic64_set(&stats->total, 0);
 	env_atomic64_set(&stats->pass_through, 0);
+	env_atomic64_set(&stats->lockless, 0);
+	env_atomic64_set(&stats->lockless_retry, 0);
 }
 
 static void ocf_stats_block_init(struct ocf_counters_block *stats)
@@ -57,6 +59,28 @@ static void ocf_stats_error_init(struct ocf_counters_error *stats)
 	env_atomic_set(&stats->write, 0);
 }
 
+static void ocf_stats_cleaner_init(struct ocf_counters_cleaner *stats)
+{
+	int i;
+
+	env_atomic64_set(&stats->cleaned, 0);
+	env_atomic64_set(&stats->core_write_bytes, 0);
+	env_atomic64_set(&stats->core_writes, 0);
+	env_atomic64_set(&stats->getter_skips, 0);
+	env_atomic64_set(&stats->lock_aborts, 0);
+	env_atomic64_set(&stats->inflight_skips, 0);
+
+	for (i = 0; i < OCF_STATS_CLEANER_LATENCY_BUCKETS; i++) {
+		env_atomic64_set(&stats->cache_read_latency[i], 0);
+		env_atomic64_set(&stats->core_write_latency[i], 0);
+	}
+
+	for (i = 0; i < OCF_STATS_CLEANER_AGE_BUCKETS; i++)
+		env_atomic64_set(&stats->dirty_age[i], 0);
+
+	stats->reset_tick = env_get_tick_count();
+}
+
 static void _ocf_stats_block_update(struct ocf_counters_block *counters, int dir,
 		uint64_t bytes)
 {
@@ -142,6 +166,18 @@ void ocf_core_stats_request_pt_update(ocf_core_t core, ocf_part_id_t part_id,
 	env_atomic64_inc(&counters->pass_through);
 }
 
+void ocf_core_stats_request_lockless_update(ocf_core_t core,
+		ocf_part_id_t part_id, bool retry)
+{
+	struct ocf_counters_req *counters =
+			&core->counters->part_counters[part_id].read_reqs;
+
+	if (retry)
+		env_atomic64_inc(&counters->lockless_retry);
+	else
+		env_atomic64_inc(&counters->lockless);
+}
+
 static void _ocf_core_stats_error_update(struct ocf_counters_error *counters,
 		uint8_t dir)
 {
@@ -171,6 +207,79 @@ void ocf_core_stats_cache_error_update(ocf_core_t core, uint8_t dir)
 	_ocf_core_stats_error_update(counters, dir);
 }
 
+static inline unsigned _ocf_stats_cleaner_bucket(uint64_t value,
+		unsigned buckets)
+{
+	unsigned bucket = 0;
+
+	while (value && bucket < buckets - 1) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+void ocf_core_stats_cleaner_clean_update(ocf_core_t core)
+{
+	env_atomic64_inc(&core->counters->cleaner.cleaned);
+}
+
+void ocf_core_stats_cleaner_write_update(ocf_core_t core, uint64_t bytes)
+{
+	struct ocf_counters_cleaner *counters = &core->counters->cleaner;
+
+	env_atomic64_inc(&counters->core_writes);
+	env_atomic64_add(bytes, &counters->core_write_bytes);
+}
+
+void ocf_core_stats_cleaner_latency_update(ocf_core_t core, uint8_t dir,
+		uint64_t ticks)
+{
+	struct ocf_counters_cleaner *counters = &core->counters->cleaner;
+	unsigned bucket = _ocf_stats_cleaner_bucket(
+			env_ticks_to_nsecs(ticks) / 1000,
+			OCF_STATS_CLEANER_LATENCY_BUCKETS);
+
+	switch (dir) {
+		case OCF_READ:
+			env_atomic64_inc(&counters->cache_read_latency[bucket]);
+			break;
+		case OCF_WRITE:
+			env_atomic64_inc(&counters->core_write_latency[bucket]);
+			break;
+		default:
+			ENV_BUG();
+	}
+}
+
+void ocf_core_stats_cleaner_lock_abort_update(ocf_core_t core)
+{
+	env_atomic64_inc(&core->counters->cleaner.lock_aborts);
+}
+
+void ocf_core_stats_cleaner_inflight_skip_update(ocf_core_t core)
+{
+	env_atomic64_inc(&core->counters->cleaner.inflight_skips);
+}
+
+void ocf_core_stats_cleaner_dirty_age_update(ocf_core_t core, uint32_t secs)
+{
+	env_atomic64_inc(&core->counters->cleaner.dirty_age[
+			_ocf_stats_cleaner_bucket(secs,
+				OCF_STATS_CLEANER_AGE_BUCKETS)]);
+}
+
+void ocf_cache_stats_cleaner_getter_skip_update(ocf_cache_t cache)
+{
+	env_atomic64_inc(&cache->cleaner_counters.getter_skips);
+}
+
+void ocf_cache_stats_cleaner_initialize(ocf_cache_t cache)
+{
+	ocf_stats_cleaner_init(&cache->cleaner_counters);
+}
+
 /********************************************************************
  * Function that resets stats, debug and breakdown counters.
  * If reset is set the following stats won't be reset:
@@ -195,6 +304,8 @@ void ocf_core_stats_initialize(ocf_core_t core)
 	ocf_stats_error_init(&exp_obj_stats->cache_errors);
 	ocf_stats_error_init(&exp_obj_stats->core_errors);
 
+	ocf_stats_cleaner_init(&exp_obj_stats->cleaner);
+
 	for (i = 0; i != OCF_USER_IO_CLASS_MAX; i++)
 		ocf_stats_part_init(&exp_obj_stats->part_counters[i]);
 
@@ -207,6 +318,8 @@ void ocf_core_stats_initialize_all(ocf_cache_t cache)
 {
 	ocf_core_id_t id;
 
+	ocf_cache_stats_cleaner_initialize(cache);
+
 	for (id = 0; id < OCF_CORE_MAX; id++) {
 		if (!env_bit_test(id, cache->conf_meta->valid_core_bitmap))
 			continue;
@@ -222,6 +335,8 @@ static void copy_req_stats(struct ocf_stats_req *dest,
 	dest->full_miss = env_atomic64_read(&from->full_miss);
 	dest->total = env_atomic64_read(&from->total);
 	dest->pass_through = env_atomic64_read(&from->pass_through);
+	dest->lockless = env_atomic64_read(&from->lockless);
+	dest->lockless_retry = env_atomic64_read(&from->lockless_retry);
 }
 
 static void accum_req_stats(struct ocf_stats_req *dest,
@@ -231,6 +346,8 @@ static void accum_req_stats(struct ocf_stats_req *dest,
 	dest->full_miss += env_atomic64_read(&from->full_miss);
 	dest->total += env_atomic64_read(&from->total);
 	dest->pass_through += env_atomic64_read(&from->pass_through);
+	dest->lockless += env_atomic64_read(&from->lockless);
+	dest->lockless_retry += env_atomic64_read(&from->lockless_retry);
 }
 
 static void copy_block_stats(struct ocf_stats_block *dest,
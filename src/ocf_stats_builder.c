@@ -10,6 +10,7 @@
 #include "utils/utils_user_part.h"
 #include "utils/utils_cache_line.h"
 #include "utils/utils_stats.h"
+#include "ocf_lru.h"
 
 static void _fill_req(struct ocf_stats_requests *req, struct ocf_stats_core *s)
 {
@@ -25,6 +26,8 @@ static void _fill_req(struct ocf_stats_requests *req, struct ocf_stats_core *s)
 	_set(&req->rd_partial_misses, s->read_reqs.partial_miss, total);
 	_set(&req->rd_full_misses, s->read_reqs.full_miss, total);
 	_set(&req->rd_total, s->read_reqs.total, total);
+	_set(&req->rd_lockless_hits, s->read_reqs.lockless, total);
+	_set(&req->rd_lockless_retries, s->read_reqs.lockless_retry, total);
 
 	/* Write Section */
 	hit = s->write_reqs.total - (s->write_reqs.full_miss +
@@ -58,6 +61,8 @@ static void _fill_req_part(struct ocf_stats_requests *req,
 	_set(&req->rd_partial_misses, s->read_reqs.partial_miss, total);
 	_set(&req->rd_full_misses, s->read_reqs.full_miss, total);
 	_set(&req->rd_total, s->read_reqs.total, total);
+	_set(&req->rd_lockless_hits, s->read_reqs.lockless, total);
+	_set(&req->rd_lockless_retries, s->read_reqs.lockless_retry, total);
 
 	/* Write Section */
 	hit = s->write_reqs.total - (s->write_reqs.full_miss +
@@ -175,6 +180,8 @@ static void _accumulate_reqs(struct ocf_stats_req *to,
 	to->partial_miss += from->partial_miss;
 	to->total += from->total;
 	to->pass_through += from->pass_through;
+	to->lockless += from->lockless;
+	to->lockless_retry += from->lockless_retry;
 }
 
 static void _accumulate_errors(struct ocf_stats_error *to,
@@ -307,6 +314,79 @@ int ocf_stats_collect_part_cache(ocf_cache_t cache, ocf_part_id_t part_id,
 	return result;
 }
 
+int ocf_stats_collect_part_lru(ocf_cache_t cache, ocf_part_id_t part_id,
+		struct ocf_stats_lru *lru)
+{
+	ocf_cache_line_size_t cache_line_size;
+	uint32_t protected, probation;
+
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(lru);
+
+	if (part_id > OCF_IO_CLASS_ID_MAX)
+		return -OCF_ERR_INVAL;
+
+	_ocf_stats_zero(lru);
+
+	if (!ocf_cache_is_device_attached(cache))
+		return 0;
+
+	/* Lists are not locked, so values are only approximation when cache
+	 * is running I/O */
+	ocf_lru_get_segments(cache, &cache->user_parts[part_id].part,
+			&protected, &probation);
+
+	cache_line_size = ocf_cache_get_line_size(cache);
+
+	_set(&lru->protected, _lines4k(protected, cache_line_size),
+			_lines4k(protected + probation, cache_line_size));
+	_set(&lru->probation, _lines4k(probation, cache_line_size),
+			_lines4k(protected + probation, cache_line_size));
+
+	return 0;
+}
+
+int ocf_stats_collect_part_eviction(ocf_cache_t cache, ocf_part_id_t part_id,
+		struct ocf_stats_eviction *eviction)
+{
+	struct ocf_lru_part_stats *stats;
+	uint64_t victims;
+	unsigned i;
+
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(eviction);
+
+	if (part_id > OCF_IO_CLASS_ID_MAX)
+		return -OCF_ERR_INVAL;
+
+	ENV_BUG_ON(env_memset(eviction, sizeof(*eviction), 0));
+
+	if (!ocf_cache_is_device_attached(cache))
+		return 0;
+
+	stats = &cache->user_parts[part_id].lru_stats;
+	victims = env_atomic64_read(&stats->victims);
+
+	eviction->victims = victims;
+	eviction->iterations = env_atomic64_read(&stats->iterations);
+	eviction->hash_lock_fails = env_atomic64_read(&stats->hash_lock_fails);
+	eviction->line_lock_fails = env_atomic64_read(&stats->line_lock_fails);
+	eviction->dirty_skipped = env_atomic64_read(&stats->dirty_skipped);
+	eviction->lock_contended = env_atomic64_read(&stats->lock_contended);
+	eviction->lock_wait_us = env_ticks_to_nsecs(
+			env_atomic64_read(&stats->lock_wait_ticks)) / 1000;
+
+	for (i = 0; i < OCF_STATS_EVICTION_AGE_BUCKETS; i++)
+		_set(&eviction->age[i], env_atomic64_read(&stats->age[i]),
+				victims);
+
+	for (i = 0; i < OCF_STATS_EVICTION_HITS_BUCKETS; i++)
+		_set(&eviction->hits[i], env_atomic64_read(&stats->hits[i]),
+				victims);
+
+	return 0;
+}
+
 int ocf_stats_collect_core(ocf_core_t core,
 		struct ocf_stats_usage *usage,
 		struct ocf_stats_requests *req,
@@ -443,3 +523,132 @@ int ocf_stats_collect_cache(ocf_cache_t cache,
 
 	return 0;
 }
+
+int ocf_stats_collect_flush(ocf_cache_t cache, struct ocf_stats_flush *flush)
+{
+	uint64_t flushed, remaining;
+
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(flush);
+
+	ENV_BUG_ON(env_memset(flush, sizeof(*flush), 0));
+
+	if (!env_atomic_read(&cache->flush_progress.active))
+		return 0;
+
+	flush->in_progress = true;
+
+	flushed = env_atomic64_read(&cache->flush_progress.flushed);
+	_set(&flush->flushed, flushed, cache->flush_progress.dirty_initial);
+	_set(&flush->scanned, env_atomic64_read(&cache->flush_progress.scanned),
+			cache->flush_progress.total);
+
+	flush->elapsed_ms = env_ticks_to_msecs(env_get_tick_count() -
+			cache->flush_progress.start);
+	if (!flush->elapsed_ms || !flushed)
+		return 0;
+
+	flush->rate = flushed * 1000 / flush->elapsed_ms;
+	if (!flush->rate)
+		return 0;
+
+	remaining = cache->flush_progress.dirty_initial -
+			OCF_MIN(flushed, cache->flush_progress.dirty_initial);
+	flush->eta_ms = remaining * 1000 / flush->rate;
+
+	return 0;
+}
+
+static void _accum_cleaner(struct ocf_stats_cleaner *cleaner,
+		const struct ocf_counters_cleaner *from)
+{
+	unsigned i;
+
+	cleaner->cleaned += env_atomic64_read(&from->cleaned);
+	cleaner->core_write_bytes += env_atomic64_read(&from->core_write_bytes);
+	cleaner->core_writes += env_atomic64_read(&from->core_writes);
+	cleaner->getter_skips += env_atomic64_read(&from->getter_skips);
+	cleaner->lock_aborts += env_atomic64_read(&from->lock_aborts);
+	cleaner->inflight_skips += env_atomic64_read(&from->inflight_skips);
+
+	for (i = 0; i < OCF_STATS_CLEANER_LATENCY_BUCKETS; i++) {
+		cleaner->cache_read_latency[i].value +=
+				env_atomic64_read(&from->cache_read_latency[i]);
+		cleaner->core_write_latency[i].value +=
+				env_atomic64_read(&from->core_write_latency[i]);
+	}
+
+	for (i = 0; i < OCF_STATS_CLEANER_AGE_BUCKETS; i++) {
+		cleaner->dirty_age[i].value +=
+				env_atomic64_read(&from->dirty_age[i]);
+	}
+}
+
+static void _fill_cleaner_histogram(struct ocf_stat *hist, unsigned buckets)
+{
+	uint64_t total = 0;
+	unsigned i;
+
+	for (i = 0; i < buckets; i++)
+		total += hist[i].value;
+
+	for (i = 0; i < buckets; i++)
+		_set(&hist[i], hist[i].value, total);
+}
+
+static void _fill_cleaner(struct ocf_stats_cleaner *cleaner,
+		uint64_t reset_tick)
+{
+	uint64_t elapsed_ms = env_ticks_to_msecs(env_get_tick_count() -
+			reset_tick);
+
+	if (elapsed_ms)
+		cleaner->rate = cleaner->cleaned * 1000 / elapsed_ms;
+
+	if (cleaner->core_writes) {
+		cleaner->avg_batch = cleaner->cleaned * 100 /
+				cleaner->core_writes;
+	}
+
+	_fill_cleaner_histogram(cleaner->cache_read_latency,
+			OCF_STATS_CLEANER_LATENCY_BUCKETS);
+	_fill_cleaner_histogram(cleaner->core_write_latency,
+			OCF_STATS_CLEANER_LATENCY_BUCKETS);
+	_fill_cleaner_histogram(cleaner->dirty_age,
+			OCF_STATS_CLEANER_AGE_BUCKETS);
+}
+
+int ocf_stats_collect_cleaner(ocf_cache_t cache,
+		struct ocf_stats_cleaner *cleaner)
+{
+	ocf_core_t core;
+	ocf_core_id_t core_id;
+
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(cleaner);
+
+	ENV_BUG_ON(env_memset(cleaner, sizeof(*cleaner), 0));
+
+	_accum_cleaner(cleaner, &cache->cleaner_counters);
+
+	for_each_core(cache, core, core_id)
+		_accum_cleaner(cleaner, &core->counters->cleaner);
+
+	_fill_cleaner(cleaner, cache->cleaner_counters.reset_tick);
+
+	return 0;
+}
+
+int ocf_stats_collect_core_cleaner(ocf_core_t core,
+		struct ocf_stats_cleaner *cleaner)
+{
+	OCF_CHECK_NULL(core);
+	OCF_CHECK_NULL(cleaner);
+
+	ENV_BUG_ON(env_memset(cleaner, sizeof(*cleaner), 0));
+
+	_accum_cleaner(cleaner, &core->counters->cleaner);
+	_fill_cleaner(cleaner, core->counters->cleaner.reset_tick);
+
+	return 0;
+}
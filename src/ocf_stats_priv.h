@@ -21,6 +21,8 @@ struct ocf_counters_req {
 	env_atomic64 full_miss;
 	env_atomic64 total;
 	env_atomic64 pass_through;
+	env_atomic64 lockless;
+	env_atomic64 lockless_retry;
 };
 
 /**
@@ -41,6 +43,12 @@ struct ocf_stats_req {
 
 	/** Pass-through requests */
 	uint64_t pass_through;
+
+	/** Hits served without taking hash bucket and cache line locks */
+	uint64_t lockless;
+
+	/** Lockless hits retried with locks due to conflicting remap */
+	uint64_t lockless_retry;
 };
 
 /**
@@ -172,10 +180,28 @@ struct ocf_counters_debug {
 };
 #endif
 
+struct ocf_counters_cleaner {
+	env_atomic64 cleaned;
+	env_atomic64 core_write_bytes;
+	env_atomic64 core_writes;
+	env_atomic64 getter_skips;
+	env_atomic64 lock_aborts;
+	env_atomic64 inflight_skips;
+
+	env_atomic64 cache_read_latency[OCF_STATS_CLEANER_LATENCY_BUCKETS];
+	env_atomic64 core_write_latency[OCF_STATS_CLEANER_LATENCY_BUCKETS];
+	env_atomic64 dirty_age[OCF_STATS_CLEANER_AGE_BUCKETS];
+
+	/* tick count of last reset */
+	uint64_t reset_tick;
+};
+
 struct ocf_counters_core {
 	struct ocf_counters_error core_errors;
 	struct ocf_counters_error cache_errors;
 
+	struct ocf_counters_cleaner cleaner;
+
 	struct ocf_counters_part part_counters[OCF_USER_IO_CLASS_MAX];
 #ifdef OCF_DEBUG_STATS
 	struct ocf_counters_debug debug_stats;
@@ -193,6 +219,8 @@ void ocf_core_stats_request_update(ocf_core_t core, ocf_part_id_t part_id,
 		uint8_t dir, uint64_t hit_no, uint64_t core_line_count);
 void ocf_core_stats_request_pt_update(ocf_core_t core, ocf_part_id_t part_id,
 		uint8_t dir, uint64_t hit_no, uint64_t core_line_count);
+void ocf_core_stats_request_lockless_update(ocf_core_t core,
+		ocf_part_id_t part_id, bool retry);
 
 void ocf_core_stats_core_error_update(ocf_core_t core, uint8_t dir);
 void ocf_core_stats_cache_error_update(ocf_core_t core, uint8_t dir);
@@ -210,6 +238,17 @@ void ocf_core_stats_cache_error_update(ocf_core_t core, uint8_t dir);
  *
  * @result zero upon successful completion; error code otherwise
  */
+void ocf_core_stats_cleaner_clean_update(ocf_core_t core);
+void ocf_core_stats_cleaner_write_update(ocf_core_t core, uint64_t bytes);
+void ocf_core_stats_cleaner_latency_update(ocf_core_t core, uint8_t dir,
+		uint64_t ticks);
+void ocf_core_stats_cleaner_lock_abort_update(ocf_core_t core);
+void ocf_core_stats_cleaner_inflight_skip_update(ocf_core_t core);
+void ocf_core_stats_cleaner_dirty_age_update(ocf_core_t core, uint32_t secs);
+
+void ocf_cache_stats_cleaner_getter_skip_update(ocf_cache_t cache);
+void ocf_cache_stats_cleaner_initialize(ocf_cache_t cache);
+
 int ocf_core_io_class_get_stats(ocf_core_t core, ocf_part_id_t part_id,
 		struct ocf_stats_io_class *stats);
 
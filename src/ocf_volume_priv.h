@@ -55,6 +55,11 @@ static inline void ocf_volume_submit_metadata(struct ocf_io *io)
 	volume->type->properties->ops.submit_metadata(io);
 }
 
+static inline bool ocf_volume_has_write_zeroes(ocf_volume_t volume)
+{
+	return !!volume->type->properties->ops.submit_write_zeroes;
+}
+
 static inline void ocf_volume_submit_write_zeroes(struct ocf_io *io)
 {
 	ocf_volume_t volume = ocf_io_get_volume(io);
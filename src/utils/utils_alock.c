@@ -6,6 +6,7 @@
 #include "../ocf_cache_priv.h"
 #include "../ocf_priv.h"
 #include "../ocf_request.h"
+#include "../metadata/metadata.h"
 #include "utils_alock.h"
 
 #define OCF_CACHE_CONCURRENCY_DEBUG 0
@@ -64,6 +65,7 @@ struct ocf_alock {
 
 	ocf_cache_line_t num_entries;
 	env_atomic *access;
+	ocf_metadata_page_t access_backing;
 	env_allocator *allocator;
 	struct ocf_alock_lock_cbs *cbs;
 	struct ocf_alock_waiters_list waiters_lsts[_WAITERS_LIST_ENTRIES];
@@ -108,7 +110,9 @@ int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
 		goto rwsem_err;
 	}
 
-	self->access = env_vzalloc(num_entries * sizeof(self->access[0]));
+	self->access = ocf_metadata_large_alloc(cache,
+			num_entries * sizeof(self->access[0]),
+			&self->access_backing);
 
 	if (!self->access) {
 		error = __LINE__;
@@ -141,8 +145,9 @@ allocation_err:
 	if (self->allocator)
 		env_allocator_destroy(self->allocator);
 
-	if (self->access)
-		env_vfree(self->access);
+	ocf_metadata_large_free(cache, self->access,
+			num_entries * sizeof(self->access[0]),
+			self->access_backing);
 
 	env_mutex_destroy(&self->lock);
 rwsem_err:
@@ -190,8 +195,9 @@ void ocf_alock_deinit(struct ocf_alock **self)
 	for (i = 0; i < _WAITERS_LIST_ENTRIES; i++)
 		env_spinlock_destroy(&concurrency->waiters_lsts[i].lock);
 
-	if (concurrency->access)
-		env_vfree(concurrency->access);
+	ocf_metadata_large_free(concurrency->cache, concurrency->access,
+			concurrency->num_entries * sizeof(concurrency->access[0]),
+			concurrency->access_backing);
 
 	if (concurrency->allocator)
 		env_allocator_destroy(concurrency->allocator);
@@ -820,6 +826,15 @@ bool ocf_cache_line_is_used(struct ocf_alock *alock,
 	return !ocf_alock_waitlist_is_empty(alock, entry);
 }
 
+bool ocf_cache_line_is_locked_wr(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	ENV_BUG_ON(entry >= alock->num_entries);
+
+	return env_atomic_read(&(alock->access[entry])) ==
+			OCF_CACHE_LINE_ACCESS_WR;
+}
+
 bool ocf_alock_waitlist_is_empty(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
@@ -13,6 +13,7 @@
 #include "utils_io.h"
 #include "utils_cache_line.h"
 #include "../ocf_queue_priv.h"
+#include "../cleaning/cleaning_discard.h"
 
 #define OCF_UTILS_CLEANER_DEBUG 0
 
@@ -48,6 +49,7 @@ static struct ocf_request *_ocf_cleaner_alloc_req(struct ocf_cache *cache,
 
 	req->info.internal = true;
 	req->info.cleaner_cache_line_lock = attribs->lock_cacheline;
+	req->discard_epoch = ocf_cleaning_discard_epoch(cache);
 
 	/* Allocate pages for cleaning IO */
 	req->data = ctx_data_alloc(cache->owner,
@@ -245,6 +247,50 @@ static bool _ocf_cleaner_sector_is_dirty(struct ocf_cache *cache,
 	return valid ? dirty : false;
 }
 
+/*
+ * Number of cache lines which fit in single IO to given volume
+ */
+static uint32_t _ocf_cleaner_max_io_lines(struct ocf_cache *cache,
+		ocf_volume_t volume)
+{
+	uint32_t max_io_size = ocf_volume_get_max_io_size(volume);
+
+	return OCF_MAX(max_io_size / ocf_line_size(cache), 1U);
+}
+
+/*
+ * Mark all cache lines covered by failed IO
+ */
+static void _ocf_cleaner_io_set_invalid(struct ocf_request *req,
+		struct ocf_map_info *map, struct ocf_io *io)
+{
+	uint32_t i, count;
+
+	count = OCF_DIV_ROUND_UP(io->bytes, ocf_line_size(req->cache));
+	for (i = 0; i < OCF_MAX(count, 1U); i++)
+		map[i].invalid |= 1;
+}
+
+/*
+ * Check whether cache line data is kept next to the previous one both in
+ * the request buffer and under given address, so that they can be
+ * transferred with single IO
+ */
+static bool _ocf_cleaner_io_adjacent(struct ocf_request *req,
+		struct ocf_map_info *prev, struct ocf_map_info *next)
+{
+	ocf_cache_t cache = req->cache;
+
+	if (next->invalid || next->status == LOOKUP_MISS)
+		return false;
+
+	if (next->core_id != prev->core_id || next->hash != prev->hash + 1)
+		return false;
+
+	return ocf_metadata_get_partition_id(cache, next->coll_idx) ==
+			ocf_metadata_get_partition_id(cache, prev->coll_idx);
+}
+
 static void _ocf_cleaner_finish_req(struct ocf_request *req)
 {
 	/* Handle cache lines unlocks */
@@ -313,6 +359,26 @@ static void _ocf_cleaner_metadata_io_end(struct ocf_request *req, int error)
 	ocf_engine_push_req_front(req, true);
 }
 
+/*
+ * Cleaning request latency is accounted to the core of its first cache
+ * line, requests are built of cache lines of single core in most cases
+ */
+static void _ocf_cleaner_latency_update(struct ocf_request *req, uint8_t dir)
+{
+	uint32_t i;
+
+	for (i = 0; i < req->core_line_count; i++) {
+		if (req->map[i].status == LOOKUP_MISS)
+			continue;
+
+		ocf_core_stats_cleaner_latency_update(
+				ocf_cache_get_core(req->cache,
+					req->map[i].core_id),
+				dir, env_get_tick_count() - req->cleaner_tick);
+		return;
+	}
+}
+
 static int _ocf_cleaner_update_metadata(struct ocf_request *req)
 {
 	struct ocf_cache *cache = req->cache;
@@ -350,6 +416,8 @@ static int _ocf_cleaner_update_metadata(struct ocf_request *req)
 					ocf_line_end_sector(cache), req, i);
 			ocf_metadata_end_collision_shared_access(cache,
 					cache_line);
+
+			ocf_core_stats_cleaner_clean_update(req->core);
 		}
 
 		ocf_hb_cline_prot_unlock_wr(&cache->metadata.lock,
@@ -466,6 +534,8 @@ static void _ocf_cleaner_core_io_end(struct ocf_request *req)
 
 	OCF_DEBUG_MSG(req->cache, "Core writes finished");
 
+	_ocf_cleaner_latency_update(req, OCF_WRITE);
+
 	/*
 	 * All cache read requests done, now we can submit writes to cores,
 	 * Move processing to thread, where IO will be (and can be) submitted
@@ -481,7 +551,7 @@ static void _ocf_cleaner_core_io_cmpl(struct ocf_io *io, int error)
 	ocf_core_t core = ocf_cache_get_core(req->cache, map->core_id);
 
 	if (error) {
-		map->invalid |= 1;
+		_ocf_cleaner_io_set_invalid(req, map, io);
 		_ocf_cleaner_set_error(req);
 		ocf_core_stats_core_error_update(core, OCF_WRITE);
 	}
@@ -494,7 +564,7 @@ static void _ocf_cleaner_core_io_cmpl(struct ocf_io *io, int error)
 static void _ocf_cleaner_core_io_for_dirty_range(struct ocf_request *req,
 		struct ocf_map_info *iter, uint64_t begin, uint64_t end)
 {
-	uint64_t addr, offset;
+	uint64_t addr, offset, i;
 	int err;
 	ocf_cache_t cache = req->cache;
 	struct ocf_io *io;
@@ -522,6 +592,8 @@ static void _ocf_cleaner_core_io_for_dirty_range(struct ocf_request *req,
 
 	ocf_core_stats_core_block_update(core, part_id, OCF_WRITE,
 			SECTORS_TO_BYTES(end - begin));
+	ocf_core_stats_cleaner_write_update(core,
+			SECTORS_TO_BYTES(end - begin));
 
 	OCF_DEBUG_PARAM(req->cache, "Core write, line = %llu, "
 			"sector = %llu, count = %llu", iter->core_line, begin,
@@ -535,10 +607,46 @@ static void _ocf_cleaner_core_io_for_dirty_range(struct ocf_request *req,
 
 	return;
 error:
-	iter->invalid = true;
+	/* Range may span several cache lines */
+	for (i = 0; i < OCF_DIV_ROUND_UP(end, ocf_line_sectors(cache)); i++)
+		iter[i].invalid = true;
 	_ocf_cleaner_set_error(req);
 }
 
+/*
+ * Check integrity of entry to be cleaned - whole cache line is written
+ * to core unless only some of its sectors are dirty
+ */
+static bool _ocf_cleaner_line_is_dirty(struct ocf_request *req,
+		struct ocf_map_info *iter)
+{
+	ocf_cache_t cache = req->cache;
+	bool dirty;
+
+	ocf_hb_cline_prot_lock_rd(&cache->metadata.lock, req->lock_idx,
+			iter->core_id, iter->core_line);
+
+	dirty = metadata_test_valid(cache, iter->coll_idx) &&
+			metadata_test_dirty(cache, iter->coll_idx);
+
+	ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock, req->lock_idx,
+			iter->core_id, iter->core_line);
+
+	return dirty;
+}
+
+static bool _ocf_cleaner_core_io_mergeable(struct ocf_request *req,
+		struct ocf_map_info *prev, struct ocf_map_info *next)
+{
+	if (!_ocf_cleaner_io_adjacent(req, prev, next))
+		return false;
+
+	if (next->core_line != prev->core_line + 1)
+		return false;
+
+	return _ocf_cleaner_line_is_dirty(req, next);
+}
+
 static void _ocf_cleaner_core_submit_io(struct ocf_request *req,
 		struct ocf_map_info *iter)
 {
@@ -546,16 +654,6 @@ static void _ocf_cleaner_core_submit_io(struct ocf_request *req,
 	struct ocf_cache *cache = req->cache;
 	bool counting_dirty = false;
 
-	/* Check integrity of entry to be cleaned */
-	if (metadata_test_valid(cache, iter->coll_idx)
-		&& metadata_test_dirty(cache, iter->coll_idx)) {
-
-		_ocf_cleaner_core_io_for_dirty_range(req, iter, 0,
-				ocf_line_sectors(cache));
-
-		return;
-	}
-
 	/* Sector cleaning, a little effort is required to this */
 	for (i = 0; i < ocf_line_sectors(cache); i++) {
 		if (!_ocf_cleaner_sector_is_dirty(cache, iter->coll_idx, i)) {
@@ -579,20 +677,52 @@ static void _ocf_cleaner_core_submit_io(struct ocf_request *req,
 		_ocf_cleaner_core_io_for_dirty_range(req, iter, dirty_start, i);
 }
 
-static int _ocf_cleaner_fire_core(struct ocf_request *req)
+/*
+ * Leave out cache lines discarded on the core since the request was
+ * allocated - they stay dirty and are invalidated by the discard
+ */
+static void _ocf_cleaner_skip_discarded(struct ocf_request *req)
 {
+	ocf_cache_t cache = req->cache;
+	struct ocf_map_info *iter;
 	uint32_t i;
+
+	if (ocf_cleaning_discard_epoch(cache) == req->discard_epoch)
+		return;
+
+	for (i = 0; i < req->core_line_count; i++) {
+		iter = &req->map[i];
+
+		if (iter->invalid || iter->status == LOOKUP_MISS)
+			continue;
+
+		if (ocf_cleaning_discarded(cache, req->discard_epoch,
+				iter->core_id, iter->core_line)) {
+			iter->invalid = true;
+		}
+	}
+}
+
+static int _ocf_cleaner_fire_core(struct ocf_request *req)
+{
+	uint32_t i, count, max_count;
 	struct ocf_map_info *iter;
 	ocf_cache_t cache = req->cache;
+	ocf_core_t core;
 
 	OCF_DEBUG_TRACE(req->cache);
 
+	_ocf_cleaner_skip_discarded(req);
+
+	req->cleaner_tick = env_get_tick_count();
+
 	/* Protect IO completion race */
 	env_atomic_set(&req->req_remaining, 1);
 
 	/* Submits writes to the core */
-	for (i = 0; i < req->core_line_count; i++) {
+	for (i = 0; i < req->core_line_count; i += count) {
 		iter = &(req->map[i]);
+		count = 1;
 
 		if (iter->invalid) {
 			/* IO read error on cache, skip this item */
@@ -602,15 +732,32 @@ static int _ocf_cleaner_fire_core(struct ocf_request *req)
 		if (iter->status == LOOKUP_MISS)
 			continue;
 
-		ocf_hb_cline_prot_lock_rd(&cache->metadata.lock,
-				req->lock_idx, req->map[i].core_id,
-				req->map[i].core_line);
+		if (!_ocf_cleaner_line_is_dirty(req, iter)) {
+			ocf_hb_cline_prot_lock_rd(&cache->metadata.lock,
+					req->lock_idx, iter->core_id,
+					iter->core_line);
 
-		_ocf_cleaner_core_submit_io(req, iter);
+			_ocf_cleaner_core_submit_io(req, iter);
 
-		ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock,
-				req->lock_idx, req->map[i].core_id,
-				req->map[i].core_line);
+			ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock,
+					req->lock_idx, iter->core_id,
+					iter->core_line);
+			continue;
+		}
+
+		/* Fully dirty cache lines following each other on the core
+		 * are written with single IO */
+		core = ocf_cache_get_core(cache, iter->core_id);
+		max_count = OCF_MIN(_ocf_cleaner_max_io_lines(cache,
+				&core->volume), req->core_line_count - i);
+
+		while (count < max_count && _ocf_cleaner_core_io_mergeable(req,
+				&iter[count - 1], &iter[count])) {
+			count++;
+		}
+
+		_ocf_cleaner_core_io_for_dirty_range(req, iter, 0,
+				count * ocf_line_sectors(cache));
 	}
 
 	/* Protect IO completion race */
@@ -629,6 +776,8 @@ static void _ocf_cleaner_cache_io_end(struct ocf_request *req)
 	if (env_atomic_dec_return(&req->req_remaining))
 		return;
 
+	_ocf_cleaner_latency_update(req, OCF_READ);
+
 	/*
 	 * All cache read requests done, now we can submit writes to cores,
 	 * Move processing to thread, where IO will be (and can be) submitted
@@ -646,7 +795,7 @@ static void _ocf_cleaner_cache_io_cmpl(struct ocf_io *io, int error)
 	ocf_core_t core = ocf_cache_get_core(req->cache, map->core_id);
 
 	if (error) {
-		map->invalid |= 1;
+		_ocf_cleaner_io_set_invalid(req, map, io);
 		_ocf_cleaner_set_error(req);
 		ocf_core_stats_cache_error_update(core, OCF_READ);
 	}
@@ -656,66 +805,106 @@ static void _ocf_cleaner_cache_io_cmpl(struct ocf_io *io, int error)
 	ocf_io_put(io);
 }
 
-/*
- * cleaner - Traverse cache lines to be cleaned, detect sequential IO, and
- * perform cache reads and core writes
- */
-static int _ocf_cleaner_fire_cache(struct ocf_request *req)
+static bool _ocf_cleaner_cache_io_mergeable(struct ocf_request *req,
+		struct ocf_map_info *prev, struct ocf_map_info *next)
 {
 	ocf_cache_t cache = req->cache;
-	ocf_core_t core;
-	uint32_t i;
-	struct ocf_map_info *iter = req->map;
+
+	if (!_ocf_cleaner_io_adjacent(req, prev, next))
+		return false;
+
+	return ocf_metadata_map_lg2phy(cache, next->coll_idx) ==
+			ocf_metadata_map_lg2phy(cache, prev->coll_idx) + 1;
+}
+
+static void _ocf_cleaner_cache_io(struct ocf_request *req,
+		struct ocf_map_info *iter, uint32_t count)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_core_t core = ocf_cache_get_core(cache, iter->core_id);
 	uint64_t addr, offset;
 	ocf_part_id_t part_id;
 	struct ocf_io *io;
+	uint32_t i;
 	int err;
 
-	/* Protect IO completion race */
+	OCF_DEBUG_PARAM(req->cache, "Cache read, line = %u, count = %u",
+			iter->coll_idx, count);
+
+	addr = ocf_metadata_map_lg2phy(cache,
+			iter->coll_idx);
+	addr *= ocf_line_size(cache);
+	addr += cache->device->metadata_offset;
+
+	offset = ocf_line_size(cache) * iter->hash;
+
+	part_id = ocf_metadata_get_partition_id(cache, iter->coll_idx);
+
+	io = ocf_new_cache_io(cache, req->io_queue,
+			addr, count * ocf_line_size(cache),
+			OCF_READ, part_id, 0);
+	if (!io) {
+		/* Allocation error */
+		goto error;
+	}
+
+	ocf_io_set_cmpl(io, iter, req, _ocf_cleaner_cache_io_cmpl);
+	err = ocf_io_set_data(io, req->data, offset);
+	if (err) {
+		ocf_io_put(io);
+		goto error;
+	}
+
+	ocf_core_stats_cache_block_update(core, part_id, OCF_READ,
+			count * ocf_line_size(cache));
+
 	env_atomic_inc(&req->req_remaining);
 
-	for (i = 0; i < req->core_line_count; i++, iter++) {
-		core = ocf_cache_get_core(cache, iter->core_id);
-		if (!core)
-			continue;
-		if (iter->status == LOOKUP_MISS)
-			continue;
+	ocf_volume_submit_io(io);
+
+	return;
+
+error:
+	for (i = 0; i < count; i++)
+		iter[i].invalid = true;
+	_ocf_cleaner_set_error(req);
+}
+
+/*
+ * cleaner - Traverse cache lines to be cleaned, detect sequential IO, and
+ * perform cache reads and core writes
+ */
+static int _ocf_cleaner_fire_cache(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	uint32_t i, count, max_count;
+	struct ocf_map_info *iter;
 
-		OCF_DEBUG_PARAM(req->cache, "Cache read, line =  %u",
-				iter->coll_idx);
+	req->cleaner_tick = env_get_tick_count();
 
-		addr = ocf_metadata_map_lg2phy(cache,
-				iter->coll_idx);
-		addr *= ocf_line_size(cache);
-		addr += cache->device->metadata_offset;
+	/* Protect IO completion race */
+	env_atomic_set(&req->req_remaining, 1);
 
-		offset = ocf_line_size(cache) * iter->hash;
+	max_count = _ocf_cleaner_max_io_lines(cache, &cache->device->volume);
 
-		part_id = ocf_metadata_get_partition_id(cache, iter->coll_idx);
+	for (i = 0; i < req->core_line_count; i += count) {
+		iter = &req->map[i];
+		count = 1;
 
-		io = ocf_new_cache_io(cache, req->io_queue,
-				addr, ocf_line_size(cache),
-				OCF_READ, part_id, 0);
-		if (!io) {
-			/* Allocation error */
-			iter->invalid = true;
-			_ocf_cleaner_set_error(req);
+		if (!ocf_cache_get_core(cache, iter->core_id))
 			continue;
-		}
-
-		ocf_io_set_cmpl(io, iter, req, _ocf_cleaner_cache_io_cmpl);
-		err = ocf_io_set_data(io, req->data, offset);
-		if (err) {
-			ocf_io_put(io);
-			iter->invalid = true;
-			_ocf_cleaner_set_error(req);
+		if (iter->status == LOOKUP_MISS)
 			continue;
-		}
 
-		ocf_core_stats_cache_block_update(core, part_id, OCF_READ,
-				ocf_line_size(cache));
+		/* Cache lines stored next to each other on the cache device
+		 * are read with single IO */
+		while (i + count < req->core_line_count && count < max_count &&
+				_ocf_cleaner_cache_io_mergeable(req,
+					&iter[count - 1], &iter[count])) {
+			count++;
+		}
 
-		ocf_volume_submit_io(io);
+		_ocf_cleaner_cache_io(req, iter, count);
 	}
 
 	/* Protect IO completion race */
@@ -780,8 +969,6 @@ static int _ocf_cleaner_do_fire(struct ocf_request *req,  uint32_t i_out,
 		bool do_sort)
 {
 	uint32_t i;
-	/* Set counts of cache IOs */
-	env_atomic_set(&req->req_remaining, i_out);
 
 	/* fill tail of a request with fake MISSes so that it won't
 	 *  be cleaned
@@ -898,6 +1085,7 @@ void ocf_cleaner_fire(struct ocf_cache *cache,
 		if (attribs->getter(cache, attribs->getter_context,
 				i, &cache_line)) {
 			OCF_DEBUG_MSG(cache, "Skip");
+			ocf_cache_stats_cleaner_getter_skip_update(cache);
 			continue;
 		}
 
@@ -1035,18 +1223,6 @@ void ocf_cleaner_sort_sectors(struct flush_data *tbl, uint32_t num)
 	env_sort(tbl, num, sizeof(*tbl), _ocf_cleaner_cmp, _ocf_cleaner_swap);
 }
 
-void ocf_cleaner_sort_flush_containers(struct flush_container *fctbl,
-		uint32_t num)
-{
-	int i;
-
-	for (i = 0; i < num; i++) {
-		env_sort(fctbl[i].flush_data, fctbl[i].count,
-				sizeof(*fctbl[i].flush_data), _ocf_cleaner_cmp,
-				_ocf_cleaner_swap);
-	}
-}
-
 void ocf_cleaner_refcnt_freeze(ocf_cache_t cache)
 {
 	struct ocf_user_part *curr_part;
@@ -1054,6 +1230,8 @@ void ocf_cleaner_refcnt_freeze(ocf_cache_t cache)
 
 	for_each_user_part(cache, curr_part, part_id)
 		ocf_refcnt_freeze(&curr_part->cleaning.counter);
+
+	ocf_refcnt_freeze(&cache->cleaner.streams.refcnt);
 }
 
 void ocf_cleaner_refcnt_unfreeze(ocf_cache_t cache)
@@ -1063,6 +1241,8 @@ void ocf_cleaner_refcnt_unfreeze(ocf_cache_t cache)
 
 	for_each_user_part(cache, curr_part, part_id)
 		ocf_refcnt_unfreeze(&curr_part->cleaning.counter);
+
+	ocf_refcnt_unfreeze(&cache->cleaner.streams.refcnt);
 }
 
 static void ocf_cleaner_refcnt_register_zero_cb_finish(void *priv)
@@ -1090,5 +1270,10 @@ void ocf_cleaner_refcnt_register_zero_cb(ocf_cache_t cache,
 				ocf_cleaner_refcnt_register_zero_cb_finish, ctx);
 	}
 
+	/* Cleaning stream I/O outlives cleaning cycle */
+	env_atomic_inc(&ctx->waiting);
+	ocf_refcnt_register_zero_cb(&cache->cleaner.streams.refcnt,
+			ocf_cleaner_refcnt_register_zero_cb_finish, ctx);
+
 	ocf_cleaner_refcnt_register_zero_cb_finish(ctx);
 }
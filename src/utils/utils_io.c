@@ -252,7 +252,7 @@ void ocf_submit_cache_reqs(struct ocf_cache* cache,
 
         ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
 
-        err = ocf_io_set_data(io, req->data, offset);
+        err = ocf_io_set_data(io, req->data, req->offset + offset);
         if (err) {
             ocf_io_put(io);
             callback(req, err);
@@ -303,7 +303,8 @@ void ocf_submit_cache_reqs(struct ocf_cache* cache,
 
         ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
 
-        err = ocf_io_set_data(io, req->data, offset + total_bytes);
+        err = ocf_io_set_data(io, req->data,
+                              req->offset + offset + total_bytes);
         if (err) {
             ocf_io_put(io);
             /* Finish all IOs which left with ERROR */
@@ -338,7 +339,7 @@ void ocf_submit_volume_req(ocf_volume_t volume, struct ocf_request* req, ocf_req
     }
 
     ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
-    err = ocf_io_set_data(io, req->data, 0);
+    err = ocf_io_set_data(io, req->data, req->offset);
     if (err) {
         ocf_io_put(io);
         callback(req, err);
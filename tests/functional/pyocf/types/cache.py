@@ -34,9 +34,18 @@ from .shared import (
 from ..utils import Size, struct_to_dict
 from .core import Core
 from .queue import Queue
+from .cleaner import Cleaner
 from .stats.cache import CacheInfo
 from .ioclass import IoClassesInfo, IoClassInfo
-from .stats.shared import UsageStats, RequestsStats, BlocksStats, ErrorsStats
+from .stats.shared import (
+    UsageStats,
+    RequestsStats,
+    BlocksStats,
+    ErrorsStats,
+    CleanerStats,
+    EvictionStats,
+    LruStats,
+)
 
 
 class Backfill(Structure):
@@ -49,9 +58,13 @@ class CacheConfig(Structure):
         ("_name", c_char * MAX_CACHE_NAME_SIZE),
         ("_cache_mode", c_uint32),
         ("_promotion_policy", c_uint32),
+        ("_eviction_policy", c_uint32),
         ("_cache_line_size", c_uint64),
         ("_metadata_layout", c_uint32),
         ("_metadata_volatile", c_bool),
+        ("_metadata_page", c_uint32),
+        ("_metadata_numa_node", c_int),
+        ("_metadata_journal", c_bool),
         ("_locked", c_bool),
         ("_pt_unaligned_io", c_bool),
         ("_use_submit_io_fast", c_bool),
@@ -121,6 +134,13 @@ class PromotionPolicy(IntEnum):
     DEFAULT = ALWAYS
 
 
+class EvictionPolicy(IntEnum):
+    LRU = 0
+    CLOCK = 1
+    COST = 2
+    DEFAULT = LRU
+
+
 class NhitParams(IntEnum):
     INSERTION_THRESHOLD = 0
     TRIGGER_THRESHOLD = 1
@@ -130,6 +150,7 @@ class CleaningPolicy(IntEnum):
     NOP = 0
     ALRU = 1
     ACP = 2
+    ELEVATOR = 3
     DEFAULT = ALRU
 
 
@@ -145,12 +166,29 @@ class AcpParams(IntEnum):
     FLUSH_MAX_BUFFERS = 1
 
 
+class ElevatorParams(IntEnum):
+    WAKE_UP_TIME = 0
+    FLUSH_MAX_BUFFERS = 1
+
+
 class MetadataLayout(IntEnum):
     STRIPING = 0
     SEQUENTIAL = 1
     DEFAULT = STRIPING
 
 
+class MetadataPage(IntEnum):
+    DEFAULT = 0
+    THP = 1
+    HUGE_2M = 2
+    HUGE_1G = 3
+
+
+NUMA_NODE_ANY = -1
+NUMA_INTERLEAVE = -2
+NUMA_NODE_MAX = 64
+
+
 class Cache:
     DEFAULT_BACKFILL_QUEUE_SIZE = 65536
     DEFAULT_BACKFILL_UNBLOCK = 60000
@@ -163,9 +201,13 @@ class Cache:
         name: str = "cache",
         cache_mode: CacheMode = CacheMode.DEFAULT,
         promotion_policy: PromotionPolicy = PromotionPolicy.DEFAULT,
+        eviction_policy: EvictionPolicy = EvictionPolicy.DEFAULT,
         cache_line_size: CacheLineSize = CacheLineSize.DEFAULT,
         metadata_layout: MetadataLayout = MetadataLayout.DEFAULT,
         metadata_volatile: bool = False,
+        metadata_page: MetadataPage = MetadataPage.DEFAULT,
+        metadata_numa_node: int = NUMA_NODE_ANY,
+        metadata_journal: bool = False,
         max_queue_size: int = DEFAULT_BACKFILL_QUEUE_SIZE,
         queue_unblock_size: int = DEFAULT_BACKFILL_UNBLOCK,
         locked: bool = False,
@@ -181,9 +223,13 @@ class Cache:
             _name=name.encode("ascii"),
             _cache_mode=cache_mode,
             _promotion_policy=promotion_policy,
+            _eviction_policy=eviction_policy,
             _cache_line_size=cache_line_size,
             _metadata_layout=metadata_layout,
             _metadata_volatile=metadata_volatile,
+            _metadata_page=metadata_page,
+            _metadata_numa_node=metadata_numa_node,
+            _metadata_journal=metadata_journal,
             _backfill=Backfill(
                 _max_queue_size=max_queue_size, _queue_unblock_size=queue_unblock_size
             ),
@@ -329,6 +375,128 @@ class Cache:
                 "Error setting cache seq cut off policy promotion count", status
             )
 
+    def set_reclaim_watermarks(self, low_watermark: int, high_watermark: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_reclaim_watermarks(
+            self.cache_handle, low_watermark, high_watermark
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting reclaim watermarks", status)
+
+    def set_eviction_stats(self, enable: bool):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_eviction_stats(
+            self.cache_handle, enable
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting eviction statistics", status)
+
+    def set_lru_deferred_balance(self, enable: bool):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_lru_deferred_balance(
+            self.cache_handle, enable
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting deferred LRU balancing", status)
+
+    def run_cleaner(self):
+        cleaner = Cleaner.get_by_cache(self.cache_handle.value)
+        c = OcfCompletion([("cleaner", c_void_p), ("interval", c_uint32)])
+        callback = c.callback
+
+        self.owner.lib.ocf_cleaner_set_cmpl(cleaner, callback)
+        self.owner.lib.ocf_cleaner_run(cleaner, self.get_default_queue())
+        c.wait()
+
+        return c.results["interval"]
+
+    def set_write_coalescing(self, max_io_size: int, max_batch_size: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_write_coalescing(
+            self.cache_handle, max_io_size, max_batch_size
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting write coalescing parameters", status)
+
+    def set_metadata_group_commit(self, max_pages: int, window_us: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_metadata_group_commit(
+            self.cache_handle, max_pages, window_us
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting metadata group commit", status)
+
+    def set_split_io_size(self, split_io_size: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_split_io_size(
+            self.cache_handle, split_io_size
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting split I/O size", status)
+
+    def set_zero_detection(self, enable: bool):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_zero_detection(
+            self.cache_handle, enable
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting zero detection", status)
+
+    def set_flush_queue_depth(self, depth: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_flush_queue_depth(
+            self.cache_handle, depth
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting flush queue depth", status)
+
+    def get_flush_queue_depth(self):
+        depth = c_uint32()
+        self.read_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_get_flush_queue_depth(
+            self.cache_handle, byref(depth)
+        )
+
+        self.read_unlock()
+
+        if status:
+            raise OcfError("Error getting flush queue depth", status)
+
+        return depth.value
+
     def get_partition_info(self, part_id: int):
         ioclass_info = IoClassInfo()
         self.read_lock()
@@ -350,6 +518,9 @@ class Cache:
             "_min_size": int(ioclass_info._min_size),
             "_max_size": int(ioclass_info._max_size),
             "_cleaning_policy_type": int(ioclass_info._cleaning_policy_type),
+            "_slru_protected_size": int(ioclass_info._slru_protected_size),
+            "_headroom_size": int(ioclass_info._headroom_size),
+            "_ttl": int(ioclass_info._ttl),
         }
 
     def add_partition(
@@ -381,6 +552,9 @@ class Cache:
         max_size: int,
         priority: int,
         cache_mode=CACHE_MODE_NONE,
+        slru_protected_size=0,
+        headroom_size=0,
+        ttl=0,
     ):
         ioclasses_info = IoClassesInfo()
 
@@ -400,6 +574,11 @@ class Cache:
             ioclasses_info._config[i]._priority = ioclass_info._priority
             ioclasses_info._config[i]._cache_mode = ioclass_info._cache_mode
             ioclasses_info._config[i]._max_size = ioclass_info._max_size
+            ioclasses_info._config[i]._slru_protected_size = (
+                ioclass_info._slru_protected_size
+            )
+            ioclasses_info._config[i]._headroom_size = ioclass_info._headroom_size
+            ioclasses_info._config[i]._ttl = ioclass_info._ttl
 
         self.read_unlock()
 
@@ -407,6 +586,9 @@ class Cache:
         ioclasses_info._config[part_id]._cache_mode = int(cache_mode)
         ioclasses_info._config[part_id]._priority = priority
         ioclasses_info._config[part_id]._max_size = max_size
+        ioclasses_info._config[part_id]._slru_protected_size = slru_protected_size
+        ioclasses_info._config[part_id]._headroom_size = headroom_size
+        ioclasses_info._config[part_id]._ttl = ttl
 
         self.write_lock()
 
@@ -591,6 +773,7 @@ class Cache:
         req = RequestsStats()
         block = BlocksStats()
         errors = ErrorsStats()
+        cleaner = CleanerStats()
 
         self.read_lock()
 
@@ -606,6 +789,13 @@ class Cache:
             self.read_unlock()
             raise OcfError("Failed getting stats", status)
 
+        status = self.owner.lib.ocf_stats_collect_cleaner(
+            self.cache_handle, byref(cleaner)
+        )
+        if status:
+            self.read_unlock()
+            raise OcfError("Failed getting cleaner stats", status)
+
         line_size = CacheLineSize(cache_info.cache_line_size)
         cache_name = self.owner.lib.ocf_cache_get_name(self).decode("ascii")
 
@@ -634,19 +824,56 @@ class Cache:
                 "state": cache_info.state,
                 "cleaning_policy": CleaningPolicy(cache_info.cleaning_policy),
                 "promotion_policy": PromotionPolicy(cache_info.promotion_policy),
+                "eviction_policy": EvictionPolicy(cache_info.eviction_policy),
                 "cache_line_size": line_size,
                 "flushed": CacheLines(cache_info.flushed, line_size),
                 "core_count": cache_info.core_count,
                 "metadata_footprint": Size(cache_info.metadata_footprint),
                 "metadata_end_offset": Size(cache_info.metadata_end_offset),
+                "metadata_backing": {
+                    page: cache_info.metadata_backing[page] for page in MetadataPage
+                },
                 "cache_name": cache_name,
             },
             "block": struct_to_dict(block),
             "req": struct_to_dict(req),
             "usage": struct_to_dict(usage),
             "errors": struct_to_dict(errors),
+            "cleaner": struct_to_dict(cleaner),
         }
 
+    def get_lru_stats(self, part_id: int = 0):
+        lru = LruStats()
+
+        self.read_lock()
+
+        status = self.owner.lib.ocf_stats_collect_part_lru(
+            self.cache_handle, part_id, byref(lru)
+        )
+
+        self.read_unlock()
+
+        if status:
+            raise OcfError("Failed getting LRU stats", status)
+
+        return struct_to_dict(lru)
+
+    def get_eviction_stats(self, part_id: int = 0):
+        eviction = EvictionStats()
+
+        self.read_lock()
+
+        status = self.owner.lib.ocf_stats_collect_part_eviction(
+            self.cache_handle, part_id, byref(eviction)
+        )
+
+        self.read_unlock()
+
+        if status:
+            raise OcfError("Failed getting eviction stats", status)
+
+        return struct_to_dict(eviction)
+
     def reset_stats(self):
         self.owner.lib.ocf_core_stats_initialize_all(self.cache_handle)
 
@@ -736,6 +963,26 @@ lib.ocf_mngt_core_set_seq_cutoff_threshold_all.argtypes = [c_void_p, c_uint32]
 lib.ocf_mngt_core_set_seq_cutoff_threshold_all.restype = c_int
 lib.ocf_mngt_core_set_seq_cutoff_promotion_count_all.argtypes = [c_void_p, c_uint32]
 lib.ocf_mngt_core_set_seq_cutoff_promotion_count_all.restype = c_int
+lib.ocf_mngt_cache_set_reclaim_watermarks.argtypes = [c_void_p, c_uint32, c_uint32]
+lib.ocf_mngt_cache_set_reclaim_watermarks.restype = c_int
+lib.ocf_mngt_cache_set_eviction_stats.argtypes = [c_void_p, c_bool]
+lib.ocf_mngt_cache_set_eviction_stats.restype = c_int
+lib.ocf_mngt_cache_set_lru_deferred_balance.argtypes = [c_void_p, c_bool]
+lib.ocf_mngt_cache_set_lru_deferred_balance.restype = c_int
+lib.ocf_cleaner_set_cmpl.argtypes = [c_void_p, c_void_p]
+lib.ocf_cleaner_run.argtypes = [c_void_p, c_void_p]
+lib.ocf_mngt_cache_set_write_coalescing.argtypes = [c_void_p, c_uint32, c_uint32]
+lib.ocf_mngt_cache_set_write_coalescing.restype = c_int
+lib.ocf_mngt_cache_set_metadata_group_commit.argtypes = [c_void_p, c_uint32, c_uint32]
+lib.ocf_mngt_cache_set_metadata_group_commit.restype = c_int
+lib.ocf_mngt_cache_set_split_io_size.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_split_io_size.restype = c_int
+lib.ocf_mngt_cache_set_zero_detection.argtypes = [c_void_p, c_bool]
+lib.ocf_mngt_cache_set_zero_detection.restype = c_int
+lib.ocf_mngt_cache_set_flush_queue_depth.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_flush_queue_depth.restype = c_int
+lib.ocf_mngt_cache_get_flush_queue_depth.argtypes = [c_void_p, c_void_p]
+lib.ocf_mngt_cache_get_flush_queue_depth.restype = c_int
 lib.ocf_stats_collect_cache.argtypes = [
     c_void_p,
     c_void_p,
@@ -744,6 +991,12 @@ lib.ocf_stats_collect_cache.argtypes = [
     c_void_p,
 ]
 lib.ocf_stats_collect_cache.restype = c_int
+lib.ocf_stats_collect_cleaner.argtypes = [c_void_p, c_void_p]
+lib.ocf_stats_collect_cleaner.restype = c_int
+lib.ocf_stats_collect_part_lru.argtypes = [c_void_p, c_uint16, c_void_p]
+lib.ocf_stats_collect_part_lru.restype = c_int
+lib.ocf_stats_collect_part_eviction.argtypes = [c_void_p, c_uint16, c_void_p]
+lib.ocf_stats_collect_part_eviction.restype = c_int
 lib.ocf_cache_get_info.argtypes = [c_void_p, c_void_p]
 lib.ocf_cache_get_info.restype = c_int
 lib.ocf_mngt_cache_cleaning_set_param.argtypes = [
@@ -27,7 +27,13 @@ from .io import Io, IoDir
 from .queue import Queue
 from .shared import Uuid, OcfCompletion, OcfError, SeqCutOffPolicy
 from .stats.core import CoreInfo
-from .stats.shared import UsageStats, RequestsStats, BlocksStats, ErrorsStats
+from .stats.shared import (
+    UsageStats,
+    RequestsStats,
+    BlocksStats,
+    ErrorsStats,
+    CleanerStats,
+)
 from .volume import Volume
 from ..ocf import OcfLib
 from ..utils import Size, struct_to_dict
@@ -126,6 +132,7 @@ class Core:
         req = RequestsStats()
         blocks = BlocksStats()
         errors = ErrorsStats()
+        cleaner = CleanerStats()
 
         self.cache.read_lock()
         status = self.cache.owner.lib.ocf_stats_collect_core(
@@ -135,6 +142,13 @@ class Core:
             self.cache.read_unlock()
             raise OcfError("Failed collecting core stats", status)
 
+        status = self.cache.owner.lib.ocf_stats_collect_core_cleaner(
+            self.handle, byref(cleaner)
+        )
+        if status:
+            self.cache.read_unlock()
+            raise OcfError("Failed collecting core cleaner stats", status)
+
         status = self.cache.owner.lib.ocf_core_get_info(
             self.handle, byref(core_info)
         )
@@ -152,6 +166,7 @@ class Core:
             "req": struct_to_dict(req),
             "blocks": struct_to_dict(blocks),
             "errors": struct_to_dict(errors),
+            "cleaner": struct_to_dict(cleaner),
         }
 
     def set_seq_cut_off_policy(self, policy: SeqCutOffPolicy):
@@ -184,6 +199,22 @@ class Core:
         if status:
             raise OcfError("Error setting core seq cut off policy promotion count", status)
 
+    def pin_range(self, addr, size):
+        self.cache.write_lock()
+
+        status = self.cache.owner.lib.ocf_mngt_core_pin_range(self.handle, addr, size)
+        self.cache.write_unlock()
+        if status:
+            raise OcfError("Error pinning core range", status)
+
+    def unpin_range(self, addr, size):
+        self.cache.write_lock()
+
+        status = self.cache.owner.lib.ocf_mngt_core_unpin_range(self.handle, addr, size)
+        self.cache.write_unlock()
+        if status:
+            raise OcfError("Error unpinning core range", status)
+
     def reset_stats(self):
         self.cache.owner.lib.ocf_core_stats_initialize(self.handle)
 
@@ -237,8 +268,14 @@ lib.ocf_mngt_core_set_seq_cutoff_threshold.argtypes = [c_void_p, c_uint32]
 lib.ocf_mngt_core_set_seq_cutoff_threshold.restype = c_int
 lib.ocf_mngt_core_set_seq_cutoff_promotion_count.argtypes = [c_void_p, c_uint32]
 lib.ocf_mngt_core_set_seq_cutoff_promotion_count.restype = c_int
+lib.ocf_mngt_core_pin_range.argtypes = [c_void_p, c_uint64, c_uint64]
+lib.ocf_mngt_core_pin_range.restype = c_int
+lib.ocf_mngt_core_unpin_range.argtypes = [c_void_p, c_uint64, c_uint64]
+lib.ocf_mngt_core_unpin_range.restype = c_int
 lib.ocf_stats_collect_core.argtypes = [c_void_p, c_void_p, c_void_p, c_void_p, c_void_p]
 lib.ocf_stats_collect_core.restype = c_int
+lib.ocf_stats_collect_core_cleaner.argtypes = [c_void_p, c_void_p]
+lib.ocf_stats_collect_core_cleaner.restype = c_int
 lib.ocf_core_get_info.argtypes = [c_void_p, c_void_p]
 lib.ocf_core_get_info.restype = c_int
 lib.ocf_core_new_io_wrapper.argtypes = [
@@ -8,6 +8,7 @@ from ctypes import (
     c_uint32,
     CFUNCTYPE,
     c_uint64,
+    c_bool,
     create_string_buffer,
     cast,
     memset,
@@ -40,6 +41,7 @@ class DataOps(Structure):
     SEEK = CFUNCTYPE(c_uint32, c_void_p, c_uint32, c_uint32)
     COPY = CFUNCTYPE(c_uint64, c_void_p, c_void_p, c_uint64, c_uint64, c_uint64)
     SECURE_ERASE = CFUNCTYPE(None, c_void_p)
+    IS_ZERO = CFUNCTYPE(c_bool, c_void_p, c_uint64, c_uint64)
 
     _fields_ = [
         ("_alloc", ALLOC),
@@ -52,6 +54,7 @@ class DataOps(Structure):
         ("_seek", SEEK),
         ("_copy", COPY),
         ("_secure_erase", SECURE_ERASE),
+        ("_is_zero", IS_ZERO),
     ]
 
 
@@ -89,6 +92,7 @@ class Data:
             _seek=cls._seek,
             _copy=cls._copy,
             _secure_erase=cls._secure_erase,
+            _is_zero=cls._is_zero,
         )
 
     @classmethod
@@ -170,6 +174,11 @@ class Data:
     def _secure_erase(dst):
         Data.get_instance(dst).secure_erase()
 
+    @staticmethod
+    @DataOps.IS_ZERO
+    def _is_zero(src, offset, size):
+        return Data.get_instance(src).is_zero(offset, size)
+
     def read(self, dst, size):
         to_read = min(self.size - self.position, size)
         memmove(dst, self.handle.value + self.position, to_read)
@@ -216,6 +225,11 @@ class Data:
     def secure_erase(self):
         pass
 
+    def is_zero(self, offset, size):
+        to_check = max(min(self.size - offset, size), 0)
+
+        return not string_at(self.handle.value + offset, to_check).strip(b"\x00")
+
     def dump(self, ignore=DATA_POISON, **kwargs):
         print_buffer(self.buffer, self.size, ignore=ignore, **kwargs)
 
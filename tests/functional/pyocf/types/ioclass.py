@@ -16,6 +16,9 @@ class IoClassInfo(Structure):
         ("_min_size", c_uint32),
         ("_max_size", c_uint32),
         ("_cleaning_policy_type", c_int),
+        ("_slru_protected_size", c_uint8),
+        ("_headroom_size", c_uint8),
+        ("_ttl", c_uint32),
     ]
 
 
@@ -26,6 +29,9 @@ class IoClassConfig(Structure):
         ("_name", c_char_p),
         ("_cache_mode", c_int),
         ("_priority", c_uint16),
+        ("_slru_protected_size", c_uint8),
+        ("_headroom_size", c_uint8),
+        ("_ttl", c_uint32),
     ]
 
 
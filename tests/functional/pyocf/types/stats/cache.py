@@ -30,9 +30,11 @@ class CacheInfo(Structure):
         ("fallback_pt", _FallbackPt),
         ("cleaning_policy", c_uint32),
         ("promotion_policy", c_uint32),
+        ("eviction_policy", c_uint32),
         ("cache_line_size", c_uint64),
         ("flushed", c_uint32),
         ("core_count", c_uint32),
         ("metadata_footprint", c_uint64),
         ("metadata_end_offset", c_uint32),
+        ("metadata_backing", c_uint64 * 4),
     ]
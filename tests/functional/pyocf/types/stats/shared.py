@@ -51,6 +51,8 @@ class RequestsStats(Structure):
         ("rd_partial_misses", _Stat),
         ("rd_full_misses", _Stat),
         ("rd_total", _Stat),
+        ("rd_lockless_hits", _Stat),
+        ("rd_lockless_retries", _Stat),
         ("wr_hits", _Stat),
         ("wr_partial_misses", _Stat),
         ("wr_full_misses", _Stat),
@@ -86,3 +88,48 @@ class ErrorsStats(Structure):
         ("cache_volume_total", _Stat),
         ("total", _Stat),
     ]
+
+
+CLEANER_LATENCY_BUCKETS = 16
+CLEANER_AGE_BUCKETS = 16
+
+
+class CleanerStats(Structure):
+    _fields_ = [
+        ("cleaned", c_uint64),
+        ("rate", c_uint64),
+        ("core_write_bytes", c_uint64),
+        ("core_writes", c_uint64),
+        ("avg_batch", c_uint64),
+        ("getter_skips", c_uint64),
+        ("lock_aborts", c_uint64),
+        ("inflight_skips", c_uint64),
+        ("cache_read_latency", _Stat * CLEANER_LATENCY_BUCKETS),
+        ("core_write_latency", _Stat * CLEANER_LATENCY_BUCKETS),
+        ("dirty_age", _Stat * CLEANER_AGE_BUCKETS),
+    ]
+
+
+class LruStats(Structure):
+    _fields_ = [
+        ("protected", _Stat),
+        ("probation", _Stat),
+    ]
+
+
+EVICTION_AGE_BUCKETS = 16
+EVICTION_HITS_BUCKETS = 9
+
+
+class EvictionStats(Structure):
+    _fields_ = [
+        ("victims", c_uint64),
+        ("iterations", c_uint64),
+        ("hash_lock_fails", c_uint64),
+        ("line_lock_fails", c_uint64),
+        ("dirty_skipped", c_uint64),
+        ("lock_contended", c_uint64),
+        ("lock_wait_us", c_uint64),
+        ("age", _Stat * EVICTION_AGE_BUCKETS),
+        ("hits", _Stat * EVICTION_HITS_BUCKETS),
+    ]
@@ -186,7 +186,12 @@ class Volume(Structure):
     @staticmethod
     @VolumeOps.SUBMIT_WRITE_ZEROES
     def _submit_write_zeroes(write_zeroes):
-        pass
+        io_structure = cast(write_zeroes, POINTER(Io))
+        volume = Volume.get_instance(
+            OcfLib.getInstance().ocf_io_get_volume(io_structure)
+        )
+
+        volume.submit_write_zeroes(io_structure)
 
     @staticmethod
     @CFUNCTYPE(c_int, c_void_p)
@@ -271,6 +276,17 @@ class Volume(Structure):
         except:  # noqa E722
             discard.contents._end(discard, -OcfErrorCode.OCF_ERR_NOT_SUPP)
 
+    def submit_write_zeroes(self, write_zeroes):
+        try:
+            dst = self._storage + write_zeroes.contents._addr
+            memset(dst, 0, write_zeroes.contents._bytes)
+
+            write_zeroes.contents._end(write_zeroes, 0)
+        except:  # noqa E722
+            write_zeroes.contents._end(
+                write_zeroes, -OcfErrorCode.OCF_ERR_NOT_SUPP
+            )
+
     def get_stats(self):
         return self.stats
 
@@ -3,7 +3,7 @@
 # SPDX-License-Identifier: BSD-3-Clause-Clear
 #
 
-from ctypes import string_at
+from ctypes import string_at, Array
 
 
 def print_buffer(
@@ -227,6 +227,11 @@ def struct_to_dict(struct):
         if hasattr(value, "_fields_"):
             d[field] = struct_to_dict(value)
             continue
+        if isinstance(value, Array):
+            d[field] = [
+                struct_to_dict(v) if hasattr(v, "_fields_") else v for v in value
+            ]
+            continue
         d[field] = value
 
     return d
@@ -0,0 +1,209 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+from threading import Event, Thread
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.utils import Size
+from pyocf.types.shared import OcfCompletion
+
+
+BLOCK = int(Size.from_KiB(4))
+
+
+def _submit(core, addr, data, direction):
+    comp = OcfCompletion([("error", c_int)], context=data)
+
+    io = core.new_io(
+        core.cache.get_default_queue(), addr, data.size, direction, 0, 0
+    )
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+
+    return comp
+
+
+def _write(core, addr, pattern, count):
+    data = Data.from_bytes(bytes([pattern]) * BLOCK * count)
+    comp = _submit(core, addr, data, IoDir.WRITE)
+    comp.wait()
+    assert not comp.results["error"]
+
+
+def _blocks(data):
+    buf = bytes(data.buffer[: data.size])
+    return [buf[i : i + BLOCK] for i in range(0, len(buf), BLOCK)]
+
+
+def _fill(core, addr, count):
+    # Only half of LRU list is kept hot, so lines of a small range can be
+    # all hot only when the list holds enough other lines
+    for i in range(count // 64):
+        _write(core, addr + i * 64 * BLOCK, 0xFF, 64)
+
+
+class HoldReadVolume(Volume):
+    """Volume holding the first read submitted after hold is set"""
+
+    def __init__(self, size):
+        self.hold = False
+        self.held = Event()
+        self.release = Event()
+        super().__init__(size)
+
+    def submit_io(self, io):
+        if self.hold and io.contents._dir == IoDir.READ:
+            self.hold = False
+            self.held.set()
+            self.release.wait()
+        super().submit_io(io)
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_fast_read_hits(pyocf_ctx, cache_mode):
+    """
+    Read the same range repeatedly so that its cache lines become hot and
+    reads are served by lockless fast path. Check that hits are accounted
+    as lockless, with no retry, and data is correct.
+    """
+    count = 8
+    reads = 16
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=cache_mode)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    _write(core, 0, 0x5A, count)
+    _fill(core, BLOCK * count, 256)
+
+    for _ in range(reads):
+        comp = _submit(core, 0, Data(BLOCK * count), IoDir.READ)
+        comp.wait()
+        assert not comp.results["error"]
+        assert all(b == bytes([0x5A]) * BLOCK for b in _blocks(comp.context))
+
+    stats = core.get_stats()
+    assert stats["req"]["rd_hits"]["value"] == reads
+    # First read may take locks to make the lines hot
+    assert stats["req"]["rd_lockless_hits"]["value"] >= reads - 1
+    assert stats["req"]["rd_lockless_retries"]["value"] == 0
+
+
+def test_fast_read_lockless_conflict(pyocf_ctx):
+    """
+    Discard hot cache lines while lockless read of them waits for the cache
+    device. Discard remaps the lines under hash bucket write lock, so once
+    cache read completes the read has to be retried with locks, and it
+    returns either old data or data of discarded range.
+    """
+    count = 8
+    old = bytes([0x5A]) * BLOCK
+    zeroes = bytes(BLOCK)
+
+    cache_device = HoldReadVolume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    _write(core, 0, 0x5A, count)
+    _fill(core, BLOCK * count, 256)
+
+    for _ in range(2):
+        comp = _submit(core, 0, Data(BLOCK * count), IoDir.READ)
+        comp.wait()
+        assert not comp.results["error"]
+
+    assert core.get_stats()["req"]["rd_lockless_hits"]["value"] > 0
+
+    completions = []
+    cache_device.hold = True
+    reader = Thread(
+        target=lambda: completions.append(
+            _submit(core, 0, Data(BLOCK * count), IoDir.READ)
+        )
+    )
+    reader.start()
+    assert cache_device.held.wait(timeout=10)
+
+    discard = OcfCompletion([("error", c_int)])
+    io = core.new_io(
+        cache.get_default_queue(), 0, BLOCK * count, IoDir.WRITE, 0, 0
+    )
+    io.callback = discard.callback
+    io.submit_discard()
+    discard.wait()
+    assert not discard.results["error"]
+
+    cache_device.release.set()
+    reader.join()
+
+    comp = completions[0]
+    comp.wait()
+    assert not comp.results["error"]
+    assert all(b in (old, zeroes) for b in _blocks(comp.context))
+
+    stats = core.get_stats()
+    assert stats["req"]["rd_lockless_retries"]["value"] == 1
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_fast_read_races_write(pyocf_ctx, cache_mode):
+    """
+    Overwrite and flush hot cache lines while reads of them are in flight.
+    A read racing with metadata update has to be retried on the locked path,
+    so each block it returns holds either old or new data, and reads submitted
+    after a write completes always return new data.
+    """
+    count = 8
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=cache_mode)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    _write(core, 0, 0, count)
+
+    for pattern in range(1, 33):
+        old = bytes([pattern - 1]) * BLOCK
+        new = bytes([pattern]) * BLOCK
+
+        reads = [
+            _submit(core, 0, Data(BLOCK * count), IoDir.READ) for _ in range(4)
+        ]
+        write = _submit(core, 0, Data.from_bytes(new * count), IoDir.WRITE)
+        reads += [
+            _submit(core, 0, Data(BLOCK * count), IoDir.READ) for _ in range(4)
+        ]
+
+        write.wait()
+
+        if pattern % 8 == 0:
+            cache.flush()
+
+        assert not write.results["error"]
+
+        for comp in reads:
+            comp.wait()
+            assert not comp.results["error"]
+            assert all(b in (old, new) for b in _blocks(comp.context))
+
+        comp = _submit(core, 0, Data(BLOCK * count), IoDir.READ)
+        comp.wait()
+        assert not comp.results["error"]
+        assert all(b == new for b in _blocks(comp.context))
@@ -0,0 +1,69 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import os
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfCompletion
+from pyocf.utils import Size
+
+
+SPLIT = int(Size.from_KiB(64))
+
+
+def _io(core, addr, data, direction):
+    comp = OcfCompletion([("error", c_int)])
+
+    io = core.new_io(
+        core.cache.get_default_queue(), addr, data.size, direction, 0, 0
+    )
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+    comp.wait()
+
+    assert not comp.results["error"]
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+@pytest.mark.parametrize("addr", [0, int(Size.from_KiB(12)), 512])
+def test_split_io(pyocf_ctx, cache_mode, addr):
+    """
+    Write and read back requests several times larger than split size,
+    starting both at and off split boundary. Every part of split request
+    lands at its own offset of the data buffer, so data read back from
+    cache and from core has to match data written.
+    """
+    size = 9 * SPLIT + int(Size.from_KiB(4))
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(16))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=cache_mode)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache.set_split_io_size(SPLIT)
+
+    content = os.urandom(size)
+    _io(core, addr, Data.from_bytes(content), IoDir.WRITE)
+
+    for _ in range(2):
+        data = Data(size)
+        _io(core, addr, data, IoDir.READ)
+        assert bytes(data.buffer[:size]) == content
+
+    assert cache.get_stats()["usage"]["occupancy"]["value"] > 0
+
+    cache.flush()
+
+    assert core_device.get_bytes()[addr : addr + size] == content
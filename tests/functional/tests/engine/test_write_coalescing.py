@@ -0,0 +1,83 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.utils import Size
+from pyocf.types.shared import OcfCompletion
+
+
+def _submit_write(core, addr, data, io_class):
+    comp = OcfCompletion([("error", c_int)])
+
+    io = core.new_io(
+        core.cache.get_default_queue(), addr, data.size, IoDir.WRITE, io_class, 0
+    )
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+
+    return comp
+
+
+def _read(core, addr, size):
+    comp = OcfCompletion([("error", c_int)])
+    data = Data(size)
+
+    io = core.new_io(core.cache.get_default_queue(), addr, size, IoDir.READ, 0, 0)
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+    comp.wait()
+
+    assert not comp.results["error"]
+
+    return data
+
+
+@pytest.mark.parametrize("io_classes", [1, 2])
+def test_write_coalescing(pyocf_ctx, io_classes):
+    """
+    Submit burst of small adjacent and overlapping writes with write
+    coalescing enabled. Check that data written last wins, and that every
+    write is accounted as separate request regardless of how writes were
+    merged.
+    """
+    write_size = Size.from_KiB(4)
+    count = 64
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache.set_write_coalescing(int(write_size), int(Size.from_KiB(128)))
+
+    completions = []
+    for i in range(count):
+        # Every other write overwrites previous one
+        addr = (i // 2) * int(write_size)
+        data = Data.from_bytes(bytes([i]) * int(write_size))
+        completions.append(_submit_write(core, addr, data, i % io_classes))
+
+    for c in completions:
+        c.wait()
+        assert not c.results["error"]
+
+    for i in range(count // 2):
+        data = _read(core, i * int(write_size), int(write_size))
+        expected = bytes([2 * i + 1]) * int(write_size)
+        assert bytes(data.buffer[: int(write_size)]) == expected
+
+    stats = core.get_stats()
+    assert stats["req"]["wr_total"]["value"] == count
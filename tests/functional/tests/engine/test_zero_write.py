@@ -0,0 +1,95 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfCompletion
+from pyocf.utils import Size
+
+
+BLOCK = int(Size.from_KiB(4))
+COUNT = 16
+
+
+def _io(core, addr, data, direction):
+    comp = OcfCompletion([("error", c_int)])
+
+    io = core.new_io(
+        core.cache.get_default_queue(), addr, data.size, direction, 0, 0
+    )
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+    comp.wait()
+
+    assert not comp.results["error"]
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_zero_write(pyocf_ctx, cache_mode):
+    """
+    With zero detection enabled, write zeroes over a cached range and over
+    a range not cached before. Zero-filled writes must not map nor dirty
+    any cache line, lines already cached must be invalidated, and data must
+    go to the core as write zeroes, so that reads return zeroes.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(16))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=cache_mode)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache.set_zero_detection(True)
+
+    size = BLOCK * COUNT
+    _io(core, 0, Data.from_bytes(b"\xAA" * size), IoDir.WRITE)
+
+    stats = cache.get_stats()
+    assert stats["usage"]["occupancy"]["value"] == COUNT
+    if cache_mode == CacheMode.WB:
+        assert stats["usage"]["dirty"]["value"] == COUNT
+
+    core_writes = core_device.get_stats()[IoDir.WRITE]
+
+    _io(core, 0, Data.from_bytes(bytes(size)), IoDir.WRITE)
+    _io(core, size, Data.from_bytes(bytes(size)), IoDir.WRITE)
+
+    stats = cache.get_stats()
+    assert stats["usage"]["occupancy"]["value"] == 0
+    assert stats["usage"]["dirty"]["value"] == 0
+
+    # Zeroes are not transferred as data
+    assert core_device.get_stats()[IoDir.WRITE] == core_writes
+    assert core_device.get_bytes()[: 2 * size] == bytes(2 * size)
+
+    data = Data(2 * size)
+    _io(core, 0, data, IoDir.READ)
+    assert bytes(data.buffer[: 2 * size]) == bytes(2 * size)
+
+
+def test_zero_write_detection_disabled(pyocf_ctx):
+    """
+    Without zero detection zero-filled write is cached as any other write.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(16))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    _io(core, 0, Data.from_bytes(bytes(BLOCK * COUNT)), IoDir.WRITE)
+
+    stats = cache.get_stats()
+    assert stats["usage"]["occupancy"]["value"] == COUNT
+    assert stats["usage"]["dirty"]["value"] == COUNT
@@ -5,11 +5,12 @@
 
 import logging
 from math import ceil, isclose
+from time import sleep
 from ctypes import c_int
 
 import pytest
 
-from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.cache import Cache, CacheMode, EvictionPolicy
 from pyocf.types.core import Core
 from pyocf.types.data import Data
 from pyocf.types.io import IoDir
@@ -176,6 +177,405 @@ def test_evict_overflown_pinned(pyocf_ctx, cls: CacheLineSize):
     ), "Overflown part has not been evicted"
 
 
+@pytest.mark.parametrize("reclaim", [False, True])
+def test_background_reclaim(pyocf_ctx, reclaim: bool):
+    """
+    Fill cache beyond its size with clean data. With reclaim watermarks set,
+    I/O queue keeps free cache lines in background, so free count ends up
+    between the watermarks. Without them all lines stay occupied.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(100))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+    low_watermark = cache_lines // 8
+    high_watermark = cache_lines // 4
+
+    if reclaim:
+        cache.set_reclaim_watermarks(low_watermark, high_watermark)
+
+    data = Data(Size.from_KiB(64))
+    for i in range(2 * cache_lines * 4096 // data.size):
+        send_io(core, data, i * data.size)
+
+    # Reclaim request is handled behind user I/O, give it time to finish
+    for _ in range(50):
+        free = cache.get_stats()["usage"]["free"]["value"]
+        if not reclaim or free >= low_watermark:
+            break
+        sleep(0.1)
+
+    if reclaim:
+        assert low_watermark <= free <= high_watermark + 128
+    else:
+        assert free == 0
+
+
+@pytest.mark.parametrize("enable", [False, True])
+def test_eviction_stats(pyocf_ctx, enable: bool):
+    """
+    Write twice the cache size of clean data. With eviction statistics
+    enabled, victims and visited LRU nodes are counted for the IO class and
+    no dirty line is reported as passed over. Every victim falls into a single
+    age and hits histogram bucket, and as no line was ever hit, all victims
+    are in the zero hits bucket. With statistics disabled (the default) all
+    counters stay zero.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(100))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    if enable:
+        cache.set_eviction_stats(True)
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+
+    data = Data(Size.from_KiB(64))
+    for i in range(2 * cache_lines * 4096 // data.size):
+        send_io(core, data, i * data.size)
+
+    stats = cache.get_eviction_stats(0)
+
+    if enable:
+        assert stats["victims"] >= cache_lines // 2
+        assert stats["iterations"] >= stats["victims"]
+        assert stats["dirty_skipped"] == 0
+        assert sum(b["value"] for b in stats["age"]) == stats["victims"]
+        assert sum(b["value"] for b in stats["hits"]) == stats["victims"]
+        assert stats["hits"][0]["value"] == stats["victims"]
+    else:
+        assert stats["victims"] == 0
+        assert stats["iterations"] == 0
+        assert stats["dirty_skipped"] == 0
+        assert all(b["value"] == 0 for b in stats["age"] + stats["hits"])
+
+
+class SlowReadVolume(Volume):
+    def __init__(self, size, delay):
+        self.delay = delay
+        super().__init__(size)
+
+    def submit_io(self, io):
+        if io.contents._dir == IoDir.READ:
+            sleep(self.delay)
+        super().submit_io(io)
+
+
+@pytest.mark.parametrize("policy", [EvictionPolicy.LRU, EvictionPolicy.COST])
+def test_eviction_cost_aware(pyocf_ctx, policy: EvictionPolicy):
+    """
+    Fill cache with interleaved read misses of a slow and a fast core, then
+    force eviction of half of the cache with new data of the fast core.
+    Cost-aware eviction should keep lines of the slow core, while plain LRU
+    evicts lines of both cores alike.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    slow_device = SlowReadVolume(Size.from_MiB(50), 0.001)
+    fast_device = Volume(Size.from_MiB(100))
+    cache = Cache.start_on_device(
+        cache_device, cache_mode=CacheMode.WT, eviction_policy=policy
+    )
+    slow_core = Core.using_device(slow_device, name="slow")
+    fast_core = Core.using_device(fast_device, name="fast")
+    cache.add_core(slow_core)
+    cache.add_core(fast_core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+    io_size = Size.from_KiB(16)
+    ios = cache_lines * 4096 // io_size.B // 2
+
+    for i in range(ios):
+        send_read(slow_core, Data(io_size), i * io_size.B)
+        send_read(fast_core, Data(io_size), i * io_size.B)
+
+    slow_occupancy = slow_core.get_stats()["usage"]["occupancy"]["value"]
+
+    for i in range(ios, ios + ios // 2):
+        send_read(fast_core, Data(io_size), i * io_size.B)
+
+    slow_kept = slow_core.get_stats()["usage"]["occupancy"]["value"]
+
+    if policy == EvictionPolicy.COST:
+        assert slow_kept >= slow_occupancy * 0.9
+    else:
+        assert slow_kept <= slow_occupancy * 0.9
+
+
+@pytest.mark.parametrize("policy", [EvictionPolicy.LRU, EvictionPolicy.CLOCK])
+def test_eviction_second_chance(pyocf_ctx, policy: EvictionPolicy):
+    """
+    Fill cache with interleaved writes of two cores, then hit all lines of
+    one of them. Force eviction of a quarter of the cache with new data of
+    the other core. With CLOCK, referenced lines get second chance and the
+    sweep evicts unreferenced lines first, so hit lines are kept, as they
+    are with LRU promoting them at hit time.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    hit_device = Volume(Size.from_MiB(50))
+    cold_device = Volume(Size.from_MiB(100))
+    cache = Cache.start_on_device(
+        cache_device, cache_mode=CacheMode.WT, eviction_policy=policy
+    )
+    hit_core = Core.using_device(hit_device, name="hit")
+    cold_core = Core.using_device(cold_device, name="cold")
+    cache.add_core(hit_core)
+    cache.add_core(cold_core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    assert cache.get_stats()["conf"]["eviction_policy"] == policy
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+    io_size = Size.from_KiB(16)
+    ios = cache_lines * 4096 // io_size.B // 2
+
+    for i in range(ios):
+        send_io(hit_core, Data(io_size), i * io_size.B)
+        send_io(cold_core, Data(io_size), i * io_size.B)
+
+    for i in range(ios):
+        send_read(hit_core, Data(io_size), i * io_size.B)
+
+    hit_occupancy = hit_core.get_stats()["usage"]["occupancy"]["value"]
+
+    for i in range(ios, ios + ios // 2):
+        send_io(cold_core, Data(io_size), i * io_size.B)
+
+    hit_kept = hit_core.get_stats()["usage"]["occupancy"]["value"]
+
+    assert hit_kept >= hit_occupancy * 0.95
+
+
+@pytest.mark.parametrize("protected_pct", [25, 50])
+def test_slru_scan(pyocf_ctx, protected_pct: int):
+    """
+    Hit a small working set of IO class with segmented LRU, so that it gets
+    promoted to the protected segment, then scan twice the cache size with
+    new data. Scan lines enter and leave through probation segment, so
+    the working set stays in cache. Then hit every cached line - protected
+    segment must not grow over its configured share of the class.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(200))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    ioclass_id = 1
+    cache.configure_partition(
+        part_id=ioclass_id,
+        name="slru_ioclass",
+        max_size=100,
+        priority=1,
+        slru_protected_size=protected_pct,
+    )
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+    working_set = cache_lines * protected_pct // 100 // 4
+    data = Data(4096)
+
+    for i in range(cache_lines):
+        send_io(core, data, i * 4096, ioclass_id)
+
+    # Hits on lines of foreign LRU lists are applied by eviction, so hit
+    # the working set a few times before the scan reaches it
+    for _ in range(2):
+        for i in range(working_set):
+            send_read(core, Data(4096), i * 4096, ioclass_id)
+
+    for i in range(cache_lines, 3 * cache_lines):
+        send_io(core, data, i * 4096, ioclass_id)
+
+    lru = cache.get_lru_stats(ioclass_id)
+    assert lru["protected"]["value"] >= working_set * 0.95
+
+    core_device.reset_stats()
+    for i in range(working_set):
+        send_read(core, Data(4096), i * 4096, ioclass_id)
+    assert core_device.get_stats()[IoDir.READ] <= working_set * 0.05
+
+    for i in range(cache_lines, 3 * cache_lines):
+        send_read(core, Data(4096), i * 4096, ioclass_id)
+
+    # One more pass applies hits deferred on foreign lists
+    for i in range(3 * cache_lines, 4 * cache_lines):
+        send_io(core, data, i * 4096, ioclass_id)
+
+    lru = cache.get_lru_stats(ioclass_id)
+    total = lru["protected"]["value"] + lru["probation"]["value"]
+    assert lru["protected"]["value"] > 0
+    assert lru["protected"]["value"] <= total * protected_pct // 100
+
+
+def test_lru_deferred_balance(pyocf_ctx):
+    """
+    Run the same I/O on two caches, one of them with deferred LRU balancing.
+    I/O path of the deferred one must leave hot elements unbalanced, and
+    the cleaner run must balance them to exactly the state kept by the
+    other cache on I/O path, and ask to be run again soon.
+    """
+    caches = []
+    for deferred in [False, True]:
+        cache_device = Volume(Size.from_MiB(50))
+        core_device = Volume(Size.from_MiB(100))
+        cache = Cache.start_on_device(
+            cache_device, cache_mode=CacheMode.WT, name=f"cache{int(deferred)}"
+        )
+        core = Core.using_device(core_device)
+        cache.add_core(core)
+        cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+        cache.set_lru_deferred_balance(deferred)
+        caches.append((cache, core))
+
+    cache_lines = int(caches[0][0].get_stats()["conf"]["size"])
+    data = Data(Size.from_KiB(64))
+    for cache, core in caches:
+        for i in range(cache_lines * 4096 // data.size // 2):
+            send_io(core, data, i * data.size)
+
+    immediate = caches[0][0].get_lru_stats()
+    deferred = caches[1][0].get_lru_stats()
+    assert immediate["protected"]["value"] > 0
+    assert deferred["protected"]["value"] == 0
+    assert deferred["probation"]["value"] == (
+        immediate["protected"]["value"] + immediate["probation"]["value"]
+    )
+
+    interval = caches[1][0].run_cleaner()
+    assert interval <= 100
+
+    assert caches[1][0].get_lru_stats() == immediate
+
+
+def test_eviction_pinned_range(pyocf_ctx):
+    """
+    Pin a core range and write it, then write twice the cache size of other
+    data. Lines of the pinned range are never chosen as eviction victims, so
+    all of them stay in cache. Once unpinned, they get evicted as any other.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    pinned_device = Volume(Size.from_MiB(50))
+    cold_device = Volume(Size.from_MiB(250))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT)
+    pinned_core = Core.using_device(pinned_device, name="pinned")
+    cold_core = Core.using_device(cold_device, name="cold")
+    cache.add_core(pinned_core)
+    cache.add_core(cold_core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+    data = Data(Size.from_KiB(64))
+    pinned_size = int(Size.from_MiB(4))
+
+    pinned_core.pin_range(0, pinned_size)
+
+    for i in range(pinned_size // data.size):
+        send_io(pinned_core, data, i * data.size)
+
+    pinned_occupancy = pinned_core.get_stats()["usage"]["occupancy"]["value"]
+    assert pinned_occupancy == pinned_size // 4096
+
+    for i in range(2 * cache_lines * 4096 // data.size):
+        send_io(cold_core, data, i * data.size)
+
+    assert pinned_core.get_stats()["usage"]["occupancy"]["value"] == pinned_occupancy
+
+    pinned_core.unpin_range(0, pinned_size)
+
+    for i in range(2 * cache_lines * 4096 // data.size):
+        send_io(cold_core, data, 2 * cache_lines * 4096 + i * data.size)
+
+    assert pinned_core.get_stats()["usage"]["occupancy"]["value"] == 0
+
+
+@pytest.mark.parametrize("ttl", [0, 5])
+def test_eviction_ttl(pyocf_ctx, ttl: int):
+    """
+    Write data of one core, wait until it is older than IO class TTL, then
+    write data of the other core and hit all lines of both. Force eviction of
+    about as many lines as the old core has. Expired lines are neither
+    promoted on hit nor given second chance, so they are evicted first, while
+    the fresh ones are kept. Without TTL hit lines of both cores are kept and
+    lines never hit are evicted instead.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    old_device = Volume(Size.from_MiB(50))
+    fresh_device = Volume(Size.from_MiB(50))
+    cold_device = Volume(Size.from_MiB(100))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT)
+    old_core = Core.using_device(old_device, name="old")
+    fresh_core = Core.using_device(fresh_device, name="fresh")
+    cold_core = Core.using_device(cold_device, name="cold")
+    cache.add_core(old_core)
+    cache.add_core(fresh_core)
+    cache.add_core(cold_core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    ioclass = 1
+    cache.configure_partition(
+        part_id=ioclass, name="ttl_ioclass", max_size=100, priority=1, ttl=ttl
+    )
+
+    cache_lines = int(cache.get_stats()["conf"]["size"])
+    io_size = Size.from_KiB(16)
+    ios = cache_lines * 4096 // io_size.B // 4
+
+    for i in range(ios):
+        send_io(old_core, Data(io_size), i * io_size.B, ioclass)
+
+    sleep(ttl + 1)
+
+    for i in range(ios):
+        send_io(fresh_core, Data(io_size), i * io_size.B, ioclass)
+
+    for i in range(ios):
+        send_read(old_core, Data(io_size), i * io_size.B, ioclass)
+        send_read(fresh_core, Data(io_size), i * io_size.B, ioclass)
+
+    old_occupancy = old_core.get_stats()["usage"]["occupancy"]["value"]
+    fresh_occupancy = fresh_core.get_stats()["usage"]["occupancy"]["value"]
+
+    # Free lines are used first, then about old core occupancy is evicted
+    for i in range(3 * ios):
+        send_io(cold_core, Data(io_size), i * io_size.B, ioclass)
+
+    old_kept = old_core.get_stats()["usage"]["occupancy"]["value"]
+    fresh_kept = fresh_core.get_stats()["usage"]["occupancy"]["value"]
+
+    assert fresh_kept >= fresh_occupancy * 0.9
+    if ttl:
+        assert old_kept <= old_occupancy * 0.1
+    else:
+        assert old_kept >= old_occupancy * 0.9
+
+
+def send_read(exported_obj: Core, data: Data, addr: int = 0, target_ioclass: int = 0):
+    io = exported_obj.new_io(
+        exported_obj.cache.get_default_queue(),
+        addr,
+        data.size,
+        IoDir.READ,
+        target_ioclass,
+        0,
+    )
+    io.set_data(data)
+
+    completion = OcfCompletion([("err", c_int)])
+    io.callback = completion.callback
+    io.submit()
+    completion.wait()
+
+    assert completion.results["err"] == 0, "IO to exported object completion"
+
+
 def send_io(exported_obj: Core, data: Data, addr: int = 0, target_ioclass: int = 0):
     io = exported_obj.new_io(
         exported_obj.cache.get_default_queue(),
@@ -0,0 +1,77 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import random
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfCompletion
+from pyocf.utils import Size
+
+
+BLOCK = int(Size.from_KiB(4))
+
+
+def _write(core, addr, pattern):
+    data = Data.from_bytes(bytes([pattern]) * BLOCK)
+    comp = OcfCompletion([("error", c_int)])
+
+    io = core.new_io(core.cache.get_default_queue(), addr, BLOCK, IoDir.WRITE, 0, 0)
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+    comp.wait()
+
+    assert not comp.results["error"]
+
+
+@pytest.mark.parametrize("dirty_shutdown", [False, True])
+def test_flush_after_load(pyocf_ctx, dirty_shutdown):
+    """
+    Leave scattered dirty cache lines in the cache and load it after clean
+    or dirty shutdown. Dirty index is rebuilt from loaded metadata, so that
+    flush finds every dirty cache line and writes it back to core.
+    """
+    blocks = int(Size.from_MiB(8)) // BLOCK
+    seed = random.randrange(2 ** 32)
+    print(f"seed: {seed}")
+    rng = random.Random(seed)
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(16))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    expected = {}
+    for block in rng.sample(range(blocks), blocks // 4):
+        expected[block] = rng.randrange(1, 256)
+        _write(core, block * BLOCK, expected[block])
+
+    if dirty_shutdown:
+        # Image of cache device taken while cache is running
+        cache_device = cache_device.get_copy()
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device)
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == len(expected)
+
+    cache.flush()
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == 0
+
+    content = core_device.get_bytes()
+    for block, pattern in expected.items():
+        offset = block * BLOCK
+        assert content[offset : offset + BLOCK] == bytes([pattern]) * BLOCK
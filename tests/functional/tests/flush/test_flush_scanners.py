@@ -0,0 +1,99 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import random
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.queue import Queue
+from pyocf.types.shared import OcfCompletion, OcfError
+from pyocf.utils import Size
+
+
+BLOCK = int(Size.from_KiB(4))
+
+
+def _write(core, addr, pattern):
+    data = Data.from_bytes(bytes([pattern]) * BLOCK)
+    comp = OcfCompletion([("error", c_int)])
+
+    io = core.new_io(core.cache.get_default_queue(), addr, BLOCK, IoDir.WRITE, 0, 0)
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+    comp.wait()
+
+    assert not comp.results["error"]
+
+
+@pytest.mark.parametrize("queues", [1, 4])
+@pytest.mark.parametrize("depth", [1, 4])
+def test_flush_scanners(pyocf_ctx, queues, depth):
+    """
+    Dirty scattered cache lines of two cores and flush the cache with
+    metadata scanned by one scanner per I/O queue. Check that nothing is
+    left dirty and that every core got data written last to each block.
+    """
+    blocks = int(Size.from_MiB(8)) // BLOCK
+    seed = random.randrange(2 ** 32)
+    print(f"seed: {seed}")
+    rng = random.Random(seed)
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_devices = [Volume(Size.from_MiB(16)) for _ in range(2)]
+
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+    for i in range(1, queues):
+        cache.io_queues += [Queue(cache, f"io-{i}-{cache.get_name()}")]
+
+    cores = [Core.using_device(device) for device in core_devices]
+    for core in cores:
+        cache.add_core(core)
+
+    cache.set_flush_queue_depth(depth)
+    assert cache.get_flush_queue_depth() == depth
+
+    expected = [{}, {}]
+    for i in range(blocks):
+        core_idx = rng.randrange(len(cores))
+        block = rng.randrange(blocks)
+        pattern = rng.randrange(1, 256)
+        _write(cores[core_idx], block * BLOCK, pattern)
+        expected[core_idx][block] = pattern
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] > 0
+
+    cache.flush()
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == 0
+
+    for device, written in zip(core_devices, expected):
+        content = device.get_bytes()
+        for block, pattern in written.items():
+            offset = block * BLOCK
+            assert content[offset : offset + BLOCK] == bytes([pattern]) * BLOCK
+
+
+def test_flush_queue_depth_range(pyocf_ctx):
+    """
+    Check that flush queue depth out of allowed range is rejected and
+    previously set depth is kept.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+
+    cache.set_flush_queue_depth(8)
+
+    for depth in [0, 65]:
+        with pytest.raises(OcfError):
+            cache.set_flush_queue_depth(depth)
+
+    assert cache.get_flush_queue_depth() == 8
@@ -11,7 +11,17 @@ from itertools import count
 import pytest
 
 from pyocf.ocf import OcfLib
-from pyocf.types.cache import Cache, CacheMode, MetadataLayout,  CleaningPolicy
+from pyocf.types.cache import (
+    Cache,
+    CacheMode,
+    MetadataLayout,
+    CleaningPolicy,
+    EvictionPolicy,
+    MetadataPage,
+    NUMA_NODE_ANY,
+    NUMA_INTERLEAVE,
+    NUMA_NODE_MAX,
+)
 from pyocf.types.core import Core
 from pyocf.types.data import Data
 from pyocf.types.io import IoDir
@@ -405,6 +415,64 @@ def test_start_stop_noqueue(pyocf_ctx):
     assert not c.results["error"], "Failed to stop cache: {}".format(c.results["error"])
 
 
+@pytest.mark.parametrize("page", [MetadataPage.DEFAULT, MetadataPage.THP, MetadataPage.HUGE_2M])
+@pytest.mark.parametrize("numa_node", [NUMA_NODE_ANY, NUMA_INTERLEAVE, 0])
+def test_start_metadata_backing(pyocf_ctx, page: MetadataPage, numa_node: int):
+    """Start cache with metadata arrays placed on given page backing and NUMA
+    node. Huge pages are only a hint, so cache has to start and serve I/O
+    whether they are available or not, and metadata memory has to be
+    reported under some backing.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(10))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT,
+                                  metadata_page=page, metadata_numa_node=numa_node)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    test_data = Data.from_string("This is test data")
+    io_to_core(core, test_data, 0)
+    read_buffer = io_from_exported_object(core, test_data.size, 0)
+    assert bytes(read_buffer.buffer[: test_data.size]) == \
+        bytes(test_data.buffer[: test_data.size]), "Data read back from cache"
+
+    backing = cache.get_stats()["conf"]["metadata_backing"]
+    assert sum(backing.values()) > 0, "Metadata backing reported"
+
+
+@pytest.mark.parametrize("numa_node", [NUMA_INTERLEAVE - 1, NUMA_NODE_MAX])
+def test_start_invalid_numa_node(pyocf_ctx, numa_node: int):
+    """Starting cache with metadata bound to NUMA node out of range
+    has to fail instead of silently ignoring the placement.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+
+    with pytest.raises(OcfError, match="OCF_ERR_INVAL"):
+        Cache.start_on_device(cache_device, cache_mode=CacheMode.WT,
+                              metadata_numa_node=numa_node)
+
+
+@pytest.mark.parametrize("policy", EvictionPolicy)
+def test_load_eviction_policy(pyocf_ctx, policy: EvictionPolicy):
+    """Eviction policy is persisted in the superblock. Cache loaded with
+    default configuration has to run with the policy it was started with.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(10))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WT,
+                                  eviction_policy=policy)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    test_data = Data.from_string("This is test data")
+    io_to_core(core, test_data, 0)
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device)
+    assert cache.get_stats()["conf"]["eviction_policy"] == policy
+
+
 def run_io_and_cache_data_if_possible(exported_obj, mode, cls, cls_no):
     test_data = Data(cls_no * cls)
 
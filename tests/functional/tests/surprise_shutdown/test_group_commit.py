@@ -0,0 +1,81 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import random
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfCompletion
+from pyocf.utils import Size
+
+
+BLOCK = int(Size.from_KiB(4))
+
+
+def _submit_write(core, addr, pattern):
+    data = Data.from_bytes(bytes([pattern]) * BLOCK)
+    comp = OcfCompletion([("error", c_int)], context=data)
+
+    io = core.new_io(core.cache.get_default_queue(), addr, BLOCK, IoDir.WRITE, 0, 0)
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+
+    return comp
+
+
+@pytest.mark.parametrize("max_pages", [1, 16, 1024])
+def test_group_commit_dirty_shutdown(pyocf_ctx, max_pages):
+    """
+    Submit burst of WB writes with metadata group commit enabled, so that
+    requests join batches while other commits are in flight. Every write
+    completes only once its metadata is persistent, so after dirty shutdown
+    the loaded cache holds all written data as dirty.
+    """
+    blocks = int(Size.from_MiB(8)) // BLOCK
+    seed = random.randrange(2 ** 32)
+    print(f"seed: {seed}")
+    rng = random.Random(seed)
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(16))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache.set_metadata_group_commit(max_pages, 1000)
+
+    expected = {}
+    completions = []
+    for block in rng.sample(range(blocks), blocks // 4):
+        expected[block] = rng.randrange(1, 256)
+        completions.append(_submit_write(core, block * BLOCK, expected[block]))
+
+    for comp in completions:
+        comp.wait()
+        assert not comp.results["error"]
+
+    # Image of cache device taken while cache is running
+    cache_device = cache_device.get_copy()
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device)
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == len(expected)
+
+    cache.flush()
+
+    content = core_device.get_bytes()
+    for block, pattern in expected.items():
+        offset = block * BLOCK
+        assert content[offset : offset + BLOCK] == bytes([pattern]) * BLOCK
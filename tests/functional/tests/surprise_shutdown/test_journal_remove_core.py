@@ -0,0 +1,87 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import random
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfCompletion
+from pyocf.utils import Size
+
+
+BLOCK = int(Size.from_KiB(4))
+
+
+def _write(core, addr, pattern):
+    data = Data.from_bytes(bytes([pattern]) * BLOCK)
+    comp = OcfCompletion([("error", c_int)])
+
+    io = core.new_io(core.cache.get_default_queue(), addr, BLOCK, IoDir.WRITE, 0, 0)
+    io.set_data(data)
+    io.callback = comp.callback
+    io.submit()
+    comp.wait()
+
+    assert not comp.results["error"]
+
+
+def test_journal_remove_core_replay(pyocf_ctx):
+    """
+    Leave dirty cache lines of a core in the journal, remove the core and add
+    it back, then write some new dirty data. After dirty shutdown, replay of
+    the journal must not bring back cache lines invalidated by core removal,
+    so only data written after the core was added back is dirty and flushed.
+    """
+    blocks = int(Size.from_MiB(8)) // BLOCK
+    seed = random.randrange(2 ** 32)
+    print(f"seed: {seed}")
+    rng = random.Random(seed)
+
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(16))
+
+    cache = Cache.start_on_device(
+        cache_device, cache_mode=CacheMode.WB, metadata_journal=True
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    for block in rng.sample(range(blocks), blocks // 4):
+        _write(core, block * BLOCK, 0xAA)
+
+    cache.remove_core(core)
+
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    # New data may land on core lines which were dirty before removal
+    expected = {}
+    for block in rng.sample(range(blocks), blocks // 8):
+        expected[block] = rng.randrange(1, 0xAA)
+        _write(core, block * BLOCK, expected[block])
+
+    # Image of cache device taken while cache is running
+    cache_device = cache_device.get_copy()
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device)
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == len(expected)
+
+    cache.flush()
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == 0
+
+    # Data discarded by core removal may have been cleaned before, but it
+    # must never overwrite data written after the core was added back
+    content = core_device.get_bytes()
+    for block, pattern in expected.items():
+        offset = block * BLOCK
+        assert content[offset : offset + BLOCK] == bytes([pattern]) * BLOCK
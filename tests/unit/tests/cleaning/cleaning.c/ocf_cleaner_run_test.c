@@ -74,6 +74,18 @@ void __wrap_ocf_cleaner_run_complete(ocf_cleaner_t cleaner, uint32_t interval)
 	function_called();
 }
 
+void __wrap_ocf_cleaning_governor_update(ocf_cache_t cache)
+{
+}
+
+void __wrap_ocf_cleaning_absorb_update(ocf_cache_t cache)
+{
+}
+
+void __wrap_ocf_cleaning_streams_update(ocf_cache_t cache)
+{
+}
+
 int __wrap_env_bit_test(int nr, const void *addr)
 {
 	function_called();
@@ -0,0 +1,169 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/cleaning/cleaning_discard.c</tested_file_path>
+<tested_function>ocf_cleaning_discarded</tested_function>
+<functions_to_leave>
+ocf_cleaning_discards_init
+ocf_cleaning_discard_register
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../utils/utils_cache_line.h"
+#include "cleaning.h"
+#include "cleaning_discard.h"
+
+#include "cleaning/cleaning_discard.c/ocf_cleaning_discarded_test_generated_wraps.c"
+
+#define LINE ocf_cache_line_size_4
+
+static struct ocf_cache *discard_test_cache(void)
+{
+	struct ocf_cache *cache = test_malloc(sizeof(*cache));
+
+	*(ocf_cache_line_size_t *)&cache->metadata.settings.size = LINE;
+	ocf_cleaning_discards_init(cache);
+
+	return cache;
+}
+
+static void ocf_cleaning_discarded_test01(void **state)
+{
+	struct ocf_cache *cache = discard_test_cache();
+	uint64_t epoch = ocf_cleaning_discard_epoch(cache);
+
+	print_test_description("Only cache lines fully covered by discard "
+			"registered since epoch are reported");
+
+	/* Covers lines 11-19 fully, lines 10 and 20 partially */
+	ocf_cleaning_discard_register(cache, 1, 10 * LINE + 512,
+			10 * LINE);
+
+	assert_false(ocf_cleaning_discarded(cache, epoch, 1, 10));
+	assert_true(ocf_cleaning_discarded(cache, epoch, 1, 11));
+	assert_true(ocf_cleaning_discarded(cache, epoch, 1, 19));
+	assert_false(ocf_cleaning_discarded(cache, epoch, 1, 20));
+
+	/* Other core */
+	assert_false(ocf_cleaning_discarded(cache, epoch, 2, 15));
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_discarded_test02(void **state)
+{
+	struct ocf_cache *cache = discard_test_cache();
+	uint64_t epoch;
+
+	print_test_description("Discard registered before epoch was observed "
+			"is not reported");
+
+	ocf_cleaning_discard_register(cache, 0, 0, 4 * LINE);
+	epoch = ocf_cleaning_discard_epoch(cache);
+
+	assert_false(ocf_cleaning_discarded(cache, epoch, 0, 0));
+
+	ocf_cleaning_discard_register(cache, 0, 8 * LINE, LINE);
+
+	assert_false(ocf_cleaning_discarded(cache, epoch, 0, 0));
+	assert_true(ocf_cleaning_discarded(cache, epoch, 0, 8));
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_discarded_test03(void **state)
+{
+	struct ocf_cache *cache = discard_test_cache();
+	uint64_t epoch = ocf_cleaning_discard_epoch(cache);
+
+	print_test_description("Discard not covering any cache line fully is "
+			"not registered");
+
+	ocf_cleaning_discard_register(cache, 0, 512, LINE);
+	ocf_cleaning_discard_register(cache, 0, 2 * LINE, LINE - 512);
+
+	assert_int_equal(ocf_cleaning_discard_epoch(cache), epoch);
+	assert_false(ocf_cleaning_discarded(cache, epoch, 0, 0));
+	assert_false(ocf_cleaning_discarded(cache, epoch, 0, 1));
+	assert_false(ocf_cleaning_discarded(cache, epoch, 0, 2));
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_discarded_test04(void **state)
+{
+	struct ocf_cache *cache = discard_test_cache();
+	uint64_t epoch = ocf_cleaning_discard_epoch(cache);
+	uint64_t i;
+
+	print_test_description("Ring wraps around - discards pushed out of "
+			"history are forgotten, recent ones are still reported");
+
+	for (i = 0; i < 2 * CLEANING_DISCARD_HISTORY; i++)
+		ocf_cleaning_discard_register(cache, 0, i * LINE, LINE);
+
+	for (i = 0; i < CLEANING_DISCARD_HISTORY; i++)
+		assert_false(ocf_cleaning_discarded(cache, epoch, 0, i));
+
+	for (; i < 2 * CLEANING_DISCARD_HISTORY; i++)
+		assert_true(ocf_cleaning_discarded(cache, epoch, 0, i));
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_discarded_test05(void **state)
+{
+	struct ocf_cache *cache = discard_test_cache();
+	uint64_t epoch = ocf_cleaning_discard_epoch(cache);
+	struct ocf_cleaning_discard *slot;
+
+	print_test_description("Slot being overwritten is skipped");
+
+	ocf_cleaning_discard_register(cache, 0, 0, LINE);
+
+	/* Writer clears slot epoch before it updates the range */
+	slot = &cache->cleaner.discards.history[(epoch + 1) %
+			CLEANING_DISCARD_HISTORY];
+	env_atomic64_set(&slot->epoch, 0);
+
+	assert_false(ocf_cleaning_discarded(cache, epoch, 0, 0));
+
+	test_free(cache);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_cleaning_discarded_test01),
+		cmocka_unit_test(ocf_cleaning_discarded_test02),
+		cmocka_unit_test(ocf_cleaning_discarded_test03),
+		cmocka_unit_test(ocf_cleaning_discarded_test04),
+		cmocka_unit_test(ocf_cleaning_discarded_test05)
+	};
+
+	print_message("Unit test of cleaning_discard.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
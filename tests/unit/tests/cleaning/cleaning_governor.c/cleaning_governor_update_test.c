@@ -0,0 +1,196 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/cleaning/cleaning_governor.c</tested_file_path>
+<tested_function>ocf_cleaning_governor_update</tested_function>
+<functions_to_leave>
+ocf_cleaning_governor_init
+ocf_cleaning_governor_budget
+ocf_cleaning_governor_charge
+_ocf_cleaning_governor_refill
+_ocf_cleaning_governor_burst
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_core_priv.h"
+#include "../utils/utils_user_part.h"
+#include "cleaning.h"
+#include "cleaning_governor.h"
+
+#include "cleaning/cleaning_governor.c/cleaning_governor_update_test_generated_wraps.c"
+
+#define MAX_RATE 1600
+
+uint32_t __wrap_ocf_cleaning_dirty_ratio(ocf_cache_t cache)
+{
+	return mock();
+}
+
+bool __wrap__ocf_cleaning_governor_congested(ocf_cache_t cache,
+		uint32_t inflight)
+{
+	return mock();
+}
+
+static struct ocf_cache *governor_test_cache(uint32_t rate, uint32_t inflight)
+{
+	struct ocf_cache *cache = test_malloc(sizeof(*cache));
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+
+	ocf_cleaning_governor_init(cache);
+
+	gov->config.min_rate = 100;
+	gov->config.max_rate = MAX_RATE;
+	gov->rate = rate;
+
+	env_atomic_set(&cache->refcnt.metadata.counter, inflight);
+	env_atomic_set(&cache->cleaner.streams.refcnt.counter, 0);
+
+	return cache;
+}
+
+static void cleaning_governor_update_test01(void **state)
+{
+	struct ocf_cache *cache = governor_test_cache(0, 0);
+
+	print_test_description("Governor is inactive by default - rate is not "
+			"updated and budget is not limited");
+
+	cache->cleaner.governor.config.max_rate =
+			OCF_CLEANING_GOVERNOR_INACTIVE;
+
+	ocf_cleaning_governor_update(cache);
+
+	assert_int_equal(cache->cleaner.governor.rate, 0);
+	assert_int_equal(ocf_cleaning_governor_budget(cache, 32), 32);
+
+	test_free(cache);
+}
+
+static void cleaning_governor_update_test02(void **state)
+{
+	struct ocf_cache *cache = governor_test_cache(200, 64);
+
+	print_test_description("Dirty ratio above high threshold - rate jumps "
+			"to max rate despite congestion");
+
+	will_return(__wrap_ocf_cleaning_dirty_ratio,
+			OCF_CLEANING_GOVERNOR_DEFAULT_DIRTY_HIGH);
+
+	ocf_cleaning_governor_update(cache);
+
+	assert_int_equal(cache->cleaner.governor.rate, MAX_RATE);
+
+	test_free(cache);
+}
+
+static void cleaning_governor_update_test03(void **state)
+{
+	struct ocf_cache *cache = governor_test_cache(800, 64);
+
+	print_test_description("Core is congested - rate is cut by a quarter");
+
+	will_return(__wrap_ocf_cleaning_dirty_ratio,
+			OCF_CLEANING_GOVERNOR_DEFAULT_DIRTY_LOW);
+	will_return(__wrap__ocf_cleaning_governor_congested, true);
+
+	ocf_cleaning_governor_update(cache);
+
+	assert_int_equal(cache->cleaner.governor.rate, 600);
+
+	test_free(cache);
+}
+
+static void cleaning_governor_update_test04(void **state)
+{
+	struct ocf_cache *cache = governor_test_cache(MAX_RATE - 50, 0);
+
+	print_test_description("Cache is idle - rate grows by 1/16 of max rate "
+			"up to max rate");
+
+	will_return(__wrap_ocf_cleaning_dirty_ratio, 0);
+	will_return(__wrap__ocf_cleaning_governor_congested, false);
+
+	ocf_cleaning_governor_update(cache);
+
+	assert_int_equal(cache->cleaner.governor.rate, MAX_RATE);
+
+	test_free(cache);
+}
+
+static void cleaning_governor_update_test05(void **state)
+{
+	struct ocf_cache *cache = governor_test_cache(104, 4);
+
+	print_test_description("Dirty ratio below low threshold with user I/O "
+			"in flight - rate decays, but not below min rate");
+
+	will_return(__wrap_ocf_cleaning_dirty_ratio, 0);
+	will_return(__wrap__ocf_cleaning_governor_congested, false);
+
+	ocf_cleaning_governor_update(cache);
+
+	assert_int_equal(cache->cleaner.governor.rate, 100);
+
+	test_free(cache);
+}
+
+static void cleaning_governor_update_test06(void **state)
+{
+	struct ocf_cache *cache = governor_test_cache(MAX_RATE, 0);
+	struct ocf_cleaning_governor *gov = &cache->cleaner.governor;
+
+	print_test_description("Budget is limited by accumulated tokens and by "
+			"policy limit, and is consumed by charged lines");
+
+	gov->tokens = 5 * 1000;
+
+	assert_int_equal(ocf_cleaning_governor_budget(cache, 32), 5);
+	assert_int_equal(ocf_cleaning_governor_budget(cache, 2), 2);
+
+	ocf_cleaning_governor_charge(cache, 3);
+	assert_int_equal(ocf_cleaning_governor_budget(cache, 32), 2);
+
+	ocf_cleaning_governor_charge(cache, 8);
+	assert_int_equal(ocf_cleaning_governor_budget(cache, 32), 0);
+
+	test_free(cache);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(cleaning_governor_update_test01),
+		cmocka_unit_test(cleaning_governor_update_test02),
+		cmocka_unit_test(cleaning_governor_update_test03),
+		cmocka_unit_test(cleaning_governor_update_test04),
+		cmocka_unit_test(cleaning_governor_update_test05),
+		cmocka_unit_test(cleaning_governor_update_test06)
+	};
+
+	print_message("Unit test of cleaning_governor.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/cleaning/cleaning_governor.c</tested_file_path>
+<tested_function>ocf_cleaning_absorb_defer</tested_function>
+<functions_to_leave>
+ocf_cleaning_governor_init
+ocf_cleaning_absorb_update
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_core_priv.h"
+#include "../utils/utils_user_part.h"
+#include "cleaning.h"
+#include "cleaning_governor.h"
+
+#include "cleaning/cleaning_governor.c/ocf_cleaning_absorb_defer_test_generated_wraps.c"
+
+#define THRESHOLD 4
+
+uint32_t __wrap_ocf_cleaning_dirty_ratio(ocf_cache_t cache)
+{
+	return mock();
+}
+
+static struct ocf_cache *absorb_test_cache(uint8_t threshold,
+		uint32_t dirty_ratio)
+{
+	struct ocf_cache *cache = test_malloc(sizeof(*cache));
+
+	ocf_cleaning_governor_init(cache);
+
+	if (threshold)
+		cache->cleaner.absorb.config.rewrite_threshold = threshold;
+
+	/* Dirty ratio is not checked while absorption is disabled */
+	if (cache->cleaner.absorb.config.rewrite_threshold)
+		will_return(__wrap_ocf_cleaning_dirty_ratio, dirty_ratio);
+	ocf_cleaning_absorb_update(cache);
+
+	return cache;
+}
+
+static void ocf_cleaning_absorb_defer_test01(void **state)
+{
+	struct ocf_cache *cache = absorb_test_cache(0, 0);
+	uint8_t rewrites = OCF_CLEANING_ABSORB_MAX_REWRITES;
+
+	print_test_description("Write absorption is disabled by default - "
+			"even the hottest cache line is cleaned");
+
+	assert_int_equal(cache->cleaner.absorb.config.rewrite_threshold, 0);
+	assert_false(ocf_cleaning_absorb_defer(cache, &rewrites));
+	assert_int_equal(rewrites, OCF_CLEANING_ABSORB_MAX_REWRITES);
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_absorb_defer_test02(void **state)
+{
+	struct ocf_cache *cache = absorb_test_cache(THRESHOLD, 0);
+	uint8_t rewrites = THRESHOLD;
+
+	print_test_description("Cache line rewritten threshold times is left "
+			"dirty and its counter is halved");
+
+	assert_true(ocf_cleaning_absorb_defer(cache, &rewrites));
+	assert_int_equal(rewrites, THRESHOLD / 2);
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_absorb_defer_test03(void **state)
+{
+	struct ocf_cache *cache = absorb_test_cache(THRESHOLD, 0);
+	uint8_t rewrites = THRESHOLD - 1;
+
+	print_test_description("Cache line rewritten less than threshold "
+			"times is cleaned");
+
+	assert_false(ocf_cleaning_absorb_defer(cache, &rewrites));
+	assert_int_equal(rewrites, THRESHOLD - 1);
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_absorb_defer_test04(void **state)
+{
+	struct ocf_cache *cache = absorb_test_cache(THRESHOLD,
+			OCF_CLEANING_ABSORB_DEFAULT_DIRTY_HIGH);
+	uint8_t rewrites = OCF_CLEANING_ABSORB_MAX_REWRITES;
+
+	print_test_description("Dirty ratio reached high threshold - hot "
+			"cache line is cleaned");
+
+	assert_false(ocf_cleaning_absorb_defer(cache, &rewrites));
+
+	test_free(cache);
+}
+
+static void ocf_cleaning_absorb_defer_test05(void **state)
+{
+	struct ocf_cache *cache = absorb_test_cache(THRESHOLD, 0);
+	uint8_t rewrites = 0;
+	int i;
+
+	print_test_description("Deferred cache line gets cleaned once it is "
+			"not rewritten anymore, counter saturates");
+
+	for (i = 0; i < 2 * OCF_CLEANING_ABSORB_MAX_REWRITES; i++)
+		ocf_cleaning_count_rewrite(&rewrites);
+	assert_int_equal(rewrites, OCF_CLEANING_ABSORB_MAX_REWRITES);
+
+	for (i = 0; ocf_cleaning_absorb_defer(cache, &rewrites); i++)
+		assert_true(i < 8);
+
+	assert_true(rewrites < THRESHOLD);
+
+	test_free(cache);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_cleaning_absorb_defer_test01),
+		cmocka_unit_test(ocf_cleaning_absorb_defer_test02),
+		cmocka_unit_test(ocf_cleaning_absorb_defer_test03),
+		cmocka_unit_test(ocf_cleaning_absorb_defer_test04),
+		cmocka_unit_test(ocf_cleaning_absorb_defer_test05)
+	};
+
+	print_message("Unit test of cleaning_governor.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/cleaning/elevator.c</tested_file_path>
+<tested_function>_elevator_collect</tested_function>
+<functions_to_leave>
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "cleaning.h"
+#include "elevator.h"
+#include "../metadata/metadata.h"
+#include "../utils/utils_cleaner.h"
+#include "../utils/utils_cache_line.h"
+#include "../engine/engine_common.h"
+#include "../concurrency/ocf_cache_line_concurrency.h"
+#include "../concurrency/ocf_metadata_concurrency.h"
+#include "cleaning_priv.h"
+#include "cleaning_governor.h"
+#include "cleaning_stream.h"
+
+#include "cleaning/elevator.c/elevator_collect_test_generated_wraps.c"
+
+#define LINES 256
+
+uint32_t _elevator_collect(struct elevator_context *ctx, uint32_t max_lines);
+
+static struct {
+	bool dirty[LINES];
+	bool busy[LINES];
+	ocf_core_id_t core_id[LINES];
+	bool ready[OCF_CORE_MAX];
+	uint32_t slots[OCF_CORE_MAX];
+	uint32_t trylocks;
+	uint32_t unlocks;
+} test;
+
+ocf_cache_line_t __wrap_ocf_metadata_dirty_index_next(struct ocf_cache *cache,
+		ocf_cache_line_t line, ocf_cache_line_t end)
+{
+	for (; line < end; line++) {
+		if (test.dirty[line])
+			return line;
+	}
+
+	return end;
+}
+
+void __wrap_ocf_metadata_get_core_info(struct ocf_cache *cache,
+		ocf_cache_line_t line, ocf_core_id_t *core_id,
+		uint64_t *core_sector)
+{
+	*core_id = test.core_id[line];
+	/* Core lines are mapped in reverse order of cache lines */
+	*core_sector = LINES - line;
+}
+
+bool __wrap_ocf_cleaning_stream_ready(ocf_cache_t cache,
+		ocf_core_id_t core_id)
+{
+	return test.ready[core_id];
+}
+
+bool __wrap_ocf_cleaning_stream_reserve(ocf_cache_t cache,
+		ocf_core_id_t core_id)
+{
+	if (!test.slots[core_id])
+		return false;
+
+	test.slots[core_id]--;
+	return true;
+}
+
+bool __wrap__elevator_trylock_dirty(ocf_cache_t cache,
+		ocf_cache_line_t cache_line, ocf_core_id_t core_id,
+		uint64_t core_line)
+{
+	/* Only dirty cache lines are ever looked up */
+	assert_true(test.dirty[cache_line]);
+	assert_int_equal(core_line, LINES - cache_line);
+
+	test.trylocks++;
+
+	return !test.busy[cache_line];
+}
+
+void __wrap_ocf_cache_line_unlock_rd(struct ocf_alock *c,
+		ocf_cache_line_t line)
+{
+	test.unlocks++;
+}
+
+static struct elevator_context *elevator_test_ctx(void)
+{
+	struct elevator_context *ctx = test_malloc(sizeof(*ctx));
+	struct ocf_cache *cache = test_malloc(sizeof(*cache));
+	int i;
+
+	cache->device = test_malloc(sizeof(*cache->device));
+	cache->device->collision_table_entries = LINES;
+
+	ctx->cache = cache;
+	ctx->cursor = 0;
+
+	memset(&test, 0, sizeof(test));
+	for (i = 0; i < OCF_CORE_MAX; i++) {
+		test.ready[i] = true;
+		test.slots[i] = LINES;
+	}
+
+	return ctx;
+}
+
+static void elevator_test_ctx_free(struct elevator_context *ctx)
+{
+	test_free(ctx->cache->device);
+	test_free(ctx->cache);
+	test_free(ctx);
+}
+
+static void elevator_collect_test01(void **state)
+{
+	struct elevator_context *ctx = elevator_test_ctx();
+
+	print_test_description("Nothing is dirty - no cache line is looked up "
+			"and nothing is collected");
+
+	assert_int_equal(_elevator_collect(ctx, 32), 0);
+	assert_int_equal(test.trylocks, 0);
+
+	elevator_test_ctx_free(ctx);
+}
+
+static void elevator_collect_test02(void **state)
+{
+	struct elevator_context *ctx = elevator_test_ctx();
+
+	print_test_description("Only dirty cache lines are looked up, batch is "
+			"limited and walk continues after last collected line");
+
+	test.dirty[3] = test.dirty[70] = test.dirty[71] = test.dirty[200] = true;
+
+	assert_int_equal(_elevator_collect(ctx, 2), 2);
+	assert_int_equal(test.trylocks, 2);
+	assert_int_equal(ctx->flush.data[0].cache_line, 3);
+	assert_int_equal(ctx->flush.data[0].core_line, LINES - 3);
+	assert_int_equal(ctx->flush.data[1].cache_line, 70);
+	assert_int_equal(ctx->cursor, 71);
+
+	assert_int_equal(_elevator_collect(ctx, 2), 2);
+	assert_int_equal(ctx->flush.data[0].cache_line, 71);
+	assert_int_equal(ctx->flush.data[1].cache_line, 200);
+
+	elevator_test_ctx_free(ctx);
+}
+
+static void elevator_collect_test03(void **state)
+{
+	struct elevator_context *ctx = elevator_test_ctx();
+
+	print_test_description("Walk wraps around at the end of the cache and "
+			"stops after a single lap");
+
+	test.dirty[10] = test.dirty[100] = true;
+	ctx->cursor = 50;
+
+	assert_int_equal(_elevator_collect(ctx, 32), 2);
+	assert_int_equal(test.trylocks, 2);
+	assert_int_equal(ctx->flush.data[0].cache_line, 100);
+	assert_int_equal(ctx->flush.data[1].cache_line, 10);
+	assert_int_equal(ctx->cursor, 50);
+
+	elevator_test_ctx_free(ctx);
+}
+
+static void elevator_collect_test04(void **state)
+{
+	struct elevator_context *ctx = elevator_test_ctx();
+
+	print_test_description("Lines of saturated core and lines which can't "
+			"be locked are passed over");
+
+	test.dirty[1] = test.dirty[2] = test.dirty[3] = test.dirty[4] = true;
+	test.core_id[1] = test.core_id[3] = 1;
+	test.ready[1] = false;
+	test.busy[4] = true;
+
+	assert_int_equal(_elevator_collect(ctx, 32), 1);
+	assert_int_equal(test.trylocks, 2);
+	assert_int_equal(ctx->flush.data[0].cache_line, 2);
+	assert_int_equal(ctx->flush.data[0].core_id, 0);
+
+	elevator_test_ctx_free(ctx);
+}
+
+static void elevator_collect_test05(void **state)
+{
+	struct elevator_context *ctx = elevator_test_ctx();
+
+	print_test_description("Line locked after stream got saturated is "
+			"unlocked and left behind");
+
+	test.dirty[5] = test.dirty[6] = test.dirty[7] = true;
+	test.slots[0] = 2;
+
+	assert_int_equal(_elevator_collect(ctx, 32), 2);
+	assert_int_equal(test.trylocks, 3);
+	assert_int_equal(test.unlocks, 1);
+	assert_int_equal(ctx->flush.data[0].cache_line, 5);
+	assert_int_equal(ctx->flush.data[1].cache_line, 6);
+
+	elevator_test_ctx_free(ctx);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(elevator_collect_test01),
+		cmocka_unit_test(elevator_collect_test02),
+		cmocka_unit_test(elevator_collect_test03),
+		cmocka_unit_test(elevator_collect_test04),
+		cmocka_unit_test(elevator_collect_test05)
+	};
+
+	print_message("Unit test of elevator.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,356 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/metadata/metadata_raw.c</tested_file_path>
+<tested_function>_raw_ram_commit_join</tested_function>
+<functions_to_leave>
+_raw_ram_commit_alloc
+_raw_ram_commit_recycle
+_raw_ram_commit_complete
+_raw_ram_commit_submit
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_request.h"
+#include "metadata.h"
+#include "metadata_raw.h"
+#include "metadata_io.h"
+
+#include "metadata/metadata_raw.c/raw_ram_commit_join_test_generated_wraps.c"
+
+#define ENTRIES_IN_PAGE 10
+#define MAX_PAGES 8
+#define MAX_WRITES 8
+
+bool _raw_ram_commit_join(ocf_cache_t cache, struct ocf_request *req,
+		struct ocf_metadata_raw *raw, ocf_req_end_t complete);
+void _raw_ram_commit_complete(ocf_cache_t cache, void *context, int error);
+
+static struct {
+	struct {
+		void *batch;
+		uint32_t pages[MAX_PAGES];
+		int count;
+	} writes[MAX_WRITES];
+	int write_count;
+	int completed;
+} test;
+
+int __wrap___raw_ram_flush_do_asynch_write(ocf_cache_t cache,
+		ocf_queue_t queue, int flags, struct ocf_metadata_raw *raw,
+		uint32_t *pages_tab, int pages_to_flush, void *context,
+		env_atomic *flush_req_cnt, ocf_metadata_io_event_t fill_hndl,
+		ocf_metadata_io_end_t compl_hndl)
+{
+	assert_true(test.write_count < MAX_WRITES);
+	assert_true(pages_to_flush <= MAX_PAGES);
+
+	test.writes[test.write_count].batch = context;
+	memcpy(test.writes[test.write_count].pages, pages_tab,
+			pages_to_flush * sizeof(*pages_tab));
+	test.writes[test.write_count].count = pages_to_flush;
+	test.write_count++;
+
+	/* Write stays in flight until test completes it */
+	env_atomic_inc(flush_req_cnt);
+
+	return 0;
+}
+
+static void req_complete(struct ocf_request *req, int error)
+{
+	assert_int_equal(error, 0);
+	test.completed++;
+}
+
+static struct ocf_cache *commit_test_cache(uint32_t max_pages)
+{
+	struct ocf_cache *cache = test_malloc(sizeof(*cache));
+
+	cache->metadata_group_commit.max_pages = max_pages;
+	cache->metadata_group_commit.window_us =
+			OCF_METADATA_GROUP_COMMIT_MAX_WINDOW_US;
+
+	memset(&test, 0, sizeof(test));
+
+	return cache;
+}
+
+static struct ocf_metadata_raw *commit_test_raw(void)
+{
+	struct ocf_metadata_raw *raw = test_malloc(sizeof(*raw));
+
+	memset(raw, 0, sizeof(*raw));
+	raw->entries_in_page = ENTRIES_IN_PAGE;
+	env_spinlock_init(&raw->group_commit.lock);
+
+	return raw;
+}
+
+static void commit_test_raw_free(struct ocf_metadata_raw *raw)
+{
+	assert_null(raw->group_commit.open);
+	assert_int_equal(raw->group_commit.in_flight, 0);
+
+	env_free(raw->group_commit.spare);
+	env_spinlock_destroy(&raw->group_commit.lock);
+	test_free(raw);
+}
+
+/* Request dirtying collision entries of given cache lines */
+static struct ocf_request *commit_test_req(ocf_cache_line_t *lines,
+		uint32_t count)
+{
+	size_t size = sizeof(struct ocf_request) +
+			count * sizeof(struct ocf_map_info);
+	struct ocf_request *req = test_malloc(size);
+	uint32_t i;
+
+	memset(req, 0, size);
+	req->core_line_count = count;
+	req->info.flush_metadata = true;
+
+	for (i = 0; i < count; i++) {
+		req->map[i].coll_idx = lines[i];
+		req->map[i].flush = true;
+	}
+
+	return req;
+}
+
+static void raw_ram_commit_join_test01(void **state)
+{
+	struct ocf_cache *cache = commit_test_cache(
+			OCF_METADATA_GROUP_COMMIT_INACTIVE);
+	struct ocf_metadata_raw *raw = commit_test_raw();
+	ocf_cache_line_t lines[] = { 0 };
+	struct ocf_request *req = commit_test_req(lines, 1);
+
+	print_test_description("Group commit inactive - request is flushed "
+			"on its own");
+
+	assert_false(_raw_ram_commit_join(cache, req, raw, req_complete));
+	assert_int_equal(test.write_count, 0);
+
+	test_free(req);
+	commit_test_raw_free(raw);
+	test_free(cache);
+}
+
+static void raw_ram_commit_join_test02(void **state)
+{
+	struct ocf_cache *cache = commit_test_cache(MAX_PAGES);
+	struct ocf_metadata_raw *raw = commit_test_raw();
+	ocf_cache_line_t lines[] = { 5, 25 };
+	struct ocf_request *req = commit_test_req(lines, 2);
+
+	print_test_description("No commit in flight - batch is written at "
+			"once and request completes with it");
+
+	assert_true(_raw_ram_commit_join(cache, req, raw, req_complete));
+	assert_int_equal(test.write_count, 1);
+	assert_int_equal(test.writes[0].count, 2);
+	assert_int_equal(test.writes[0].pages[0], 0);
+	assert_int_equal(test.writes[0].pages[1], 2);
+	assert_null(raw->group_commit.open);
+	assert_int_equal(test.completed, 0);
+
+	_raw_ram_commit_complete(cache, test.writes[0].batch, 0);
+	assert_int_equal(test.completed, 1);
+	assert_ptr_equal(raw->group_commit.spare, test.writes[0].batch);
+
+	test_free(req);
+	commit_test_raw_free(raw);
+	test_free(cache);
+}
+
+static void raw_ram_commit_join_test03(void **state)
+{
+	struct ocf_cache *cache = commit_test_cache(MAX_PAGES);
+	struct ocf_metadata_raw *raw = commit_test_raw();
+	ocf_cache_line_t lines1[] = { 1 };
+	ocf_cache_line_t lines2[] = { 11 };
+	ocf_cache_line_t lines3[] = { 21, 31 };
+	struct ocf_request *req1 = commit_test_req(lines1, 1);
+	struct ocf_request *req2 = commit_test_req(lines2, 1);
+	struct ocf_request *req3 = commit_test_req(lines3, 2);
+
+	print_test_description("Requests joining while commit is in flight "
+			"are written together once it completes");
+
+	assert_true(_raw_ram_commit_join(cache, req1, raw, req_complete));
+	assert_true(_raw_ram_commit_join(cache, req2, raw, req_complete));
+	assert_true(_raw_ram_commit_join(cache, req3, raw, req_complete));
+
+	assert_int_equal(test.write_count, 1);
+	assert_non_null(raw->group_commit.open);
+
+	_raw_ram_commit_complete(cache, test.writes[0].batch, 0);
+
+	assert_int_equal(test.completed, 1);
+	assert_int_equal(test.write_count, 2);
+	assert_null(raw->group_commit.open);
+	assert_int_equal(test.writes[1].count, 3);
+	assert_int_equal(test.writes[1].pages[0], 1);
+	assert_int_equal(test.writes[1].pages[1], 2);
+	assert_int_equal(test.writes[1].pages[2], 3);
+
+	_raw_ram_commit_complete(cache, test.writes[1].batch, 0);
+	assert_int_equal(test.completed, 3);
+
+	test_free(req1);
+	test_free(req2);
+	test_free(req3);
+	commit_test_raw_free(raw);
+	test_free(cache);
+}
+
+static void raw_ram_commit_join_test04(void **state)
+{
+	struct ocf_cache *cache = commit_test_cache(MAX_PAGES);
+	struct ocf_metadata_raw *raw = commit_test_raw();
+	ocf_cache_line_t lines[] = { 0 };
+	struct ocf_request *req1 = commit_test_req(lines, 1);
+	struct ocf_request *req2 = commit_test_req(lines, 1);
+	struct ocf_request *req3 = commit_test_req(lines, 1);
+	void *first;
+
+	print_test_description("Completed batch is kept as spare and reused "
+			"by next batch, new one is allocated only while spare "
+			"is in flight");
+
+	assert_true(_raw_ram_commit_join(cache, req1, raw, req_complete));
+	first = test.writes[0].batch;
+	_raw_ram_commit_complete(cache, first, 0);
+	assert_ptr_equal(raw->group_commit.spare, first);
+
+	/* Spare is taken for the batch written at once */
+	assert_true(_raw_ram_commit_join(cache, req2, raw, req_complete));
+	assert_ptr_equal(test.writes[1].batch, first);
+	assert_null(raw->group_commit.spare);
+
+	/* No spare while first batch is in flight, so new one is allocated */
+	assert_true(_raw_ram_commit_join(cache, req3, raw, req_complete));
+	assert_non_null(raw->group_commit.open);
+	assert_ptr_not_equal(raw->group_commit.open, first);
+
+	_raw_ram_commit_complete(cache, first, 0);
+	assert_int_equal(test.write_count, 3);
+	assert_ptr_equal(raw->group_commit.spare, first);
+
+	/* Only one batch is kept, the other one is freed */
+	_raw_ram_commit_complete(cache, test.writes[2].batch, 0);
+	assert_ptr_equal(raw->group_commit.spare, first);
+	assert_int_equal(test.completed, 3);
+
+	test_free(req1);
+	test_free(req2);
+	test_free(req3);
+	commit_test_raw_free(raw);
+	test_free(cache);
+}
+
+static void raw_ram_commit_join_test05(void **state)
+{
+	struct ocf_cache *cache = commit_test_cache(MAX_PAGES);
+	struct ocf_metadata_raw *raw = commit_test_raw();
+	ocf_cache_line_t lines[] = { 0 };
+	struct ocf_request *req1 = commit_test_req(lines, 1);
+	struct ocf_request *req2 = commit_test_req(lines, 1);
+	void *first;
+
+	print_test_description("Spare of previous page limit is dropped "
+			"instead of being reused");
+
+	assert_true(_raw_ram_commit_join(cache, req1, raw, req_complete));
+	first = test.writes[0].batch;
+	_raw_ram_commit_complete(cache, first, 0);
+	assert_ptr_equal(raw->group_commit.spare, first);
+
+	cache->metadata_group_commit.max_pages = MAX_PAGES / 2;
+
+	assert_true(_raw_ram_commit_join(cache, req2, raw, req_complete));
+	assert_int_equal(test.write_count, 2);
+	assert_null(raw->group_commit.spare);
+
+	_raw_ram_commit_complete(cache, test.writes[1].batch, 0);
+	assert_non_null(raw->group_commit.spare);
+	assert_int_equal(test.completed, 2);
+
+	test_free(req1);
+	test_free(req2);
+	commit_test_raw_free(raw);
+	test_free(cache);
+}
+
+static void raw_ram_commit_join_test06(void **state)
+{
+	struct ocf_cache *cache = commit_test_cache(2);
+	struct ocf_metadata_raw *raw = commit_test_raw();
+	ocf_cache_line_t lines1[] = { 0 };
+	ocf_cache_line_t lines2[] = { 10, 20 };
+	ocf_cache_line_t lines3[] = { 30, 40, 50 };
+	struct ocf_request *req1 = commit_test_req(lines1, 1);
+	struct ocf_request *req2 = commit_test_req(lines2, 2);
+	struct ocf_request *req3 = commit_test_req(lines3, 3);
+
+	print_test_description("Batch reaching page limit is written without "
+			"waiting, requests above the limit are not joined");
+
+	assert_true(_raw_ram_commit_join(cache, req1, raw, req_complete));
+	assert_int_equal(test.write_count, 1);
+
+	assert_true(_raw_ram_commit_join(cache, req2, raw, req_complete));
+	assert_int_equal(test.write_count, 2);
+	assert_int_equal(test.writes[1].count, 2);
+
+	assert_false(_raw_ram_commit_join(cache, req3, raw, req_complete));
+
+	_raw_ram_commit_complete(cache, test.writes[0].batch, 0);
+	_raw_ram_commit_complete(cache, test.writes[1].batch, 0);
+	assert_int_equal(test.completed, 2);
+
+	test_free(req1);
+	test_free(req2);
+	test_free(req3);
+	commit_test_raw_free(raw);
+	test_free(cache);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(raw_ram_commit_join_test01),
+		cmocka_unit_test(raw_ram_commit_join_test02),
+		cmocka_unit_test(raw_ram_commit_join_test03),
+		cmocka_unit_test(raw_ram_commit_join_test04),
+		cmocka_unit_test(raw_ram_commit_join_test05),
+		cmocka_unit_test(raw_ram_commit_join_test06)
+	};
+
+	print_message("Unit test of metadata_raw.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
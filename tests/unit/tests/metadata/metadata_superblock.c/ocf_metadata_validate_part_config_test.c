@@ -0,0 +1,137 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/metadata/metadata_superblock.c</tested_file_path>
+<tested_function>ocf_metadata_validate_part_config</tested_function>
+<functions_to_leave>
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_def_priv.h"
+#include "../ocf_cache_priv.h"
+#include "metadata.h"
+#include "metadata_internal.h"
+#include "metadata_superblock.h"
+#include "../utils/utils_cache_line.h"
+
+#include "metadata/metadata_superblock.c/ocf_metadata_validate_part_config_test_generated_wraps.c"
+
+int ocf_metadata_validate_part_config(ocf_cache_t cache);
+
+const char * const ocf_metadata_segment_names[metadata_segment_max] = {
+	[metadata_segment_part_config] = "Part config",
+};
+
+static struct ocf_cache cache;
+static struct ocf_user_part_config config[OCF_USER_IO_CLASS_MAX];
+static struct ocf_part_runtime runtime[OCF_USER_IO_CLASS_MAX];
+
+/* All IO classes invalid, except the default one using whole cache */
+static void test_part_config_init(void)
+{
+	ocf_part_id_t part_id;
+
+	memset(&cache, 0, sizeof(cache));
+	memset(config, 0, sizeof(config));
+	memset(runtime, 0, sizeof(runtime));
+
+	for (part_id = 0; part_id < OCF_USER_IO_CLASS_MAX; part_id++) {
+		cache.user_parts[part_id].config = &config[part_id];
+		cache.user_parts[part_id].part.runtime = &runtime[part_id];
+	}
+
+	config[0].flags.valid = true;
+	config[0].max_size = PARTITION_SIZE_MAX;
+}
+
+static void test_part_add(ocf_part_id_t part_id, uint32_t max_size,
+		uint8_t headroom_size)
+{
+	config[part_id].flags.valid = true;
+	config[part_id].max_size = max_size;
+	config[part_id].headroom_size = headroom_size;
+}
+
+static void ocf_metadata_validate_part_config_test01(void **state)
+{
+	print_test_description("IO classes with headroom within cache size "
+			"are valid");
+
+	test_part_config_init();
+	test_part_add(1, PARTITION_SIZE_MAX, 50);
+	test_part_add(2, 60, 50);
+
+	assert_int_equal(ocf_metadata_validate_part_config(&cache), 0);
+}
+
+static void ocf_metadata_validate_part_config_test02(void **state)
+{
+	print_test_description("IO classes with total headroom exceeding "
+			"cache size are rejected");
+
+	test_part_config_init();
+	test_part_add(1, PARTITION_SIZE_MAX, 60);
+	test_part_add(2, PARTITION_SIZE_MAX, 41);
+
+	assert_int_equal(ocf_metadata_validate_part_config(&cache),
+			-OCF_ERR_INVAL);
+}
+
+static void ocf_metadata_validate_part_config_test03(void **state)
+{
+	print_test_description("Headroom of invalid IO class is not counted");
+
+	test_part_config_init();
+	test_part_add(1, PARTITION_SIZE_MAX, 60);
+	test_part_add(2, PARTITION_SIZE_MAX, 41);
+	config[2].flags.valid = false;
+
+	assert_int_equal(ocf_metadata_validate_part_config(&cache), 0);
+}
+
+static void ocf_metadata_validate_part_config_test04(void **state)
+{
+	print_test_description("IO class with headroom above its maximum size "
+			"is rejected");
+
+	test_part_config_init();
+	test_part_add(1, 40, 50);
+
+	assert_int_equal(ocf_metadata_validate_part_config(&cache),
+			-OCF_ERR_INVAL);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_metadata_validate_part_config_test01),
+		cmocka_unit_test(ocf_metadata_validate_part_config_test02),
+		cmocka_unit_test(ocf_metadata_validate_part_config_test03),
+		cmocka_unit_test(ocf_metadata_validate_part_config_test04)
+	};
+
+	print_message("Unit test of metadata_superblock.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
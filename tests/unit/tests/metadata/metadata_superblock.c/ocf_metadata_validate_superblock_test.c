@@ -0,0 +1,125 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/metadata/metadata_superblock.c</tested_file_path>
+<tested_function>ocf_metadata_validate_superblock</tested_function>
+<functions_to_leave>
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_def_priv.h"
+#include "../ocf_cache_priv.h"
+#include "metadata.h"
+#include "metadata_internal.h"
+#include "metadata_superblock.h"
+#include "../utils/utils_cache_line.h"
+
+#include "metadata/metadata_superblock.c/ocf_metadata_validate_superblock_test_generated_wraps.c"
+
+const char * const ocf_metadata_segment_names[metadata_segment_max] = {
+	[metadata_segment_sb_config] = "Super block config",
+};
+
+bool __wrap_ocf_cache_line_size_is_valid(uint64_t size)
+{
+	return true;
+}
+
+static void test_superblock_init(struct ocf_superblock_config *superblock,
+		ocf_eviction_t eviction_policy)
+{
+	memset(superblock, 0, sizeof(*superblock));
+
+	superblock->magic_number = CACHE_MAGIC_NUMBER;
+	superblock->metadata_version = METADATA_VERSION();
+	superblock->cache_mode = ocf_cache_mode_wt;
+	superblock->line_size = ocf_cache_line_size_4;
+	superblock->lru_lists = 1;
+	superblock->eviction_policy_type = eviction_policy;
+
+	superblock->checksum[metadata_segment_sb_config] = env_crc32(0,
+			(void *)superblock,
+			offsetof(struct ocf_superblock_config, checksum));
+}
+
+static void ocf_metadata_validate_superblock_test01(void **state)
+{
+	struct ocf_cache cache = {};
+	struct ocf_superblock_config superblock;
+	ocf_eviction_t policy;
+
+	print_test_description("Superblock with supported eviction policy "
+			"is valid");
+
+	for (policy = 0; policy < ocf_eviction_max; policy++) {
+		test_superblock_init(&superblock, policy);
+		assert_int_equal(ocf_metadata_validate_superblock(&cache,
+				&superblock), 0);
+	}
+}
+
+static void ocf_metadata_validate_superblock_test02(void **state)
+{
+	struct ocf_cache cache = {};
+	struct ocf_superblock_config superblock;
+
+	print_test_description("Superblock with eviction policy out of range "
+			"is rejected");
+
+	test_superblock_init(&superblock, ocf_eviction_max);
+	assert_int_equal(ocf_metadata_validate_superblock(&cache, &superblock),
+			-OCF_ERR_INVAL);
+
+	test_superblock_init(&superblock, -1);
+	assert_int_equal(ocf_metadata_validate_superblock(&cache, &superblock),
+			-OCF_ERR_INVAL);
+}
+
+static void ocf_metadata_validate_superblock_test03(void **state)
+{
+	struct ocf_cache cache = {};
+	struct ocf_superblock_config superblock;
+
+	print_test_description("Eviction policy changed without checksum "
+			"update is rejected");
+
+	test_superblock_init(&superblock, ocf_eviction_lru);
+	superblock.eviction_policy_type = ocf_eviction_clock;
+
+	assert_int_equal(ocf_metadata_validate_superblock(&cache, &superblock),
+			-OCF_ERR_INVAL);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_metadata_validate_superblock_test01),
+		cmocka_unit_test(ocf_metadata_validate_superblock_test02),
+		cmocka_unit_test(ocf_metadata_validate_superblock_test03)
+	};
+
+	print_message("Unit test of metadata_superblock.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/ocf_core.c</tested_file_path>
+<tested_function>ocf_core_submit_io_split</tested_function>
+<functions_to_leave>
+ocf_core_volume_submit_io
+ocf_core_update_second_admission
+ocf_io_to_req
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "ocf_priv.h"
+#include "ocf_cache_priv.h"
+#include "ocf_core_priv.h"
+#include "ocf_request.h"
+#include "engine/cache_engine.h"
+#include "engine/engine_split.h"
+#include "utils/utils_history_hash.h"
+
+#include "ocf_core.c/ocf_core_submit_io_split_test_generated_wraps.c"
+
+#define TEST_PAGES 16
+
+void ocf_core_volume_submit_io(struct ocf_io *io);
+
+static struct ocf_cache cache;
+static struct ocf_core core;
+
+int __wrap_ocf_core_validate_io(struct ocf_io *io)
+{
+	return 0;
+}
+
+ocf_volume_t __wrap_ocf_io_get_volume(struct ocf_io *io)
+{
+	return NULL;
+}
+
+ocf_core_t __wrap_ocf_volume_to_core(ocf_volume_t volume)
+{
+	return &core;
+}
+
+ocf_cache_t __wrap_ocf_core_get_cache(ocf_core_t core)
+{
+	return &cache;
+}
+
+ocf_core_id_t __wrap_ocf_core_get_id(ocf_core_t core)
+{
+	return 0;
+}
+
+ocf_part_id_t __wrap_ocf_user_part_class2id(ocf_cache_t cache,
+		uint64_t class)
+{
+	return 0;
+}
+
+bool __wrap_ocf_engine_split_needed(struct ocf_request *req)
+{
+	return true;
+}
+
+void __wrap_ocf_resolve_effective_cache_mode(ocf_cache_t cache,
+		ocf_core_t core, struct ocf_request *req)
+{
+	function_called();
+	req->cache_mode = ocf_req_cache_mode_wt;
+}
+
+int __wrap_ocf_engine_prepare_split_req(struct ocf_request *req)
+{
+	return mock();
+}
+
+void __wrap_ocf_engine_submit_split_req(struct ocf_request *req)
+{
+	function_called();
+	check_expected(req->allow_second_admission);
+}
+
+int __wrap_ocf_req_alloc_map(struct ocf_request *req)
+{
+	function_called();
+	return 0;
+}
+
+int __wrap_ocf_core_submit_io_fast(struct ocf_io *io,
+		struct ocf_request *req, ocf_core_t core, ocf_cache_t cache)
+{
+	return mock();
+}
+
+bool __wrap_ocf_is_cache_full(ocf_cache_t cache)
+{
+	return true;
+}
+
+bool __wrap_ocf_history_hash_find(uint64_t addr, int core_id)
+{
+	function_called();
+	return false;
+}
+
+void __wrap_ocf_history_hash_add_addr(uint64_t addr, int core_id)
+{
+	function_called();
+}
+
+int __wrap_ocf_engine_hndl_req(struct ocf_request *req)
+{
+	function_called();
+	check_expected(req->allow_second_admission);
+	return 0;
+}
+
+static struct ocf_request *test_req_new(void)
+{
+	struct ocf_request *req = test_malloc(sizeof(*req));
+
+	memset(req, 0, sizeof(*req));
+	memset(&cache, 0, sizeof(cache));
+	memset(&core, 0, sizeof(core));
+
+	env_bit_set(ocf_cache_state_running, &cache.cache_state);
+
+	req->rw = OCF_READ;
+	req->ioi.io.dir = OCF_READ;
+	req->ioi.io.addr = 0;
+	req->ioi.io.bytes = TEST_PAGES * PAGE_SIZE;
+
+	return req;
+}
+
+static void ocf_core_submit_io_split_test01(void **state)
+{
+	struct ocf_request *req = test_req_new();
+
+	print_test_description("Split declined, request missed in fast path - "
+			"cache mode and admission are evaluated once");
+
+	will_return(__wrap_ocf_engine_prepare_split_req, -OCF_ERR_NO_MEM);
+	will_return(__wrap_ocf_core_submit_io_fast, -OCF_ERR_IO);
+
+	expect_function_call(__wrap_ocf_resolve_effective_cache_mode);
+	expect_function_call(__wrap_ocf_req_alloc_map);
+	expect_function_calls(__wrap_ocf_history_hash_find, TEST_PAGES);
+	expect_function_calls(__wrap_ocf_history_hash_add_addr, TEST_PAGES);
+	expect_function_call(__wrap_ocf_engine_hndl_req);
+	expect_value(__wrap_ocf_engine_hndl_req, req->allow_second_admission,
+			false);
+
+	ocf_core_volume_submit_io(&req->ioi.io);
+
+	assert_int_equal(req->cache_mode, ocf_req_cache_mode_wt);
+
+	test_free(req);
+}
+
+static void ocf_core_submit_io_split_test02(void **state)
+{
+	struct ocf_request *req = test_req_new();
+
+	print_test_description("Split declined, request hit in fast path - "
+			"admission is not evaluated");
+
+	will_return(__wrap_ocf_engine_prepare_split_req, -OCF_ERR_NO_MEM);
+	will_return(__wrap_ocf_core_submit_io_fast, 0);
+
+	expect_function_call(__wrap_ocf_resolve_effective_cache_mode);
+	expect_function_call(__wrap_ocf_req_alloc_map);
+
+	ocf_core_volume_submit_io(&req->ioi.io);
+
+	test_free(req);
+}
+
+static void ocf_core_submit_io_split_test03(void **state)
+{
+	struct ocf_request *req = test_req_new();
+
+	print_test_description("Request split - admission is evaluated once "
+			"and passed to children");
+
+	will_return(__wrap_ocf_engine_prepare_split_req, 0);
+
+	expect_function_call(__wrap_ocf_resolve_effective_cache_mode);
+	expect_function_calls(__wrap_ocf_history_hash_find, TEST_PAGES);
+	expect_function_calls(__wrap_ocf_history_hash_add_addr, TEST_PAGES);
+	expect_function_call(__wrap_ocf_engine_submit_split_req);
+	expect_value(__wrap_ocf_engine_submit_split_req,
+			req->allow_second_admission, false);
+
+	ocf_core_volume_submit_io(&req->ioi.io);
+
+	test_free(req);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(ocf_core_submit_io_split_test01),
+		cmocka_unit_test(ocf_core_submit_io_split_test02),
+		cmocka_unit_test(ocf_core_submit_io_split_test03)
+	};
+
+	print_message("Unit test of ocf_core.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
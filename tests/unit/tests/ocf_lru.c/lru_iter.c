@@ -13,6 +13,7 @@
  *  ocf_rotate_right
  *  ocf_get_lru
  *  lru_iter_eviction_next
+ *  lru_list_eviction_candidate
  *  lru_iter_cleaning_next
  * </functions_to_leave>
  */
@@ -32,6 +33,7 @@
 #include "ocf_lru.h"
 #include "../utils/utils_cleaner.h"
 #include "../utils/utils_cache_line.h"
+#include "../utils/utils_user_part.h"
 #include "../concurrency/ocf_concurrency.h"
 #include "../mngt/ocf_mngt_common.h"
 #include "../engine/engine_zero.h"
@@ -46,6 +48,11 @@ struct ocf_cache_line_concurrency *__wrap_ocf_cache_line_concurrency(ocf_cache_t
 	return NULL;
 }
 
+uint32_t __wrap_ocf_lru_num_lists(ocf_cache_t cache)
+{
+	return OCF_NUM_LRU_LISTS;
+}
+
 ocf_cache_line_t test_cases[10 * OCF_NUM_LRU_LISTS][OCF_NUM_LRU_LISTS][20];
 unsigned num_cases = 20;
 
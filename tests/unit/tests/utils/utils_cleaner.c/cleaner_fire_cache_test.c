@@ -0,0 +1,207 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/utils/utils_cleaner.c</tested_file_path>
+<tested_function>_ocf_cleaner_fire_cache</tested_function>
+<functions_to_leave>
+_ocf_cleaner_set_error
+_ocf_cleaner_max_io_lines
+_ocf_cleaner_io_set_invalid
+_ocf_cleaner_io_adjacent
+_ocf_cleaner_cache_io_end
+_ocf_cleaner_cache_io_cmpl
+_ocf_cleaner_cache_io_mergeable
+_ocf_cleaner_cache_io
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_request.h"
+#include "../metadata/metadata.h"
+#include "../engine/engine_common.h"
+#include "../concurrency/ocf_metadata_concurrency.h"
+#include "utils_cleaner.h"
+#include "utils_io.h"
+#include "utils_cache_line.h"
+
+#include "utils/utils_cleaner.c/cleaner_fire_cache_test_generated_wraps.c"
+
+#define LINES 8
+#define LINE_SIZE 4096
+#define METADATA_OFFSET (1024 * 1024)
+
+/* Value of ocf_cleaner_req_type_master in tested file */
+#define REQ_TYPE_MASTER 1
+
+int _ocf_cleaner_fire_cache(struct ocf_request *req);
+
+static struct {
+	ocf_cache_line_t phys[LINES];
+	unsigned max_io_size;
+	int error;
+	struct ocf_io ios[LINES];
+	uint32_t io_count;
+} test;
+
+static struct ocf_cache cache;
+static struct ocf_cache_device device;
+static uint64_t req_buf[(sizeof(struct ocf_request) +
+		LINES * sizeof(struct ocf_map_info)) / sizeof(uint64_t) + 1];
+static struct ocf_request *req = (struct ocf_request *)req_buf;
+static struct ocf_map_info *map = ((struct ocf_request *)req_buf)->map;
+
+ocf_cache_line_t __wrap_ocf_metadata_map_lg2phy(struct ocf_cache *cache,
+		ocf_cache_line_t coll_idx)
+{
+	return test.phys[coll_idx];
+}
+
+ocf_part_id_t __wrap_ocf_metadata_get_partition_id(struct ocf_cache *cache,
+		ocf_cache_line_t line)
+{
+	return 0;
+}
+
+unsigned int __wrap_ocf_volume_get_max_io_size(ocf_volume_t volume)
+{
+	return test.max_io_size;
+}
+
+struct ocf_io *__wrap_ocf_volume_new_io(ocf_volume_t volume,
+		ocf_queue_t queue, uint64_t addr, uint32_t bytes, uint32_t dir,
+		uint32_t io_class, uint64_t flags)
+{
+	struct ocf_io *io = &test.ios[test.io_count++];
+
+	io->addr = addr;
+	io->bytes = bytes;
+	io->dir = dir;
+
+	return io;
+}
+
+int __wrap_ocf_io_set_data(struct ocf_io *io, ctx_data_t *data,
+		uint32_t offset)
+{
+	return 0;
+}
+
+void __wrap_ocf_volume_submit_io(struct ocf_io *io)
+{
+	io->end(io, test.error);
+}
+
+/* Lines kept next to each other in the request buffer and stored
+ * sequentially on the cache device */
+static void test_init(uint32_t count, unsigned max_io_size)
+{
+	struct ocf_cache_line_settings *settings;
+	uint32_t i;
+
+	memset(&test, 0, sizeof(test));
+	memset(&cache, 0, sizeof(cache));
+	memset(&device, 0, sizeof(device));
+	memset(req_buf, 0, sizeof(req_buf));
+
+	settings = (struct ocf_cache_line_settings *)&cache.metadata.settings;
+	settings->size = LINE_SIZE;
+	settings->sector_count = LINE_SIZE / 512;
+	settings->sector_end = LINE_SIZE / 512 - 1;
+
+	device.metadata_offset = METADATA_OFFSET;
+	cache.device = &device;
+
+	for (i = 0; i < count; i++) {
+		map[i].core_id = 0;
+		map[i].core_line = i;
+		map[i].coll_idx = i;
+		map[i].hash = i;
+		map[i].status = LOOKUP_HIT;
+		test.phys[i] = 10 + i;
+	}
+
+	req->cache = &cache;
+	req->core_line_count = count;
+	req->master_io_req_type = REQ_TYPE_MASTER;
+
+	test.max_io_size = max_io_size;
+}
+
+static void assert_io(uint32_t idx, ocf_cache_line_t phys, uint32_t lines)
+{
+	assert_int_equal(test.ios[idx].addr,
+			METADATA_OFFSET + phys * LINE_SIZE);
+	assert_int_equal(test.ios[idx].bytes, lines * LINE_SIZE);
+	assert_int_equal(test.ios[idx].dir, OCF_READ);
+}
+
+static void cleaner_fire_cache_test01(void **state)
+{
+	print_test_description("Lines stored sequentially on cache device are "
+			"read with single IO, capped by max IO size");
+
+	test_init(5, 2 * LINE_SIZE);
+
+	/* line 3 stored elsewhere */
+	test.phys[3] = 40;
+	test.phys[4] = 41;
+
+	assert_int_equal(_ocf_cleaner_fire_cache(req), 0);
+
+	assert_int_equal(test.io_count, 3);
+	assert_io(0, 10, 2);
+	assert_io(1, 12, 1);
+	assert_io(2, 40, 2);
+	assert_int_equal(env_atomic_read(&req->req_remaining), 0);
+}
+
+static void cleaner_fire_cache_test02(void **state)
+{
+	uint32_t i;
+
+	print_test_description("Failed merged cache read marks all covered "
+			"lines invalid");
+
+	test_init(4, 1024 * 1024);
+	test.error = -OCF_ERR_IO;
+
+	assert_int_equal(_ocf_cleaner_fire_cache(req), 0);
+
+	assert_int_equal(test.io_count, 1);
+	for (i = 0; i < 4; i++)
+		assert_true(map[i].invalid);
+	assert_int_equal(req->error, -OCF_ERR_IO);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(cleaner_fire_cache_test01),
+		cmocka_unit_test(cleaner_fire_cache_test02)
+	};
+
+	print_message("Unit test of utils_cleaner.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright(c) 2012-2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*
+<tested_file_path>src/utils/utils_cleaner.c</tested_file_path>
+<tested_function>_ocf_cleaner_fire_core</tested_function>
+<functions_to_leave>
+_ocf_cleaner_set_error
+_ocf_cleaner_sector_is_dirty
+_ocf_cleaner_max_io_lines
+_ocf_cleaner_io_set_invalid
+_ocf_cleaner_io_adjacent
+_ocf_cleaner_core_io_end
+_ocf_cleaner_core_io_cmpl
+_ocf_cleaner_core_io_for_dirty_range
+_ocf_cleaner_line_is_dirty
+_ocf_cleaner_core_io_mergeable
+_ocf_cleaner_core_submit_io
+_ocf_cleaner_skip_discarded
+</functions_to_leave>
+*/
+
+#undef static
+#undef inline
+/*
+ * This headers must be in test source file. It's important that cmocka.h is
+ * last.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "print_desc.h"
+
+/*
+ * Headers from tested target.
+ */
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_request.h"
+#include "../metadata/metadata.h"
+#include "../engine/engine_common.h"
+#include "../concurrency/ocf_metadata_concurrency.h"
+#include "utils_cleaner.h"
+#include "utils_io.h"
+#include "utils_cache_line.h"
+
+#include "utils/utils_cleaner.c/cleaner_fire_core_test_generated_wraps.c"
+
+#define LINES 8
+#define LINE_SECTORS 8
+#define LINE_SIZE (LINE_SECTORS * 512)
+#define FIRST_CORE_LINE 100
+
+/* Value of ocf_cleaner_req_type_master in tested file */
+#define REQ_TYPE_MASTER 1
+
+int _ocf_cleaner_fire_core(struct ocf_request *req);
+
+static struct {
+	uint8_t valid[LINES];
+	uint8_t dirty[LINES];
+	unsigned max_io_size;
+	int error;
+	struct ocf_io ios[LINES * LINE_SECTORS];
+	uint32_t io_count;
+	uint32_t submitted;
+} test;
+
+static struct ocf_cache cache;
+static uint64_t req_buf[(sizeof(struct ocf_request) +
+		LINES * sizeof(struct ocf_map_info)) / sizeof(uint64_t) + 1];
+static struct ocf_request *req = (struct ocf_request *)req_buf;
+static struct ocf_map_info *map = ((struct ocf_request *)req_buf)->map;
+
+static bool test_sectors(uint8_t mask, uint8_t start, uint8_t stop, bool all)
+{
+	uint8_t range = (uint8_t)((0xff >> (7 - stop)) & (0xff << start));
+
+	return all ? (mask & range) == range : !!(mask & range);
+}
+
+bool __wrap_ocf_metadata_test_dirty(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all)
+{
+	return test_sectors(test.dirty[line], start, stop, all);
+}
+
+bool __wrap_ocf_metadata_test_valid(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all)
+{
+	return test_sectors(test.valid[line], start, stop, all);
+}
+
+ocf_part_id_t __wrap_ocf_metadata_get_partition_id(struct ocf_cache *cache,
+		ocf_cache_line_t line)
+{
+	return 0;
+}
+
+unsigned int __wrap_ocf_volume_get_max_io_size(ocf_volume_t volume)
+{
+	return test.max_io_size;
+}
+
+struct ocf_io *__wrap_ocf_volume_new_io(ocf_volume_t volume,
+		ocf_queue_t queue, uint64_t addr, uint32_t bytes, uint32_t dir,
+		uint32_t io_class, uint64_t flags)
+{
+	struct ocf_io *io = &test.ios[test.io_count++];
+
+	io->addr = addr;
+	io->bytes = bytes;
+	io->dir = dir;
+
+	return io;
+}
+
+int __wrap_ocf_io_set_data(struct ocf_io *io, ctx_data_t *data,
+		uint32_t offset)
+{
+	return 0;
+}
+
+void __wrap_ocf_volume_submit_io(struct ocf_io *io)
+{
+	test.submitted++;
+	io->end(io, test.error);
+}
+
+/* Fully valid and dirty lines following each other on core and in the
+ * request buffer */
+static void test_init(uint32_t count, unsigned max_io_size)
+{
+	struct ocf_cache_line_settings *settings;
+	uint32_t i;
+
+	memset(&test, 0, sizeof(test));
+	memset(&cache, 0, sizeof(cache));
+	memset(req_buf, 0, sizeof(req_buf));
+
+	settings = (struct ocf_cache_line_settings *)&cache.metadata.settings;
+	settings->size = LINE_SIZE;
+	settings->sector_count = LINE_SECTORS;
+	settings->sector_start = 0;
+	settings->sector_end = LINE_SECTORS - 1;
+
+	for (i = 0; i < count; i++) {
+		map[i].core_id = 0;
+		map[i].core_line = FIRST_CORE_LINE + i;
+		map[i].coll_idx = i;
+		map[i].hash = i;
+		map[i].status = LOOKUP_HIT;
+		test.valid[i] = 0xff;
+		test.dirty[i] = 0xff;
+	}
+
+	req->cache = &cache;
+	req->core_line_count = count;
+	req->master_io_req_type = REQ_TYPE_MASTER;
+
+	test.max_io_size = max_io_size;
+}
+
+static void assert_io(uint32_t idx, uint64_t core_line, uint32_t sector,
+		uint32_t sectors)
+{
+	assert_int_equal(test.ios[idx].addr,
+			core_line * LINE_SIZE + sector * 512);
+	assert_int_equal(test.ios[idx].bytes, sectors * 512);
+	assert_int_equal(test.ios[idx].dir, OCF_WRITE);
+}
+
+static void cleaner_fire_core_test01(void **state)
+{
+	print_test_description("Adjacent dirty lines are written with single "
+			"core IO");
+
+	test_init(4, 1024 * 1024);
+
+	assert_int_equal(_ocf_cleaner_fire_core(req), 0);
+
+	assert_int_equal(test.submitted, 1);
+	assert_io(0, FIRST_CORE_LINE, 0, 4 * LINE_SECTORS);
+	assert_int_equal(req->error, 0);
+	assert_int_equal(env_atomic_read(&req->req_remaining), 0);
+}
+
+static void cleaner_fire_core_test02(void **state)
+{
+	print_test_description("Merged core IO is capped by max IO size of "
+			"core volume");
+
+	test_init(5, 2 * LINE_SIZE);
+
+	assert_int_equal(_ocf_cleaner_fire_core(req), 0);
+
+	assert_int_equal(test.submitted, 3);
+	assert_io(0, FIRST_CORE_LINE, 0, 2 * LINE_SECTORS);
+	assert_io(1, FIRST_CORE_LINE + 2, 0, 2 * LINE_SECTORS);
+	assert_io(2, FIRST_CORE_LINE + 4, 0, LINE_SECTORS);
+}
+
+static void cleaner_fire_core_test03(void **state)
+{
+	print_test_description("Partially dirty line is written per dirty "
+			"range and breaks the merge");
+
+	test_init(3, 1024 * 1024);
+
+	/* sectors 0-1 and 4-5 dirty */
+	test.valid[1] = 0x3f;
+	test.dirty[1] = 0x33;
+
+	assert_int_equal(_ocf_cleaner_fire_core(req), 0);
+
+	assert_int_equal(test.submitted, 4);
+	assert_io(0, FIRST_CORE_LINE, 0, LINE_SECTORS);
+	assert_io(1, FIRST_CORE_LINE + 1, 0, 2);
+	assert_io(2, FIRST_CORE_LINE + 1, 4, 2);
+	assert_io(3, FIRST_CORE_LINE + 2, 0, LINE_SECTORS);
+}
+
+static void cleaner_fire_core_test04(void **state)
+{
+	print_test_description("Lines not adjacent on core are not merged");
+
+	test_init(3, 1024 * 1024);
+
+	map[2].core_line = FIRST_CORE_LINE + 5;
+
+	assert_int_equal(_ocf_cleaner_fire_core(req), 0);
+
+	assert_int_equal(test.submitted, 2);
+	assert_io(0, FIRST_CORE_LINE, 0, 2 * LINE_SECTORS);
+	assert_io(1, FIRST_CORE_LINE + 5, 0, LINE_SECTORS);
+}
+
+static void cleaner_fire_core_test05(void **state)
+{
+	uint32_t i;
+
+	print_test_description("Failed merged core IO marks all covered "
+			"lines invalid");
+
+	test_init(4, 1024 * 1024);
+	test.error = -OCF_ERR_IO;
+
+	assert_int_equal(_ocf_cleaner_fire_core(req), 0);
+
+	assert_int_equal(test.submitted, 1);
+	for (i = 0; i < 4; i++)
+		assert_true(map[i].invalid);
+	assert_int_equal(req->error, -OCF_ERR_IO);
+}
+
+/*
+ * Main function. It runs tests.
+ */
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(cleaner_fire_core_test01),
+		cmocka_unit_test(cleaner_fire_core_test02),
+		cmocka_unit_test(cleaner_fire_core_test03),
+		cmocka_unit_test(cleaner_fire_core_test04),
+		cmocka_unit_test(cleaner_fire_core_test05)
+	};
+
+	print_message("Unit test of utils_cleaner.c\n");
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}